@@ -0,0 +1,277 @@
+/**
+ * @file BenchHarness.h
+ * @brief Minimal Microbenchmark Harness (Calibration, Statistics, JSON)
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Tools
+ *
+ * Each benchmark is a callable taking an iteration count:
+ *
+ *   runner.run("db/translate/SENSOR", [&](uint64_t n) {
+ *       for (uint64_t i = 0; i < n; i++) keep(dDatabase::translateToSQL(msg));
+ *   });
+ *
+ * The harness doubles the count until one batch takes --min-time-ms,
+ * runs one untimed warm-up batch, then --repetitions timed batches.
+ * Per-operation times are reported as median/mean/stddev/min/max so runs
+ * on a loaded Pi can be told apart from real regressions (compare the
+ * medians; a large stddev means the run was disturbed).
+ *
+ * Results are written as JSON together with the machine, compiler and git
+ * revision, so files from different commits or from the x86_64 and ARM64
+ * builds can be compared with bench/compare_bench.py.
+ */
+
+#ifndef BENCHHARNESS_H
+#define BENCHHARNESS_H
+
+/* ============================================================================
+ * System Includes
+ * ============================================================================ */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <sys/utsname.h>
+
+/* ============================================================================
+ * Build Information (set by src/CMakeLists.txt)
+ * ============================================================================ */
+#ifndef LEAFSENSE_GIT_REV
+#define LEAFSENSE_GIT_REV "unknown"
+#endif
+
+#ifndef LEAFSENSE_BUILD_TYPE
+#define LEAFSENSE_BUILD_TYPE "unknown"
+#endif
+
+/**
+ * @brief Keeps a value alive so the optimizer cannot drop the benchmarked work
+ */
+template <typename T>
+inline void keep(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @struct BenchOptions
+ * @brief Command line options shared by all benchmarks
+ */
+struct BenchOptions {
+    std::string filter;         ///< Substring; empty = run everything
+    int repetitions;            ///< Timed batches per benchmark
+    double minTimeMs;           ///< Minimum duration of one batch
+    std::string jsonPath;       ///< Results file
+    std::string imagePath;      ///< Input for ml/ and cam/ (empty = synthetic)
+    std::string dbDir;          ///< Scratch directory for benchmark databases
+    std::string schemaPath;     ///< database/schema.sql
+
+    BenchOptions()
+        : repetitions(10)
+        , minTimeMs(50.0)
+        , jsonPath("leafsense_bench.json")
+        , dbDir("/tmp")
+#ifdef LEAFSENSE_SCHEMA_PATH
+        , schemaPath(LEAFSENSE_SCHEMA_PATH)
+#else
+        , schemaPath("database/schema.sql")
+#endif
+    {}
+};
+
+/**
+ * @struct BenchResult
+ * @brief Per-operation statistics of one benchmark
+ */
+struct BenchResult {
+    std::string name;
+    uint64_t iterations;        ///< Operations per timed batch
+    uint64_t itemsPerOp;        ///< e.g. rows per batched insert
+    std::vector<double> samples;///< ns/op of each repetition
+    double medianNs;
+    double meanNs;
+    double stddevNs;
+    double minNs;
+    double maxNs;
+};
+
+/**
+ * @class BenchRunner
+ * @brief Runs, summarizes and exports benchmarks
+ */
+class BenchRunner {
+private:
+    BenchOptions options;
+    std::vector<BenchResult> results;
+
+    static int64_t nowNs()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+    static std::string escape(const std::string& text)
+    {
+        std::string out;
+        for (size_t i = 0; i < text.size(); i++) {
+            char c = text[i];
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                out += ' ';
+            } else {
+                out += c;
+            }
+        }
+        return out;
+    }
+
+    /** @brief "model name" (x86) or "Model" (Raspberry Pi) from /proc/cpuinfo */
+    static std::string cpuModel()
+    {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        std::string model;
+        while (std::getline(cpuinfo, line)) {
+            size_t colon = line.find(':');
+            if (colon == std::string::npos) continue;
+            std::string key = line.substr(0, line.find_last_not_of(" \t", colon - 1) + 1);
+            if (key == "model name" || (key == "Model" && model.empty())) {
+                model = line.substr(std::min(colon + 2, line.size()));
+                if (key == "model name") break;
+            }
+        }
+        return model.empty() ? "unknown" : model;
+    }
+
+public:
+    explicit BenchRunner(const BenchOptions& opts) : options(opts) {}
+
+    const BenchOptions& getOptions() const { return options; }
+
+    bool selected(const std::string& name) const
+    {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+
+    /**
+     * @brief Calibrates, warms up and times one benchmark
+     * @param name Hierarchical name ("group/case")
+     * @param body Runs the operation n times
+     * @param itemsPerOp Items processed by one operation (for throughput)
+     */
+    template <typename Body>
+    void run(const std::string& name, Body body, uint64_t itemsPerOp = 1)
+    {
+        if (!selected(name)) return;
+
+        // Calibrate: grow n until one batch reaches the minimum time
+        const double minNs = options.minTimeMs * 1e6;
+        uint64_t n = 1;
+        for (;;) {
+            int64_t start = nowNs();
+            body(n);
+            double elapsed = static_cast<double>(nowNs() - start);
+            if (elapsed >= minNs || n >= (1ULL << 40)) break;
+            double grow = elapsed > 0.0 ? 1.4 * minNs / elapsed : 100.0;
+            if (grow < 2.0) grow = 2.0;
+            if (grow > 100.0) grow = 100.0;
+            n = static_cast<uint64_t>(std::ceil(n * grow));
+        }
+
+        body(n);  // Warm-up (caches, allocator, SQLite page cache)
+
+        BenchResult result;
+        result.name = name;
+        result.iterations = n;
+        result.itemsPerOp = itemsPerOp;
+        for (int r = 0; r < options.repetitions; r++) {
+            int64_t start = nowNs();
+            body(n);
+            result.samples.push_back(static_cast<double>(nowNs() - start) / n);
+        }
+
+        std::vector<double> sorted = result.samples;
+        std::sort(sorted.begin(), sorted.end());
+        size_t count = sorted.size();
+        result.medianNs = (count % 2) ? sorted[count / 2]
+                                      : 0.5 * (sorted[count / 2 - 1] + sorted[count / 2]);
+        double sum = 0.0;
+        for (size_t i = 0; i < count; i++) sum += sorted[i];
+        result.meanNs = sum / count;
+        double var = 0.0;
+        for (size_t i = 0; i < count; i++) {
+            var += (sorted[i] - result.meanNs) * (sorted[i] - result.meanNs);
+        }
+        result.stddevNs = count > 1 ? std::sqrt(var / (count - 1)) : 0.0;
+        result.minNs = sorted.front();
+        result.maxNs = sorted.back();
+
+        printf("%-44s %12.1f ns/op  +-%5.1f%%  (%llu x %d)\n",
+               name.c_str(), result.medianNs,
+               result.meanNs > 0.0 ? 100.0 * result.stddevNs / result.meanNs : 0.0,
+               static_cast<unsigned long long>(n), options.repetitions);
+        fflush(stdout);
+
+        results.push_back(result);
+    }
+
+    /** @brief Writes the context and all results to options.jsonPath */
+    bool writeJson() const
+    {
+        FILE* out = fopen(options.jsonPath.c_str(), "w");
+        if (!out) {
+            fprintf(stderr, "[Bench] Cannot write %s\n", options.jsonPath.c_str());
+            return false;
+        }
+
+        struct utsname uts;
+        std::string arch = (uname(&uts) == 0) ? uts.machine : "unknown";
+        std::string kernel = (uname(&uts) == 0) ? uts.release : "unknown";
+        char date[32];
+        time_t now = time(NULL);
+        strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+        fprintf(out, "{\n  \"context\": {\n");
+        fprintf(out, "    \"date\": \"%s\",\n", date);
+        fprintf(out, "    \"arch\": \"%s\",\n", escape(arch).c_str());
+        fprintf(out, "    \"kernel\": \"%s\",\n", escape(kernel).c_str());
+        fprintf(out, "    \"cpu\": \"%s\",\n", escape(cpuModel()).c_str());
+        fprintf(out, "    \"compiler\": \"%s\",\n", escape(__VERSION__).c_str());
+        fprintf(out, "    \"build_type\": \"%s\",\n", escape(LEAFSENSE_BUILD_TYPE).c_str());
+        fprintf(out, "    \"git_rev\": \"%s\",\n", escape(LEAFSENSE_GIT_REV).c_str());
+        fprintf(out, "    \"repetitions\": %d,\n", options.repetitions);
+        fprintf(out, "    \"min_time_ms\": %.1f\n", options.minTimeMs);
+        fprintf(out, "  },\n  \"benchmarks\": [");
+
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult& r = results[i];
+            fprintf(out, "%s\n    {\"name\": \"%s\", \"iterations\": %llu, \"items_per_op\": %llu, "
+                         "\"median_ns\": %.3f, \"mean_ns\": %.3f, \"stddev_ns\": %.3f, "
+                         "\"min_ns\": %.3f, \"max_ns\": %.3f, \"samples_ns\": [",
+                    i ? "," : "", escape(r.name).c_str(),
+                    static_cast<unsigned long long>(r.iterations),
+                    static_cast<unsigned long long>(r.itemsPerOp),
+                    r.medianNs, r.meanNs, r.stddevNs, r.minNs, r.maxNs);
+            for (size_t s = 0; s < r.samples.size(); s++) {
+                fprintf(out, "%s%.3f", s ? ", " : "", r.samples[s]);
+            }
+            fprintf(out, "]}");
+        }
+        fprintf(out, "\n  ]\n}\n");
+
+        bool ok = (fclose(out) == 0);
+        if (ok) printf("[Bench] %zu result(s) written to %s\n", results.size(), options.jsonPath.c_str());
+        return ok;
+    }
+};
+
+#endif // BENCHHARNESS_H
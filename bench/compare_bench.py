@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+"""
+LeafSense - Compare two leafsense_bench JSON result files
+
+Usage:
+    python3 bench/compare_bench.py baseline.json candidate.json [--threshold 5]
+
+Prints the median ns/op of every benchmark present in both files and the
+relative change. A change is only flagged when it exceeds the threshold
+(percent) AND the min/max ranges of the two runs do not overlap, so noisy
+benchmarks are not reported as regressions.
+
+Files from different machines (e.g. x86_64 vs ARM64) can be compared the
+same way; the context of both runs is printed first.
+
+Exit status is 1 if any benchmark regressed, 0 otherwise.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return data.get('context', {}), {b['name']: b for b in data.get('benchmarks', [])}
+
+
+def describe(label, context):
+    print(f"{label}: {context.get('arch', '?')} | {context.get('cpu', '?')} | "
+          f"gcc {context.get('compiler', '?')} | {context.get('build_type', '?')} | "
+          f"rev {context.get('git_rev', '?')} | {context.get('date', '?')}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare leafsense_bench results')
+    parser.add_argument('baseline', help='Reference JSON file')
+    parser.add_argument('candidate', help='JSON file to compare against the baseline')
+    parser.add_argument('--threshold', type=float, default=5.0,
+                        help='Minimum change in percent to flag (default: 5)')
+    args = parser.parse_args()
+
+    base_ctx, base = load(args.baseline)
+    cand_ctx, cand = load(args.candidate)
+    describe('baseline ', base_ctx)
+    describe('candidate', cand_ctx)
+    print()
+
+    print(f"{'benchmark':<44} {'baseline':>14} {'candidate':>14} {'change':>9}")
+    print('-' * 84)
+
+    regressions = 0
+    for name in sorted(set(base) & set(cand)):
+        b, c = base[name], cand[name]
+        change = 100.0 * (c['median_ns'] - b['median_ns']) / b['median_ns'] if b['median_ns'] else 0.0
+        overlap = c['min_ns'] <= b['max_ns'] and b['min_ns'] <= c['max_ns']
+
+        flag = ''
+        if abs(change) >= args.threshold and not overlap:
+            flag = '  SLOWER' if change > 0 else '  faster'
+            if change > 0:
+                regressions += 1
+
+        print(f"{name:<44} {b['median_ns']:>11.1f} ns {c['median_ns']:>11.1f} ns "
+              f"{change:>+8.1f}%{flag}")
+
+    only = sorted(set(base) ^ set(cand))
+    if only:
+        print(f"\nPresent in one file only: {', '.join(only)}")
+
+    print(f"\n{regressions} regression(s) above {args.threshold:.1f}%")
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,432 @@
+/**
+ * @file leafsense_bench.cpp
+ * @brief Microbenchmarks of the LeafSense Hot Paths
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Tools
+ *
+ * Build and run (not part of the default build):
+ *
+ *   cmake --build build --target leafsense_bench
+ *   ./build/src/leafsense_bench --json bench-$(uname -m).json
+ *
+ * Groups (select with --filter <substring>):
+ * - queue/   MQueueHandler send/receive with 1, 2 and 4 producers
+ * - db/      dDatabase::translateToSQL per message type, dbManager::insert
+ *            one row per transaction and 100 rows per transaction
+ * - bridge/  LeafSenseDataBridge queries on 30 days of per-minute readings
+ * - ml/      ImageKernels::preprocessCHW (fused kernel vs the former OpenCV chain),
+ *            softmax, calculateEntropy, green ratio (fused kernel vs the
+ *            former full-frame HSV masks)
+ * - cam/     Cam::enhanceImage
+ *
+ * ml/ and cam/ use a seeded synthetic 640x480 frame unless --image is
+ * given, so results are comparable between machines. Databases are
+ * created under --db-dir and removed afterwards.
+ */
+
+/* ============================================================================
+ * Includes
+ * ============================================================================ */
+#include "BenchHarness.h"
+#include "MQueueHandler.h"
+#include "dDatabase.h"
+#include "dbManager.h"
+#include "leafsense_data_bridge.h"
+#include "ML.h"
+#include "ImageKernels.h"
+#include "Cam.h"
+#include "Logger.h"
+
+#include <opencv2/opencv.hpp>
+#include <QCoreApplication>
+#include <QDateTime>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <pthread.h>
+#include <unistd.h>
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+/** @brief Opens (or creates) a database and applies database/schema.sql */
+static dbManager* openBenchDatabase(const std::string& path, const std::string& schemaPath)
+{
+    unlink(path.c_str());
+    dbManager* db = new dbManager(path);
+
+    std::ifstream schema(schemaPath);
+    if (!schema.good()) {
+        fprintf(stderr, "[Bench] Schema not found: %s (use --schema)\n", schemaPath.c_str());
+        return db;
+    }
+    std::stringstream sql;
+    sql << schema.rdbuf();
+    db->execute(sql.str());
+    return db;
+}
+
+/** @brief Sensor message for minute i, with plausible values */
+static std::string sensorMessage(long i, long epoch)
+{
+    char msg[96];
+    snprintf(msg, sizeof(msg), "SENSOR|%.2f|%.2f|%d|%ld",
+             22.0 + 1.5 * std::sin(i / 229.0), 6.2 + 0.3 * std::sin(i / 517.0),
+             static_cast<int>(1200 + 150 * std::sin(i / 911.0)), epoch);
+    return msg;
+}
+
+/** @brief Drops Qt debug output (the bridge logs every query) */
+static void quietQtMessages(QtMsgType type, const QMessageLogContext&, const QString& msg)
+{
+    if (type == QtDebugMsg || type == QtInfoMsg) return;
+    fprintf(stderr, "%s\n", msg.toLocal8Bit().constData());
+}
+
+/* ============================================================================
+ * Message Queue
+ * ============================================================================ */
+
+struct ProducerArgs {
+    MQueueHandler* queue;
+    uint64_t count;
+};
+
+static void* producerFunc(void* arg)
+{
+    ProducerArgs* args = static_cast<ProducerArgs*>(arg);
+    const std::string msg = "SENSOR|23.40|6.12|1240|1760000000";
+    for (uint64_t i = 0; i < args->count; i++) {
+        args->queue->sendMessage(msg);
+    }
+    return NULL;
+}
+
+static void benchQueue(BenchRunner& runner)
+{
+    const int producerCounts[] = { 1, 2, 4 };
+    for (int producers : producerCounts) {
+        MQueueHandler queue;
+        // One op = one message through the queue (consumer on this thread)
+        runner.run("queue/send_receive/producers:" + std::to_string(producers), [&](uint64_t n) {
+            std::vector<pthread_t> threads(producers);
+            std::vector<ProducerArgs> args(producers);
+            uint64_t total = 0;
+            for (int p = 0; p < producers; p++) {
+                args[p].queue = &queue;
+                args[p].count = n / producers + (static_cast<uint64_t>(p) < n % producers ? 1 : 0);
+                total += args[p].count;
+                pthread_create(&threads[p], NULL, producerFunc, &args[p]);
+            }
+            for (uint64_t i = 0; i < total; i++) {
+                keep(queue.receiveMessage());
+            }
+            for (int p = 0; p < producers; p++) {
+                pthread_join(threads[p], NULL);
+            }
+        });
+    }
+}
+
+/* ============================================================================
+ * Database Daemon
+ * ============================================================================ */
+
+static void benchDbTranslate(BenchRunner& runner)
+{
+    if (!runner.selected("db/translate/")) return;
+
+    const char* messages[][2] = {
+        { "SENSOR",       "SENSOR|23.40|6.12|1240" },
+        { "SENSOR_EPOCH", "Z2|SENSOR|23.40|6.12|1240|1760000000" },
+        { "LOG",          "LOG|PUMP|pH down dosed|500ms on pump 19" },
+        { "ALERT",        "ALERT|PH|pH out of range (7.42)" },
+        { "IMG",          "IMG|20251018_120000.jpg|/opt/leafsense/gallery/20251018_120000.jpg" },
+        { "PRED",         "PRED|20251018_120000.jpg|Healthy|0.93" },
+        { "REC",          "REC|20251018_120000.jpg|care|Keep the plant's current routine|0.93" },
+    };
+    for (const auto& m : messages) {
+        const std::string msg = m[1];
+        runner.run(std::string("db/translate/") + m[0], [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; i++) {
+                keep(dDatabase::translateToSQL(msg));
+            }
+        });
+    }
+}
+
+static void benchDbInsert(BenchRunner& runner)
+{
+    if (!runner.selected("db/insert/")) return;
+
+    std::string path = runner.getOptions().dbDir + "/leafsense_bench_insert.db";
+    dbManager* db = openBenchDatabase(path, runner.getOptions().schemaPath);
+    MQueueHandler queue;
+    dDatabase daemon(&queue, path);  // Migrates the schema (zones, zone_id)
+    long minute = 0;
+    const long base = 1760000000L;
+
+    // What dDatabase::run() does per message: one implicit transaction
+    runner.run("db/insert/single", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++, minute++) {
+            keep(db->insert(dDatabase::translateToSQL(sensorMessage(minute, base + minute * 60))));
+        }
+    });
+
+    const int BATCH = 100;
+    runner.run("db/insert/batch_100", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            db->execute("BEGIN;");
+            for (int r = 0; r < BATCH; r++, minute++) {
+                db->insert(dDatabase::translateToSQL(sensorMessage(minute, base + minute * 60)));
+            }
+            keep(db->execute("COMMIT;"));
+        }
+    }, BATCH);
+
+    delete db;
+    unlink(path.c_str());
+}
+
+/* ============================================================================
+ * GUI Data Bridge
+ * ============================================================================ */
+
+static void benchBridge(BenchRunner& runner)
+{
+    if (!runner.selected("bridge/")) return;
+
+    std::string path = runner.getOptions().dbDir + "/leafsense_bench_bridge.db";
+    dbManager* db = openBenchDatabase(path, runner.getOptions().schemaPath);
+    MQueueHandler queue;
+    dDatabase daemon(&queue, path);  // Migrates the schema (zones, zone_id)
+
+    // 30 days at one reading per minute, ending now, plus alerts and predictions
+    const long DAYS = 30;
+    const long now = static_cast<long>(QDateTime::currentSecsSinceEpoch());
+    const long start = now - DAYS * 86400;
+    db->execute("BEGIN;");
+    for (long i = 0; i < DAYS * 1440; i++) {
+        db->insert(dDatabase::translateToSQL(sensorMessage(i, start + i * 60)));
+    }
+    for (int i = 0; i < 200; i++) {
+        db->insert(dDatabase::translateToSQL("ALERT|PH|pH out of range (" + std::to_string(i) + ")"));
+    }
+    std::string lastImage;
+    for (int i = 0; i < 100; i++) {
+        lastImage = "bench_" + std::to_string(i) + ".jpg";
+        db->insert(dDatabase::translateToSQL("IMG|" + lastImage + "|/tmp/" + lastImage));
+        db->insert(dDatabase::translateToSQL("PRED|" + lastImage + "|Healthy|0.91"));
+    }
+    db->execute("COMMIT;");
+    delete db;
+
+    LeafSenseDataBridge bridge(QString::fromStdString(path));
+    const QString image = QString::fromStdString(lastImage);
+
+    runner.run("bridge/get_sensor_data", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) keep(bridge.get_sensor_data());
+    });
+    runner.run("bridge/get_latest_alert", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) keep(bridge.get_latest_alert());
+    });
+    runner.run("bridge/get_health_assessment", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) keep(bridge.get_health_assessment());
+    });
+    runner.run("bridge/get_sensor_history/30d", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) keep(bridge.get_sensor_history(30));
+    });
+    runner.run("bridge/get_interpolated_series/24h_5min", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) keep(bridge.get_interpolated_series(now - 86400, now, 300));
+    });
+    runner.run("bridge/get_image_prediction", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) keep(bridge.get_image_prediction(image));
+    });
+
+    unlink(path.c_str());
+}
+
+/* ============================================================================
+ * ML / Camera
+ * ============================================================================ */
+
+/**
+ * @brief Preprocessing as ML did it before ImageKernels (reference only)
+ *
+ * resize, cvtColor, convertTo, split and per-channel arithmetic, each
+ * allocating, then an element-wise copy into CHW.
+ */
+static std::vector<float> preprocessOpenCV(const cv::Mat& image, int size)
+{
+    cv::Mat resized, rgb, normalized;
+    cv::resize(image, resized, cv::Size(size, size));
+    cv::cvtColor(resized, rgb, cv::COLOR_BGR2RGB);
+    rgb.convertTo(normalized, CV_32FC3, 1.0 / 255.0);
+
+    std::vector<cv::Mat> channels(3);
+    cv::split(normalized, channels);
+
+    const float mean[] = { 0.485f, 0.456f, 0.406f };
+    const float stdDev[] = { 0.229f, 0.224f, 0.225f };
+    for (int i = 0; i < 3; i++) {
+        channels[i] = (channels[i] - mean[i]) / stdDev[i];
+    }
+
+    std::vector<float> tensor(3 * size * size);
+    for (int c = 0; c < 3; c++) {
+        for (int h = 0; h < size; h++) {
+            for (int w = 0; w < size; w++) {
+                tensor[c * size * size + h * size + w] = channels[c].at<float>(h, w);
+            }
+        }
+    }
+    return tensor;
+}
+
+/**
+ * @brief Green ratio as ML computed it before it moved into ImageKernels
+ *        (reference only): full-frame HSV, two masks, OR, count
+ */
+static float greenRatioOpenCV(const cv::Mat& image)
+{
+    cv::Mat hsv, greenMask, yellowGreenMask, combinedMask;
+    cv::cvtColor(image, hsv, cv::COLOR_BGR2HSV);
+    cv::inRange(hsv, cv::Scalar(35, 30, 30), cv::Scalar(85, 255, 255), greenMask);
+    cv::inRange(hsv, cv::Scalar(20, 30, 30), cv::Scalar(35, 255, 255), yellowGreenMask);
+    cv::bitwise_or(greenMask, yellowGreenMask, combinedMask);
+    return static_cast<float>(cv::countNonZero(combinedMask)) / (image.rows * image.cols);
+}
+
+static void benchML(BenchRunner& runner, const cv::Mat& frame)
+{
+    if (!runner.selected("ml/") && !runner.selected("cam/")) return;
+
+    // Kernels only, no model: ML::preprocess() is preprocessCHW() plus a
+    // type conversion that 8-bit BGR frames skip
+    const std::vector<float> logits = { 1.2f, -0.4f, 3.1f, 0.2f };
+    const std::vector<float> probs = ML::softmax(logits);
+    const int size = ML::IMAGE_SIZE;
+
+    // Fused kernel against the chain it replaced, on the same frame
+    std::vector<float> tensor(3 * size * size);
+    float greenRatio = 0.0f;
+    const std::vector<float> reference = preprocessOpenCV(frame, size);
+    ImageKernels::preprocessCHW(frame.data, frame.cols, frame.rows, frame.step,
+                                tensor.data(), size, &greenRatio);
+    float maxDiff = 0.0f;
+    for (size_t i = 0; i < tensor.size() && i < reference.size(); i++) {
+        maxDiff = std::max(maxDiff, std::fabs(tensor[i] - reference[i]));
+    }
+    fprintf(stderr, "[Bench] preprocess: %s path, max |fused - opencv| = %.4f\n",
+            ImageKernels::simdPath(), maxDiff);
+    fprintf(stderr, "[Bench] green ratio: fused (224x224) %.4f, opencv (full frame) %.4f\n",
+            greenRatio, greenRatioOpenCV(frame));
+
+    runner.run("ml/preprocess", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            ImageKernels::preprocessCHW(frame.data, frame.cols, frame.rows, frame.step,
+                                        tensor.data(), size, &greenRatio);
+            keep(tensor.data());
+        }
+    });
+    runner.run("ml/preprocess_no_green", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            ImageKernels::preprocessCHW(frame.data, frame.cols, frame.rows, frame.step,
+                                        tensor.data(), size);
+            keep(tensor.data());
+        }
+    });
+    runner.run("ml/preprocess_opencv", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) keep(preprocessOpenCV(frame, size));
+    });
+    runner.run("ml/softmax", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) keep(ML::softmax(logits));
+    });
+    runner.run("ml/entropy", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) keep(ML::calculateEntropy(probs));
+    });
+    runner.run("ml/green_ratio_opencv", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) keep(greenRatioOpenCV(frame));
+    });
+    runner.run("cam/enhance", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) keep(Cam::enhanceImage(frame));
+    });
+}
+
+/** @brief --image, or a seeded frame with leaf-like green blobs on noise */
+static cv::Mat benchFrame(const std::string& imagePath)
+{
+    if (!imagePath.empty()) {
+        cv::Mat image = cv::imread(imagePath);
+        if (!image.empty()) return image;
+        fprintf(stderr, "[Bench] Cannot read %s, using synthetic frame\n", imagePath.c_str());
+    }
+
+    cv::Mat frame(480, 640, CV_8UC3);
+    cv::RNG rng(42);
+    rng.fill(frame, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+    for (int i = 0; i < 12; i++) {
+        cv::Point center(rng.uniform(0, 640), rng.uniform(0, 480));
+        cv::Size axes(rng.uniform(30, 90), rng.uniform(20, 60));
+        cv::ellipse(frame, center, axes, rng.uniform(0, 180), 0, 360,
+                    cv::Scalar(rng.uniform(20, 60), rng.uniform(120, 200), rng.uniform(20, 70)),
+                    cv::FILLED);
+    }
+    return frame;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+static void usage(const char* argv0)
+{
+    printf("Usage: %s [options]\n"
+           "  --filter <text>       Run benchmarks whose name contains <text>\n"
+           "  --repetitions <n>     Timed batches per benchmark (default 10)\n"
+           "  --min-time-ms <ms>    Minimum duration of one batch (default 50)\n"
+           "  --json <file>         Results file (default leafsense_bench.json)\n"
+           "  --image <file>        Input image for ml/ and cam/ (default synthetic)\n"
+           "  --db-dir <dir>        Scratch directory for databases (default /tmp)\n"
+           "  --schema <file>       database/schema.sql\n", argv0);
+}
+
+int main(int argc, char* argv[])
+{
+    // Only errors from the code under test; must be set before Logger starts
+    setenv("LEAFSENSE_LOG_LEVEL", "error", 0);
+
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "--filter" && hasValue) options.filter = argv[++i];
+        else if (arg == "--repetitions" && hasValue) options.repetitions = std::max(1, atoi(argv[++i]));
+        else if (arg == "--min-time-ms" && hasValue) options.minTimeMs = atof(argv[++i]);
+        else if (arg == "--json" && hasValue) options.jsonPath = argv[++i];
+        else if (arg == "--image" && hasValue) options.imagePath = argv[++i];
+        else if (arg == "--db-dir" && hasValue) options.dbDir = argv[++i];
+        else if (arg == "--schema" && hasValue) options.schemaPath = argv[++i];
+        else {
+            usage(argv[0]);
+            return (arg == "--help" || arg == "-h") ? 0 : 1;
+        }
+    }
+
+    QCoreApplication app(argc, argv);
+    qInstallMessageHandler(quietQtMessages);
+
+    BenchRunner runner(options);
+    benchQueue(runner);
+    benchDbTranslate(runner);
+    benchDbInsert(runner);
+    benchBridge(runner);
+    benchML(runner, benchFrame(options.imagePath));
+
+    bool ok = runner.writeJson();
+    Logger::instance().shutdown();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,339 @@
+/**
+ * @file ml_compare.cpp
+ * @brief Accuracy/Latency Comparison of Two Plant Health Models
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Tools
+ *
+ * Build and run (not part of the default build, no Qt needed):
+ *
+ *   cmake --build build --target leafsense_mlcompare
+ *   ./build/src/leafsense_mlcompare --images dataset/val \
+ *       --a /opt/leafsense/leafsense_model.onnx \
+ *       --b /opt/leafsense/leafsense_model_int8.onnx
+ *
+ * --images follows the training layout (<dir>/<class>/<image>.jpg). Class
+ * folders are sorted by name to get label ids, as torchvision's
+ * ImageFolder does, so they line up with the model outputs.
+ *
+ * Each model is evaluated in its own child process, so "peak RSS" is the
+ * high-water mark of that model alone (session, arena and buffers).
+ * Latency covers ML::infer() only (copy into the bound input, ORT run,
+ * softmax) after the warm-up run done at load time; decoding and
+ * preprocessing are identical for both models and excluded.
+ *
+ * Reported: top-1 agreement between the models, overall and per-class
+ * accuracy, p50/p99 latency and peak RSS. --json writes the same data.
+ */
+
+/* ============================================================================
+ * Includes
+ * ============================================================================ */
+#include "ML.h"
+#include "Logger.h"
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* ============================================================================
+ * Data Set
+ * ============================================================================ */
+
+struct LabelledImage {
+    std::string path;
+    int label;
+};
+
+/** @brief Sorted entries of a directory (no "." / "..") */
+static std::vector<std::string> listDir(const std::string& dir)
+{
+    std::vector<std::string> names;
+    DIR* d = opendir(dir.c_str());
+    if (!d) return names;
+    while (struct dirent* e = readdir(d)) {
+        if (e->d_name[0] != '.') names.push_back(e->d_name);
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+static bool isDirectory(const std::string& path)
+{
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+static bool isImageFile(const std::string& name)
+{
+    size_t dot = name.find_last_of('.');
+    if (dot == std::string::npos) return false;
+    std::string ext = name.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == "jpg" || ext == "jpeg" || ext == "png";
+}
+
+static std::vector<LabelledImage> loadDataset(const std::string& root, std::vector<std::string>& classes)
+{
+    std::vector<LabelledImage> images;
+    for (const std::string& name : listDir(root)) {
+        if (!isDirectory(root + "/" + name)) continue;
+        int label = static_cast<int>(classes.size());
+        classes.push_back(name);
+        for (const std::string& file : listDir(root + "/" + name)) {
+            if (isImageFile(file)) images.push_back({ root + "/" + name + "/" + file, label });
+        }
+    }
+    return images;
+}
+
+/* ============================================================================
+ * Evaluation (child process)
+ * ============================================================================ */
+
+struct ModelRun {
+    std::string path;
+    std::string precision;
+    std::vector<int> predictions;   ///< Arg-max class per image (-1 = not run)
+    std::vector<double> latencyMs;  ///< ML::infer() per image
+    long peakRssKb;
+    bool ok;
+};
+
+static double monotonicMs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+/**
+ * @brief Loads one model and streams "<prediction> <ms>" lines to fd
+ *
+ * The first line is the precision tag; nothing else is written, so the
+ * parent can parse the pipe without framing.
+ */
+static int evaluateChild(const std::string& modelPath, const std::vector<LabelledImage>& images, int fd)
+{
+    Logger::instance().setLevel(LEVEL_WARN);  // No per-image prediction lines
+
+    size_t slash = modelPath.find_last_of('/');
+    std::string dir = (slash == std::string::npos) ? "." : modelPath.substr(0, slash);
+    std::string name = (slash == std::string::npos) ? modelPath : modelPath.substr(slash + 1);
+
+    ML ml(dir, name);
+    if (!ml.isInitialized()) {
+        fprintf(stderr, "[Compare] Cannot load %s\n", modelPath.c_str());
+        return 2;
+    }
+
+    FILE* out = fdopen(fd, "w");
+    fprintf(out, "%s\n", ml.getPrecision().c_str());
+
+    std::vector<float> tensor;
+    for (const LabelledImage& image : images) {
+        float greenRatio = 0.0f;
+        cv::Mat frame = cv::imread(image.path);
+        if (!ml.prepareInput(frame, tensor, greenRatio)) {
+            fprintf(out, "-1 0\n");
+            continue;
+        }
+
+        double t0 = monotonicMs();
+        MLResult result = ml.infer(tensor, greenRatio);
+        double ms = monotonicMs() - t0;
+
+        // Raw arg-max: the OOD override (class -1) is a separate concern
+        int prediction = -1;
+        if (!result.probs.empty()) {
+            prediction = static_cast<int>(std::max_element(result.probs.begin(), result.probs.end()) -
+                                          result.probs.begin());
+        }
+        fprintf(out, "%d %.4f\n", prediction, ms);
+    }
+    fclose(out);
+    Logger::instance().shutdown();
+    return 0;
+}
+
+/** @brief Forks, evaluates one model in the child and collects its results */
+static ModelRun evaluate(const std::string& modelPath, const std::vector<LabelledImage>& images)
+{
+    ModelRun run;
+    run.path = modelPath;
+    run.peakRssKb = 0;
+    run.ok = false;
+
+    int fds[2];
+    if (pipe(fds) != 0) return run;
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return run;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        _exit(evaluateChild(modelPath, images, fds[1]));
+    }
+
+    close(fds[1]);
+    FILE* in = fdopen(fds[0], "r");
+    char precision[64] = "";
+    if (fscanf(in, "%63s", precision) == 1) {
+        run.precision = precision;
+        int prediction;
+        double ms;
+        while (fscanf(in, "%d %lf", &prediction, &ms) == 2) {
+            run.predictions.push_back(prediction);
+            if (prediction >= 0) run.latencyMs.push_back(ms);
+        }
+    }
+    fclose(in);
+
+    int status = 0;
+    struct rusage usage;
+    memset(&usage, 0, sizeof(usage));
+    wait4(pid, &status, 0, &usage);
+    run.peakRssKb = usage.ru_maxrss;  // KiB on Linux
+    run.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 && run.predictions.size() == images.size();
+    return run;
+}
+
+/* ============================================================================
+ * Report
+ * ============================================================================ */
+
+static double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(p / 100.0 * (values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+
+struct Accuracy {
+    std::vector<int> correct;
+    std::vector<int> total;
+    int allCorrect;
+};
+
+static Accuracy accuracy(const ModelRun& run, const std::vector<LabelledImage>& images, size_t classCount)
+{
+    Accuracy acc;
+    acc.correct.assign(classCount, 0);
+    acc.total.assign(classCount, 0);
+    acc.allCorrect = 0;
+    for (size_t i = 0; i < images.size(); i++) {
+        acc.total[images[i].label]++;
+        if (run.predictions[i] == images[i].label) {
+            acc.correct[images[i].label]++;
+            acc.allCorrect++;
+        }
+    }
+    return acc;
+}
+
+static double pct(int part, int whole)
+{
+    return whole ? 100.0 * part / whole : 0.0;
+}
+
+static void usage(const char* argv0)
+{
+    fprintf(stderr,
+            "Usage: %s --images <dir> --a <model.onnx> --b <model.onnx> [--json <file>]\n"
+            "  --images  Labelled set: <dir>/<class>/*.jpg (classes sorted by name)\n"
+            "  --a, --b  Models to compare (e.g. float32 and INT8 QDQ)\n",
+            argv0);
+}
+
+int main(int argc, char* argv[])
+{
+    std::string imagesDir, modelA, modelB, jsonPath;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) { usage(argv[0]); return 1; }
+        if (arg == "--images") imagesDir = argv[++i];
+        else if (arg == "--a") modelA = argv[++i];
+        else if (arg == "--b") modelB = argv[++i];
+        else if (arg == "--json") jsonPath = argv[++i];
+        else { usage(argv[0]); return 1; }
+    }
+    if (imagesDir.empty() || modelA.empty() || modelB.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<std::string> classes;
+    std::vector<LabelledImage> images = loadDataset(imagesDir, classes);
+    if (images.empty()) {
+        fprintf(stderr, "[Compare] No images under %s/<class>/\n", imagesDir.c_str());
+        return 1;
+    }
+    printf("%zu images, %zu classes\n", images.size(), classes.size());
+
+    ModelRun runs[2] = { evaluate(modelA, images), evaluate(modelB, images) };
+    for (const ModelRun& run : runs) {
+        if (!run.ok) {
+            fprintf(stderr, "[Compare] Evaluation of %s failed\n", run.path.c_str());
+            return 1;
+        }
+    }
+
+    int agree = 0;
+    for (size_t i = 0; i < images.size(); i++) {
+        if (runs[0].predictions[i] == runs[1].predictions[i]) agree++;
+    }
+    Accuracy acc[2] = { accuracy(runs[0], images, classes.size()), accuracy(runs[1], images, classes.size()) };
+    const int n = static_cast<int>(images.size());
+
+    printf("\n%-26s %12s %12s\n", "", "A", "B");
+    printf("%-26s %12s %12s\n", "precision", runs[0].precision.c_str(), runs[1].precision.c_str());
+    printf("%-26s %11.2f%% %11.2f%%\n", "top-1 accuracy", pct(acc[0].allCorrect, n), pct(acc[1].allCorrect, n));
+    for (size_t c = 0; c < classes.size(); c++) {
+        printf("  %-24s %11.2f%% %11.2f%%  (%d images)\n", classes[c].c_str(),
+               pct(acc[0].correct[c], acc[0].total[c]), pct(acc[1].correct[c], acc[1].total[c]), acc[0].total[c]);
+    }
+    printf("%-26s %10.2fms %10.2fms\n", "latency p50", percentile(runs[0].latencyMs, 50), percentile(runs[1].latencyMs, 50));
+    printf("%-26s %10.2fms %10.2fms\n", "latency p99", percentile(runs[0].latencyMs, 99), percentile(runs[1].latencyMs, 99));
+    printf("%-26s %10.1fMB %10.1fMB\n", "peak RSS", runs[0].peakRssKb / 1024.0, runs[1].peakRssKb / 1024.0);
+    printf("\ntop-1 agreement A/B: %.2f%% (%d of %d)\n", pct(agree, n), agree, n);
+    printf("A = %s\nB = %s\n", runs[0].path.c_str(), runs[1].path.c_str());
+
+    if (!jsonPath.empty()) {
+        FILE* f = fopen(jsonPath.c_str(), "w");
+        if (!f) {
+            fprintf(stderr, "[Compare] Cannot write %s\n", jsonPath.c_str());
+            return 1;
+        }
+        fprintf(f, "{\n  \"images\": %d,\n  \"top1_agreement\": %.4f,\n  \"models\": [\n", n, pct(agree, n) / 100.0);
+        for (int m = 0; m < 2; m++) {
+            fprintf(f, "    {\"path\": \"%s\", \"precision\": \"%s\", \"top1_accuracy\": %.4f, "
+                       "\"p50_ms\": %.3f, \"p99_ms\": %.3f, \"peak_rss_kb\": %ld, \"per_class\": {",
+                    runs[m].path.c_str(), runs[m].precision.c_str(), pct(acc[m].allCorrect, n) / 100.0,
+                    percentile(runs[m].latencyMs, 50), percentile(runs[m].latencyMs, 99), runs[m].peakRssKb);
+            for (size_t c = 0; c < classes.size(); c++) {
+                fprintf(f, "%s\"%s\": %.4f", c ? ", " : "", classes[c].c_str(),
+                        pct(acc[m].correct[c], acc[m].total[c]) / 100.0);
+            }
+            fprintf(f, "}}%s\n", m == 0 ? "," : "");
+        }
+        fprintf(f, "  ]\n}\n");
+        fclose(f);
+    }
+    return 0;
+}
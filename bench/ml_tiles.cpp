@@ -0,0 +1,218 @@
+/**
+ * @file ml_tiles.cpp
+ * @brief Latency/Accuracy of Tiled Inference per Tile Count
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Tools
+ *
+ * Build and run (not part of the default build, no Qt needed):
+ *
+ *   cmake --build build --target leafsense_mltiles
+ *   ./build/src/leafsense_mltiles --images dataset/val \
+ *       --model /opt/leafsense/leafsense_model.onnx --tiles 1,2,3 --overlap 0.25
+ *
+ * Runs ML::analyzeTiled() on every image once per grid size. Grid 1 is
+ * the plain full-frame classification. Latency covers the whole call:
+ * cropping, parallel preprocessing of the crops, the ORT call and the
+ * pooling. Decoding is excluded.
+ *
+ * --images may follow the training layout (<dir>/<class>/<image>.jpg,
+ * classes sorted by name as in ml_compare) to also report accuracy, or be
+ * a flat directory of frames (latency and regions only).
+ *
+ * Reported per grid: crops per frame, p50/p99 latency, images with at
+ * least one region, regions per image, and top-1 accuracy when labelled
+ * (an OOD rejection counts as wrong, unlike ml_compare's raw arg-max).
+ */
+
+/* ============================================================================
+ * Includes
+ * ============================================================================ */
+#include "ML.h"
+#include "Logger.h"
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+
+/* ============================================================================
+ * Data Set
+ * ============================================================================ */
+
+struct Frame {
+    std::string path;
+    int label;      ///< Class index, -1 for a flat directory
+};
+
+/** @brief Sorted entries of a directory (no "." / "..") */
+static std::vector<std::string> listDir(const std::string& dir)
+{
+    std::vector<std::string> names;
+    DIR* d = opendir(dir.c_str());
+    if (!d) return names;
+    while (struct dirent* e = readdir(d)) {
+        if (e->d_name[0] != '.') names.push_back(e->d_name);
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+static bool isDirectory(const std::string& path)
+{
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+static bool isImageFile(const std::string& name)
+{
+    size_t dot = name.find_last_of('.');
+    if (dot == std::string::npos) return false;
+    std::string ext = name.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == "jpg" || ext == "jpeg" || ext == "png";
+}
+
+/** @brief Class folders if there are any, otherwise the images in root */
+static std::vector<Frame> loadFrames(const std::string& root, size_t& classCount)
+{
+    std::vector<Frame> frames;
+    classCount = 0;
+    for (const std::string& name : listDir(root)) {
+        if (!isDirectory(root + "/" + name)) continue;
+        int label = static_cast<int>(classCount++);
+        for (const std::string& file : listDir(root + "/" + name)) {
+            if (isImageFile(file)) frames.push_back({ root + "/" + name + "/" + file, label });
+        }
+    }
+    if (classCount == 0) {
+        for (const std::string& file : listDir(root)) {
+            if (isImageFile(file)) frames.push_back({ root + "/" + file, -1 });
+        }
+    }
+    return frames;
+}
+
+/* ============================================================================
+ * Report
+ * ============================================================================ */
+
+static double monotonicMs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(p / 100.0 * (values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+
+static void usage(const char* argv0)
+{
+    fprintf(stderr,
+            "Usage: %s --images <dir> --model <model.onnx> [--tiles 1,2,3] [--overlap 0.25]\n"
+            "  --images   <dir>/<class>/*.jpg (adds accuracy) or <dir>/*.jpg\n"
+            "  --tiles    Grid sizes to compare (1 = full frame only, max 4)\n"
+            "  --overlap  Share of a tile shared with its neighbour (0 - 0.5)\n",
+            argv0);
+}
+
+int main(int argc, char* argv[])
+{
+    std::string imagesDir, modelPath, tileList = "1,2,3";
+    float overlap = 0.25f;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) { usage(argv[0]); return 1; }
+        if (arg == "--images") imagesDir = argv[++i];
+        else if (arg == "--model") modelPath = argv[++i];
+        else if (arg == "--tiles") tileList = argv[++i];
+        else if (arg == "--overlap") overlap = static_cast<float>(atof(argv[++i]));
+        else { usage(argv[0]); return 1; }
+    }
+    if (imagesDir.empty() || modelPath.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<int> grids;
+    std::stringstream list(tileList);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        int grid = atoi(item.c_str());
+        if (grid < 1 || grid > 4) {
+            fprintf(stderr, "[Tiles] Grid size %s out of range (1-4)\n", item.c_str());
+            return 1;
+        }
+        grids.push_back(grid);
+    }
+
+    size_t classCount = 0;
+    std::vector<Frame> frames = loadFrames(imagesDir, classCount);
+    if (frames.empty()) {
+        fprintf(stderr, "[Tiles] No images in %s\n", imagesDir.c_str());
+        return 1;
+    }
+
+    Logger::instance().setLevel(LEVEL_WARN);  // No per-crop prediction lines
+    size_t slash = modelPath.find_last_of('/');
+    ML ml(slash == std::string::npos ? "." : modelPath.substr(0, slash),
+          slash == std::string::npos ? modelPath : modelPath.substr(slash + 1));
+    if (!ml.isInitialized()) {
+        fprintf(stderr, "[Tiles] Cannot load %s\n", modelPath.c_str());
+        return 1;
+    }
+
+    // Decoded once: every grid size sees the same pixels
+    std::vector<cv::Mat> images;
+    for (const Frame& frame : frames) {
+        images.push_back(cv::imread(frame.path));
+    }
+
+    printf("%zu images%s, model %s, overlap %.0f%%\n\n", frames.size(),
+           classCount ? "" : " (unlabelled)", ml.getModelVersion().c_str(), overlap * 100);
+    printf("%-6s %6s %10s %10s %10s %10s %10s\n",
+           "grid", "crops", "p50", "p99", "flagged", "regions", "top-1");
+
+    for (int grid : grids) {
+        std::vector<double> latencyMs;
+        int flagged = 0, regions = 0, correct = 0, counted = 0;
+        for (size_t i = 0; i < frames.size(); i++) {
+            if (images[i].empty()) continue;
+            double t0 = monotonicMs();
+            MLResult result = ml.analyzeTiled(images[i], grid, overlap);
+            latencyMs.push_back(monotonicMs() - t0);
+
+            if (!result.regions.empty()) flagged++;
+            regions += static_cast<int>(result.regions.size());
+            counted++;
+            if (result.class_id == frames[i].label) correct++;
+        }
+
+        const int crops = grid > 1 ? grid * grid + 1 : 1;
+        printf("%dx%-4d %6d %8.2fms %8.2fms %9.1f%% %10.2f", grid, grid, crops,
+               percentile(latencyMs, 50), percentile(latencyMs, 99),
+               counted ? 100.0 * flagged / counted : 0.0,
+               counted ? static_cast<double>(regions) / counted : 0.0);
+        if (classCount) {
+            printf(" %9.2f%%\n", counted ? 100.0 * correct / counted : 0.0);
+        } else {
+            printf(" %10s\n", "-");
+        }
+    }
+
+    Logger::instance().shutdown();
+    return 0;
+}
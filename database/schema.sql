@@ -25,9 +25,18 @@ CREATE TABLE IF NOT EXISTS plant (
     updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
 );
 
+-- 2b. ZONES TABLE
+-- One row per reservoir controlled by this device (id matches zone.<id>.* in leafsense.conf)
+CREATE TABLE IF NOT EXISTS zones (
+    id INTEGER PRIMARY KEY,
+    name TEXT NOT NULL,
+    created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+);
+
 -- 3. SENSOR_READINGS TABLE
 CREATE TABLE IF NOT EXISTS sensor_readings (
     id INTEGER PRIMARY KEY AUTOINCREMENT,
+    zone_id INTEGER NOT NULL DEFAULT 1 REFERENCES zones(id),
     temperature REAL,
     ph REAL,
     ec REAL,
@@ -35,10 +44,13 @@ CREATE TABLE IF NOT EXISTS sensor_readings (
 );
 -- ERD [INDEX]: Optimized for time-series plotting
 CREATE INDEX IF NOT EXISTS idx_sensor_timestamp ON sensor_readings(timestamp);
+-- ERD [INDEX]: Optimized for per-zone plotting
+CREATE INDEX IF NOT EXISTS idx_sensor_zone_timestamp ON sensor_readings(zone_id, timestamp);
 
 -- 4. ALERTS TABLE
 CREATE TABLE IF NOT EXISTS alerts (
     id INTEGER PRIMARY KEY AUTOINCREMENT,
+    zone_id INTEGER NOT NULL DEFAULT 1 REFERENCES zones(id),
     type TEXT NOT NULL, -- 'Warning', 'Critical', 'Info'
     message TEXT NOT NULL,
     details TEXT,
@@ -51,6 +63,7 @@ CREATE INDEX IF NOT EXISTS idx_alerts_is_read ON alerts(is_read);
 -- 5. LOGS TABLE
 CREATE TABLE IF NOT EXISTS logs (
     id INTEGER PRIMARY KEY AUTOINCREMENT,
+    zone_id INTEGER NOT NULL DEFAULT 1 REFERENCES zones(id),
     log_type TEXT NOT NULL, -- 'Disease', 'Deficiency', 'Maintenance', 'Alert'
     message TEXT NOT NULL,
     details TEXT,
@@ -62,6 +75,7 @@ CREATE INDEX IF NOT EXISTS idx_logs_type ON logs(log_type);
 -- 6. PLANT_IMAGES TABLE
 CREATE TABLE IF NOT EXISTS plant_images (
     id INTEGER PRIMARY KEY AUTOINCREMENT,
+    zone_id INTEGER NOT NULL DEFAULT 1 REFERENCES zones(id),
     filename TEXT NOT NULL,
     filepath TEXT NOT NULL,
     captured_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
@@ -78,7 +92,7 @@ CREATE TABLE IF NOT EXISTS ml_predictions (
     prediction_type TEXT NOT NULL, -- 'Disease', 'Deficiency', 'Healthy'
     prediction_label TEXT NOT NULL,
     confidence REAL NOT NULL,
-    bounding_box TEXT, -- JSON string coordinates
+    bounding_box TEXT, -- "x,y,w,h[;x,y,w,h...]" image pixels, tiled inference only
     predicted_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
     model_version TEXT,
     FOREIGN KEY (image_id) REFERENCES plant_images(id) ON DELETE CASCADE
@@ -139,6 +153,21 @@ CREATE TABLE IF NOT EXISTS ml_recommendations (
 -- ERD [INDEX]: Optimized for the "Actions Needed" dashboard panel
 CREATE INDEX IF NOT EXISTS idx_recs_ack ON ml_recommendations(user_acknowledged);
 
+-- 11. ML_RESULT_CACHE TABLE
+-- Model output per image content; written (and pruned) by leafsense-rescore only
+CREATE TABLE IF NOT EXISTS ml_result_cache (
+    image_hash TEXT NOT NULL, -- plant_images.image_hash
+    model_version TEXT NOT NULL, -- ML::getModelVersion()
+    class_id INTEGER NOT NULL,
+    class_name TEXT NOT NULL,
+    confidence REAL NOT NULL,
+    entropy REAL NOT NULL,
+    is_valid INTEGER NOT NULL, -- OOD check passed
+    probs TEXT NOT NULL, -- comma-separated class probabilities
+    created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP, -- last store or hit (LRU prune)
+    PRIMARY KEY (image_hash, model_version)
+);
+
 -- ==========================================
 -- VIEWS (Virtual Tables for Analytics)
 -- ==========================================
@@ -150,6 +179,14 @@ SELECT * FROM sensor_readings
 ORDER BY timestamp DESC 
 LIMIT 1;
 
+-- View 1b: Latest Sensor Reading per Zone
+-- Used for: Zone overview (one row per reservoir)
+CREATE VIEW IF NOT EXISTS vw_latest_sensor_reading_per_zone AS
+SELECT s.* FROM sensor_readings s
+WHERE s.id = (SELECT id FROM sensor_readings
+              WHERE zone_id = s.zone_id
+              ORDER BY timestamp DESC LIMIT 1);
+
 -- View 2: Unread Alerts
 -- Used for: Notification badges and Alert Panel
 CREATE VIEW IF NOT EXISTS vw_unread_alerts AS
@@ -161,6 +198,7 @@ ORDER BY timestamp DESC;
 -- Used for: Analytics charts (daily averages, min/max trends)
 CREATE VIEW IF NOT EXISTS vw_daily_sensor_summary AS
 SELECT 
+    zone_id,
     strftime('%Y-%m-%d', timestamp) as day,
     ROUND(AVG(temperature), 2) as avg_temp,
     MIN(temperature) as min_temp,
@@ -173,7 +211,7 @@ SELECT
     MAX(ec) as max_ec,
     COUNT(*) as reading_count
 FROM sensor_readings
-GROUP BY day
+GROUP BY zone_id, day
 ORDER BY day DESC;
 
 -- View 4: Pending Recommendations
@@ -198,5 +236,8 @@ ORDER BY r.generated_at DESC;
 INSERT OR IGNORE INTO user (id, username, password_hash) 
 VALUES (1, 'admin', '8c6976e5b5410415bde908bd4dee15dfb167a9c873fc4bb8a81f6f2ab448a918');
 
+INSERT OR IGNORE INTO zones (id, name)
+VALUES (1, 'Zone 1');
+
 INSERT OR IGNORE INTO plant (id, name) 
 VALUES (1, 'Lettuce');
\ No newline at end of file
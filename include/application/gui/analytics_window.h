@@ -54,7 +54,7 @@ struct GalleryItem {
     QString timestamp;          ///< When image was captured
     QString prediction_label;   ///< ML prediction (e.g., "Healthy", "Powdery Mildew")
     QString recommendation_text; ///< ML recommendation text for the prediction
-    QString bounding_box;       ///< Bounding box coords "x,y,w,h" (empty if none)
+    QString bounding_box;       ///< Bounding boxes "x,y,w,h[;x,y,w,h...]" (empty if none)
     bool is_verified;           ///< Whether user has verified this prediction
     bool is_acknowledged;       ///< Whether user has acknowledged the recommendation
 };
@@ -11,6 +11,9 @@
  * 
  * The bridge polls the database at regular intervals and emits Qt signals
  * when new data is available, allowing the UI to update reactively.
+ * Attached to leafsense-daemon (set_live_client()), live readings come
+ * from shared memory as soon as the daemon announces a frame, and user
+ * actions are sent to the daemon instead of being written here.
  */
 
 #ifndef LEAFSENSE_DATA_BRIDGE_H
@@ -23,11 +26,16 @@
 #include <QObject>
 #include <QTimer>
 #include <QVector>
+#include <QPair>
 
 /* ============================================================================
  * Forward Declarations
  * ============================================================================ */
 class dbManager;
+class SensorSnapshot;
+class LiveClient;
+class QSocketNotifier;
+struct SensorParameters;
 
 /* ============================================================================
  * Enumerations
@@ -71,6 +79,17 @@ struct DailySensorSummary {
     double avg_ec;      ///< Average EC for the day
 };
 
+/**
+ * @struct SensorSample
+ * @brief Sensor values reconstructed at a point in time
+ */
+struct SensorSample {
+    qint64 epoch;       ///< UTC seconds
+    double temp;        ///< Temperature (°C)
+    double ph;          ///< pH level
+    double ec;          ///< EC (ppm)
+};
+
 /**
  * @struct HealthAssessment
  * @brief Plant health evaluation from ML analysis
@@ -123,6 +142,13 @@ public:
      * Constructor / Destructor
      * ------------------------------------------------------------------------ */
     explicit LeafSenseDataBridge(QObject *parent = nullptr);
+
+    /**
+     * @brief Opens a database other than <app dir>/leafsense.db
+     * @param db_path SQLite file (tools, benchmarks)
+     * @param parent Parent QObject
+     */
+    explicit LeafSenseDataBridge(const QString &db_path, QObject *parent = nullptr);
     ~LeafSenseDataBridge();
 
     /* ------------------------------------------------------------------------
@@ -134,13 +160,55 @@ public:
      * @return true if initialization successful
      */
     bool initialize();
+    
+    /**
+     * @brief Use the in-process sensor snapshot for live readings
+     * @param snapshot Snapshot owned by Master (nullptr = database only)
+     * 
+     * When set, get_sensor_data() reads the cached frame lock-free and
+     * only falls back to the database if the frame is missing or stale.
+     */
+    void set_sensor_snapshot(const SensorSnapshot *snapshot);
+
+    /**
+     * @brief Use leafsense-daemon for live readings and commands
+     * @param client Connection owned by main() (nullptr = detach)
+     * 
+     * Each frame the daemon publishes triggers sensor_data_updated()
+     * immediately. If the daemon goes away the bridge falls back to the
+     * database and reconnects on the next poll.
+     */
+    void set_live_client(LiveClient *client);
+
+    /**
+     * @brief Send new ideal ranges to the controller of this zone
+     * @param params Ranges from the settings window
+     * @return true if the daemon applied them
+     */
+    bool apply_thresholds(const SensorParameters &params);
+
+    /**
+     * @brief Select the zone whose readings are queried
+     * @param id Zone id (defaults to 1); switches to that zone's snapshot
+     *           and emits fresh data for it
+     */
+    void set_zone_id(int id);
+
+    /** @brief Zone whose readings are queried */
+    int get_zone_id() const { return zone_id; }
+
+    /**
+     * @brief Zones configured on the controller (zones table)
+     * @return (id, name) pairs ordered by id; empty on an old database
+     */
+    QVector<QPair<int, QString>> get_zones();
 
     /* ------------------------------------------------------------------------
      * Data Retrieval Methods
      * ------------------------------------------------------------------------ */
     
     /**
-     * @brief Get current sensor readings from database
+     * @brief Get current sensor readings (snapshot first, then database)
      * @return SensorData struct with latest values
      */
     SensorData get_sensor_data();
@@ -152,19 +220,19 @@ public:
     HealthAssessment get_health_assessment();
     
     /**
-     * @brief Get most recent unread alert
+     * @brief Get most recent unread alert of the selected zone
      * @return SystemAlert struct with alert details
      */
     SystemAlert get_latest_alert();
     
     /**
-     * @brief Mark all alerts as read in the database
+     * @brief Mark all alerts of the selected zone as read
      * @return true if operation succeeded
      */
     bool mark_alerts_as_read();
     
     /**
-     * @brief Check if there are any unread alerts
+     * @brief Check if the selected zone has unread alerts
      * @return true if unread alerts exist
      */
     bool has_unread_alerts();
@@ -204,11 +272,27 @@ public:
      * @param days Number of days/readings to retrieve (default: 30)
      * @return Vector of daily summaries, or individual readings if < 5 days exist
      * 
-     * First attempts to use vw_daily_sensor_summary view.
+     * Days come from vw_daily_sensor_summary; averages are time-weighted
+     * over the interpolated signal (see get_interpolated_series()).
      * Falls back to individual readings if insufficient daily data exists.
      */
     QVector<DailySensorSummary> get_sensor_history(int days = 30);
     
+    /**
+     * @brief Reconstruct sensor values on a regular time grid
+     * @param from_epoch Start of the window (UTC seconds)
+     * @param to_epoch End of the window (UTC seconds)
+     * @param step_seconds Grid spacing
+     * @return Linearly interpolated samples
+     * 
+     * The backend only stores the rows needed to rebuild the signal within
+     * tolerance (swinging-door compression), so analytics must interpolate
+     * between stored rows instead of averaging them. Grid points inside a
+     * gap longer than two heartbeats (system off) are skipped.
+     */
+    QVector<SensorSample> get_interpolated_series(qint64 from_epoch, qint64 to_epoch,
+                                                  int step_seconds);
+    
     /**
      * @brief Get ML prediction for a specific image file
      * @param filename Name of the image file
@@ -216,6 +300,13 @@ public:
      */
     QString get_image_prediction(const QString &filename);
     
+    /**
+     * @brief Get the regions marked by tiled inference for an image file
+     * @param filename Name of the image file
+     * @return "x,y,w,h[;x,y,w,h...]" in image pixels, or empty if none
+     */
+    QString get_image_bounding_box(const QString &filename);
+    
     /**
      * @brief Get ML recommendation text for a specific image file
      * @param filename Name of the image file
@@ -242,12 +333,25 @@ private slots:
      */
     void update_data();
 
+    /**
+     * @brief Daemon announced a frame (or closed the connection)
+     */
+    void on_live_event();
+
 private:
     /* ------------------------------------------------------------------------
      * Private Members
      * ------------------------------------------------------------------------ */
     QTimer *update_timer;   ///< Polling timer (2 second interval)
     dbManager *dbReader;    ///< Database access object
+    const SensorSnapshot *sensor_snapshot;  ///< Live sensor cache (optional)
+    LiveClient *live_client;                ///< Daemon link (optional, not owned)
+    QSocketNotifier *live_notifier;         ///< Watches the daemon's notifications
+    int zone_id;                            ///< Zone shown by the GUI
+    static const int HISTORY_STEP_SECONDS = 300;  ///< Resampling grid for daily averages
+
+    bool connect_live();
+    void disconnect_live();
 };
 
 #endif // LEAFSENSE_DATA_BRIDGE_H
@@ -21,6 +21,7 @@
 #include <QTimer>
 #include <QLabel>
 #include <QPushButton>
+#include <QComboBox>
 #include <QProgressBar>
 #include <QColor>
 
@@ -90,6 +91,8 @@ public:
     void set_logged_in_user(const QString &user);
     void set_login_time(const QString &time);
     void set_selected_plant(const Plant &plant);
+    void set_sensor_snapshot(const SensorSnapshot *snapshot);
+    void set_live_client(LiveClient *client);
 
 private slots:
     /* ------------------------------------------------------------------------
@@ -108,6 +111,7 @@ private slots:
     void on_info_button_clicked();
     void on_logs_button_clicked();
     void on_logout_button_clicked();
+    void on_zone_selected(int index);
 
     /* ------------------------------------------------------------------------
      * Theme Management
@@ -121,6 +125,7 @@ private:
     void setup_ui();
     void setup_connections();
     void setup_logo();
+    void setup_zone_selector();
 
     /* ------------------------------------------------------------------------
      * Private Methods - Theme
@@ -134,6 +139,7 @@ private:
      * ------------------------------------------------------------------------ */
     QLabel *logo_label;         ///< LeafSense logo display
     QLabel *plant_name_label;   ///< Current plant name
+    QComboBox *zone_selector;   ///< Zone shown on the dashboard (hidden with one zone)
     QLabel *time_label;         ///< UTC time display
     QLabel *greeting_label;     ///< User greeting ("Hi, username")
     QLabel *status_indicator;   ///< System status dot (green/yellow/red)
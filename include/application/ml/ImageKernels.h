@@ -0,0 +1,84 @@
+/**
+ * @file ImageKernels.h
+ * @brief Fused Pixel Kernels for the ML Input Path
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Application/ML
+ *
+ * Works on raw 8-bit BGR rows so it has no OpenCV dependency. The
+ * vector paths are chosen at compile time: NEON on the Raspberry Pi
+ * (always available on aarch64), AVX2+FMA when the build enables it
+ * (LEAFSENSE_NATIVE_ARCH on x86_64), SSE2 otherwise on x86_64, and a
+ * scalar fallback everywhere else.
+ */
+
+#ifndef IMAGEKERNELS_H
+#define IMAGEKERNELS_H
+
+/* ============================================================================
+ * Includes
+ * ============================================================================ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class ImageKernels
+ * @brief Single-pass image transforms used before inference
+ */
+class ImageKernels {
+public:
+    /**
+     * @brief Resize + BGR->RGB + ImageNet normalization into planar CHW
+     * @param src First byte of an 8-bit BGR image
+     * @param srcWidth Width in pixels
+     * @param srcHeight Height in pixels
+     * @param srcStep Bytes between rows
+     * @param dst Output tensor, 3 * dstSize * dstSize floats (R, G, B planes)
+     * @param dstSize Output width and height
+     * @param[out] greenRatio Share of green/yellow-green pixels in the resized
+     *             frame (OOD check), or nullptr to skip it
+     *
+     * Bilinear sampling uses the same pixel-centre mapping as
+     * cv::resize(INTER_LINEAR) but keeps full float precision instead of
+     * rounding to 8 bits, so outputs differ from the OpenCV chain by at
+     * most one grey level before normalization.
+     *
+     * The green test runs on each resized row before it is normalized. It
+     * matches cv::inRange on COLOR_BGR2HSV with H 20-85, S >= 30, V >= 30
+     * (OpenCV 8-bit units), but works from min/max/difference comparisons
+     * without computing the hue.
+     */
+    static void preprocessCHW(const uint8_t* src, int srcWidth, int srcHeight, size_t srcStep,
+                              float* dst, int dstSize, float* greenRatio = nullptr);
+
+    /**
+     * @brief 64-bit content hash of an 8-bit image
+     * @param src First byte of the image
+     * @param rowBytes Bytes of pixel data per row (width * channels)
+     * @param rows Number of rows
+     * @param srcStep Bytes between rows (row padding is not hashed)
+     * @param seed Mixed in first, e.g. the image dimensions and type
+     *
+     * Four-lane multiply/rotate hash (xxHash64 constants), about 4 bytes
+     * per cycle without SIMD. Used to detect repeated frames, not as a
+     * cryptographic digest.
+     */
+    static uint64_t contentHash(const uint8_t* src, size_t rowBytes, int rows, size_t srcStep,
+                                uint64_t seed);
+
+    /** @brief Name of the compiled vector path ("neon", "avx2", "sse2", "scalar") */
+    static const char* simdPath();
+
+private:
+    /** @brief dst = a + (b - a) * w over two 8-bit rows (vector path) */
+    static void blendRows(const uint8_t* a, const uint8_t* b, float w, float* dst, int count);
+
+    /** @brief Number of plant-coloured pixels in planar 0-255 RGB rows (vector path) */
+    static int countGreen(const float* r, const float* g, const float* b, int count);
+
+    /** @brief p = p * scale + bias in place (vector path) */
+    static void scaleRow(float* p, int count, float scale, float bias);
+};
+
+#endif // IMAGEKERNELS_H
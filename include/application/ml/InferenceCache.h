@@ -0,0 +1,104 @@
+/**
+ * @file InferenceCache.h
+ * @brief Inference Results Keyed on Image Content and Model
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Application/ML
+ *
+ * Maps (image hash, model version) to the MLResult the model produced, so
+ * a repeated frame or a second re-scoring pass does not run the model
+ * again. Recent entries are kept in an LRU map in memory. With a database
+ * path, entries are also written to the ml_result_cache table so hits
+ * survive restarts. Only leafsense-rescore opens it that way: the daemon
+ * keeps dDatabase as its single SQLite writer and caches in memory only.
+ * The table is bounded with prune() (age limit, then least recently used).
+ *
+ * Thread-safe: the camera pipeline looks up on the preprocess thread and
+ * stores on the inference thread.
+ */
+
+#ifndef INFERENCECACHE_H
+#define INFERENCECACHE_H
+
+/* ============================================================================
+ * Includes
+ * ============================================================================ */
+
+#include <pthread.h>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "ML.h"
+
+class dbManager;
+
+/**
+ * @class InferenceCache
+ * @brief Two-level (memory, SQLite) result cache
+ */
+class InferenceCache {
+private:
+    typedef std::pair<std::string, MLResult> Entry;
+
+    size_t capacity;                ///< Entries kept in memory
+    std::list<Entry> lru;           ///< Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    dbManager* db;                  ///< Own connection, nullptr = memory only
+    pthread_mutex_t mutex;          ///< Guards lru, index, db and counters
+
+    uint64_t memoryHits;
+    uint64_t dbHits;
+    uint64_t misses;
+
+    /** @brief Inserts or refreshes an entry in memory (mutex held) */
+    void remember(const std::string& key, const MLResult& result);
+
+    /** @brief Reads one row of ml_result_cache (mutex held) */
+    bool loadFromDb(const std::string& hash, const std::string& modelVersion, MLResult& result);
+
+public:
+    /**
+     * @brief Constructor
+     * @param entries In-memory capacity (at least 1)
+     * @param dbPath SQLite database for the persistent level, empty for memory only
+     */
+    InferenceCache(size_t entries, const std::string& dbPath);
+    ~InferenceCache();
+
+    InferenceCache(const InferenceCache&) = delete;
+    InferenceCache& operator=(const InferenceCache&) = delete;
+
+    /**
+     * @brief Looks up a stored result
+     * @param hash ML::imageHash() of the frame
+     * @param modelVersion ML::getModelVersion() of the model that would run
+     * @param[out] result Stored result on a hit
+     * @return true on a hit (memory first, then SQLite)
+     */
+    bool lookup(const std::string& hash, const std::string& modelVersion, MLResult& result);
+
+    /**
+     * @brief Stores a model result
+     *
+     * Results without probabilities (mock mode, unreadable input, ORT
+     * errors) are not cached, so a transient failure is retried next time.
+     */
+    void store(const std::string& hash, const std::string& modelVersion, const MLResult& result);
+
+    /**
+     * @brief Bounds ml_result_cache (no-op for a memory-only cache)
+     * @param maxRows Rows kept, least recently stored or hit dropped first
+     * @param maxAgeDays Rows not stored or hit for this long are dropped (0 = no limit)
+     * @return Rows deleted
+     */
+    size_t prune(int maxRows, int maxAgeDays);
+
+    /**
+     * @brief Hit/miss counters since construction
+     */
+    void getStats(uint64_t& memory, uint64_t& persistent, uint64_t& missed);
+};
+
+#endif // INFERENCECACHE_H
@@ -6,6 +6,15 @@
  * 
  * Performs plant disease detection using ONNX Runtime inference.
  * Analyzes plant images to detect diseases and deficiencies.
+ * 
+ * Accepts the float32 model and its statically quantized INT8 (QDQ)
+ * export from ml/train_model.py --int8; both keep float input/output,
+ * so only the file differs (see resolveModel()).
+ * 
+ * The model can be replaced while the engine runs: reload() (or the file
+ * watcher) builds and warms a new session next to the current one, then
+ * swaps it in between inferences. Runs already in progress finish on the
+ * model they started with. The replaced model stays loaded for rollback().
  */
 
 #ifndef ML_H
@@ -18,6 +27,8 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include <pthread.h>
 
 // Forward declarations to avoid including heavy headers here
 namespace Ort {
@@ -25,11 +36,25 @@ namespace Ort {
     class Session;
     class SessionOptions;
 }
+namespace cv {
+    class Mat;
+}
+struct BatchPrepJob;
 
 /* ============================================================================
  * ML Result Structure
  * ============================================================================ */
 
+/**
+ * @struct MLRegion
+ * @brief Part of the frame a tile classified as unhealthy (tiled inference)
+ */
+struct MLRegion {
+    int x, y, width, height;    ///< Pixels of the analysed frame
+    int class_id;               ///< Class of the tile(s), never Healthy
+    float confidence;           ///< Highest tile probability for class_id
+};
+
 /**
  * @struct MLResult
  * @brief Holds the result of ML inference
@@ -41,6 +66,8 @@ struct MLResult {
     std::vector<float> probs;   ///< Probabilities for all classes
     bool isValidPlant;          ///< Whether image appears to be a valid plant (OOD detection)
     float entropy;              ///< Shannon entropy of probability distribution (lower = more confident)
+    std::string modelVersion;   ///< ML::getModelVersion() of the model that produced it ("mock" if none)
+    std::vector<MLRegion> regions; ///< Unhealthy areas from tiled inference (empty otherwise)
 };
 
 /* ============================================================================
@@ -58,16 +85,74 @@ struct MLResult {
  * - 3: Pest Damage
  */
 class ML {
+public:
+    static const int IMAGE_SIZE = 224;  ///< Model input width and height
+
 private:
+    /**
+     * @brief One loaded model with its session and run state
+     * 
+     * Reference counted under swapMutex: the active and previous slots
+     * hold one reference each, every inference holds one while it runs.
+     * The last release() deletes it.
+     */
+    struct Model {
+        std::string name;                ///< Model file name
+        std::string precision;           ///< "fp32" or "int8" (model metadata)
+        std::string version;             ///< "<file>/<precision>/<weights hash>"
+        
+        // ONNX Runtime objects (opaque pointers to avoid header pollution)
+        void* session;
+        void* sessionOptions;
+        
+        // Run state prepared once by setupRunState(), reused by every inference
+        std::string inputName;           ///< Cached model input name
+        std::string outputName;          ///< Cached model output name
+        std::vector<float> inputBuffer;  ///< Bound model input (written by analyzeDetailed/infer)
+        std::vector<float> outputBuffer; ///< Bound model output (logits)
+        void* ioBinding;                 ///< Ort::IoBinding over inputBuffer/outputBuffer
+        void* inputValue;                ///< Ort::Value viewing inputBuffer
+        void* outputValue;               ///< Ort::Value viewing outputBuffer
+        pthread_mutex_t runMutex;        ///< Serializes use of the bound buffers
+        bool batchDynamic;               ///< Model input has a dynamic batch dimension
+        int refs;
+    };
+    
+    std::string modelDir;       ///< Directory of the model file
+    std::string modelName;      ///< Model file watched and reloaded
     std::string modelPath;      ///< Full path to ONNX model
-    bool initialized;           ///< Whether model loaded successfully
+    void* env;                  ///< Ort::Env shared by every loaded model
+    
+    Model* active;              ///< Serves new inferences (nullptr = mock mode)
+    Model* previous;            ///< Replaced model, kept for rollback()
+    mutable pthread_mutex_t swapMutex;  ///< Guards active, previous and refs
+    pthread_mutex_t reloadMutex;        ///< One reload() at a time
+    
+    // Model file watcher (startWatching())
+    pthread_t watchThread;
+    pthread_mutex_t watchMutex;
+    pthread_cond_t watchCond;
+    bool watching;
+    int watchIntervalMs;
     
-    // ONNX Runtime objects (opaque pointers to avoid header pollution)
-    void* env;
-    void* session;
-    void* sessionOptions;
+    // Preprocessing pool of analyzeBatch() (started once, one thread per extra core)
+    std::vector<pthread_t> prepThreads;
+    pthread_mutex_t prepSubmitMutex;    ///< One batch on the pool at a time
+    pthread_mutex_t prepMutex;          ///< Guards the fields below
+    pthread_cond_t prepCond;            ///< New job posted, or stop
+    pthread_cond_t prepDoneCond;        ///< A thread finished the current job
+    BatchPrepJob* prepJob;
+    unsigned prepGeneration;            ///< Bumped for every posted job
+    size_t prepPending;                 ///< Pool threads still on the current job
+    bool prepStop;
     
-    static const int IMAGE_SIZE = 224;
+    static constexpr int TENSOR_SIZE = 3 * IMAGE_SIZE * IMAGE_SIZE;
+    static const int MAX_BATCH = 8;  ///< Frames per ORT call in analyzeBatch()
+    static const int MAX_TILE_GRID = 4;  ///< 4x4 tiles + full frame in one ORT call
+    static constexpr float TILE_MIN_CONFIDENCE = 0.5f; ///< Tile probability that marks a region
+    
+    int tileGrid;               ///< Tiles per side for analyzeDetailed() (< 2 = off)
+    float tileOverlap;          ///< Share of a tile shared with its neighbour
     static const std::vector<std::string> CLASS_NAMES;
     
     // Out-of-distribution detection thresholds
@@ -76,32 +161,107 @@ private:
     static constexpr float MIN_GREEN_RATIO = 0.10f;       ///< Minimum green pixel ratio (10% for lettuce)
     
     /**
-     * @brief Preprocess image for inference
-     * @param imagePath Path to image file
-     * @return Preprocessed tensor data (CHW format, normalized)
+     * @brief Preprocess a decoded image for inference
+     * @param image BGR image (grayscale/BGRA are converted first)
+     * @param[out] tensor CHW, ImageNet-normalized; storage is reused when already sized
+     * @param[out] greenRatio Share of plant-coloured pixels (OOD check)
+     * @return false if the image is empty
+     * 
+     * Single pass through ImageKernels::preprocessCHW (resize, BGR->RGB,
+     * green ratio, normalization and layout fused). The green ratio is
+     * measured on the 224x224 model input, not the full frame.
      */
-    std::vector<float> preprocess(const std::string& imagePath);
+    bool preprocess(const cv::Mat& image, std::vector<float>& tensor, float& greenRatio);
+    
+    /** @brief preprocess() into caller storage of 3 * IMAGE_SIZE * IMAGE_SIZE floats */
+    bool preprocess(const cv::Mat& image, float* tensor, float& greenRatio);
     
     /**
-     * @brief Apply softmax to convert logits to probabilities
-     * @param logits Raw model output
-     * @return Probability distribution
+     * @brief Creates a session for a model file's contents and warms it up
+     * @param bytes File contents (loaded from memory, so a file replaced
+     *        meanwhile cannot mismatch the hash)
+     * @param weightsHash 8 hex digits of bytes (version suffix)
+     * @return New model holding no references, or nullptr if it cannot be used
      */
-    std::vector<float> softmax(const std::vector<float>& logits);
+    Model* loadModel(const std::vector<uint8_t>& bytes, const std::string& weightsHash);
     
     /**
-     * @brief Check if image contains sufficient green/plant-like colors
-     * @param imagePath Path to image file
-     * @return Ratio of green pixels (0.0 to 1.0)
+     * @brief Caches I/O names, binds preallocated buffers and runs a warm-up
+     * @throws Ort::Exception if the model's outputs cannot be bound
      */
-    float checkGreenRatio(const std::string& imagePath);
+    static void setupRunState(Model* model);
+    
+    /** @brief Releases the ORT objects of a model nobody references */
+    static void destroyModel(Model* model);
+    
+    /** @brief Current model with one reference taken, nullptr in mock mode */
+    Model* acquire() const;
+    
+    /** @brief Drops a reference taken by acquire() (nullptr is ignored) */
+    void release(Model* model) const;
+    
+    /** @brief Watcher thread body: polls the model file and calls reload() */
+    void watchLoop();
+    static void* watchThreadFunc(void* arg);
     
     /**
-     * @brief Calculate Shannon entropy of probability distribution
-     * @param probs Probability distribution
-     * @return Entropy value (0 = certain, log2(N) = uniform/uncertain)
+     * @brief Runs the bound session on the model's inputBuffer (its runMutex held)
+     * @param model Acquired model
+     * @param greenRatio Green pixel ratio for OOD detection
+     * @return Classified result
+     */
+    MLResult classify(Model* model, float greenRatio);
+    
+    /**
+     * @brief Softmax, OOD checks and labelling of one row of logits
+     * @param logits Model output for one image
+     * @param count Number of classes
+     * @param greenRatio Green pixel ratio for OOD detection
+     * @return Classified result
+     */
+    MLResult scoreLogits(const float* logits, size_t count, float greenRatio);
+    
+    /** @brief scoreLogits() after the softmax */
+    MLResult scoreProbs(std::vector<float> probs, float greenRatio);
+    
+    /**
+     * @brief Shared body of the analyzeBatch() overloads and analyzeTiled()
+     * @param count Number of inputs
+     * @param frames Decoded frames, or nullptr when paths are given
+     * @param paths Image paths, or nullptr when frames are given
+     * @param chunk Inputs per ORT call
+     * @return One result per input, in order
      */
-    float calculateEntropy(const std::vector<float>& probs);
+    std::vector<MLResult> analyzeBatch(size_t count, const cv::Mat* frames, const std::string* paths,
+                                       size_t chunk);
+    
+    /**
+     * @brief Image-level result and regions from per-tile results
+     * @param tiles Results of the full frame (first) and each tile
+     * @param rects Tile rectangles, same order (first = full frame)
+     * @return Pooled result
+     * 
+     * Tiles that fail the OOD checks (background, no plant) are ignored.
+     * Unhealthy classes take their highest tile probability and Healthy
+     * its lowest, so one diseased tile is enough to flag the frame.
+     */
+    MLResult aggregateTiles(const std::vector<MLResult>& tiles, const std::vector<MLRegion>& rects);
+    
+    /** @brief Decodes/preprocesses inputs of a job until none are left (any thread) */
+    static void runPrepJob(BatchPrepJob* job);
+    
+    /** @brief Pool thread body: runs every posted job once */
+    void prepLoop();
+    static void* prepThreadFunc(void* arg);
+    
+    /** @brief Runs a job on the calling thread plus the pool (alone if the pool is busy) */
+    void runOnPool(BatchPrepJob* job);
+    
+    /** @brief Healthy result returned in mock mode and on input errors */
+    static MLResult defaultResult();
+    
+    /** @brief Result reported when ONNX Runtime fails (confidence 0, not valid) */
+    static MLResult errorResult();
     
     /**
      * @brief Check if prediction indicates a valid plant image
@@ -121,15 +281,101 @@ public:
     ML(std::string dir, std::string name);
     
     /**
-     * @brief Destructor - releases ONNX resources
+     * @brief Destructor - stops the watcher, releases ONNX resources
+     * 
+     * No inference may be running.
      */
     ~ML();
     
+    ML(const ML&) = delete;
+    ML& operator=(const ML&) = delete;
+    
     /**
-     * @brief Check if model loaded successfully
+     * @brief Check if a model is loaded
      * @return true if ready for inference
      */
-    bool isInitialized() const { return initialized; }
+    bool isInitialized() const;
+    
+    /**
+     * @brief Weight precision recorded by the export script
+     * @return "fp32", "int8", or "unknown" for untagged models and mock mode
+     */
+    std::string getPrecision() const;
+    
+    /**
+     * @brief Picks the model file for a configured variant (ml.variant)
+     * @param dir Model directory
+     * @param variant "fp32" (leafsense_model.onnx) or "int8" (leafsense_model_int8.onnx)
+     * @return File name inside dir; falls back to fp32 if the INT8 file is missing
+     */
+    static std::string resolveModel(const std::string& dir, const std::string& variant);
+    
+    /**
+     * @brief Identifies the active model in ml_predictions and the result cache
+     * @return "<model file>/<precision>/<weights hash>",
+     *         e.g. "leafsense_model_int8.onnx/int8/3f9c01a2", or "mock"
+     * 
+     * A swap may happen right after this returns; results carry the
+     * version that actually produced them (MLResult::modelVersion).
+     */
+    std::string getModelVersion() const;
+    
+    /* ------------------------------------------------------------------------
+     * Model Swap
+     * ------------------------------------------------------------------------ */
+    
+    /**
+     * @brief Loads the model file again and swaps it in if its weights changed
+     * @return true if the file's model is now active (also when unchanged),
+     *         false if it could not be loaded (the current model stays)
+     * 
+     * Loading and the warm-up run happen on the caller's thread while
+     * inferences continue on the current model. The swap itself only
+     * exchanges pointers; the replaced model becomes the rollback target.
+     */
+    bool reload();
+    
+    /**
+     * @brief Swaps the previous model back in (no loading)
+     * @return false if there is no previous model
+     * 
+     * Calling it again undoes the rollback.
+     */
+    bool rollback();
+    
+    /**
+     * @brief Reloads automatically when the model file changes
+     * @param intervalMs Polling period; a change must be seen on two
+     *        consecutive polls (copy finished) before it is loaded
+     */
+    void startWatching(int intervalMs);
+    
+    /** @brief Stops the watcher thread (waits for a reload in progress) */
+    void stopWatching();
+    
+    /**
+     * @brief Content hash of a decoded frame (plant_images.image_hash)
+     * @param image 8-bit image
+     * @return 16 hex digits, or an empty string for an empty image
+     * 
+     * Covers pixel data, size and type, so the same frame hashes the same
+     * whether it came from the camera or was decoded from a lossless copy.
+     */
+    static std::string imageHash(const cv::Mat& image);
+    
+    /**
+     * @brief Apply softmax to convert logits to probabilities
+     * @param logits Raw model output
+     * @return Probability distribution
+     */
+    static std::vector<float> softmax(const std::vector<float>& logits);
+    
+    /**
+     * @brief Calculate Shannon entropy of probability distribution
+     * @param probs Probability distribution
+     * @return Entropy value (0 = certain, log2(N) = uniform/uncertain)
+     */
+    static float calculateEntropy(const std::vector<float>& probs);
     
     /**
      * @brief Analyzes image for plant diseases (legacy interface)
@@ -144,6 +390,94 @@ public:
      * @return MLResult with class, confidence, and probabilities
      */
     MLResult analyzeDetailed(const std::string& imagePath);
+    
+    /**
+     * @brief Analyzes an already decoded frame (no file I/O)
+     * @param image BGR image, e.g. from Cam::capture()
+     * @return MLResult with class, confidence, and probabilities
+     * 
+     * Runs analyzeTiled() when setTiling() enabled it (both overloads).
+     */
+    MLResult analyzeDetailed(const cv::Mat& image);
+    
+    /**
+     * @brief Analyzes several frames, e.g. one per camera
+     * @param frames BGR images
+     * @return One result per frame, in order
+     * 
+     * Frames are preprocessed in parallel (the caller plus the engine's
+     * tBatchPrep pool) and classified in chunks of MAX_BATCH with one ORT
+     * call each. Models exported with a fixed batch
+     * size of 1 are run one frame at a time. Empty frames get the default
+     * result.
+     */
+    std::vector<MLResult> analyzeBatch(const std::vector<cv::Mat>& frames);
+    
+    /**
+     * @brief analyzeBatch() for image files (decoding is parallelized too)
+     * @param imagePaths Paths to image files
+     * @return One result per path, in order
+     */
+    std::vector<MLResult> analyzeBatch(const std::vector<std::string>& imagePaths);
+    
+    /**
+     * @brief Classifies overlapping crops of a frame and locates unhealthy areas
+     * @param image BGR image
+     * @param grid Tiles per side (2-4); 1 runs the full frame only
+     * @param overlap Share of a tile's width/height shared with its
+     *        neighbour (0 - 0.5)
+     * @return Pooled result; regions holds the unhealthy tiles, merged
+     *         where they overlap
+     * 
+     * The full frame and the grid x grid tiles are preprocessed in
+     * parallel and classified with one ORT call (one call per tile if the
+     * model has a fixed batch size of 1). Small lesions cover more of a
+     * tile's 224x224 input than of the squashed full frame.
+     */
+    MLResult analyzeTiled(const cv::Mat& image, int grid, float overlap);
+    
+    /**
+     * @brief Makes analyzeDetailed() use analyzeTiled() (ml.tiles)
+     * @param grid Tiles per side, < 2 turns tiling off
+     * @param overlap See analyzeTiled()
+     */
+    void setTiling(int grid, float overlap);
+    
+    /** @brief Tiles per side used by analyzeDetailed(), 0 if off */
+    int getTileGrid() const { return tileGrid; }
+    
+    /* ------------------------------------------------------------------------
+     * Split Interface (used by pipelined callers)
+     * ------------------------------------------------------------------------ */
+    
+    /**
+     * @brief Decodes an image once and prepares everything inference needs
+     * @param imagePath Path to image file
+     * @param[out] tensor Preprocessed input tensor (CHW, normalized)
+     * @param[out] greenRatio Green pixel ratio for OOD detection
+     * @return false if the image could not be loaded
+     * 
+     * Does not touch the ONNX session, so it may run on a different
+     * thread than infer().
+     */
+    bool prepareInput(const std::string& imagePath, std::vector<float>& tensor, float& greenRatio);
+    
+    /**
+     * @brief prepareInput() for a frame that is already in memory
+     * @param image BGR image
+     * @param[out] tensor Preprocessed input tensor (CHW, normalized)
+     * @param[out] greenRatio Green pixel ratio for OOD detection
+     * @return false if the image is empty
+     */
+    bool prepareInput(const cv::Mat& image, std::vector<float>& tensor, float& greenRatio);
+    
+    /**
+     * @brief Runs the model on a tensor produced by prepareInput()
+     * @param tensor Preprocessed input tensor
+     * @param greenRatio Green pixel ratio from prepareInput()
+     * @return MLResult with class, confidence, and probabilities
+     */
+    MLResult infer(const std::vector<float>& tensor, float greenRatio);
 };
 
 #endif // ML_H
\ No newline at end of file
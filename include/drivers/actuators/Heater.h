@@ -12,6 +12,7 @@
 
 #include <string>
 #include <gpiod.h>
+#include "ReservoirSim.h"
 
 /**
  * @class Heater
@@ -27,11 +28,12 @@ private:
     bool initialized;              ///< Whether GPIO was successfully initialized
     struct gpiod_chip *chip;       ///< GPIO chip handle
     struct gpiod_line *line;       ///< GPIO line handle
+    ReservoirSim *sim;             ///< Simulated reservoir (nullptr = none)
 
 public:
     /**
      * @brief Constructs heater driver
-     * @param pin GPIO pin number (BCM numbering), default 26
+     * @param pin GPIO pin number (BCM numbering), default 26; -1 for no GPIO
      */
     Heater(int pin = 26);
     
@@ -51,6 +53,12 @@ public:
      * @return true if heater is ON
      */
     bool getState() { return state; }
+
+    /**
+     * @brief Drives a simulated reservoir's heater as well
+     * @param s Simulator (owned by the caller), nullptr to detach
+     */
+    void setSimulation(ReservoirSim* s) { sim = s; }
     
     /**
      * @brief Checks if GPIO was initialized successfully
@@ -12,6 +12,7 @@
 #define PUMPS_H
 
 #include <gpiod.h>
+#include "ReservoirSim.h"
 
 /**
  * @class Pumps
@@ -27,11 +28,13 @@ private:
     bool initialized;              ///< Whether GPIO was successfully initialized
     struct gpiod_chip *chip;       ///< GPIO chip handle
     struct gpiod_line *line;       ///< GPIO line handle
+    ReservoirSim *sim;             ///< Simulated reservoir (nullptr = none)
+    SimActuator simOutput;         ///< Which simulated pump this is
 
 public:
     /**
      * @brief Constructs pump driver
-     * @param pin GPIO pin number (BCM numbering)
+     * @param pin GPIO pin number (BCM numbering), -1 for no GPIO
      */
     Pumps(int pin);
     
@@ -51,6 +54,13 @@ public:
      * @return true if pump is ON
      */
     bool getState() { return state; }
+
+    /**
+     * @brief Drives a simulated reservoir's pump as well
+     * @param s Simulator (owned by the caller), nullptr to detach
+     * @param output SIM_PH_UP, SIM_PH_DOWN or SIM_NUTRIENTS
+     */
+    void setSimulation(ReservoirSim* s, SimActuator output) { sim = s; simOutput = output; }
 };
 
 #endif // PUMPS_H
\ No newline at end of file
@@ -2,51 +2,196 @@
  * @file ADC.h
  * @brief ADS1115 Analog-to-Digital Converter Driver
  * @layer Drivers/Sensors
- * 
+ *
  * Provides I2C interface to ADS1115 16-bit ADC.
  * Used by pH and TDS sensors for analog readings.
+ * Register access goes through a shared I2CBus, so several ADS1115s
+ * (0x48-0x4B) and other devices can use the same adapter.
+ *
+ * Three acquisition modes:
+ * - Polled single-shot (default): start a conversion and poll the
+ *   OS bit of the config register until it completes.
+ * - Single-shot + ALERT/RDY: the comparator is set to conversion-ready
+ *   mode and the driver sleeps on the GPIO edge instead of polling I2C.
+ * - Continuous scan + ALERT/RDY: the ADC converts continuously at the
+ *   selected data rate, cycling through the enabled channels. Each RDY
+ *   edge reads one conversion and advances the sequencer; readVoltage()
+ *   returns the latest cached value without touching the bus.
  */
 
 #ifndef ADC_H
 #define ADC_H
 
+/* ============================================================================
+ * Includes
+ * ============================================================================ */
+#include <atomic>
+#include <cstdint>
+#include <pthread.h>
+#include <gpiod.h>
+#include "I2CBus.h"
+
 /**
  * @class ADC
  * @brief ADS1115 ADC driver with I2C support
- * 
- * Real mode: Communicates via I2C at specified address (/dev/i2c-1)
+ *
+ * Real mode: Communicates via the shared I2C bus at the specified address
  * Mock mode: Returns random voltage values (0.0-3.0V) if I2C unavailable
  */
 class ADC {
+public:
+    static const int NUM_CHANNELS = 4;  ///< Single-ended inputs AIN0..AIN3
+    static const int HISTORY_SIZE = 16; ///< Scanned conversions kept per channel
+    static const int STALE_SCANS = 4;   ///< Missed scan cycles before scanned values are stale
+
 private:
-    int i2cAddr;       ///< I2C slave address (typically 0x48)
-    int i2cFd;         ///< I2C file descriptor
-    bool initialized;  ///< True if I2C connection is active
+    I2CBus* bus;       ///< Shared bus (owned by the caller)
+    int i2cAddr;       ///< I2C slave address (0x48-0x4B)
+    bool initialized;  ///< True if the bus is available
+
+    /* ------------------------------------------------------------------------
+     * Conversion Settings
+     * ------------------------------------------------------------------------ */
+    uint16_t dataRateBits;         ///< DR field (bits 7-5 of config)
+    int dataRateSps;               ///< Selected data rate (samples/s)
+
+    /* ------------------------------------------------------------------------
+     * ALERT/RDY Pin (libgpiod edge events)
+     * ------------------------------------------------------------------------ */
+    int readyPin;                  ///< GPIO of ALERT/RDY (BCM), -1 if unused
+    struct gpiod_chip *chip;       ///< GPIO chip handle
+    struct gpiod_line *readyLine;  ///< Falling-edge event line
+
+    /* ------------------------------------------------------------------------
+     * Channel-Scan Sequencer (continuous mode)
+     * ------------------------------------------------------------------------ */
+    std::atomic<bool> scanning;          ///< Continuous scan active (read by any thread)
+    int scanList[NUM_CHANNELS];          ///< Enabled channels in scan order
+    int scanCount;                       ///< Entries in scanList
+    int scanIndex;                       ///< Channel currently converting
+    int settleCount;                     ///< Conversions to discard after a MUX change
+    float history[NUM_CHANNELS][HISTORY_SIZE];  ///< Recent conversions (ring) per channel
+    uint32_t sampleCount[NUM_CHANNELS];  ///< Conversions stored per channel
+    uint64_t sampleTimeMs[NUM_CHANNELS]; ///< CLOCK_MONOTONIC of the latest stored conversion
+    pthread_mutex_t sampleMutex;         ///< Guards history/sampleCount/sampleTimeMs
+    pthread_cond_t sampleCond;           ///< Signalled on every stored conversion
+
+    uint16_t buildConfig(int channel, bool singleShot) const;
+    bool writeRegister(uint8_t reg, uint16_t value);
+    bool readRegister(uint8_t reg, uint16_t &value);
+    bool waitReady(int timeoutMs);
+    float readSingleShot(int channel);
+    uint64_t staleAfterMs() const;
+    static float toVoltage(uint16_t raw);
 
 public:
     /**
-     * @brief Constructs ADC driver and initializes I2C
-     * @param addr I2C address (typically 0x48)
+     * @brief Constructs ADC driver on a shared bus
+     * @param i2cBus Bus manager (nullptr or closed = mock mode)
+     * @param addr I2C address (0x48-0x4B, set by the ADDR pin)
      */
-    ADC(int addr);
-    
+    ADC(I2CBus* i2cBus, int addr);
+
     /**
-     * @brief Destructor - closes I2C connection
+     * @brief Destructor - stops scanning and releases GPIO
      */
     ~ADC();
-    
+
+    ADC(const ADC&) = delete;
+    ADC& operator=(const ADC&) = delete;
+
+    /* ------------------------------------------------------------------------
+     * Configuration (call before startScan)
+     * ------------------------------------------------------------------------ */
+
+    /**
+     * @brief Selects the conversion data rate
+     * @param sps Requested rate; rounded up to 8/16/32/64/128/250/475/860
+     * @return Rate actually selected
+     */
+    int setDataRate(int sps);
+
+    /**
+     * @brief Uses the ALERT/RDY pin to wait for conversions
+     * @param gpioPin GPIO connected to ALERT/RDY (BCM numbering)
+     * @return true if the line was requested for falling-edge events
+     */
+    bool attachReadyPin(int gpioPin);
+
+    /**
+     * @brief Adds a channel to the scan sequence
+     * @param ch Channel number (0-3)
+     */
+    void enableChannel(int ch);
+
+    /* ------------------------------------------------------------------------
+     * Continuous Scan
+     * ------------------------------------------------------------------------ */
+
+    /**
+     * @brief Starts continuous conversion over the enabled channels
+     * @return false if I2C, the ready pin or channels are missing
+     */
+    bool startScan();
+
+    /**
+     * @brief Powers the ADC down to single-shot mode
+     */
+    void stopScan();
+
+    /**
+     * @brief File descriptor that becomes readable on ALERT/RDY edges
+     * @return fd for poll()/select(), or -1 without a ready pin
+     */
+    int getReadyFd() const;
+
+    /**
+     * @brief Handles a readable ready fd (event-loop callback)
+     *
+     * Consumes pending edge events, stores the finished conversion and
+     * switches the multiplexer to the next channel in the scan list.
+     * @return false on I2C error
+     */
+    bool serviceReady();
+
+    /* ------------------------------------------------------------------------
+     * Reading
+     * ------------------------------------------------------------------------ */
+
     /**
      * @brief Reads voltage from specified channel
+     *
+     * While scanning this returns the latest converted value (waiting
+     * briefly for the first one); otherwise a single-shot conversion
+     * is performed.
      * @param ch Channel number (0-3)
-     * @return Voltage in volts (0.0 - 4.096V range)
+     * @return Voltage in volts (0.0 - 4.096V range), -1.0 on error
      */
     float readVoltage(int ch);
-    
+
+    /**
+     * @brief Reads an oversampled (decimated) voltage
+     *
+     * While scanning, averages the last n conversions of the channel
+     * (at most HISTORY_SIZE); otherwise averages n single-shot
+     * conversions. Scanned values older than STALE_SCANS scan cycles
+     * (e.g. ALERT/RDY edges stopped arriving) are an error, so the
+     * sensor falls back instead of reporting them.
+     * @param ch Channel number (0-3)
+     * @param n Conversions to average
+     * @return Mean voltage, -1.0 on error
+     */
+    float readAveraged(int ch, int n);
+
     /**
      * @brief Checks if I2C is initialized
      * @return true if I2C connection is active
      */
     bool isInitialized() { return initialized; }
+
+    bool isScanning() const { return scanning; }
+    int getDataRate() const { return dataRateSps; }
+    int getAddress() const { return i2cAddr; }
 };
 
-#endif // ADC_H
\ No newline at end of file
+#endif // ADC_H
@@ -6,6 +6,8 @@
  * Captures images from Raspberry Pi Camera Module (OV5647) for ML disease detection.
  * Uses OpenCV VideoCapture for image acquisition.
  * Images are saved to /opt/leafsense/gallery/ with timestamp.
+ * capture() hands the decoded frame to the caller so inference does not
+ * have to read the JPEG back; saveImage() writes it to the gallery.
  */
 
 #ifndef CAM_H
@@ -23,21 +25,57 @@
  * Captures images from /dev/video0 (OV5647 camera module) using OpenCV.
  * Photos are automatically saved with timestamp to gallery directory.
  */
+namespace cv {
+    class Mat;
+}
+
 class Cam {
+private:
+    std::string filePrefix;  ///< Gallery filename prefix (distinguishes zones)
+    int cameraIndex;         ///< libcamera camera id (1-based) / V4L2 index, -1 = auto
+
 public:
     /**
      * @brief Constructs camera driver
+     * @param prefix Filename prefix ("plant" for the first zone)
+     * @param index Camera to use when several are attached (-1 = first found)
      */
-    Cam() {}
+    Cam(const std::string& prefix = "plant", int index = -1)
+        : filePrefix(prefix), cameraIndex(index) {}
     
     /**
      * @brief Captures a photo from the camera
      * @return Filepath to the captured image, or empty string on failure
      * 
-     * The image is saved to /opt/leafsense/gallery/plant_YYYYMMDD_HHMMSS.jpg
+     * The image is saved to /opt/leafsense/gallery/<prefix>_YYYYMMDD_HHMMSS.jpg
      * Returns empty string if camera cannot be opened or capture fails.
      */
     std::string takePhoto();
+
+    /**
+     * @brief Captures a frame without encoding it
+     * @param[out] image Enhanced BGR frame (may be empty if a saved capture fails to decode)
+     * @param[out] saved true if the capture tool already wrote the JPEG
+     * @return Gallery path reserved for the frame, or empty string on failure
+     * 
+     * When saved is false, pass the frame to saveImage() to write the JPEG.
+     */
+    std::string capture(cv::Mat& image, bool& saved);
+
+    /**
+     * @brief Encodes a frame to the gallery (JPEG quality 85)
+     * @param image BGR image
+     * @param filepath Destination from capture()
+     * @return true on success
+     */
+    static bool saveImage(const cv::Mat& image, const std::string& filepath);
+
+    /**
+     * @brief White balance, CLAHE contrast and sharpening of a capture
+     * @param input BGR image
+     * @return Enhanced image (input itself if empty)
+     */
+    static cv::Mat enhanceImage(const cv::Mat& input);
 };
 
 #endif // CAM_H
\ No newline at end of file
@@ -0,0 +1,123 @@
+/**
+ * @file I2CBus.h
+ * @brief Shared I2C Bus Manager
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Drivers/Sensors
+ *
+ * Owns the single file descriptor of an I2C adapter (/dev/i2c-1) and
+ * serializes every transfer on it, so several devices (e.g. ADS1115s
+ * at 0x48-0x4B) and threads can share the bus. Register reads are one
+ * combined I2C_RDWR transaction (write register pointer, repeated
+ * start, read), instead of separate write() and read() syscalls.
+ *
+ * Failed transfers are retried and counted per device address.
+ */
+
+#ifndef I2CBUS_H
+#define I2CBUS_H
+
+/* ============================================================================
+ * Includes
+ * ============================================================================ */
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <pthread.h>
+
+/**
+ * @struct I2CDeviceStats
+ * @brief Transfer counters of one device address
+ */
+struct I2CDeviceStats {
+    uint32_t transfers;   ///< Successful transactions
+    uint32_t retries;     ///< Extra attempts after a failure
+    uint32_t errors;      ///< Transactions that failed every attempt
+};
+
+/**
+ * @class I2CBus
+ * @brief Thread-safe access to one I2C adapter
+ */
+class I2CBus {
+public:
+    static const int MAX_ADDRESS = 0x7F;  ///< 7-bit addressing
+
+private:
+    std::string devicePath;   ///< Adapter node (e.g. /dev/i2c-1)
+    int fd;                   ///< Adapter file descriptor, -1 if closed
+    int maxRetries;           ///< Extra attempts per transaction
+    pthread_mutex_t busMutex; ///< One transaction at a time
+    I2CDeviceStats stats[MAX_ADDRESS + 1];  ///< Per-address counters (guarded by busMutex)
+
+    bool transferLocked(int addr, const uint8_t* tx, size_t txLen, uint8_t* rx, size_t rxLen);
+
+public:
+    /**
+     * @brief Opens the adapter
+     * @param device Adapter node
+     * @param retries Extra attempts after a failed transaction
+     */
+    I2CBus(const std::string& device = "/dev/i2c-1", int retries = 2);
+
+    /**
+     * @brief Destructor - closes the adapter
+     */
+    ~I2CBus();
+
+    I2CBus(const I2CBus&) = delete;
+    I2CBus& operator=(const I2CBus&) = delete;
+
+    /**
+     * @brief Checks if the adapter was opened
+     * @return false in mock mode
+     */
+    bool isOpen() const { return fd >= 0; }
+
+    /* ------------------------------------------------------------------------
+     * Transfers
+     * ------------------------------------------------------------------------ */
+
+    /**
+     * @brief Generic transaction: write tx, then (repeated start) read rx
+     * @param addr 7-bit device address
+     * @param tx Bytes to write (may be nullptr if txLen is 0)
+     * @param txLen Number of bytes to write
+     * @param rx Buffer for the read phase (may be nullptr if rxLen is 0)
+     * @param rxLen Number of bytes to read
+     * @return true on success (after retries)
+     */
+    bool transfer(int addr, const uint8_t* tx, size_t txLen, uint8_t* rx, size_t rxLen);
+
+    /**
+     * @brief Writes a big-endian 16-bit register
+     */
+    bool writeRegister16(int addr, uint8_t reg, uint16_t value);
+
+    /**
+     * @brief Reads a big-endian 16-bit register in one combined transaction
+     */
+    bool readRegister16(int addr, uint8_t reg, uint16_t& value);
+
+    /**
+     * @brief Checks whether a device acknowledges its address
+     */
+    bool probe(int addr);
+
+    /* ------------------------------------------------------------------------
+     * Diagnostics
+     * ------------------------------------------------------------------------ */
+
+    /**
+     * @brief Returns the counters of one device
+     */
+    I2CDeviceStats getStats(int addr);
+
+    /**
+     * @brief Prints the counters of every device that was used
+     */
+    void logStats();
+
+    const std::string& getDevicePath() const { return devicePath; }
+};
+
+#endif // I2CBUS_H
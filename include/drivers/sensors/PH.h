@@ -15,6 +15,7 @@
  * ============================================================================ */
 #include "Sensor.h"
 #include "ADC.h"
+#include "SignalFilter.h"
 
 /**
  * @class PH
@@ -22,6 +23,7 @@
  * 
  * Real mode: Reads ADC voltage and converts to pH (0-14 scale)
  * Mock mode: Returns random values between 6.0-7.0
+ * Simulation: Reads the attached ReservoirSim (see setSimulation())
  */
 class PH : public Sensor {
 public:
@@ -38,9 +40,16 @@ public:
      */
     float readSensor() override;
 
+    /**
+     * @brief Sets the filter chain applied to hardware readings
+     * @param cfg Oversampling, median, EMA and Kalman settings
+     */
+    void setFilter(const FilterConfig& cfg) { filter.configure(cfg); }
+
 private:
-    ADC* adc;      ///< Pointer to ADC driver
-    int channel;   ///< ADC channel (0-3)
+    ADC* adc;             ///< Pointer to ADC driver
+    int channel;          ///< ADC channel (0-3)
+    SignalFilter filter;  ///< Noise filter (control path uses the output)
 };
 
 #endif // PH_H
\ No newline at end of file
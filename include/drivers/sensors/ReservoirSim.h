@@ -0,0 +1,132 @@
+/**
+ * @file ReservoirSim.h
+ * @brief Deterministic Reservoir Physics Simulator (Hardware Backend)
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Drivers/Sensors
+ *
+ * Stands in for the probes and relays of one reservoir so the control
+ * logic can be evaluated without hardware. Sensors read the simulated
+ * water (plus seeded Gaussian noise) and the heater/pump drivers switch
+ * the simulated actuators instead of GPIOs.
+ *
+ * Model (integrated in 1 s steps of simulated time):
+ * - Temperature: heater power in, loss to ambient (k * (T - ambient)),
+ *   ambient following a daily sine around sim.ambient
+ * - pH: dosing moves pH by a fixed amount per mL per litre; plant uptake
+ *   drifts it upwards
+ * - EC: nutrient dosing adds salt mass, plant uptake removes it, and
+ *   evaporation concentrates it; a float valve tops up fresh water
+ *
+ * Time only advances through advance(), called once per scheduler tick.
+ * In sim mode Master runs each tick in lockstep: the next advance waits
+ * until the tick's sensor reads and the actuator commands they produced
+ * are done, and sampling rates, frame timestamps and the SENSOR rows use
+ * simulated time (second 0 = daemon start). The control run is
+ * then reproducible for a given seed regardless of wall-clock speed
+ * (sim.speed shortens the tick period only; late ticks are skipped, not
+ * replayed).
+ */
+
+#ifndef RESERVOIRSIM_H
+#define RESERVOIRSIM_H
+
+/* ============================================================================
+ * Includes
+ * ============================================================================ */
+#include <cstdint>
+#include <random>
+#include <string>
+#include <pthread.h>
+
+/**
+ * @enum SimActuator
+ * @brief Simulated outputs driven by the actuator drivers
+ */
+enum SimActuator {
+    SIM_HEATER = 0,
+    SIM_PH_UP,
+    SIM_PH_DOWN,
+    SIM_NUTRIENTS,
+    SIM_ACTUATOR_COUNT
+};
+
+/**
+ * @struct ReservoirSimParams
+ * @brief Physical constants and initial state of one reservoir
+ */
+struct ReservoirSimParams {
+    uint32_t seed;              ///< Noise seed (per zone)
+    float volumeL;              ///< Full reservoir volume
+    float ambientC;             ///< Mean ambient temperature
+    float ambientSwingC;        ///< Day/night amplitude around ambientC
+    float heaterW;              ///< Heater power
+    float lossWPerC;            ///< Heat loss coefficient to ambient
+    float pumpMlPerS;           ///< Flow of each dosing pump
+    float phPerMlPerL;          ///< pH change per mL of pH Up/Down per litre
+    float ecPpmPerMlPerL;       ///< EC added per mL of nutrient per litre
+    float phDriftPerDay;        ///< pH rise caused by plant uptake
+    float ecUptakePerDay;       ///< EC removed by plant uptake (ppm)
+    float evaporationLPerDay;   ///< Water lost to evaporation
+    float topUpFraction;        ///< Refill to full below this fraction (0 = never)
+    float tempNoise;            ///< Sensor noise standard deviations
+    float phNoise;
+    float ecNoise;
+    float initialTempC;
+    float initialPh;
+    float initialEcPpm;
+};
+
+/**
+ * @class ReservoirSim
+ * @brief Simulated water, probes and relays of one reservoir
+ */
+class ReservoirSim {
+private:
+    ReservoirSimParams params;
+    std::mt19937 rng;                     ///< Seeded noise source
+    std::normal_distribution<float> gauss;
+
+    double simSeconds;                    ///< Simulated time since start
+    float tempC;
+    float ph;
+    float ecPpm;
+    float volumeL;
+    bool outputs[SIM_ACTUATOR_COUNT];     ///< Simulated relay states
+    double dosedMl[SIM_ACTUATOR_COUNT];   ///< Totals (pumps) / on-seconds (heater)
+
+    pthread_mutex_t simMutex;             ///< tSig advances, tReadSensors reads, actuators switch
+
+    void stepLocked(double dt);
+    float noisyLocked(float value, float sigma);
+
+public:
+    explicit ReservoirSim(const ReservoirSimParams& p);
+    ~ReservoirSim();
+
+    ReservoirSim(const ReservoirSim&) = delete;
+    ReservoirSim& operator=(const ReservoirSim&) = delete;
+
+    /**
+     * @brief Advances simulated time
+     * @param seconds Simulated seconds (integrated in 1 s steps)
+     */
+    void advance(double seconds);
+
+    /** @brief Switches a simulated heater/pump */
+    void setOutput(SimActuator which, bool on);
+
+    /* ------------------------------------------------------------------------
+     * Probe Readings (true value + noise)
+     * ------------------------------------------------------------------------ */
+    float readTemperature();
+    float readPh();
+    float readEc();
+
+    /* ------------------------------------------------------------------------
+     * Diagnostics (true values, no noise)
+     * ------------------------------------------------------------------------ */
+    double getSimSeconds();
+    std::string describe();
+};
+
+#endif // RESERVOIRSIM_H
@@ -10,6 +10,19 @@
 #ifndef SENSOR_H
 #define SENSOR_H
 
+class ReservoirSim;
+
+/**
+ * @enum SensorStatus
+ * @brief Quality flags describing where the last reading came from
+ */
+enum SensorStatus : unsigned int {
+    SENSOR_OK        = 0,        ///< Value read from hardware
+    SENSOR_MOCK      = 1u << 0,  ///< No hardware present - simulated value
+    SENSOR_FALLBACK  = 1u << 1,  ///< Hardware read failed - fallback value
+    SENSOR_CLAMPED   = 1u << 2   ///< Value was clamped to the valid range
+};
+
 /**
  * @class Sensor
  * @brief Abstract sensor interface
@@ -17,17 +30,21 @@
  * Provides:
  * - Pure virtual readSensor() method
  * - Correction mode flag for faster polling during adjustments
+ * - Quality flags for the last reading
  */
 class Sensor {
 protected:
-    float realValue;   ///< Last read sensor value
-    bool correcting;   ///< Fast-poll mode during corrections
+    float realValue;      ///< Last read sensor value (filtered where a filter applies)
+    float rawValue;       ///< Last value before filtering (diagnostics)
+    bool correcting;      ///< Fast-poll mode during corrections
+    unsigned int status;  ///< SensorStatus flags of the last reading
+    ReservoirSim* sim;    ///< Simulated reservoir replacing the hardware (nullptr = none)
 
 public:
     /* ------------------------------------------------------------------------
      * Constructor / Destructor
      * ------------------------------------------------------------------------ */
-    Sensor() : realValue(0), correcting(false) {}
+    Sensor() : realValue(0), rawValue(0), correcting(false), status(SENSOR_MOCK), sim(nullptr) {}
     virtual ~Sensor() {}
 
     /* ------------------------------------------------------------------------
@@ -49,6 +66,24 @@ public:
      * @param c true to enable fast polling
      */
     void setTime(bool c) { correcting = c; }
+
+    /**
+     * @brief Gets the quality flags of the last reading
+     * @return Bitmask of SensorStatus values
+     */
+    unsigned int getStatus() const { return status; }
+
+    /**
+     * @brief Gets the last reading before digital filtering
+     * @return Unfiltered value (equals readSensor() for unfiltered sensors)
+     */
+    float getRawValue() const { return rawValue; }
+
+    /**
+     * @brief Reads from a simulated reservoir instead of the hardware
+     * @param s Simulator (owned by the caller), nullptr to detach
+     */
+    void setSimulation(ReservoirSim* s) { sim = s; }
 };
 
 #endif // SENSOR_H
\ No newline at end of file
@@ -0,0 +1,137 @@
+/**
+ * @file SignalFilter.h
+ * @brief Per-Channel Digital Filter Chain for Analog Sensors
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Drivers/Sensors
+ *
+ * Filter chain applied to every pH/EC reading:
+ *
+ *   ADC oversampling/decimation -> median-of-N -> EMA -> 1-D Kalman
+ *
+ * Oversampling happens in the ADC (mean of N conversions); the other
+ * stages run here on the converted value. Each stage can be disabled.
+ * All state lives in fixed-size arrays, so filtering never allocates.
+ */
+
+#ifndef SIGNALFILTER_H
+#define SIGNALFILTER_H
+
+/**
+ * @struct FilterConfig
+ * @brief Settings of one channel's filter chain
+ */
+struct FilterConfig {
+    int oversample;     ///< ADC conversions averaged per reading (1 = off)
+    int medianWindow;   ///< Median-of-N window, odd, 1 = off (max MedianFilter::MAX_WINDOW)
+    float emaAlpha;     ///< EMA weight of the new value, 1.0 = off
+    bool kalman;        ///< Enable the 1-D Kalman stage
+    float kalmanQ;      ///< Process noise variance (units^2 per reading)
+    float kalmanR;      ///< Measurement noise variance (units^2)
+
+    /**
+     * @brief Settings that leave readings unchanged
+     */
+    static FilterConfig passthrough();
+};
+
+/**
+ * @class MedianFilter
+ * @brief Sliding median over a fixed ring buffer (spike rejection)
+ */
+class MedianFilter {
+public:
+    static const int MAX_WINDOW = 9;
+
+private:
+    float ring[MAX_WINDOW];   ///< Last values, oldest overwritten first
+    int window;               ///< Active window size
+    int count;                ///< Values held (<= window)
+    int head;                 ///< Next write position
+
+public:
+    explicit MedianFilter(int size = 1);
+
+    void setWindow(int size);
+    void reset();
+
+    /**
+     * @brief Adds a value and returns the median of the window
+     */
+    float process(float value);
+};
+
+/**
+ * @class EmaFilter
+ * @brief Exponential moving average
+ */
+class EmaFilter {
+private:
+    float alpha;   ///< Weight of the new value (0, 1]
+    float state;   ///< Current average
+    bool primed;   ///< state holds a value
+
+public:
+    explicit EmaFilter(float a = 1.0f);
+
+    void setAlpha(float a);
+    void reset() { primed = false; }
+    float process(float value);
+};
+
+/**
+ * @class KalmanFilter1D
+ * @brief Scalar Kalman filter with a constant-value process model
+ */
+class KalmanFilter1D {
+private:
+    float q;        ///< Process noise variance
+    float r;        ///< Measurement noise variance
+    float x;        ///< Estimate
+    float p;        ///< Estimate variance
+    bool primed;    ///< x holds a value
+
+public:
+    KalmanFilter1D(float processNoise = 0.0f, float measurementNoise = 1.0f);
+
+    void setNoise(float processNoise, float measurementNoise);
+    void reset() { primed = false; }
+    float process(float value);
+};
+
+/**
+ * @class SignalFilter
+ * @brief Complete filter chain of one channel
+ *
+ * Not thread-safe: owned by a sensor and used by the acquisition thread.
+ */
+class SignalFilter {
+private:
+    FilterConfig config;
+    MedianFilter median;
+    EmaFilter ema;
+    KalmanFilter1D kalmanFilter;
+
+public:
+    explicit SignalFilter(const FilterConfig& cfg = FilterConfig::passthrough());
+
+    /**
+     * @brief Replaces the settings and clears the filter state
+     */
+    void configure(const FilterConfig& cfg);
+
+    /**
+     * @brief Clears the state (e.g. after a sensor fault)
+     */
+    void reset();
+
+    /**
+     * @brief Runs one value through median, EMA and Kalman stages
+     * @param value Converted reading (already oversampled by the ADC)
+     * @return Filtered value
+     */
+    float process(float value);
+
+    int getOversample() const { return config.oversample; }
+};
+
+#endif // SIGNALFILTER_H
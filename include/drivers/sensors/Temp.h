@@ -2,7 +2,7 @@
  * @file Temp.h
  * @brief DS18B20 Temperature Sensor Driver
  * @layer Drivers/Sensors
- * 
+ *
  * Reads temperature from a DS18B20 1-Wire digital sensor.
  * In mock mode, returns simulated values for testing.
  */
@@ -14,28 +14,35 @@
  * Includes
  * ============================================================================ */
 #include "Sensor.h"
+#include "W1Bus.h"
 #include <string>
 
 /**
  * @class Temp
  * @brief Temperature sensor driver (DS18B20)
- * 
- * Real mode: Reads from /sys/bus/w1/devices/{addr}/temperature
- * Mock mode: Returns random values between 20.0-25.0°C
+ *
+ * Real mode: Reads one probe of a shared W1Bus (last bulk conversion)
+ * Mock mode: Returns random values between 15.0-25.0°C
+ * Simulation: Reads the attached ReservoirSim (see setSimulation())
  */
 class Temp : public Sensor {
 public:
     /**
      * @brief Constructs temperature sensor
-     * @param addr 1-Wire device address (e.g., "28-xxxx")
+     * @param w1 Shared 1-Wire bus (nullptr = mock mode)
+     * @param addr 1-Wire device id (e.g., "28-xxxx"), "auto" for the first probe
      */
-    Temp(std::string addr) {}
-    
+    Temp(W1Bus* w1, const std::string& addr) : bus(w1), probeId(addr) {}
+
     /**
      * @brief Reads current temperature
      * @return Temperature in degrees Celsius
      */
     float readSensor() override;
+
+private:
+    W1Bus* bus;           ///< Shared 1-Wire master (owned by the caller)
+    std::string probeId;  ///< Stable probe id
 };
 
-#endif // TEMP_H
\ No newline at end of file
+#endif // TEMP_H
@@ -0,0 +1,103 @@
+/**
+ * @file W1Bus.h
+ * @brief 1-Wire Bus Master for DS18B20 Probes
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Drivers/Sensors
+ *
+ * Wraps one kernel 1-Wire master (/sys/bus/w1/devices/w1_bus_master1):
+ * - Discovery of DS18B20 probes (family 28) is done once and redone only
+ *   when the master's slave list changes (hotplug) or a probe fails.
+ * - Each probe keeps an open file descriptor read with pread(), so a
+ *   reading is one syscall and no allocation.
+ * - convertAll() starts a conversion on every probe at once through
+ *   therm_bulk_read, so the ~750 ms conversion is paid once per bus
+ *   instead of once per probe.
+ */
+
+#ifndef W1BUS_H
+#define W1BUS_H
+
+/* ============================================================================
+ * Includes
+ * ============================================================================ */
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+/**
+ * @class W1Bus
+ * @brief DS18B20 discovery, bulk conversion and reading for one master
+ */
+class W1Bus {
+private:
+    /**
+     * @struct Probe
+     * @brief One discovered DS18B20
+     */
+    struct Probe {
+        std::string id;   ///< Stable ROM id ("28-xxxxxxxxxxxx")
+        int fd;           ///< Open "temperature" (or "w1_slave") attribute
+        bool legacy;      ///< fd is w1_slave (two-line format)
+    };
+
+    std::string masterPath;        ///< /sys/bus/w1/devices/<master>/
+    std::vector<Probe> probes;     ///< Discovered probes, sorted by id
+    std::string slaveList;         ///< Last contents of w1_master_slaves
+    int slavesFd;                  ///< Open w1_master_slaves
+    int bulkFd;                    ///< Open therm_bulk_read, -1 if unsupported
+    bool needsRefresh;             ///< A probe failed or hotplug seen
+    pthread_mutex_t busMutex;      ///< Guards probes and the fds
+
+    void closeProbes();
+    bool readSlaveList(std::string& list);
+    void discoverLocked();
+    bool waitBulkDone(int timeoutMs);
+    static bool parseTemperature(const char* text, bool legacy, float& celsius);
+
+public:
+    /**
+     * @brief Opens the master and discovers its probes
+     * @param master Master name under /sys/bus/w1/devices
+     */
+    explicit W1Bus(const std::string& master = "w1_bus_master1");
+    ~W1Bus();
+
+    W1Bus(const W1Bus&) = delete;
+    W1Bus& operator=(const W1Bus&) = delete;
+
+    /**
+     * @brief Checks if the 1-Wire master exists
+     * @return false in mock mode
+     */
+    bool isAvailable() const { return slavesFd >= 0; }
+
+    /**
+     * @brief Rediscovers probes if the slave list changed
+     * @return Number of probes known after the check
+     */
+    size_t refresh();
+
+    /**
+     * @brief Starts a conversion on every probe and waits for it
+     *
+     * Without therm_bulk_read support this is a no-op and each read
+     * converts on its own.
+     * @return true if a bulk conversion completed
+     */
+    bool convertAll();
+
+    /**
+     * @brief Reads the last conversion of one probe
+     * @param id Probe id, or "auto"/"" for the first probe found
+     * @param[out] celsius Temperature (°C)
+     * @return false if the probe is missing or the read/CRC failed
+     */
+    bool readProbe(const std::string& id, float& celsius);
+
+    /**
+     * @brief Ids of the discovered probes
+     */
+    std::vector<std::string> getProbeIds();
+};
+
+#endif // W1BUS_H
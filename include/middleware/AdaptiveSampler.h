@@ -0,0 +1,83 @@
+/**
+ * @file AdaptiveSampler.h
+ * @brief Per-Sensor Adaptive Sampling Interval
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Middleware
+ *
+ * Decides how often one sensor is read, in tSig ticks. The interval
+ * drops to the minimum when the value is changing fast, is close to
+ * (or outside) its ideal range, or a correction is in progress, and
+ * doubles back towards the maximum while the reading stays stable.
+ */
+
+#ifndef ADAPTIVESAMPLER_H
+#define ADAPTIVESAMPLER_H
+
+/* ============================================================================
+ * System Includes
+ * ============================================================================ */
+#include <pthread.h>
+#include <cstdint>
+
+/**
+ * @struct SamplingLimits
+ * @brief Tuning parameters for one sensor
+ */
+struct SamplingLimits {
+    int minTicks;         ///< Fastest interval (tSig ticks)
+    int maxTicks;         ///< Slowest interval / stable heartbeat (tSig ticks)
+    float rateThreshold;  ///< Change per minute considered "fast"
+    float nearMargin;     ///< Fraction of the ideal range treated as "near threshold"
+};
+
+/**
+ * @class AdaptiveSampler
+ * @brief Countdown with a variability-driven reload value
+ *
+ * tick() is called by the dispatcher thread, update() by the
+ * acquisition thread after a reading; both are guarded by a mutex.
+ */
+class AdaptiveSampler {
+private:
+    SamplingLimits limits;
+    int interval;          ///< Current reload value (ticks)
+    int countdown;         ///< Ticks until the next read
+    bool hasLast;          ///< lastValue is valid
+    float lastValue;       ///< Previous reading
+    uint64_t lastMs;       ///< Time of previous reading (monotonic ms)
+    pthread_mutex_t mutex;
+
+public:
+    /**
+     * @brief Constructor
+     * @param lim Tuning parameters
+     * @param initialTicks Interval used until the first update()
+     */
+    AdaptiveSampler(const SamplingLimits& lim, int initialTicks);
+    ~AdaptiveSampler();
+
+    AdaptiveSampler(const AdaptiveSampler&) = delete;
+    AdaptiveSampler& operator=(const AdaptiveSampler&) = delete;
+
+    /**
+     * @brief Advances one tSig tick
+     * @return true if the sensor is due (the countdown is reloaded)
+     */
+    bool tick();
+
+    /**
+     * @brief Adapts the interval to a new reading
+     * @param value Reading just acquired
+     * @param range Ideal range [min, max]
+     * @param correcting true while an actuator is correcting this parameter
+     * @param nowMs Acquisition time (monotonic ms)
+     */
+    void update(float value, const float range[2], bool correcting, uint64_t nowMs);
+
+    int getInterval();
+    int getCountdown();
+    int getMinInterval() const { return limits.minTicks; }
+    int getMaxInterval() const { return limits.maxTicks; }
+};
+
+#endif // ADAPTIVESAMPLER_H
@@ -0,0 +1,202 @@
+/**
+ * @file BoundedQueue.h
+ * @brief Fixed-Capacity Blocking Queue with Overflow Policy
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Middleware
+ *
+ * Used between processing stages so a slow consumer applies
+ * backpressure (or sheds load) instead of letting work pile up
+ * without bound, as an unbounded MQueueHandler would.
+ */
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+/* ============================================================================
+ * System Includes
+ * ============================================================================ */
+#include <deque>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <pthread.h>
+
+/**
+ * @enum OverflowPolicy
+ * @brief What push() does when the queue is full
+ */
+enum class OverflowPolicy {
+    BLOCK,        ///< Wait for space (backpressure to the producer)
+    DROP_OLDEST,  ///< Discard the oldest queued item, keep the new one
+    DROP_NEWEST   ///< Discard the item being pushed
+};
+
+/**
+ * @class BoundedQueue
+ * @brief Thread-safe bounded FIFO (POSIX mutex/condition variables)
+ *
+ * close() wakes all waiters; after closing, pop() drains remaining
+ * items and then returns false. Items the overflow policy discards can
+ * be handed to a drop handler to release what they own.
+ *
+ * @tparam T Item type (moved in and out)
+ */
+template <typename T>
+class BoundedQueue {
+private:
+    std::deque<T> items;
+    size_t capacity;
+    OverflowPolicy policy;
+    bool closed;
+    size_t dropped;      ///< Items discarded by the overflow policy
+    size_t highWater;    ///< Maximum observed depth
+    std::function<void(T&)> dropHandler;  ///< Called for discarded items (optional)
+
+    pthread_mutex_t mutex;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+
+public:
+    /**
+     * @brief Constructor
+     * @param cap Maximum number of queued items (>= 1)
+     * @param p Overflow policy
+     */
+    BoundedQueue(size_t cap, OverflowPolicy p)
+        : capacity(cap ? cap : 1), policy(p), closed(false), dropped(0), highWater(0)
+    {
+        pthread_mutex_init(&mutex, NULL);
+        pthread_cond_init(&notEmpty, NULL);
+        pthread_cond_init(&notFull, NULL);
+    }
+
+    ~BoundedQueue()
+    {
+        pthread_mutex_destroy(&mutex);
+        pthread_cond_destroy(&notEmpty);
+        pthread_cond_destroy(&notFull);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * @brief Sets the handler for items the overflow policy discards
+     * @param handler Called outside the lock; set before the queue is shared
+     */
+    void setDropHandler(std::function<void(T&)> handler) { dropHandler = handler; }
+
+    /**
+     * @brief Adds an item according to the overflow policy
+     * @param item Item to enqueue
+     * @return false if the item was rejected (DROP_NEWEST or closed)
+     */
+    bool push(T item)
+    {
+        pthread_mutex_lock(&mutex);
+
+        if (policy == OverflowPolicy::BLOCK) {
+            while (!closed && items.size() >= capacity) {
+                pthread_cond_wait(&notFull, &mutex);
+            }
+        }
+
+        if (closed) {
+            pthread_mutex_unlock(&mutex);
+            return false;
+        }
+
+        bool evicted = false;
+        T oldest;
+        if (items.size() >= capacity) {
+            dropped++;
+            if (policy == OverflowPolicy::DROP_NEWEST) {
+                pthread_mutex_unlock(&mutex);
+                if (dropHandler) dropHandler(item);
+                return false;
+            }
+            oldest = std::move(items.front());  // DROP_OLDEST
+            items.pop_front();
+            evicted = true;
+        }
+
+        items.push_back(std::move(item));
+        if (items.size() > highWater) highWater = items.size();
+
+        pthread_cond_signal(&notEmpty);
+        pthread_mutex_unlock(&mutex);
+
+        if (evicted && dropHandler) dropHandler(oldest);
+        return true;
+    }
+
+    /**
+     * @brief Removes the next item, blocking while empty
+     * @param[out] item Dequeued item
+     * @return false once the queue is closed and drained
+     */
+    bool pop(T& item)
+    {
+        pthread_mutex_lock(&mutex);
+
+        while (!closed && items.empty()) {
+            pthread_cond_wait(&notEmpty, &mutex);
+        }
+
+        if (items.empty()) {
+            pthread_mutex_unlock(&mutex);
+            return false;
+        }
+
+        item = std::move(items.front());
+        items.pop_front();
+
+        pthread_cond_signal(&notFull);
+        pthread_mutex_unlock(&mutex);
+        return true;
+    }
+
+    /**
+     * @brief Wakes all producers and consumers; further pushes fail
+     */
+    void close()
+    {
+        pthread_mutex_lock(&mutex);
+        closed = true;
+        pthread_cond_broadcast(&notEmpty);
+        pthread_cond_broadcast(&notFull);
+        pthread_mutex_unlock(&mutex);
+    }
+
+    /* ------------------------------------------------------------------------
+     * Statistics
+     * ------------------------------------------------------------------------ */
+
+    size_t size()
+    {
+        pthread_mutex_lock(&mutex);
+        size_t n = items.size();
+        pthread_mutex_unlock(&mutex);
+        return n;
+    }
+
+    size_t droppedCount()
+    {
+        pthread_mutex_lock(&mutex);
+        size_t n = dropped;
+        pthread_mutex_unlock(&mutex);
+        return n;
+    }
+
+    size_t highWaterMark()
+    {
+        pthread_mutex_lock(&mutex);
+        size_t n = highWater;
+        pthread_mutex_unlock(&mutex);
+        return n;
+    }
+
+    size_t getCapacity() const { return capacity; }
+};
+
+#endif // BOUNDEDQUEUE_H
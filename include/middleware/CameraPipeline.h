@@ -0,0 +1,238 @@
+/**
+ * @file CameraPipeline.h
+ * @brief Staged Camera -> Preprocess -> Inference -> Persist Pipeline
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Middleware
+ *
+ * Each stage runs on its own thread and hands frames to the next one
+ * through a BoundedQueue, so a slow inference no longer delays the next
+ * capture and capture latency no longer delays results.
+ *
+ * Stage Threads:
+ * - tCapture:    Cam::capture() for each requested camera (frame kept in memory),
+ *                content hash
+ * - tPreprocess: Result cache lookup, otherwise resize/normalize, green ratio
+ *                (nothing in tiled mode: ML::analyzeTiled() cuts the crops)
+ * - tInference:  Submits the tensor (tiled mode: the frame) to the
+ *                InferenceService (SCHEDULED) and waits for the result
+ *                (skipped on a cache hit)
+ * - tPersist:    Gallery JPEG encode, then the caller-supplied handler
+ *                (DB messages, LED, recommendations)
+ *
+ * The captured cv::Mat travels with the frame, so analysis never
+ * decodes the gallery JPEG and encoding stays off the path to a result.
+ */
+
+#ifndef CAMERAPIPELINE_H
+#define CAMERAPIPELINE_H
+
+/* ============================================================================
+ * System Includes
+ * ============================================================================ */
+#include <pthread.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+
+/* ============================================================================
+ * Project Includes
+ * ============================================================================ */
+#include "BoundedQueue.h"
+#include "drivers/sensors/Cam.h"
+#include "application/ml/ML.h"
+#include "application/ml/InferenceCache.h"
+#include "InferenceService.h"
+
+/**
+ * @enum PipelineStage
+ * @brief Stage indices used for timing and queue statistics
+ */
+enum PipelineStage {
+    STAGE_CAPTURE = 0,
+    STAGE_PREPROCESS,
+    STAGE_INFERENCE,
+    STAGE_PERSIST,
+    STAGE_COUNT
+};
+
+/**
+ * @struct PipelineFrame
+ * @brief Work item travelling through the pipeline
+ */
+struct PipelineFrame {
+    int cameraId;                   ///< Index returned by addCamera()
+    uint64_t sequence;              ///< Monotonic frame counter
+    uint64_t triggeredAtMs;         ///< When the capture was requested
+    std::string photoPath;          ///< Gallery path (written before persistHandler runs)
+    std::string filename;           ///< File name component of photoPath
+    cv::Mat image;                  ///< Captured BGR frame (released after persist)
+    bool imageSaved;                ///< JPEG already on disk (capture tool wrote it)
+    std::string imageHash;          ///< ML::imageHash() of image (plant_images.image_hash)
+    bool cached;                    ///< result came from the InferenceCache
+    std::vector<float> tensor;      ///< Model input (filled by preprocess)
+    float greenRatio;               ///< OOD colour check (filled by preprocess)
+    bool inputValid;                ///< false if the image could not be decoded
+    MLResult result;                ///< Inference output
+    double stageMs[STAGE_COUNT];    ///< Time spent in each stage
+};
+
+/**
+ * @struct PipelineStageStats
+ * @brief Snapshot of one stage's counters
+ */
+struct PipelineStageStats {
+    uint64_t processed;     ///< Frames completed by this stage
+    uint64_t dropped;       ///< Frames discarded at this stage's input queue
+    double lastMs;          ///< Duration of the last frame
+    double avgMs;           ///< Mean duration
+    double maxMs;           ///< Worst-case duration
+    size_t queueDepth;      ///< Current input queue depth
+    size_t queueHighWater;  ///< Maximum input queue depth observed
+    size_t queueCapacity;   ///< Input queue capacity
+};
+
+/**
+ * @class CameraPipeline
+ * @brief Multi-camera capture and analysis pipeline with backpressure
+ *
+ * Drop policy when saturated:
+ * - Capture requests beyond the queue capacity are rejected, so a burst
+ *   of triggers collapses to the ones already pending.
+ * - Before preprocess/inference the oldest waiting frame is dropped in
+ *   favour of the newest, so results always reflect recent images. A
+ *   JPEG the capture tool already wrote for it is deleted.
+ * - Analysed frames are never dropped; the persist queue blocks instead.
+ */
+class CameraPipeline {
+public:
+    /**
+     * @brief Called on the persist thread for every analysed frame
+     */
+    typedef std::function<void(const PipelineFrame&)> PersistHandler;
+
+private:
+    /* ------------------------------------------------------------------------
+     * Collaborators
+     * ------------------------------------------------------------------------ */
+    InferenceService* inference;        ///< Runs the model (not owned)
+    ML* mlEngine;                       ///< inference->getEngine(), for preprocessing
+    InferenceCache* resultCache;        ///< Optional, not owned
+    PersistHandler persistHandler;      ///< Result sink
+    std::vector<Cam*> cameras;          ///< Registered cameras (not owned)
+
+    /* ------------------------------------------------------------------------
+     * Stage Queues
+     * ------------------------------------------------------------------------ */
+    BoundedQueue<PipelineFrame> captureQueue;     ///< Pending capture requests
+    BoundedQueue<PipelineFrame> preprocessQueue;  ///< Captured, not yet decoded
+    BoundedQueue<PipelineFrame> inferenceQueue;   ///< Decoded, waiting for the model
+    BoundedQueue<PipelineFrame> persistQueue;     ///< Analysed, waiting for persistence
+
+    /* ------------------------------------------------------------------------
+     * Stage Threads
+     * ------------------------------------------------------------------------ */
+    pthread_t tCapture;
+    pthread_t tPreprocess;
+    pthread_t tInference;
+    pthread_t tPersist;
+    bool running;
+
+    /* ------------------------------------------------------------------------
+     * Statistics (guarded by statsMutex)
+     * ------------------------------------------------------------------------ */
+    pthread_mutex_t statsMutex;
+    uint64_t nextSequence;
+    uint64_t processed[STAGE_COUNT];
+    double totalMs[STAGE_COUNT];
+    double lastMs[STAGE_COUNT];
+    double maxMs[STAGE_COUNT];
+
+    void recordStage(PipelineStage stage, double ms);
+    BoundedQueue<PipelineFrame>* inputQueue(PipelineStage stage);
+
+    /** @brief Deletes the gallery JPEG of a frame that will never be persisted */
+    static void discardFrame(PipelineFrame& frame);
+
+    /* ------------------------------------------------------------------------
+     * Stage Loops
+     * ------------------------------------------------------------------------ */
+    void captureLoop();
+    void preprocessLoop();
+    void inferenceLoop();
+    void persistLoop();
+
+    static void* captureLoopStatic(void* arg);
+    static void* preprocessLoopStatic(void* arg);
+    static void* inferenceLoopStatic(void* arg);
+    static void* persistLoopStatic(void* arg);
+
+public:
+    /* ------------------------------------------------------------------------
+     * Constructor / Destructor
+     * ------------------------------------------------------------------------ */
+
+    /**
+     * @brief Constructor
+     * @param service Inference service shared with on-demand requests
+     * @param handler Persist-stage callback
+     * @param queueCapacity Capacity of each inter-stage queue
+     */
+    CameraPipeline(InferenceService* service, PersistHandler handler, size_t queueCapacity = 2);
+    ~CameraPipeline();
+
+    /**
+     * @brief Registers a camera (before start())
+     * @param cam Camera driver (not owned)
+     * @return Camera id used in PipelineFrame::cameraId
+     */
+    int addCamera(Cam* cam);
+
+    /**
+     * @brief Enables result reuse for repeated frames (before start())
+     * @param cache Result cache (not owned), nullptr to always run the model
+     */
+    void setResultCache(InferenceCache* cache);
+
+    /* ------------------------------------------------------------------------
+     * Lifecycle Control
+     * ------------------------------------------------------------------------ */
+    void start();  ///< Creates the stage threads
+    void stop();   ///< Closes the queues and joins the stage threads
+
+    /* ------------------------------------------------------------------------
+     * Triggers
+     * ------------------------------------------------------------------------ */
+
+    /**
+     * @brief Requests one capture from every registered camera
+     * @return Number of requests accepted
+     */
+    int trigger();
+
+    /**
+     * @brief Requests one capture from a single camera
+     * @param cameraId Id returned by addCamera()
+     * @return false if the request was dropped (pipeline saturated)
+     */
+    bool triggerCamera(int cameraId);
+
+    /* ------------------------------------------------------------------------
+     * Statistics
+     * ------------------------------------------------------------------------ */
+
+    /**
+     * @brief Copies per-stage timings and queue depths
+     * @param stage Stage to query
+     * @return Stage statistics
+     */
+    PipelineStageStats getStats(PipelineStage stage);
+
+    /**
+     * @brief Prints a one-line summary per stage to stdout
+     */
+    void printStats();
+};
+
+#endif // CAMERAPIPELINE_H
@@ -0,0 +1,66 @@
+/**
+ * @file Config.h
+ * @brief Runtime Configuration (key = value file + environment overrides)
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Middleware
+ *
+ * Settings are read once from /opt/leafsense/leafsense.conf (or the file
+ * named by LEAFSENSE_CONFIG). Any key can be overridden from the
+ * environment: "sampling.min_interval_s" -> LEAFSENSE_SAMPLING_MIN_INTERVAL_S.
+ *
+ * File format:
+ * @code
+ * # comment
+ * sampling.min_interval_s = 10
+ * @endcode
+ */
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+/* ============================================================================
+ * System Includes
+ * ============================================================================ */
+#include <map>
+#include <string>
+
+/**
+ * @class Config
+ * @brief Read-only key/value settings shared by the backend
+ *
+ * Loaded on first use and never modified afterwards, so lookups are
+ * safe from any thread.
+ */
+class Config {
+private:
+    std::map<std::string, std::string> values;  ///< Entries from the file
+    std::string sourcePath;                     ///< File that was loaded
+
+    Config();
+    bool load(const std::string& path);
+    bool lookup(const std::string& key, std::string& value) const;
+
+public:
+    Config(const Config&) = delete;
+    Config& operator=(const Config&) = delete;
+
+    /**
+     * @brief Gets the process-wide configuration
+     */
+    static Config& instance();
+
+    /* ------------------------------------------------------------------------
+     * Typed Getters (return def when the key is missing or malformed)
+     * ------------------------------------------------------------------------ */
+    std::string getString(const std::string& key, const std::string& def) const;
+    int getInt(const std::string& key, int def) const;
+    float getFloat(const std::string& key, float def) const;
+    bool getBool(const std::string& key, bool def) const;
+
+    /**
+     * @brief Path of the loaded file (empty if none was found)
+     */
+    const std::string& getSourcePath() const { return sourcePath; }
+};
+
+#endif // CONFIG_H
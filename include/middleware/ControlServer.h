@@ -0,0 +1,103 @@
+/**
+ * @file ControlServer.h
+ * @brief Unix-Socket Control Channel (GUI -> Daemon, Frame Notifications)
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Middleware
+ *
+ * Line-based protocol on a Unix stream socket (ipc.socket, default
+ * /var/run/leafsense.sock), in the same TAG|FIELD style as the database
+ * queue:
+ *
+ *   SUBSCRIBE                         -> OK, then "FRAME" per published frame
+ *   PING                              -> OK
+ *   THRESHOLDS|<zone>|<tmin>|<tmax>|<phmin>|<phmax>|<ecmin>|<ecmax>
+ *   ACK_ALERTS[|<zone>]
+ *   ACK_REC|<filename>
+ *   ANALYZE|<image path>             -> OK|<label>|<confidence>|<valid 0/1>|<boxes>
+ *   MODEL[|RELOAD|ROLLBACK]          -> OK|<active model version>
+ *
+ * Commands other than SUBSCRIBE/PING are passed to the handler (Master),
+ * which answers "OK" (optionally followed by |fields) or "ERR|<reason>".
+ * Commands that take time (ANALYZE, MODEL|RELOAD) hand back a PendingReply instead: the
+ * server polls it while it keeps serving the other clients, and reads no
+ * further command from that client until the reply is sent. A GUI that
+ * hangs or exits only loses its own connection; control continues.
+ */
+
+#ifndef CONTROLSERVER_H
+#define CONTROLSERVER_H
+
+/* ============================================================================
+ * System Includes
+ * ============================================================================ */
+#include <functional>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+/* ============================================================================
+ * Middleware Includes
+ * ============================================================================ */
+#include "LiveState.h"
+
+/**
+ * @class ControlServer
+ * @brief Accepts GUI connections, runs commands and fans out notifications
+ */
+class ControlServer {
+public:
+    /** @brief Polled on the server thread: true once the reply line is set */
+    typedef std::function<bool(std::string&)> PendingReply;
+
+    /**
+     * @brief Executes one command line
+     * @param line Command
+     * @param[out] later Set (reply left empty) when the answer is not ready yet
+     * @return Reply line
+     */
+    typedef std::function<std::string(const std::string& line, PendingReply& later)> CommandHandler;
+
+private:
+    struct Client {
+        int fd;
+        bool subscribed;
+        std::string pending;    ///< Partial command line
+        PendingReply waiting;   ///< Reply still being computed (empty = none)
+    };
+
+    std::string socketPath;
+    LiveState* live;            ///< Notification source (not owned)
+    CommandHandler handler;
+
+    int listenFd;
+    int stopFd;                 ///< eventfd that wakes the thread for stop()
+    std::vector<Client> clients;
+    pthread_t thread;
+    bool started;
+
+    static void* threadFunc(void* arg);
+    void loop();
+    void acceptClient();
+    bool serviceClient(Client& client);   ///< false = connection closed
+    bool runCommands(Client& client);     ///< Complete lines in pending; false = write failed
+    bool checkWaiting(Client& client);    ///< Sends a finished reply; false = write failed
+    void notifySubscribers();
+    static bool writeLine(int fd, const std::string& line);
+
+public:
+    /**
+     * @param path Socket path
+     * @param state Live state whose notify fd triggers "FRAME" messages
+     * @param commandHandler Executes commands, returns the reply line
+     */
+    ControlServer(const std::string& path, LiveState* state, CommandHandler commandHandler);
+    ~ControlServer();
+
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+
+    bool start();   ///< Binds the socket and starts the server thread
+    void stop();    ///< Closes every connection and removes the socket
+};
+
+#endif // CONTROLSERVER_H
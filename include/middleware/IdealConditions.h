@@ -6,12 +6,15 @@
  * 
  * Stores and provides access to the ideal ranges for all monitored
  * parameters. Used by the Master control loop to determine when
- * corrective action is needed.
+ * corrective action is needed. Ranges may be changed at runtime from
+ * the control socket while the acquisition thread reads them.
  */
 
 #ifndef IDEALCONDITIONS_H
 #define IDEALCONDITIONS_H
 
+#include <pthread.h>
+
 /**
  * @class IdealConditions
  * @brief Stores ideal parameter ranges for plant growth
@@ -30,6 +33,8 @@ private:
     float ph_min, ph_max;      ///< pH range
     float temp_min, temp_max;  ///< Temperature range (°C)
 
+    mutable pthread_mutex_t rangeMutex;  ///< Control socket writes, tReadSensors reads
+
 public:
     /* ------------------------------------------------------------------------
      * Constructor
@@ -39,6 +44,10 @@ public:
      * @brief Constructor with default Lettuce values
      */
     IdealConditions();
+    ~IdealConditions();
+
+    IdealConditions(const IdealConditions&) = delete;
+    IdealConditions& operator=(const IdealConditions&) = delete;
 
     /* ------------------------------------------------------------------------
      * Getters (Array-based for efficiency)
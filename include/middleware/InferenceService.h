@@ -0,0 +1,172 @@
+/**
+ * @file InferenceService.h
+ * @brief Asynchronous, Prioritized Access to the ML Engine
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Middleware
+ *
+ * Owns the ML engine and runs every classification on one worker thread
+ * (tInferenceSvc), so the camera pipeline, control commands and tools can
+ * request results without sharing the session or blocking each other.
+ *
+ * - submit() returns a std::future<MLResult>; it never blocks.
+ * - ON_DEMAND requests (a user waiting in the GUI) are served before
+ *   SCHEDULED ones (periodic captures), FIFO within a priority.
+ * - The queue is bounded. When it is full, an ON_DEMAND request evicts
+ *   the oldest SCHEDULED one; otherwise the new request is rejected.
+ * - cancel() removes a request that has not started yet.
+ *
+ * Rejected and cancelled requests complete their future with an
+ * InferenceCancelled exception.
+ */
+
+#ifndef INFERENCESERVICE_H
+#define INFERENCESERVICE_H
+
+/* ============================================================================
+ * System Includes
+ * ============================================================================ */
+#include <pthread.h>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+
+/* ============================================================================
+ * Project Includes
+ * ============================================================================ */
+#include "application/ml/ML.h"
+
+/**
+ * @enum InferencePriority
+ * @brief Request classes, highest first
+ */
+enum class InferencePriority {
+    ON_DEMAND = 0,  ///< Requested by a user, answer as soon as possible
+    SCHEDULED = 1,  ///< Periodic capture, may wait or be shed
+};
+
+/**
+ * @class InferenceCancelled
+ * @brief Set on the future of a cancelled or rejected request
+ */
+class InferenceCancelled : public std::runtime_error {
+public:
+    explicit InferenceCancelled(const std::string& reason) : std::runtime_error(reason) {}
+};
+
+/**
+ * @struct InferenceServiceStats
+ * @brief Snapshot of the service counters
+ */
+struct InferenceServiceStats {
+    uint64_t completed;     ///< Requests that ran
+    uint64_t cancelled;     ///< Removed by cancel()
+    uint64_t rejected;      ///< Queue full, or evicted by an ON_DEMAND request
+    double avgQueueMs;      ///< Mean time from submit() to start of run
+    double maxQueueMs;
+    double avgRunMs;        ///< Mean preprocessing + inference time
+    double maxRunMs;
+    size_t queueDepth;      ///< Requests waiting now
+    size_t queueCapacity;
+};
+
+/**
+ * @class InferenceService
+ * @brief Single-worker request queue in front of ML
+ */
+class InferenceService {
+public:
+    typedef uint64_t Ticket;    ///< Identifies a request for cancel()
+
+private:
+    struct Request {
+        Ticket ticket;
+        cv::Mat image;              ///< Decoded frame (empty if prepared)
+        std::vector<float> tensor;  ///< Preprocessed input (if prepared)
+        float greenRatio;
+        bool prepared;              ///< tensor/greenRatio already computed
+        double submittedMs;
+        std::promise<MLResult> promise;
+    };
+
+    ML* engine;                                 ///< Owned
+    size_t capacity;                            ///< Total waiting requests
+    std::deque<Request> queues[2];              ///< Indexed by InferencePriority
+    Ticket nextTicket;
+    bool running;
+
+    pthread_t thread;
+    pthread_mutex_t mutex;                      ///< Guards queues and counters
+    pthread_cond_t notEmpty;
+
+    uint64_t completed;
+    uint64_t cancelled;
+    uint64_t rejected;
+    double totalQueueMs;
+    double maxQueueMs;
+    double totalRunMs;
+    double maxRunMs;
+
+    std::future<MLResult> enqueue(Request&& request, InferencePriority priority, Ticket* ticket);
+    void loop();
+    static void* threadFunc(void* arg);
+
+public:
+    /**
+     * @brief Constructor
+     * @param ml Engine to own (deleted by the destructor)
+     * @param queueCapacity Waiting requests across both priorities
+     */
+    InferenceService(ML* ml, size_t queueCapacity);
+    ~InferenceService();
+
+    InferenceService(const InferenceService&) = delete;
+    InferenceService& operator=(const InferenceService&) = delete;
+
+    void start();   ///< Creates the worker thread
+    void stop();    ///< Cancels waiting requests, finishes the running one
+
+    /**
+     * @brief Queues a decoded frame (preprocessed on the worker)
+     * @param image BGR frame (shared, not copied)
+     * @param priority Request class
+     * @param[out] ticket Handle for cancel(), may be nullptr
+     * @return Future result
+     */
+    std::future<MLResult> submit(const cv::Mat& image, InferencePriority priority,
+                                 Ticket* ticket = nullptr);
+
+    /**
+     * @brief Queues a tensor from ML::prepareInput() (preprocessing done by the caller)
+     * @param tensor Model input, moved in
+     * @param greenRatio Green pixel ratio from prepareInput()
+     * @param priority Request class
+     * @param[out] ticket Handle for cancel(), may be nullptr
+     * @return Future result
+     */
+    std::future<MLResult> submitPrepared(std::vector<float>&& tensor, float greenRatio,
+                                         InferencePriority priority, Ticket* ticket = nullptr);
+
+    /**
+     * @brief Removes a request that has not started
+     * @param ticket Value returned through submit()
+     * @return true if it was still queued (its future gets InferenceCancelled)
+     */
+    bool cancel(Ticket ticket);
+
+    /**
+     * @brief Engine for preprocessing on the caller's thread (prepareInput()
+     *        and the static helpers are safe outside the worker)
+     */
+    ML* getEngine() const { return engine; }
+
+    /**
+     * @brief Copies the counters and queue depth
+     */
+    InferenceServiceStats getStats();
+};
+
+#endif // INFERENCESERVICE_H
@@ -0,0 +1,92 @@
+/**
+ * @file LiveClient.h
+ * @brief GUI Side of the Daemon Link (Live State + Control Socket)
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Middleware
+ *
+ * Maps the daemon's live-state segment read-only and keeps a subscribed
+ * control connection whose fd becomes readable for every published
+ * frame (the GUI watches it with a QSocketNotifier). Commands use a
+ * short-lived connection of their own so replies never interleave with
+ * notifications. After the daemon goes away, connect() can simply be
+ * called again; the GUI keeps running in the meantime.
+ */
+
+#ifndef LIVECLIENT_H
+#define LIVECLIENT_H
+
+/* ============================================================================
+ * System Includes
+ * ============================================================================ */
+#include <string>
+
+/* ============================================================================
+ * Middleware Includes
+ * ============================================================================ */
+#include "LiveState.h"
+
+/**
+ * @class LiveClient
+ * @brief Connection from the GUI process to leafsense-daemon
+ */
+class LiveClient {
+private:
+    std::string socketPath;
+    std::string shmName;
+    LiveState* state;       ///< Read-only mapping (kept across reconnects)
+    int eventFd;            ///< Subscribed connection, -1 when disconnected
+
+    static int openSocket(const std::string& path);
+
+public:
+    /**
+     * @param path Control socket (ipc.socket)
+     * @param shm Live-state segment (ipc.shm)
+     */
+    LiveClient(const std::string& path, const std::string& shm);
+    ~LiveClient();
+
+    LiveClient(const LiveClient&) = delete;
+    LiveClient& operator=(const LiveClient&) = delete;
+
+    /**
+     * @brief Maps the segment (once) and subscribes to frame notifications
+     * @return true if connected to a running daemon
+     */
+    bool connect();
+
+    /** @brief Closes the subscription (the mapping stays valid) */
+    void disconnect();
+
+    bool isConnected() const { return eventFd >= 0; }
+
+    /** @brief Readable on every published frame and when the daemon exits */
+    int getEventFd() const { return eventFd; }
+
+    /**
+     * @brief Consumes pending notifications
+     * @return false if the daemon closed the connection
+     */
+    bool drainEvents();
+
+    /**
+     * @brief Live snapshot of a zone (shared memory)
+     * @param zoneId zone_id column value
+     * @return Snapshot, or nullptr if the zone is not published
+     */
+    const SensorSnapshot* getSnapshot(int zoneId) const;
+
+    /** @brief Mapping for history access (nullptr before the first connect) */
+    const LiveState* getState() const { return state; }
+
+    /**
+     * @brief Sends one command and waits for its reply
+     * @param command Protocol line without newline (see ControlServer.h)
+     * @param[out] reply "OK", "OK|<fields>" or "ERR|..." (empty on timeout)
+     * @param timeoutMs Reply timeout (ANALYZE needs more than ml.request_timeout_ms)
+     * @return true if the reply was "OK" or started with "OK|"
+     */
+    bool sendCommand(const std::string& command, std::string& reply, int timeoutMs = 1000);
+};
+
+#endif // LIVECLIENT_H
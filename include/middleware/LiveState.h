@@ -0,0 +1,142 @@
+/**
+ * @file LiveState.h
+ * @brief Shared-Memory Live State (Daemon -> GUI)
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Middleware
+ *
+ * leafsense-daemon publishes every acquisition cycle into a POSIX
+ * shared-memory segment (ipc.shm, default /leafsense-live) so the GUI
+ * process reads live values without SQL and without sharing an address
+ * space with the control loop:
+ *
+ *   Segment: header | LiveZone[0] | ... | LiveZone[LIVE_MAX_ZONES-1]
+ *   LiveZone: SensorSnapshot (seqlock, latest frame)
+ *             + ring of the last LIVE_HISTORY frames (one seqlock per slot)
+ *
+ * The daemon is the only writer; readers never block it. The segment is
+ * reused across daemon restarts (same name and size), so a running GUI
+ * keeps a valid mapping; create() repairs any slot a crashed daemon left
+ * mid-write. Frame notifications travel over the control
+ * socket (see ControlServer.h).
+ */
+
+#ifndef LIVESTATE_H
+#define LIVESTATE_H
+
+/* ============================================================================
+ * System Includes
+ * ============================================================================ */
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* ============================================================================
+ * Middleware Includes
+ * ============================================================================ */
+#include "SensorSnapshot.h"
+#include "SeqLock.h"
+
+static const uint32_t LIVE_STATE_MAGIC = 0x4C534C56;   ///< "LSLV"
+static const uint32_t LIVE_STATE_VERSION = 3;          ///< Bump on layout change
+static const size_t LIVE_MAX_ZONES = 8;
+static const uint32_t LIVE_HISTORY = 256;              ///< Power of two
+
+/**
+ * @struct LiveZone
+ * @brief Latest frame and recent history of one zone (shared memory)
+ */
+struct LiveZone {
+    SensorSnapshot snapshot;                    ///< Latest frame and the zone's freshness limit
+    std::atomic<uint32_t> historyHead;          ///< Frames ever written to history
+    SeqLock<SensorFrame> history[LIVE_HISTORY];
+
+    /**
+     * @brief Copies the most recent frames, oldest first
+     * @param[out] frames Destination (cleared first)
+     * @param maxFrames Upper bound (at most LIVE_HISTORY)
+     * @return Number of frames copied
+     */
+    size_t readHistory(std::vector<SensorFrame>& frames, size_t maxFrames) const;
+};
+
+/**
+ * @struct LiveStateLayout
+ * @brief Contents of the shared-memory segment
+ */
+struct LiveStateLayout {
+    uint32_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> zoneCount;
+    std::atomic<int32_t> daemonPid;
+    std::atomic<uint64_t> frameCount;           ///< Frames published (all zones)
+    int32_t zoneIds[LIVE_MAX_ZONES];            ///< zone_id of each slot
+    LiveZone zones[LIVE_MAX_ZONES];
+};
+
+/**
+ * @class LiveState
+ * @brief Mapping of the live-state segment (writer or read-only)
+ */
+class LiveState {
+private:
+    LiveStateLayout* layout;
+    bool writer;
+    int notifyFd;        ///< eventfd signalled on publish (writer only)
+
+    LiveState(LiveStateLayout* mapped, bool isWriter, int fd);
+
+public:
+    ~LiveState();
+
+    LiveState(const LiveState&) = delete;
+    LiveState& operator=(const LiveState&) = delete;
+
+    /**
+     * @brief Creates (or reuses) and maps the segment for writing
+     * @param name POSIX shm name ("/leafsense-live")
+     * @return Mapping, or nullptr on failure
+     */
+    static LiveState* create(const std::string& name);
+
+    /**
+     * @brief Maps an existing segment read-only
+     * @param name POSIX shm name
+     * @return Mapping, or nullptr if absent or of another layout version
+     */
+    static LiveState* attach(const std::string& name);
+
+    /* ------------------------------------------------------------------------
+     * Writer Interface (daemon)
+     * ------------------------------------------------------------------------ */
+
+    /**
+     * @brief Assigns a zone to a slot and updates zoneCount
+     * @param index Zone slot
+     * @param zoneId zone_id column value
+     * @param maxAgeMs Age after which the zone's snapshot is stale
+     */
+    void setZone(size_t index, int zoneId, uint64_t maxAgeMs);
+
+    /**
+     * @brief Publishes a stamped frame to a zone's snapshot and history
+     * @param index Zone slot
+     * @param frame Frame as stored by the zone's own snapshot
+     */
+    void publish(size_t index, const SensorFrame& frame);
+
+    /** @brief Readable after publish(); the control server drains it */
+    int getNotifyFd() const { return notifyFd; }
+
+    /* ------------------------------------------------------------------------
+     * Reader Interface
+     * ------------------------------------------------------------------------ */
+    size_t getZoneCount() const;
+    int getZoneId(size_t index) const;
+    const LiveZone* getZone(size_t index) const;
+    uint64_t getFrameCount() const;
+    int getDaemonPid() const;
+};
+
+#endif // LIVESTATE_H
@@ -0,0 +1,333 @@
+/**
+ * @file Logger.h
+ * @brief Asynchronous Structured Logger
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Middleware
+ *
+ * Replaces std::cout/std::endl on hot paths. A log call only captures
+ * its arguments into a fixed-size record in the calling thread's own
+ * lock-free ring buffer (no formatting, no locks, no syscalls). A
+ * background thread merges the rings in time order, formats the
+ * records and writes them in batches to a size-rotated file.
+ *
+ * Usage (format placeholders are "{}", "{:x}" for hex integers):
+ *
+ *   LS_INFO("ADC", "Channel {}: Raw={}, Voltage={}V", ch, raw, v);
+ *
+ * - Levels: LS_DEBUG, LS_INFO, LS_WARN, LS_ERROR
+ * - Calls below LEAFSENSE_LOG_MIN_LEVEL are removed at compile time
+ *   (default: debug removed unless LEAFSENSE_LOG_DEBUG is defined)
+ * - Each call site is rate limited (log.rate_limit per second);
+ *   suppressed messages are counted and reported
+ * - log.file / log.max_size_kb / log.max_files control
+ *   output and rotation; without a writable file, stdout is used
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+/* ============================================================================
+ * System Includes
+ * ============================================================================ */
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <pthread.h>
+
+/**
+ * @enum LogLevel
+ * @brief Severity of a log record
+ */
+enum LogLevel {
+    LEVEL_DEBUG = 0,
+    LEVEL_INFO  = 1,
+    LEVEL_WARN  = 2,
+    LEVEL_ERROR = 3
+};
+
+#ifndef LEAFSENSE_LOG_MIN_LEVEL
+#ifdef LEAFSENSE_LOG_DEBUG
+#define LEAFSENSE_LOG_MIN_LEVEL 0
+#else
+#define LEAFSENSE_LOG_MIN_LEVEL 1
+#endif
+#endif
+
+/**
+ * @struct LogSite
+ * @brief Static per-call-site state (rate limiting)
+ */
+struct LogSite {
+    const char* file;
+    int line;
+    std::atomic<int64_t> windowSecond;   ///< Second the count belongs to
+    std::atomic<uint32_t> windowCount;   ///< Records accepted in that second
+    std::atomic<uint32_t> suppressed;    ///< Records dropped by the limit
+
+    LogSite(const char* f, int l)
+        : file(f), line(l), windowSecond(0), windowCount(0), suppressed(0) {}
+};
+
+/**
+ * @struct LogArg
+ * @brief One captured argument (formatted later)
+ */
+struct LogArg {
+    enum Type : uint8_t { INT, UINT, DOUBLE, STRING, CHAR, BOOL, POINTER };
+    Type type;
+    uint8_t strLen;      ///< STRING: bytes in the record's text area
+    uint16_t strOffset;  ///< STRING: offset in the record's text area
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+        const void* p;
+    };
+};
+
+/**
+ * @struct LogRecord
+ * @brief Fixed-size entry of a per-thread ring (no heap data)
+ */
+struct LogRecord {
+    static const int MAX_ARGS = 8;
+    static const int TEXT_SIZE = 96;
+
+    int64_t timestampNs;       ///< CLOCK_REALTIME
+    const char* tag;           ///< Component ("ADC", "tSig", ...), static storage
+    const char* format;        ///< Format string with "{}", static storage
+    uint32_t suppressed;       ///< Messages this site dropped before this one
+    uint8_t level;             ///< LogLevel
+    uint8_t argCount;
+    uint16_t textUsed;
+    LogArg args[MAX_ARGS];
+    char text[TEXT_SIZE];      ///< Copied string arguments
+};
+
+/**
+ * @class LogRing
+ * @brief Single-producer single-consumer ring of LogRecords
+ */
+class LogRing {
+public:
+    static const uint32_t CAPACITY = 256;   ///< Power of two
+
+private:
+    LogRecord slots[CAPACITY];
+    std::atomic<uint32_t> head;     ///< Next slot written (producer)
+    std::atomic<uint32_t> tail;     ///< Next slot read (consumer)
+
+public:
+    std::atomic<uint32_t> dropped;  ///< Records lost because the ring was full
+    std::atomic<bool> retired;      ///< Owner thread exited (freed once drained)
+
+    LogRing() : head(0), tail(0), dropped(0), retired(false) {}
+
+    /** @brief Slot to fill, or nullptr if full (producer only) */
+    LogRecord* beginWrite();
+    /** @brief Publishes the slot from beginWrite() */
+    void commitWrite();
+    /** @brief Oldest record, or nullptr if empty (consumer only) */
+    LogRecord* peek();
+    /** @brief Releases the record from peek() */
+    void pop();
+};
+
+/**
+ * @class Logger
+ * @brief Process-wide asynchronous logger (singleton)
+ */
+class Logger {
+private:
+    std::vector<LogRing*> rings;       ///< One per live thread that logged
+    pthread_mutex_t ringsMutex;        ///< Guards rings (registration/removal)
+    pthread_mutex_t wakeMutex;
+    pthread_cond_t wakeCond;
+    pthread_t writerThread;
+    std::atomic<bool> running;
+    std::atomic<int> minLevel;         ///< Runtime level (>= compile-time level)
+    uint32_t rateLimit;                ///< Records per site per second (0 = off)
+
+    /* ------------------------------------------------------------------------
+     * Output (writer thread only)
+     * ------------------------------------------------------------------------ */
+    std::string filePath;
+    int fd;
+    bool ownsFd;                       ///< fd is the log file (not stdout)
+    size_t fileSize;
+    size_t maxFileSize;
+    int maxFiles;
+    std::vector<LogRecord> batch;      ///< Records merged from all rings
+    std::string out;                   ///< Formatted batch
+
+    Logger();
+    ~Logger();
+
+    LogRing* threadRing();
+    bool admit(LogSite& site, int64_t nowNs, uint32_t& suppressedOut);
+    void drain();
+    void format(const LogRecord& rec);
+    void writeOut();
+    void openFile();
+    void rotate();
+
+    static void* writerFuncStatic(void* arg);
+    void writerFunc();
+
+    /* ------------------------------------------------------------------------
+     * Argument capture
+     * ------------------------------------------------------------------------ */
+    static void capture(LogRecord&) {}
+
+    template <typename T, typename... Rest>
+    static void capture(LogRecord& rec, const T& value, const Rest&... rest)
+    {
+        if (rec.argCount < LogRecord::MAX_ARGS) {
+            put(rec, rec.args[rec.argCount], value);
+            rec.argCount++;
+        }
+        capture(rec, rest...);
+    }
+
+    static void putText(LogRecord& rec, LogArg& arg, const char* s, size_t len);
+    static void put(LogRecord& rec, LogArg& arg, const char* s) { putText(rec, arg, s ? s : "(null)", s ? strlen(s) : 6); }
+    static void put(LogRecord& rec, LogArg& arg, char* s) { put(rec, arg, static_cast<const char*>(s)); }
+    static void put(LogRecord& rec, LogArg& arg, const std::string& s) { putText(rec, arg, s.data(), s.size()); }
+    static void put(LogRecord&, LogArg& arg, bool v) { arg.type = LogArg::BOOL; arg.i = v; }
+    static void put(LogRecord&, LogArg& arg, char v) { arg.type = LogArg::CHAR; arg.i = v; }
+
+    template <size_t N>
+    static void put(LogRecord& rec, LogArg& arg, const char (&s)[N]) { put(rec, arg, static_cast<const char*>(s)); }
+
+    template <typename T>
+    static void put(LogRecord&, LogArg& arg, const T& v)
+    {
+        if (std::is_floating_point<T>::value) {
+            arg.type = LogArg::DOUBLE;
+            arg.d = static_cast<double>(v);
+        } else if (std::is_enum<T>::value || std::is_signed<T>::value) {
+            arg.type = LogArg::INT;
+            arg.i = static_cast<int64_t>(v);
+        } else {
+            arg.type = LogArg::UINT;
+            arg.u = static_cast<uint64_t>(v);
+        }
+    }
+
+    template <typename T>
+    static void put(LogRecord&, LogArg& arg, T* p) { arg.type = LogArg::POINTER; arg.p = p; }
+
+public:
+    /**
+     * @brief Returns the logger (started on first use)
+     */
+    static Logger& instance();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * @brief Writes everything pending and stops the writer thread
+     *
+     * Later calls are formatted and written synchronously.
+     */
+    void shutdown();
+
+    bool enabled(int level) const { return level >= minLevel.load(std::memory_order_relaxed); }
+    void setLevel(int level) { minLevel = level; }
+
+    /**
+     * @brief Captures one record (called through the LS_* macros)
+     */
+    template <typename... Args>
+    void log(LogSite& site, int level, const char* tag, const char* fmt, const Args&... args)
+    {
+        LogRecord* rec = nullptr;
+        LogRing* ring = nullptr;
+        int64_t now = nowNs();
+        uint32_t suppressed = 0;
+        if (!admit(site, now, suppressed)) return;
+
+        LogRecord local;
+        bool async = running.load(std::memory_order_acquire);
+        if (async) {
+            ring = threadRing();
+            rec = ring->beginWrite();
+            if (!rec) {
+                ring->dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        } else {
+            rec = &local;
+        }
+
+        rec->timestampNs = now;
+        rec->tag = tag;
+        rec->format = fmt;
+        rec->suppressed = suppressed;
+        rec->level = static_cast<uint8_t>(level);
+        rec->argCount = 0;
+        rec->textUsed = 0;
+        capture(*rec, args...);
+
+        if (async) {
+            ring->commitWrite();
+            if (level >= LEVEL_ERROR) wake();
+        } else {
+            writeSync(*rec);
+        }
+    }
+
+    /**
+     * @brief Type-checks arguments of compiled-out calls (never called)
+     */
+    template <typename... Args>
+    static void discard(const char*, const char*, const Args&...) {}
+
+    static int64_t nowNs();
+
+private:
+    void wake();
+    void writeSync(const LogRecord& rec);
+};
+
+/* ============================================================================
+ * Logging Macros
+ * ============================================================================ */
+
+#define LS_LOG(level, tag, ...)                                              \
+    do {                                                                     \
+        if (Logger::instance().enabled(level)) {                             \
+            static LogSite ls_site_(__FILE__, __LINE__);                     \
+            Logger::instance().log(ls_site_, level, tag, __VA_ARGS__);       \
+        }                                                                    \
+    } while (0)
+
+#define LS_DISCARD(tag, ...) \
+    do { if (false) Logger::discard(tag, __VA_ARGS__); } while (0)
+
+#if LEAFSENSE_LOG_MIN_LEVEL <= 0
+#define LS_DEBUG(tag, ...) LS_LOG(LEVEL_DEBUG, tag, __VA_ARGS__)
+#else
+#define LS_DEBUG(tag, ...) LS_DISCARD(tag, __VA_ARGS__)
+#endif
+
+#if LEAFSENSE_LOG_MIN_LEVEL <= 1
+#define LS_INFO(tag, ...) LS_LOG(LEVEL_INFO, tag, __VA_ARGS__)
+#else
+#define LS_INFO(tag, ...) LS_DISCARD(tag, __VA_ARGS__)
+#endif
+
+#if LEAFSENSE_LOG_MIN_LEVEL <= 2
+#define LS_WARN(tag, ...) LS_LOG(LEVEL_WARN, tag, __VA_ARGS__)
+#else
+#define LS_WARN(tag, ...) LS_DISCARD(tag, __VA_ARGS__)
+#endif
+
+#define LS_ERROR(tag, ...) LS_LOG(LEVEL_ERROR, tag, __VA_ARGS__)
+
+#endif // LOGGER_H
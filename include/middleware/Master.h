@@ -8,13 +8,16 @@
  * Coordinates sensor reading, data logging, and actuator control
  * using POSIX threads with mutex/condition variable synchronization.
  * 
- * Thread Architecture:
- * - tTime: Heartbeat timer (2s interval)
- * - tSig: Signal dispatcher
- * - tReadSensors: Sensor polling and control logic
- * - tWaterHeater: Temperature control actuator
- * - tPHU/tPHD: pH Up/Down pump control
- * - tNutrients: Nutrient dosing pump control
+ * Thread Architecture (fixed, independent of the number of zones):
+ * - tTime: Heartbeat timer (5s interval)
+ * - tSig: Scheduler - advances every zone's sampling/camera schedule
+ * - tReadSensors: Sensor acquisition and control logic for all zones
+ * - tActuators: Heater and pump commands for all zones
+ * - tAdcEvents: ALERT/RDY event loop (only while an ADC is scanning)
+ * - CameraPipeline: capture / preprocess / inference / persist stages
+ *
+ * Zones are configured with "zones.count" and "zone.<id>.*" keys
+ * (see Zone.h); ADCs are shared between zones by I2C address.
  */
 
 #ifndef MASTER_H
@@ -25,27 +28,28 @@
  * ============================================================================ */
 #include <pthread.h>
 #include <unistd.h>
+#include <atomic>
+#include <map>
+#include <vector>
 
 /* ============================================================================
  * Middleware Includes
  * ============================================================================ */
 #include "MQueueHandler.h"
-#include "IdealConditions.h"
+#include "SensorSnapshot.h"
+#include "LiveState.h"
+#include "ControlServer.h"
+#include "CameraPipeline.h"
+#include "BoundedQueue.h"
+#include "Config.h"
+#include "Zone.h"
 
 /* ============================================================================
  * Driver Includes - Sensors
  * ============================================================================ */
-#include "drivers/sensors/Temp.h"
-#include "drivers/sensors/PH.h"
-#include "drivers/sensors/TDS.h"
+#include "drivers/sensors/I2CBus.h"
 #include "drivers/sensors/ADC.h"
-#include "drivers/sensors/Cam.h"
-
-/* ============================================================================
- * Driver Includes - Actuators
- * ============================================================================ */
-#include "drivers/actuators/Pumps.h"
-#include "drivers/actuators/Heater.h"
+#include "drivers/sensors/W1Bus.h"
 
 /* ============================================================================
  * Application Includes
@@ -66,52 +70,58 @@ private:
      * ------------------------------------------------------------------------ */
     MQueueHandler* msgQueue;     ///< Queue for database logging
     bool running;                ///< Thread run flag
-    bool sensorsCorrecting;      ///< Flag: correction in progress
-    int cameraCaptureCounter;    ///< Counter for periodic camera capture
-    int cameraCaptureInterval; ///< Camera capture interval in tSig activations (900 = 30 min)
-    int readSensorCD;            ///< Cooldown counter for sensor reading
-    int readSensorInterval; ///< Sensor read interval in tSig activations
+    static const int TICK_SECONDS = 5;  ///< tTime period (simulated time in sim mode)
+    int tickPeriodMs;            ///< Wall-clock tick period (shortened by sim.speed)
+    bool lockstep;               ///< Sim mode: a tick's reads and actuations finish before the next
 
     /* ------------------------------------------------------------------------
-     * Configuration
+     * Zones (one per reservoir, no threads of their own)
      * ------------------------------------------------------------------------ */
-    IdealConditions* idealConditions;  ///< Ideal parameter ranges
+    std::vector<Zone*> zones;              ///< All configured zones
+    I2CBus* i2cBus;                        ///< Shared /dev/i2c-1 (all I2C devices)
+    std::map<int, ADC*> adcBus;            ///< ADS1115 devices by I2C address (shared)
+    W1Bus* w1Bus;                          ///< 1-Wire master with every DS18B20
+    std::vector<Zone*> cameraZones;        ///< Zone owning each pipeline camera id
+    std::atomic<uint32_t> mlAlertZones;    ///< Bit per zone index with a bad ML class
 
     /* ------------------------------------------------------------------------
-     * Actuators
+     * Actuators (single worker for every zone)
      * ------------------------------------------------------------------------ */
-    Heater* heater;              ///< Water heater control
-    Pumps *phuPump;              ///< pH Up dosing pump
-    Pumps *phdPump;              ///< pH Down dosing pump
-    Pumps *nPump;                ///< Nutrient dosing pump
+    BoundedQueue<ActuatorCommand> actuatorQueue;  ///< Commands queued by zones
 
     /* ------------------------------------------------------------------------
-     * Sensors
+     * Machine Learning
      * ------------------------------------------------------------------------ */
-    ADC* adc;                    ///< Analog-to-Digital converter
-    Temp* tempSensor;            ///< DS18B20 temperature sensor
-    PH* phSensor;                ///< pH probe via ADC
-    TDS* tdsSensor;              ///< TDS/EC probe via ADC
-    Cam* camera;                 ///< USB camera for ML
-    ML* mlEngine;                ///< Machine Learning inference
+    ML* mlEngine;                ///< Machine Learning inference (owned by inferenceService)
+    InferenceService* inferenceService; ///< Only thread that runs the model
+    int analyzeTimeoutMs;        ///< ANALYZE command deadline (ml.request_timeout_ms)
+    int modelWatchMs;            ///< Model file poll period (ml.watch_interval_ms, 0 = off)
+    CameraPipeline* cameraPipeline; ///< Staged capture & ML analysis
+    InferenceCache* resultCache; ///< Results of repeated frames (nullptr = off)
 
     /* ------------------------------------------------------------------------
      * Thread Handles
      * ------------------------------------------------------------------------ */
     pthread_t tTime;             ///< Heartbeat timer thread
-    pthread_t tSig;              ///< Signal dispatcher thread
-    pthread_t tReadSensors;      ///< Sensor polling thread
-    pthread_t tCamera;           ///< Camera capture & ML thread
-    pthread_t tWaterHeater;      ///< Heater control thread
-    pthread_t tPHU;              ///< pH Up pump thread
-    pthread_t tPHD;              ///< pH Down pump thread
-    pthread_t tNutrients;        ///< Nutrient pump thread
+    pthread_t tSig;              ///< Scheduler for all zones
+    pthread_t tReadSensors;      ///< Acquisition for all zones
+    pthread_t tActuators;        ///< Actuator worker for all zones
+    pthread_t tAdcEvents;        ///< ADC conversion-ready events
+    bool adcEventsStarted;       ///< tAdcEvents was created
+    pthread_t tReload;           ///< MODEL|RELOAD worker (one at a time)
+    bool reloadStarted;          ///< tReload was created and not joined yet
+    std::atomic<bool> reloading; ///< tReload is still loading
+    bool reloadOk;               ///< Result of the last reload (valid once !reloading)
 
     /* ------------------------------------------------------------------------
      * Synchronization Primitives
      * ------------------------------------------------------------------------ */
-    pthread_mutex_t mutexRS, mutexTime, mutexN, mutexPHU, mutexPHD, mutexWH, mutexCam;
-    pthread_cond_t condRS, condTime, condN, condPHU, condPHD, condWH, condCam;
+    pthread_mutex_t mutexRS, mutexTime;
+    pthread_cond_t condRS, condTime;
+    pthread_cond_t condStep;     ///< Lockstep: read cycle or actuator fence done (mutexRS)
+    bool readRequested;          ///< tSig -> tReadSensors request (guarded by mutexRS)
+    bool readDone;               ///< Lockstep: requested read cycle finished (mutexRS)
+    bool fenceReached;           ///< Lockstep: tActuators got past the fence (mutexRS)
 
     /* ------------------------------------------------------------------------
      * Private Methods - Synchronization
@@ -120,6 +130,7 @@ private:
     void createConds();          ///< Initialize all condition variables
     void destroyMutexes();       ///< Destroy all mutexes
     void destroyConds();         ///< Destroy all condition variables
+    void finishStep(bool readsPending); ///< Lockstep: waits for the tick's reads and actuations
     
     /**
      * @brief Blocks until signal received
@@ -147,23 +158,44 @@ private:
     /**
      * @brief Controls alert LED based on ML classification
      * 
-     * Turns LED ON when bad class detected (Disease, Deficiency, Pest)
-     * Turns LED OFF when Healthy or OOD
-     * @param alertActive true to turn LED ON, false for OFF
+     * The LED is shared by all zones: ON while any zone's latest
+     * analysis is a bad class (Disease, Deficiency, Pest), OFF once
+     * every zone is Healthy or OOD.
+     * @param zoneIndex Index of the analysed zone
+     * @param alertActive true if this zone's latest result is a bad class
      */
-    void setMLAlertLED(bool alertActive);
+    void setMLAlertLED(size_t zoneIndex, bool alertActive);
     
     /**
      * @brief Generates recommendations based on ML prediction results
      * 
      * Creates specific treatment recommendations based on detected issues.
-     * Correlates ML predictions with current sensor readings for
+     * Correlates ML predictions with the cached sensor snapshot for
      * more accurate nutrient deficiency recommendations.
      * 
+     * @param zone Zone the image belongs to
      * @param mlResult The ML inference result with class and confidence
      * @param filename The image filename for database linking
      */
-    void generateMLRecommendation(const MLResult& mlResult, const std::string& filename);
+    void generateMLRecommendation(Zone* zone, const MLResult& mlResult, const std::string& filename);
+    
+    /**
+     * @brief Persist stage of the camera pipeline
+     * 
+     * Logs the image and prediction, drives the ML alert LED and
+     * generates recommendations. Runs on the pipeline's persist thread.
+     * 
+     * @param frame Analysed frame
+     */
+    void persistCameraFrame(const PipelineFrame& frame);
+
+    /**
+     * @brief Applies "adc.*" settings and starts continuous scanning
+     * 
+     * Requires the channels of every zone on this ADC to be enabled.
+     * @param adc Shared ADC to configure
+     */
+    void configureAdc(ADC* adc);
 
 public:
     /* ------------------------------------------------------------------------
@@ -184,29 +216,49 @@ public:
     void start();  ///< Creates and starts all threads
     void stop();   ///< Signals all threads to stop and joins them
 
+    /**
+     * @brief Gives read-only access to a zone's latest sensor frame
+     * @param zoneIndex Zone index (0 = first zone)
+     * @return Snapshot cache (lock-free, no hardware access), or nullptr
+     */
+    const SensorSnapshot* getSensorSnapshot(size_t zoneIndex = 0) const;
+
+    /**
+     * @brief Mirrors every zone's frames into shared memory (daemon)
+     * @param state Writable live state; call before start()
+     */
+    void attachLiveState(LiveState* state);
+
+    /**
+     * @brief Executes a control-socket command (see ControlServer.h)
+     * @param line THRESHOLDS|..., ACK_ALERTS[|zone], ACK_REC|file, ANALYZE|path, MODEL...
+     * @param[out] later Set for ANALYZE and MODEL|RELOAD: polled by the server until done
+     * @return "OK" or "ERR|<reason>" (empty when later is set)
+     */
+    std::string handleCommand(const std::string& line, ControlServer::PendingReply& later);
+
+    size_t getZoneCount() const { return zones.size(); }
+    Zone* getZone(size_t zoneIndex) { return zoneIndex < zones.size() ? zones[zoneIndex] : nullptr; }
+
     /* ------------------------------------------------------------------------
      * Static Thread Entry Points (pthread requires static)
      * ------------------------------------------------------------------------ */
     static void* tTimeFuncStatic(void* arg);
     static void* tSigFuncStatic(void* arg);
     static void* tReadSensorsFuncStatic(void* arg);
-    static void* tCameraFuncStatic(void* arg);
-    static void* tWaterHeaterFuncStatic(void* arg);
-    static void* tPHUFuncStatic(void* arg);
-    static void* tPHDFuncStatic(void* arg);
-    static void* tNutrientsFuncStatic(void* arg);
+    static void* tActuatorsFuncStatic(void* arg);
+    static void* tAdcEventsFuncStatic(void* arg);
+    static void* tReloadFuncStatic(void* arg);
 
     /* ------------------------------------------------------------------------
      * Thread Functions (Instance Methods)
      * ------------------------------------------------------------------------ */
-    void tTimeFunc();         ///< Heartbeat: triggers every 2s
-    void tSigFunc();          ///< Dispatcher: forwards time signal
-    void tReadSensorsFunc();  ///< Reads sensors, triggers actuators
-    void tCameraFunc();       ///< Camera capture & ML analysis
-    void tWaterHeaterFunc();  ///< Toggles heater state
-    void tPHUFunc();          ///< Doses pH Up solution
-    void tPHDFunc();          ///< Doses pH Down solution
-    void tNutrientsFunc();    ///< Doses nutrient solution
+    void tTimeFunc();         ///< Heartbeat: triggers every 5s
+    void tSigFunc();          ///< Scheduler: advances every zone's schedule
+    void tReadSensorsFunc();  ///< Acquires due sensors of every zone
+    void tActuatorsFunc();    ///< Executes actuator commands of every zone
+    void tAdcEventsFunc();    ///< Services ALERT/RDY edges of scanning ADCs
+    void tReloadFunc();       ///< Loads and warms up a new model (MODEL|RELOAD)
 };
 
 #endif // MASTER_H
\ No newline at end of file
@@ -0,0 +1,109 @@
+/**
+ * @file SensorLogFilter.h
+ * @brief Swinging-Door Compression of Sensor Rows
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Middleware
+ *
+ * Sits between acquisition and MQueueHandler and decides which frames
+ * become SENSOR rows. A frame is only written when one of the metrics
+ * can no longer be reconstructed, within its tolerance, by a straight
+ * line from the last written row (swinging door), when a sensor status
+ * changes, or when the heartbeat interval has elapsed.
+ *
+ * Every discarded reading lies within tolerance of the linear
+ * interpolation between the rows around it, so excursions are kept.
+ */
+
+#ifndef SENSORLOGFILTER_H
+#define SENSORLOGFILTER_H
+
+/* ============================================================================
+ * System Includes
+ * ============================================================================ */
+#include <vector>
+
+/* ============================================================================
+ * Middleware Includes
+ * ============================================================================ */
+#include "SensorSnapshot.h"
+
+/**
+ * @class SwingingDoor
+ * @brief Swinging-door state for a single metric
+ */
+class SwingingDoor {
+private:
+    float tolerance;       ///< Maximum reconstruction error
+    double pivotTime;      ///< Time of the last archived point (s)
+    float pivotValue;      ///< Value of the last archived point
+    double upperSlope;     ///< Smallest slope towards (v + tolerance)
+    double lowerSlope;     ///< Largest slope towards (v - tolerance)
+
+public:
+    explicit SwingingDoor(float tol = 0.0f);
+
+    void setTolerance(float tol) { tolerance = tol; }
+
+    /**
+     * @brief Restarts the door from an archived point
+     */
+    void reset(double time, float value);
+
+    /**
+     * @brief Offers a new point
+     * @return true if the door closed (the previous point must be archived);
+     *         the door is left unchanged in that case
+     */
+    bool offer(double time, float value);
+};
+
+/**
+ * @class SensorLogFilter
+ * @brief Row-level compression across temperature, pH and EC
+ *
+ * Used only by the acquisition thread (not thread-safe).
+ */
+class SensorLogFilter {
+private:
+    SwingingDoor tempDoor;
+    SwingingDoor phDoor;
+    SwingingDoor ecDoor;
+    int heartbeatSeconds;       ///< Maximum gap between written rows
+    bool enabled;               ///< false = write every frame
+
+    bool hasArchived;           ///< A row has been written
+    int64_t archivedEpoch;      ///< Wall-clock time of the last written row
+    SensorFrame archived;       ///< Last written row
+    bool hasHeld;               ///< held is a candidate not yet written
+    SensorFrame held;           ///< Most recent frame not yet written
+
+    void archive(const SensorFrame& frame, std::vector<SensorFrame>& out);
+    static double seconds(const SensorFrame& frame);
+
+public:
+    /**
+     * @brief Constructor
+     * @param tempTol Temperature tolerance (°C)
+     * @param phTol pH tolerance
+     * @param ecTol EC tolerance (ppm)
+     * @param heartbeatS Maximum seconds between rows
+     * @param enable false to pass every frame through
+     */
+    SensorLogFilter(float tempTol, float phTol, float ecTol, int heartbeatS, bool enable = true);
+
+    /**
+     * @brief Feeds one acquired frame
+     * @param frame Frame as published to the snapshot
+     * @param[out] out Frames to write, oldest first (0, 1 or 2 entries)
+     */
+    void process(const SensorFrame& frame, std::vector<SensorFrame>& out);
+
+    /**
+     * @brief Returns the pending frame so the last reading is not lost on shutdown
+     * @param[out] frame Frame to write
+     * @return false if nothing is pending
+     */
+    bool flush(SensorFrame& frame);
+};
+
+#endif // SENSORLOGFILTER_H
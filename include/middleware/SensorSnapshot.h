@@ -0,0 +1,129 @@
+/**
+ * @file SensorSnapshot.h
+ * @brief Timestamped Cache of the Latest Sensor Frame
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Middleware
+ *
+ * The sensor acquisition thread is the only component that talks to the
+ * I2C and 1-Wire hardware. After each read cycle it publishes a frame
+ * here; every other consumer (ML correlation, GUI, health score) reads
+ * the cached frame instead of triggering new bus transactions.
+ */
+
+#ifndef SENSORSNAPSHOT_H
+#define SENSORSNAPSHOT_H
+
+/* ============================================================================
+ * System Includes
+ * ============================================================================ */
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+
+/* ============================================================================
+ * Middleware Includes
+ * ============================================================================ */
+#include "SeqLock.h"
+
+/**
+ * @struct SensorFrame
+ * @brief One acquisition cycle worth of sensor values
+ *
+ * Status fields hold SensorStatus flags (see Sensor.h) describing
+ * whether the value came from hardware, a fallback, or mock mode.
+ *
+ * A simulated zone stamps acquiredAt* with the simulator's clock, so a
+ * faster-than-real-time run is logged at the times it models. Age
+ * checks always use publishedAtMs, which is real time in every zone.
+ */
+struct SensorFrame {
+    float temperature;          ///< Water temperature (°C)
+    float ph;                   ///< pH level
+    float ec;                   ///< EC/TDS (ppm)
+    float phRaw;                ///< pH before filtering (diagnostics)
+    float ecRaw;                ///< EC before filtering (diagnostics)
+    uint32_t tempStatus;        ///< Quality flags for temperature
+    uint32_t phStatus;          ///< Quality flags for pH
+    uint32_t ecStatus;          ///< Quality flags for EC
+    uint64_t acquiredAtMs;      ///< Acquisition time on the zone clock (ms, monotonic or simulated)
+    int64_t acquiredAtEpoch;    ///< Acquisition time (epoch seconds, wall clock or simulated)
+    uint64_t publishedAtMs;     ///< Publish time (CLOCK_MONOTONIC, ms), for freshness checks
+};
+
+/**
+ * @class SensorSnapshot
+ * @brief Lock-free latest-value store with age checking
+ *
+ * Single writer (acquisition thread), any number of readers.
+ */
+class SensorSnapshot {
+private:
+    SeqLock<SensorFrame> latest;   ///< Most recently published frame
+    std::atomic<uint64_t> maxAgeMs; ///< Writer's freshness limit (0 = not set)
+
+public:
+    SensorSnapshot() : maxAgeMs(0) {}
+
+    /* ------------------------------------------------------------------------
+     * Writer Interface
+     * ------------------------------------------------------------------------ */
+
+    /**
+     * @brief Publishes a new frame, stamping it with the current time
+     * @param frame Sensor values and status flags
+     */
+    void publish(SensorFrame frame);
+
+    /**
+     * @brief Publishes a new frame acquired at the given time
+     * @param frame Sensor values and status flags
+     * @param atMs Acquisition time on the zone clock (ms)
+     * @param atEpoch Acquisition time (epoch seconds)
+     */
+    void publish(SensorFrame frame, uint64_t atMs, int64_t atEpoch);
+
+    /**
+     * @brief Publishes a frame that already carries its timestamps
+     * @param frame Frame read from another snapshot (mirroring)
+     */
+    void republish(const SensorFrame& frame) { latest.store(frame); }
+
+    /**
+     * @brief Sets the age after which readers should treat the frame as stale
+     * @param ms Longest expected gap between publishes plus margin
+     */
+    void setMaxAgeMs(uint64_t ms) { maxAgeMs.store(ms, std::memory_order_release); }
+
+    /** @brief Repairs a frame a previous writer left half written (SeqLock::recover()) */
+    void recover() { latest.recover(); }
+
+    /* ------------------------------------------------------------------------
+     * Reader Interface
+     * ------------------------------------------------------------------------ */
+
+    /**
+     * @brief Reads the latest frame without any hardware access
+     * @param[out] frame Latest frame (left untouched if none published yet)
+     * @param maxAgeMs Maximum acceptable age in milliseconds
+     * @return true if a frame exists, could be copied and is not older than maxAgeMs
+     */
+    bool read(SensorFrame& frame, uint64_t maxAgeMs) const;
+
+    /**
+     * @brief Freshness limit published by the writer
+     * @return Milliseconds, 0 until the writer sets it
+     */
+    uint64_t getMaxAgeMs() const { return maxAgeMs.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Checks whether any frame has been published
+     */
+    bool hasData() const { return latest.version() > 0; }
+
+    /**
+     * @brief Current monotonic time in milliseconds
+     */
+    static uint64_t nowMs();
+};
+
+#endif // SENSORSNAPSHOT_H
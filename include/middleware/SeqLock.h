@@ -0,0 +1,127 @@
+/**
+ * @file SeqLock.h
+ * @brief Single-Writer Sequence Lock for Lock-Free Snapshot Sharing
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Middleware
+ *
+ * A sequence lock lets one writer publish a small, trivially copyable
+ * value while any number of readers copy it without taking a mutex.
+ * Readers retry if they observe a write in progress, so the writer
+ * is never blocked by a slow reader (e.g. the GUI thread). The retries
+ * are bounded: a writer that died mid-write (shared memory) cannot hang
+ * a reader.
+ */
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+/* ============================================================================
+ * System Includes
+ * ============================================================================ */
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @class SeqLock
+ * @brief Lock-free single-writer / multi-reader container
+ *
+ * The payload is stored as an array of relaxed atomic words so that
+ * concurrent reads and writes are well-defined. The layout contains no
+ * pointers and is safe to place in shared memory.
+ *
+ * @tparam T Trivially copyable payload type
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SeqLock payload must be trivially copyable");
+
+private:
+    static const size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    static const int MAX_RETRIES = 1000;  ///< Attempts before load() gives up
+
+    std::atomic<uint32_t> sequence;       ///< Odd while a write is in progress
+    std::atomic<uint64_t> words[WORDS];   ///< Payload storage
+
+public:
+    SeqLock() : sequence(0)
+    {
+        for (size_t i = 0; i < WORDS; i++) {
+            words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Publishes a new value (single writer only)
+     * @param value Value to publish
+     */
+    void store(const T& value)
+    {
+        uint64_t buffer[WORDS] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < WORDS; i++) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Completes a write a previous writer left half done (writer only)
+     *
+     * For a writer that takes over an existing shared-memory value: an odd
+     * sequence means the old writer died mid-write, so the payload is
+     * cleared and the sequence made even again.
+     */
+    void recover()
+    {
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        if (!(seq & 1)) return;
+        for (size_t i = 0; i < WORDS; i++) {
+            words[i].store(0, std::memory_order_relaxed);
+        }
+        sequence.store(seq + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copies the latest consistent value
+     * @param[out] value Destination (untouched if no consistent copy was made)
+     * @return Sequence number of the copied value (0 = never written, or
+     *         no consistent copy within MAX_RETRIES attempts)
+     */
+    uint32_t load(T& value) const
+    {
+        uint64_t buffer[WORDS];
+
+        for (int attempt = 0; attempt < MAX_RETRIES; attempt++) {
+            uint32_t before = sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;  // Writer active - retry
+            }
+            for (size_t i = 0; i < WORDS; i++) {
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint32_t after = sequence.load(std::memory_order_relaxed);
+            if (before == after) {
+                std::memcpy(&value, buffer, sizeof(T));
+                return before / 2;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Returns the number of completed writes
+     */
+    uint32_t version() const { return sequence.load(std::memory_order_acquire) / 2; }
+};
+
+#endif // SEQLOCK_H
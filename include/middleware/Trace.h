@@ -0,0 +1,143 @@
+/**
+ * @file Trace.h
+ * @brief Scoped Trace Spans (Chrome Trace / Perfetto Export)
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Middleware
+ *
+ * Measures where time goes inside a sensor or camera/ML cycle:
+ *
+ *   void ADC::readVoltage(...) {
+ *       LS_TRACE_SPAN("adc.convert");
+ *       ...
+ *   }
+ *
+ * A span records its start/end (CLOCK_MONOTONIC) into the calling
+ * thread's own ring buffer when its scope ends; the oldest spans are
+ * overwritten. Tracer::dump() writes every buffer as Chrome trace JSON,
+ * which loads in chrome://tracing or ui.perfetto.dev.
+ *
+ * - trace.enabled turns recording on at startup (default off)
+ * - trace.file is the dump path; SIGUSR1 requests a dump at runtime
+ * - When disabled, a span costs one load and one predictable branch
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/* ============================================================================
+ * System Includes
+ * ============================================================================ */
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+/**
+ * @struct TraceEvent
+ * @brief One completed span
+ */
+struct TraceEvent {
+    const char* name;   ///< Static storage
+    int64_t startNs;    ///< CLOCK_MONOTONIC
+    int64_t durNs;
+};
+
+/**
+ * @class TraceBuffer
+ * @brief Per-thread ring of completed spans (single writer)
+ */
+class TraceBuffer {
+public:
+    static const uint32_t CAPACITY = 4096;  ///< Power of two
+
+    TraceEvent events[CAPACITY];
+    std::atomic<uint32_t> head;     ///< Spans ever written
+    int tid;                        ///< Kernel thread id
+    char threadName[32];
+
+    TraceBuffer();
+
+    void record(const char* name, int64_t startNs, int64_t endNs)
+    {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        TraceEvent& e = events[h & (CAPACITY - 1)];
+        e.name = name;
+        e.startNs = startNs;
+        e.durNs = endNs - startNs;
+        head.store(h + 1, std::memory_order_release);
+    }
+};
+
+/**
+ * @class Tracer
+ * @brief Registry of trace buffers and JSON exporter (static)
+ */
+class Tracer {
+private:
+    static std::atomic<bool> active;
+    static std::vector<TraceBuffer*> buffers;   ///< One per live thread (freed on exit)
+    static pthread_mutex_t buffersMutex;        ///< Held by dump() while it reads buffers
+
+    friend struct ThreadTraceBuffer;
+
+public:
+    /** @brief Reads trace.enabled from Config */
+    static void configure();
+
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+    static void setEnabled(bool on) { active.store(on, std::memory_order_relaxed); }
+
+    /** @brief Calling thread's buffer (created on first use, freed when the thread exits) */
+    static TraceBuffer* threadBuffer();
+
+    /** @brief Names the calling thread in the trace ("tReadSensors", ...) */
+    static void setThreadName(const char* name);
+
+    /**
+     * @brief Writes all buffers as Chrome trace JSON
+     * @param path Output file (empty = trace.file)
+     * @return true on success
+     */
+    static bool dump(const std::string& path = "");
+
+    static int64_t nowNs();
+};
+
+/**
+ * @class TraceSpan
+ * @brief RAII span: records from construction to destruction
+ */
+class TraceSpan {
+private:
+    const char* name;
+    int64_t startNs;     ///< 0 = tracing was off at construction
+
+public:
+    explicit TraceSpan(const char* spanName)
+        : name(spanName)
+        , startNs(Tracer::enabled() ? Tracer::nowNs() : 0)
+    {}
+
+    ~TraceSpan()
+    {
+        if (startNs != 0) {
+            Tracer::threadBuffer()->record(name, startNs, Tracer::nowNs());
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+/* ============================================================================
+ * Tracing Macros
+ * ============================================================================ */
+
+#define LS_TRACE_CONCAT_(a, b) a##b
+#define LS_TRACE_CONCAT(a, b) LS_TRACE_CONCAT_(a, b)
+
+/** @brief Span covering the rest of the enclosing scope */
+#define LS_TRACE_SPAN(name) TraceSpan LS_TRACE_CONCAT(ls_span_, __LINE__)(name)
+
+#endif // TRACE_H
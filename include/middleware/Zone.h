@@ -0,0 +1,273 @@
+/**
+ * @file Zone.h
+ * @brief One Reservoir: Sensors, Actuators, Ideal Ranges and Schedule
+ * @author Daniel Cardoso, Marco Costa
+ * @layer Middleware
+ *
+ * A zone bundles everything that belongs to a single reservoir. Zones
+ * own no threads: Master's tSig advances every zone's schedule, one
+ * tReadSensors thread acquires for all zones, and one actuator thread
+ * executes the commands they queue. Adding a zone therefore adds no
+ * threads.
+ *
+ * Every database message sent by a zone is prefixed with "Z<id>|" so
+ * dDatabase can store the zone_id.
+ */
+
+#ifndef ZONE_H
+#define ZONE_H
+
+/* ============================================================================
+ * System Includes
+ * ============================================================================ */
+#include <atomic>
+#include <string>
+
+/* ============================================================================
+ * Middleware Includes
+ * ============================================================================ */
+#include "MQueueHandler.h"
+#include "IdealConditions.h"
+#include "SensorSnapshot.h"
+#include "LiveState.h"
+#include "AdaptiveSampler.h"
+#include "SensorLogFilter.h"
+#include "BoundedQueue.h"
+
+/* ============================================================================
+ * Driver Includes
+ * ============================================================================ */
+#include "drivers/sensors/Temp.h"
+#include "drivers/sensors/PH.h"
+#include "drivers/sensors/TDS.h"
+#include "drivers/sensors/ADC.h"
+#include "drivers/sensors/Cam.h"
+#include "drivers/sensors/ReservoirSim.h"
+#include "drivers/actuators/Heater.h"
+#include "drivers/actuators/Pumps.h"
+
+class Zone;
+
+/**
+ * @enum SampleMask
+ * @brief Sensors requested in one acquisition cycle
+ */
+enum SampleMask : unsigned int {
+    SAMPLE_TEMP = 1u << 0,
+    SAMPLE_PH   = 1u << 1,
+    SAMPLE_EC   = 1u << 2
+};
+
+/**
+ * @enum ActuatorKind
+ * @brief Actuators a zone can ask the actuator thread to switch
+ */
+enum ActuatorKind {
+    ACT_HEATER = 0,
+    ACT_PH_UP,
+    ACT_PH_DOWN,
+    ACT_NUTRIENTS
+};
+
+/**
+ * @struct ActuatorCommand
+ * @brief Work item for the shared actuator thread
+ */
+struct ActuatorCommand {
+    Zone* zone;          ///< Zone owning the actuator
+    ActuatorKind kind;   ///< Actuator to switch
+    bool on;             ///< Desired state
+};
+
+/**
+ * @struct ZoneConfig
+ * @brief Hardware mapping and schedule of one zone
+ *
+ * Read from Config keys "zone.<id>.*"; zone 1 defaults to the original
+ * single-reservoir wiring.
+ */
+struct ZoneConfig {
+    int id;                     ///< Zone id (1-based, stored as zone_id)
+    std::string name;           ///< Display name
+    int heaterPin;              ///< Heater GPIO (BCM)
+    int phUpPin;                ///< pH Up pump GPIO
+    int phDownPin;              ///< pH Down pump GPIO
+    int nutrientPin;            ///< Nutrient pump GPIO
+    int adcAddress;             ///< ADS1115 I2C address (may be shared)
+    int phChannel;              ///< ADC channel of the pH probe
+    int tdsChannel;             ///< ADC channel of the TDS probe
+    std::string tempAddress;    ///< DS18B20 1-Wire id ("auto" = first probe)
+    bool hasCamera;             ///< Zone has its own camera
+    int cameraIndex;            ///< Camera index (-1 = first found)
+    int cameraIntervalTicks;    ///< Ticks between captures
+    int tickSeconds;            ///< Scheduler period (s)
+    SamplingLimits tempLimits;  ///< Adaptive sampling for temperature
+    SamplingLimits phLimits;    ///< Adaptive sampling for pH
+    SamplingLimits ecLimits;    ///< Adaptive sampling for EC
+    FilterConfig phFilter;      ///< Noise filter chain for pH
+    FilterConfig ecFilter;      ///< Noise filter chain for EC
+    bool simulated;             ///< Probes and relays replaced by a ReservoirSim
+    ReservoirSimParams sim;     ///< Simulator constants ("sim.*")
+
+    /**
+     * @brief Builds the configuration of a zone from Config
+     * @param id Zone id
+     * @param tickSeconds Scheduler period used to convert seconds to ticks
+     */
+    static ZoneConfig fromConfig(int id, int tickSeconds);
+};
+
+/**
+ * @class Zone
+ * @brief Reservoir with its own sensors, actuators, ranges and schedule
+ */
+class Zone {
+private:
+    /* ------------------------------------------------------------------------
+     * Identity / Communication
+     * ------------------------------------------------------------------------ */
+    ZoneConfig config;
+    std::string prefix;                               ///< "Z<id>|"
+    MQueueHandler* msgQueue;                          ///< Database queue
+    BoundedQueue<ActuatorCommand>* actuatorQueue;     ///< Shared actuator thread
+
+    /* ------------------------------------------------------------------------
+     * Configuration
+     * ------------------------------------------------------------------------ */
+    IdealConditions* idealConditions;
+
+    /* ------------------------------------------------------------------------
+     * Hardware (ADC is owned by Master and may be shared between zones)
+     * ------------------------------------------------------------------------ */
+    Heater* heater;
+    Pumps* phuPump;
+    Pumps* phdPump;
+    Pumps* nPump;
+    Temp* tempSensor;
+    PH* phSensor;
+    TDS* tdsSensor;
+    Cam* camera;
+    int cameraId;                                     ///< CameraPipeline id, -1 if none
+    ReservoirSim* sim;                                ///< Simulated reservoir, nullptr on hardware
+    int64_t simEpochBase;                             ///< Epoch second of simulated time 0
+
+    /* ------------------------------------------------------------------------
+     * Schedule (advanced by tSig)
+     * ------------------------------------------------------------------------ */
+    AdaptiveSampler* tempSampler;
+    AdaptiveSampler* phSampler;
+    AdaptiveSampler* ecSampler;
+    std::atomic<unsigned int> pendingReads;           ///< SampleMask bits requested by tSig
+    int cameraCountdown;                              ///< Ticks until the next capture
+
+    /* ------------------------------------------------------------------------
+     * Acquisition State (tReadSensors only)
+     * ------------------------------------------------------------------------ */
+    SensorSnapshot sensorSnapshot;
+    uint64_t snapshotMaxAgeMs;
+    SensorLogFilter* sensorLogFilter;
+    LiveState* live;                                  ///< Shared-memory mirror (daemon), or nullptr
+    size_t liveIndex;                                 ///< Slot in the live state
+
+    void requestActuator(ActuatorKind kind, bool on);
+    void logSensorRow(const SensorFrame& frame);
+
+public:
+    /**
+     * @brief Constructor
+     * @param cfg Hardware mapping and schedule
+     * @param adc Shared ADC at cfg.adcAddress
+     * @param w1 Shared 1-Wire bus with the zone's probe
+     * @param queue Database message queue
+     * @param actuators Queue of the shared actuator thread
+     */
+    Zone(const ZoneConfig& cfg, ADC* adc, W1Bus* w1, MQueueHandler* queue,
+         BoundedQueue<ActuatorCommand>* actuators);
+    ~Zone();
+
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+    /* ------------------------------------------------------------------------
+     * Scheduler Interface (tSig)
+     * ------------------------------------------------------------------------ */
+
+    /**
+     * @brief Advances the zone's schedule by one tick
+     *
+     * Ends dosing pulses and marks the sensors that are due. A simulated
+     * reservoir advances by one tick of simulated time.
+     * @return true if the zone has sensors waiting to be read
+     */
+    bool tick();
+
+    /**
+     * @brief Advances the camera countdown
+     * @return true if a capture is due
+     */
+    bool cameraTick();
+
+    /* ------------------------------------------------------------------------
+     * Acquisition Interface (tReadSensors)
+     * ------------------------------------------------------------------------ */
+
+    /**
+     * @brief Checks whether the next acquire() reads the temperature
+     * @return true if a 1-Wire conversion is needed first (hardware zones)
+     */
+    bool isTempDue() const { return (pendingReads.load() & SAMPLE_TEMP) != 0; }
+
+    /**
+     * @brief Checks whether the probes are replaced by a ReservoirSim
+     * @return true if reads never touch the I2C or 1-Wire bus
+     */
+    bool isSimulated() const { return sim != nullptr; }
+
+    /**
+     * @brief Reads the due sensors, logs and runs the control logic
+     */
+    void acquire();
+
+    /**
+     * @brief Writes the row held back by compression (shutdown)
+     */
+    void flushLog();
+
+    /* ------------------------------------------------------------------------
+     * Actuator Interface (actuator thread)
+     * ------------------------------------------------------------------------ */
+    void actuate(const ActuatorCommand& cmd);
+
+    /* ------------------------------------------------------------------------
+     * Accessors
+     * ------------------------------------------------------------------------ */
+
+    /**
+     * @brief Sends a database message tagged with this zone
+     * @param msg Protocol message ("TAG|...")
+     */
+    void send(const std::string& msg);
+
+    /**
+     * @brief Reads the cached frame (no hardware access)
+     * @return true if the frame is fresh
+     */
+    bool readSnapshot(SensorFrame& frame) const;
+
+    int getId() const { return config.id; }
+    const std::string& getName() const { return config.name; }
+    Cam* getCamera() { return camera; }
+    int getCameraId() const { return cameraId; }
+    void setCameraId(int id) { cameraId = id; }
+    IdealConditions* getIdealConditions() { return idealConditions; }
+    const SensorSnapshot* getSensorSnapshot() const { return &sensorSnapshot; }
+
+    /**
+     * @brief Mirrors every published frame into shared memory
+     * @param state Live state of the daemon (set before start)
+     * @param index Zone slot
+     */
+    void setLiveState(LiveState* state, size_t index) { live = state; liveIndex = index; }
+};
+
+#endif // ZONE_H
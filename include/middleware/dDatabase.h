@@ -21,16 +21,9 @@ private:
     bool running;
 
     /**
-     * @brief Helper: Splits a string by a delimiter
-     * used to parse "TAG|DATA" messages
+     * @brief Adds the zones table and zone_id columns to older databases
      */
-    std::vector<std::string> split(const std::string& str, char delimiter);
-
-    /**
-     * @brief The "Translation Layer" (Section 4.5.11)
-     * Converts raw message strings into SQL commands
-     */
-    std::string translateToSQL(std::string rawMessage);
+    void migrateSchema();
 
 public:
     /**
@@ -42,6 +35,19 @@ public:
 
     ~dDatabase();
 
+    /**
+     * @brief Helper: Splits a string by a delimiter
+     * used to parse "TAG|DATA" messages
+     */
+    static std::vector<std::string> split(const std::string& str, char delimiter);
+
+    /**
+     * @brief The "Translation Layer" (Section 4.5.11)
+     * Converts raw message strings into SQL commands
+     * @return SQL statement, or "" for an unknown/malformed message
+     */
+    static std::string translateToSQL(std::string rawMessage);
+
     /**
      * @brief The Main Event Loop (Figure 63)
      * Continuous loop: Receive -> Translate -> Execute
@@ -19,10 +19,17 @@ dataset/
 
 Usage:
     python3 train_model.py --dataset ./dataset --epochs 20
+    python3 train_model.py --dataset ./dataset --epochs 20 --int8
+    python3 train_model.py --dataset ./dataset --quantize-only --output leafsense_model.onnx
+
+--int8 also writes <output>_int8.onnx: static INT8 quantization in QDQ
+format, calibrated on the validation set (onnx and onnxruntime packages
+required). Select it on the device with ml.variant = int8.
 """
 
 import os
 import argparse
+import random
 import torch
 import torch.nn as nn
 import torch.optim as optim
@@ -37,6 +44,7 @@ from datetime import datetime
 BATCH_SIZE = 32
 IMAGE_SIZE = 224
 NUM_WORKERS = 4
+CALIBRATION_SAMPLES = 300   # Validation images used to calibrate INT8 ranges
 
 # =============================================================================
 # Data Transforms
@@ -161,8 +169,103 @@ def export_to_onnx(model, output_path, device):
         dynamo=False
     )
     
+    tag_precision(output_path, "fp32")
     print(f"✓ Model exported to: {output_path}")
 
+def tag_precision(model_path, precision):
+    """Record the weight precision in the model metadata (read by ML.cpp)"""
+    try:
+        import onnx
+    except ImportError:
+        print("  (onnx not installed: precision tag skipped)")
+        return
+    
+    model = onnx.load(model_path)
+    for prop in list(model.metadata_props):
+        if prop.key == "leafsense.precision":
+            model.metadata_props.remove(prop)
+    entry = model.metadata_props.add()
+    entry.key = "leafsense.precision"
+    entry.value = precision
+    onnx.save(model, model_path)
+
+# =============================================================================
+# INT8 Quantization
+# =============================================================================
+
+def calibration_indices(dataset, count, seed=0):
+    """
+    Stratified, seeded subset of an ImageFolder.
+    
+    ImageFolder lists samples sorted by class, so the first N indices
+    would only cover the first class(es). Each class is shuffled with a
+    fixed seed and the classes are taken round-robin, so every class
+    contributes to the activation ranges and reruns pick the same images.
+    """
+    rng = random.Random(seed)
+    per_class = {}
+    for index, label in enumerate(dataset.targets):
+        per_class.setdefault(label, []).append(index)
+    pools = [per_class[label] for label in sorted(per_class)]
+    for pool in pools:
+        rng.shuffle(pool)
+    
+    chosen = []
+    while len(chosen) < count and any(pools):
+        for pool in pools:
+            if pool and len(chosen) < count:
+                chosen.append(pool.pop())
+    return chosen
+
+def export_int8(fp32_path, int8_path, calib_dataset, max_samples):
+    """
+    Static INT8 quantization in QDQ format.
+    
+    Activation ranges are calibrated on validation images with the same
+    transforms the device applies (resize, ImageNet normalization).
+    Weights are per-channel signed INT8, activations unsigned INT8: the
+    U8S8 combination ONNX Runtime accelerates on ARM64. Input and output
+    stay float, so ML.cpp binds both models the same way.
+    """
+    from onnxruntime.quantization import (CalibrationDataReader, CalibrationMethod,
+                                          QuantFormat, QuantType, quantize_static)
+    from onnxruntime.quantization.shape_inference import quant_pre_process
+    
+    class ValidationReader(CalibrationDataReader):
+        def __init__(self, dataset, count):
+            self.dataset = dataset
+            self.indices = iter(calibration_indices(dataset, count))
+        
+        def get_next(self):
+            index = next(self.indices, None)
+            if index is None:
+                return None
+            image, _ = self.dataset[index]
+            return {"input": image.unsqueeze(0).numpy()}
+    
+    samples = min(max_samples, len(calib_dataset))
+    print(f"Calibrating INT8 ranges on {samples} validation images "
+          f"({len(calib_dataset.classes)} classes, stratified)...")
+    
+    # Shape inference and graph cleanup make more nodes quantizable
+    prepared_path = fp32_path.replace('.onnx', '_prep.onnx')
+    quant_pre_process(fp32_path, prepared_path)
+    
+    quantize_static(
+        prepared_path,
+        int8_path,
+        ValidationReader(calib_dataset, samples),
+        quant_format=QuantFormat.QDQ,
+        per_channel=True,
+        activation_type=QuantType.QUInt8,
+        weight_type=QuantType.QInt8,
+        calibrate_method=CalibrationMethod.MinMax
+    )
+    os.remove(prepared_path)
+    
+    tag_precision(int8_path, "int8")
+    print(f"✓ INT8 model exported to: {int8_path}")
+
 # =============================================================================
 # Main Training Function
 # =============================================================================
@@ -182,6 +285,15 @@ def main(args):
     train_path = os.path.join(args.dataset, "train")
     val_path = os.path.join(args.dataset, "val")
     
+    int8_path = args.output.replace('.onnx', '_int8.onnx')
+    
+    if args.quantize_only:
+        # Quantize an existing export without training
+        calib_path = val_path if os.path.exists(val_path) else train_path
+        calib_dataset = datasets.ImageFolder(calib_path, transform=val_transforms)
+        export_int8(args.output, int8_path, calib_dataset, args.calib_samples)
+        return
+    
     if not os.path.exists(train_path):
         print(f"Error: Training data not found at {train_path}")
         print("\nPlease organize your dataset as:")
@@ -291,6 +403,14 @@ def main(args):
             f.write(cls + '\n')
     print(f"✓ Class names saved to: {class_file}")
     
+    if args.int8:
+        # Calibrate without training augmentation
+        if os.path.exists(val_path):
+            calib_dataset = val_dataset
+        else:
+            calib_dataset = datasets.ImageFolder(train_path, transform=val_transforms)
+        export_int8(args.output, int8_path, calib_dataset, args.calib_samples)
+    
     print("\n✓ Done! Copy the .onnx file to the build folder to use it.")
 
 # =============================================================================
@@ -308,6 +428,12 @@ if __name__ == "__main__":
                         help="Learning rate")
     parser.add_argument("--output", type=str, default="leafsense_model.onnx",
                         help="Output ONNX model path")
+    parser.add_argument("--int8", action="store_true",
+                        help="Also export a static INT8 (QDQ) model calibrated on the validation set")
+    parser.add_argument("--quantize-only", action="store_true",
+                        help="Skip training and quantize the existing --output model")
+    parser.add_argument("--calib-samples", type=int, default=CALIBRATION_SAMPLES,
+                        help="Validation images used for INT8 calibration")
     
     args = parser.parse_args()
     main(args)
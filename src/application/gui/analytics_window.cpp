@@ -561,6 +561,8 @@ void AnalyticsWindow::load_gallery_data()
             } else {
                 item.prediction_label = "No prediction";
             }
+            // Regions found by tiled inference
+            item.bounding_box = data_bridge->get_image_bounding_box(fileInfo.fileName());
             // Get recommendation text
             item.recommendation_text = data_bridge->get_image_recommendation(fileInfo.fileName());
             // Check if recommendation is acknowledged
@@ -613,21 +615,23 @@ void AnalyticsWindow::update_gallery_display()
         qDebug() << "[Gallery] Loaded image:" << item.filepath;
         QPixmap drawing = pixmap.copy();
 
-        // Draw bounding box if present
+        // Draw bounding boxes if present ("x,y,w,h;x,y,w,h")
         if (!item.bounding_box.isEmpty()) {
             QPainter painter(&drawing);
             QPen pen(Qt::red);
             pen.setWidth(5);
             painter.setPen(pen);
 
-            QStringList coords = item.bounding_box.split(",");
-            if (coords.size() == 4) {
-                painter.drawRect(
-                    coords[0].toInt(),
-                    coords[1].toInt(),
-                    coords[2].toInt(),
-                    coords[3].toInt()
-                );
+            for (const QString &box : item.bounding_box.split(";")) {
+                QStringList coords = box.split(",");
+                if (coords.size() == 4) {
+                    painter.drawRect(
+                        coords[0].toInt(),
+                        coords[1].toInt(),
+                        coords[2].toInt(),
+                        coords[3].toInt()
+                    );
+                }
             }
         }
 
@@ -12,6 +12,10 @@
  * ============================================================================ */
 #include "leafsense_data_bridge.h"
 #include "middleware/dbManager.h"
+#include "middleware/SensorSnapshot.h"
+#include "middleware/LiveClient.h"
+#include "middleware/Config.h"
+#include "theme/theme_manager.h"
 
 /* ============================================================================
  * Qt Framework Includes
@@ -19,6 +23,7 @@
 #include <QDateTime>
 #include <QDebug>
 #include <QCoreApplication>
+#include <QSocketNotifier>
 
 /* ============================================================================
  * Standard Library Includes
@@ -30,20 +35,29 @@
  * ============================================================================ */
 
 LeafSenseDataBridge::LeafSenseDataBridge(QObject *parent)
+    // Same file the backend writes (default: next to the executable)
+    : LeafSenseDataBridge(QString::fromStdString(Config::instance().getString("database.path",
+          (QCoreApplication::applicationDirPath() + "/leafsense.db").toStdString())), parent)
+{
+}
+
+LeafSenseDataBridge::LeafSenseDataBridge(const QString &db_path, QObject *parent)
     : QObject(parent)
     , update_timer(nullptr)
     , dbReader(nullptr)
+    , sensor_snapshot(nullptr)
+    , live_client(nullptr)
+    , live_notifier(nullptr)
+    , zone_id(1)
 {
     // IMPORTANT: Set C locale for numeric parsing
     // This ensures std::stod() uses '.' as decimal separator regardless of system locale.
     // Required for systems with Portuguese/European locale that use ',' as decimal separator.
     std::setlocale(LC_NUMERIC, "C");
 
-    // Database path relative to application executable
-    QString dbPath = QCoreApplication::applicationDirPath() + "/leafsense.db";
-    qDebug() << "[DataBridge] Opening database at:" << dbPath;
+    qDebug() << "[DataBridge] Opening database at:" << db_path;
     
-    dbReader = new dbManager(dbPath.toStdString());
+    dbReader = new dbManager(db_path.toStdString());
 }
 
 /**
@@ -52,6 +66,7 @@ LeafSenseDataBridge::LeafSenseDataBridge(QObject *parent)
  */
 LeafSenseDataBridge::~LeafSenseDataBridge()
 {
+    delete live_notifier;
     if (update_timer) {
         update_timer->stop();
         delete update_timer;
@@ -85,22 +100,167 @@ bool LeafSenseDataBridge::initialize()
     return true;
 }
 
+/**
+ * @brief Attaches the in-process sensor snapshot.
+ * @param snapshot Snapshot owned by Master, or nullptr.
+ * @author Daniel Cardoso, Marco Costa
+ */
+void LeafSenseDataBridge::set_sensor_snapshot(const SensorSnapshot *snapshot)
+{
+    sensor_snapshot = snapshot;
+}
+
+/**
+ * @brief Selects the zone whose readings are shown.
+ * @param id Zone id (zone_id column).
+ */
+void LeafSenseDataBridge::set_zone_id(int id)
+{
+    zone_id = id;
+    if (live_client && live_client->isConnected()) {
+        sensor_snapshot = live_client->getSnapshot(zone_id);
+    }
+    update_data();
+}
+
+/**
+ * @brief Lists the zones the daemon registered from its configuration.
+ * @return (id, name) pairs ordered by id.
+ */
+QVector<QPair<int, QString>> LeafSenseDataBridge::get_zones()
+{
+    QVector<QPair<int, QString>> zones;
+    DBResult res = dbReader->read("SELECT id, name FROM zones ORDER BY id;");
+    for (const auto &row : res.rows) {
+        if (row.size() < 2) continue;
+        try {
+            zones.append(qMakePair(std::stoi(row[0]), QString::fromStdString(row[1])));
+        } catch (...) {
+            qDebug() << "[DataBridge] Error parsing zone row";
+        }
+    }
+    return zones;
+}
+
+/* ============================================================================
+ * Daemon Link
+ * ============================================================================ */
+
+/**
+ * @brief Attaches the connection to leafsense-daemon.
+ * @param client Daemon link owned by main(), or nullptr.
+ */
+void LeafSenseDataBridge::set_live_client(LiveClient *client)
+{
+    disconnect_live();
+    live_client = client;
+    if (live_client && !connect_live()) {
+        qDebug() << "[DataBridge] Daemon not reachable, reading the database until it is";
+    }
+}
+
+/**
+ * @brief Subscribes to the daemon and switches live readings to shared memory.
+ * @return true if connected.
+ */
+bool LeafSenseDataBridge::connect_live()
+{
+    if (!live_client->connect()) return false;
+
+    sensor_snapshot = live_client->getSnapshot(zone_id);
+    live_notifier = new QSocketNotifier(live_client->getEventFd(), QSocketNotifier::Read, this);
+    connect(live_notifier, &QSocketNotifier::activated, this, &LeafSenseDataBridge::on_live_event);
+    qDebug() << "[DataBridge] Connected to leafsense-daemon";
+    return true;
+}
+
+/**
+ * @brief Drops the daemon subscription; readings fall back to the database.
+ */
+void LeafSenseDataBridge::disconnect_live()
+{
+    if (live_notifier) {
+        // May run inside the notifier's own slot
+        live_notifier->setEnabled(false);
+        live_notifier->deleteLater();
+        live_notifier = nullptr;
+    }
+    if (live_client) {
+        live_client->disconnect();
+    }
+    sensor_snapshot = nullptr;
+}
+
+/**
+ * @brief Pushes a new frame to the widgets as soon as the daemon announces it.
+ */
+void LeafSenseDataBridge::on_live_event()
+{
+    if (!live_client->drainEvents()) {
+        qDebug() << "[DataBridge] leafsense-daemon disconnected";
+        disconnect_live();
+        return;
+    }
+    emit sensor_data_updated(get_sensor_data());
+}
+
+/**
+ * @brief Sends the ideal ranges to the daemon controlling this zone.
+ * @param params Ranges from the settings window.
+ * @return true if the daemon applied them.
+ */
+bool LeafSenseDataBridge::apply_thresholds(const SensorParameters &params)
+{
+    if (!live_client || !live_client->isConnected()) return false;
+
+    QString command = QString("THRESHOLDS|%1|%2|%3|%4|%5|%6|%7")
+        .arg(zone_id)
+        .arg(params.temp_min).arg(params.temp_max)
+        .arg(params.ph_min).arg(params.ph_max)
+        .arg(params.ec_min).arg(params.ec_max);
+
+    std::string reply;
+    bool ok = live_client->sendCommand(command.toStdString(), reply);
+    if (!ok) {
+        qWarning() << "[DataBridge] Thresholds rejected:" << QString::fromStdString(reply);
+    }
+    return ok;
+}
+
 /* ============================================================================
  * Real-Time Data Retrieval
  * ============================================================================ */
 
 /**
- * @brief Retrieves the latest sensor data from the database.
+ * @brief Retrieves the latest sensor data.
  * @return SensorData struct with latest readings.
  * @author Daniel Cardoso, Marco Costa
+ * 
+ * Reads the live snapshot when available (no SQL, no hardware access);
+ * otherwise queries the most recent row from the database.
  */
 SensorData LeafSenseDataBridge::get_sensor_data()
 {
     SensorData data{0, 0, 0, "--:--", false};
 
-    // Query latest sensor reading from database view
-    DBResult res = dbReader->read(
-        "SELECT temperature, ph, ec, timestamp FROM vw_latest_sensor_reading;");
+    // Frames older than the zone's slowest sampling interval (plus margin,
+    // published by the writer) are treated as missing
+    SensorFrame frame;
+    if (sensor_snapshot && sensor_snapshot->read(frame, sensor_snapshot->getMaxAgeMs())) {
+        data.temperature = frame.temperature;
+        data.ph = frame.ph;
+        data.ec = frame.ec;
+        // Same format/timezone as SQLite CURRENT_TIMESTAMP
+        data.last_update_time = QDateTime::fromSecsSinceEpoch(frame.acquiredAtEpoch, Qt::UTC)
+                                    .toString("yyyy-MM-dd HH:mm:ss");
+        data.is_valid = true;
+        return data;
+    }
+
+    // Query latest sensor reading of this zone
+    DBResult res = dbReader->read(QString(
+        "SELECT temperature, ph, ec, timestamp FROM sensor_readings "
+        "WHERE zone_id = %1 ORDER BY timestamp DESC LIMIT 1;").arg(zone_id).toStdString());
 
     qDebug() << "[DataBridge] Query returned" << res.rows.size() << "rows";
 
@@ -139,9 +299,10 @@ SystemAlert LeafSenseDataBridge::get_latest_alert()
 {
     SystemAlert alert{"System OK", "No active alerts", PlantHealthStatus::HEALTHY, ""};
 
-    // Query latest unread alert
-    DBResult res = dbReader->read(
-        "SELECT type, message, timestamp FROM vw_unread_alerts LIMIT 1;");
+    // Query latest unread alert of this zone
+    DBResult res = dbReader->read(QString(
+        "SELECT type, message, timestamp FROM vw_unread_alerts "
+        "WHERE zone_id = %1 LIMIT 1;").arg(zone_id).toStdString());
 
     if (!res.rows.empty()) {
         alert.title = QString::fromStdString(res.rows[0][0]);
@@ -205,10 +366,11 @@ HealthAssessment LeafSenseDataBridge::get_health_assessment()
         }
     }
     
-    // Check latest ML prediction from database
-    DBResult mlRes = dbReader->read(
-        "SELECT prediction_label, confidence FROM ml_predictions "
-        "ORDER BY id DESC LIMIT 1;");
+    // Check latest ML prediction of this zone's camera
+    DBResult mlRes = dbReader->read(QString(
+        "SELECT mp.prediction_label, mp.confidence FROM ml_predictions mp "
+        "JOIN plant_images pi ON mp.image_id = pi.id "
+        "WHERE pi.zone_id = %1 ORDER BY mp.id DESC LIMIT 1;").arg(zone_id).toStdString());
     
     if (!mlRes.rows.empty()) {
         QString prediction = QString::fromStdString(mlRes.rows[0][0]);
@@ -258,8 +420,9 @@ QVector<DailySensorSummary> LeafSenseDataBridge::get_sensor_history(int days)
     QVector<DailySensorSummary> history;
 
     // First, try to get daily aggregated summaries
-    DBResult res = dbReader->read(
-        "SELECT day, avg_temp, avg_ph, avg_ec FROM vw_daily_sensor_summary LIMIT 30;");
+    DBResult res = dbReader->read(QString(
+        "SELECT day, avg_temp, avg_ph, avg_ec FROM vw_daily_sensor_summary "
+        "WHERE zone_id = %1 LIMIT 30;").arg(zone_id).toStdString());
 
     qDebug() << "[DataBridge] Daily summary query returned" << res.rows.size() << "rows";
 
@@ -271,8 +434,9 @@ QVector<DailySensorSummary> LeafSenseDataBridge::get_sensor_history(int days)
         QString query = QString(
             "SELECT timestamp, temperature, ph, ec "
             "FROM sensor_readings "
+            "WHERE zone_id = %2 "
             "ORDER BY timestamp DESC "
-            "LIMIT %1;").arg(days);
+            "LIMIT %1;").arg(days).arg(zone_id);
         
         res = dbReader->read(query.toStdString());
         qDebug() << "[DataBridge] Individual readings query returned" << res.rows.size() << "rows";
@@ -293,26 +457,121 @@ QVector<DailySensorSummary> LeafSenseDataBridge::get_sensor_history(int days)
             }
         }
     } else {
-        // Use daily summaries from the view
+        // Rows are compressed, so a plain AVG() over them is biased towards
+        // busy periods. Average the interpolated signal instead (time-weighted).
         for (const auto &row : res.rows) {
-            if (row.size() >= 4) {
-                try {
-                    DailySensorSummary summary;
-                    summary.date = QString::fromStdString(row[0]);
-                    summary.avg_temp = std::stod(row[1]);
-                    summary.avg_ph = std::stod(row[2]);
-                    summary.avg_ec = std::stod(row[3]);
-                    history.append(summary);
-                } catch (...) {
-                    qDebug() << "[DataBridge] Error parsing history row";
-                }
+            if (row.size() < 1) continue;
+
+            QDateTime dayStart = QDateTime::fromString(
+                QString::fromStdString(row[0]), "yyyy-MM-dd");
+            dayStart.setTimeSpec(Qt::UTC);
+            if (!dayStart.isValid()) continue;
+
+            qint64 from = dayStart.toSecsSinceEpoch();
+            QVector<SensorSample> samples =
+                get_interpolated_series(from, from + 86400 - 1, HISTORY_STEP_SECONDS);
+            if (samples.isEmpty()) continue;
+
+            DailySensorSummary summary;
+            summary.date = QString::fromStdString(row[0]);
+            summary.avg_temp = 0.0;
+            summary.avg_ph = 0.0;
+            summary.avg_ec = 0.0;
+            for (const auto &sample : samples) {
+                summary.avg_temp += sample.temp;
+                summary.avg_ph += sample.ph;
+                summary.avg_ec += sample.ec;
             }
+            summary.avg_temp /= samples.size();
+            summary.avg_ph /= samples.size();
+            summary.avg_ec /= samples.size();
+            history.append(summary);
         }
     }
 
     return history;
 }
 
+/**
+ * @brief Rebuilds the sensor signal on a regular grid from compressed rows.
+ * @param from_epoch Window start (UTC seconds).
+ * @param to_epoch Window end (UTC seconds).
+ * @param step_seconds Grid spacing in seconds.
+ * @return Interpolated samples (grid points with no surrounding rows are skipped).
+ * @author Daniel Cardoso, Marco Costa
+ */
+QVector<SensorSample> LeafSenseDataBridge::get_interpolated_series(qint64 from_epoch,
+                                                                   qint64 to_epoch,
+                                                                   int step_seconds)
+{
+    QVector<SensorSample> series;
+    if (step_seconds <= 0 || to_epoch < from_epoch) return series;
+
+    // Include the stored row just before and just after the window so the
+    // edges can be interpolated too
+    QString query = QString(
+        "SELECT CAST(strftime('%s', timestamp) AS INTEGER), temperature, ph, ec "
+        "FROM sensor_readings "
+        "WHERE zone_id = %3 "
+        "  AND timestamp >= IFNULL((SELECT MAX(timestamp) FROM sensor_readings "
+        "                           WHERE zone_id = %3 AND timestamp <= datetime(%1, 'unixepoch')), "
+        "                          datetime(%1, 'unixepoch')) "
+        "  AND timestamp <= IFNULL((SELECT MIN(timestamp) FROM sensor_readings "
+        "                           WHERE zone_id = %3 AND timestamp >= datetime(%2, 'unixepoch')), "
+        "                          datetime(%2, 'unixepoch')) "
+        "ORDER BY timestamp ASC;").arg(from_epoch).arg(to_epoch).arg(zone_id);
+
+    DBResult res = dbReader->read(query.toStdString());
+
+    QVector<SensorSample> points;
+    for (const auto &row : res.rows) {
+        if (row.size() < 4) continue;
+        try {
+            SensorSample point;
+            point.epoch = std::stoll(row[0]);
+            point.temp = std::stod(row[1]);
+            point.ph = std::stod(row[2]);
+            point.ec = std::stod(row[3]);
+            points.append(point);
+        } catch (...) {
+            qDebug() << "[DataBridge] Error parsing reading row";
+        }
+    }
+    if (points.isEmpty()) return series;
+
+    // Rows are at most one heartbeat apart while the backend is running
+    qint64 maxGap = 2LL * Config::instance().getInt("logging.heartbeat_s", 900);
+
+    int seg = 0;
+    for (qint64 t = from_epoch; t <= to_epoch; t += step_seconds) {
+        while (seg + 1 < points.size() && points[seg + 1].epoch < t) {
+            seg++;
+        }
+
+        const SensorSample &a = points[seg];
+        if (t == a.epoch) {
+            SensorSample exact = a;
+            series.append(exact);
+            continue;
+        }
+        if (seg + 1 >= points.size() || t < a.epoch) continue;  // No extrapolation
+
+        const SensorSample &b = points[seg + 1];
+        qint64 span = b.epoch - a.epoch;
+        if (span <= 0 || span > maxGap) continue;
+
+        double w = double(t - a.epoch) / double(span);
+        SensorSample sample;
+        sample.epoch = t;
+        sample.temp = a.temp + (b.temp - a.temp) * w;
+        sample.ph = a.ph + (b.ph - a.ph) * w;
+        sample.ec = a.ec + (b.ec - a.ec) * w;
+        series.append(sample);
+    }
+
+    return series;
+}
+
 /* ============================================================================
  * Image Prediction Retrieval
  * ============================================================================ */
@@ -346,6 +605,31 @@ QString LeafSenseDataBridge::get_image_prediction(const QString &filename)
     return QString();
 }
 
+/**
+ * @brief Gets the bounding boxes of the latest ML prediction for an image.
+ * @param filename The image filename (not full path).
+ * @return Boxes as "x,y,w,h;...", or empty if the prediction has none.
+ * @author Daniel Cardoso, Marco Costa
+ */
+QString LeafSenseDataBridge::get_image_bounding_box(const QString &filename)
+{
+    QString query = QString(
+        "SELECT p.bounding_box "
+        "FROM ml_predictions p "
+        "JOIN plant_images i ON p.image_id = i.id "
+        "WHERE i.filename = '%1' "
+        "ORDER BY p.predicted_at DESC LIMIT 1;"
+    ).arg(filename);
+    
+    DBResult res = dbReader->read(query.toStdString());
+    
+    if (!res.rows.empty() && !res.rows[0].empty()) {
+        return QString::fromStdString(res.rows[0][0]);
+    }
+    
+    return QString();
+}
+
 /**
  * @brief Gets the ML recommendation text for an image.
  * @param filename Name of the image file
@@ -377,15 +661,23 @@ QString LeafSenseDataBridge::get_image_recommendation(const QString &filename)
  * ============================================================================ */
 
 /**
- * @brief Marks all alerts as read in the database.
+ * @brief Marks all alerts of the selected zone as read in the database.
  * @return true if operation succeeded.
  * @author Daniel Cardoso, Marco Costa
  */
 bool LeafSenseDataBridge::mark_alerts_as_read()
 {
-    bool success = dbReader->execute("UPDATE alerts SET is_read = 1 WHERE is_read = 0;");
+    // The daemon owns the database while it runs
+    std::string reply;
+    if (live_client && live_client->isConnected()) {
+        return live_client->sendCommand("ACK_ALERTS|" + std::to_string(zone_id), reply);
+    }
+
+    bool success = dbReader->execute(QString(
+        "UPDATE alerts SET is_read = 1 WHERE is_read = 0 AND zone_id = %1;")
+        .arg(zone_id).toStdString());
     if (success) {
-        qDebug() << "[DataBridge] All alerts marked as read";
+        qDebug() << "[DataBridge] Alerts of zone" << zone_id << "marked as read";
     }
     return success;
 }
@@ -397,7 +689,8 @@ bool LeafSenseDataBridge::mark_alerts_as_read()
  */
 bool LeafSenseDataBridge::has_unread_alerts()
 {
-    DBResult res = dbReader->read("SELECT COUNT(*) FROM alerts WHERE is_read = 0;");
+    DBResult res = dbReader->read(QString(
+        "SELECT COUNT(*) FROM alerts WHERE is_read = 0 AND zone_id = %1;").arg(zone_id).toStdString());
     if (!res.rows.empty() && !res.rows[0].empty()) {
         return std::stoi(res.rows[0][0]) > 0;
     }
@@ -412,6 +705,11 @@ bool LeafSenseDataBridge::has_unread_alerts()
  */
 bool LeafSenseDataBridge::acknowledge_recommendation(const QString &filename)
 {
+    std::string reply;
+    if (live_client && live_client->isConnected()) {
+        return live_client->sendCommand("ACK_REC|" + filename.toStdString(), reply);
+    }
+
     // Update ml_recommendations.user_acknowledged = 1 for this image
     // Join through ml_predictions -> plant_images to find by filename
     QString sql = QString(
@@ -472,6 +770,11 @@ QString LeafSenseDataBridge::get_current_time()
  */
 void LeafSenseDataBridge::update_data()
 {
+    // Daemon restarted or started after the GUI
+    if (live_client && !live_client->isConnected()) {
+        connect_live();
+    }
+
     // Emit signals with latest data (connected widgets will update)
     emit sensor_data_updated(get_sensor_data());
     emit health_updated(get_health_assessment());
@@ -6,6 +6,7 @@
 #include "../include/application/gui/logs_window.h"
 #include "../include/application/gui/theme/theme_manager.h"
 #include "middleware/dbManager.h"
+#include "middleware/Config.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QApplication>
@@ -155,7 +156,7 @@ void LogsWindow::load_logs()
     
     // Open database connection
     QString dbPath = QCoreApplication::applicationDirPath() + "/leafsense.db";
-    dbManager db(dbPath.toStdString());
+    dbManager db(Config::instance().getString("database.path", dbPath.toStdString()));
     
     // Load from logs table - maps log_type to our display categories
     // Database log_type: 'Disease', 'Deficiency', 'Maintenance', 'ML Analysis'
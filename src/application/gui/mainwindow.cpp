@@ -70,6 +70,7 @@ MainWindow::MainWindow(QWidget *parent)
     if (!data_bridge->initialize()) {
         qWarning() << "Failed to initialize LeafSense data bridge";
     }
+    setup_zone_selector();
 
     // Defer theme application to ensure all widgets are ready
     QTimer::singleShot(0, this, &MainWindow::apply_theme_deferred);
@@ -119,8 +120,14 @@ void MainWindow::setup_ui()
     plant_font.setBold(true);
     plant_name_label->setFont(plant_font);
 
+    // Zone selector (filled from the database once the bridge is up)
+    zone_selector = new QComboBox();
+    zone_selector->setMaximumWidth(110);
+    zone_selector->setVisible(false);
+
     header_layout->addWidget(logo_label, 0);
     header_layout->addWidget(plant_name_label, 0);
+    header_layout->addWidget(zone_selector, 0);
     header_layout->addStretch();
 
     // Time display
@@ -214,6 +221,31 @@ void MainWindow::setup_connections()
             this, &MainWindow::on_time_updated);
 }
 
+void MainWindow::setup_zone_selector()
+{
+    /**
+     * @brief Lists the controller's zones; the selector only shows with more than one.
+     */
+    QVector<QPair<int, QString>> zones = data_bridge->get_zones();
+    for (const auto &zone : zones) {
+        zone_selector->addItem(zone.second, zone.first);
+    }
+    zone_selector->setCurrentIndex(zone_selector->findData(data_bridge->get_zone_id()));
+    zone_selector->setVisible(zones.size() > 1);
+    connect(zone_selector, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::on_zone_selected);
+}
+
+void MainWindow::on_zone_selected(int index)
+{
+    /**
+     * @brief Switches readings, alerts and health to the selected zone.
+     * @param index Selector row
+     */
+    if (!data_bridge || index < 0) return;
+    data_bridge->set_zone_id(zone_selector->itemData(index).toInt());
+}
+
 /* ============================================================================
  * Theme Management
  * ============================================================================ */
@@ -424,6 +456,28 @@ void MainWindow::set_selected_plant(const Plant &plant)
     plant_name_label->setText(plant.name);
 }
 
+void MainWindow::set_sensor_snapshot(const SensorSnapshot *snapshot)
+{
+     /**
+      * @brief Routes live sensor readings from the backend snapshot.
+      * @param snapshot Snapshot owned by Master
+      */
+    if (data_bridge) {
+        data_bridge->set_sensor_snapshot(snapshot);
+    }
+}
+
+void MainWindow::set_live_client(LiveClient *client)
+{
+     /**
+      * @brief Routes live readings and commands through leafsense-daemon.
+      * @param client Daemon link owned by main()
+      */
+    if (data_bridge) {
+        data_bridge->set_live_client(client);
+    }
+}
+
 /* ============================================================================
  * Navigation Button Handlers
  * ============================================================================ */
@@ -449,6 +503,8 @@ void MainWindow::on_settings_button_clicked()
         if (before != ThemeManager::instance().get_current_theme()) {
             reload_logo_for_theme();
         }
+        // No-op unless the controller runs in leafsense-daemon
+        data_bridge->apply_thresholds(ThemeManager::instance().get_sensor_parameters());
     }
 }
 
@@ -0,0 +1,429 @@
+/**
+ * @file ImageKernels.cpp
+ * @brief Implementation of the Fused Pixel Kernels
+ */
+
+#include "ImageKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define LS_SIMD_NEON 1
+#elif defined(__AVX2__) && defined(__FMA__)
+    #include <immintrin.h>
+    #define LS_SIMD_AVX2 1
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+    #define LS_SIMD_SSE2 1
+#endif
+
+/* ============================================================================
+ * Constants
+ * ============================================================================ */
+
+// ImageNet statistics in output (RGB) order
+static const float IMAGENET_MEAN[3] = { 0.485f, 0.456f, 0.406f };
+static const float IMAGENET_STD[3] = { 0.229f, 0.224f, 0.225f };
+
+// Plant colours in OpenCV 8-bit HSV units: H 20-85 (yellow-green to
+// green, H = degrees / 2), S >= 30, V >= 30 (S and V scaled to 0-255).
+// OpenCV rounds H and S before comparing, hence the half-unit margins.
+static const float GREEN_MIN_SAT = 29.5f;
+static const float GREEN_MIN_VAL = 30.0f;
+// H >= 20 where R is the maximum: H = 30 * (g - b) / d >= 19.5
+static const float GREEN_HUE_LO = 19.5f / 30.0f;
+// H <= 85 where G is the maximum: H = 60 + 30 * (b - r) / d < 85.5
+static const float GREEN_HUE_HI = 25.5f / 30.0f;
+
+/* ============================================================================
+ * Sampling Tables
+ * ============================================================================ */
+
+/**
+ * @brief Source index and weight for one output coordinate
+ *
+ * Pixel-centre mapping of cv::resize(INTER_LINEAR), clamped at the edges.
+ */
+struct LinearTap {
+    int i0;
+    int i1;
+    float w;
+};
+
+static LinearTap linearTap(int dst, int srcSize, float scale)
+{
+    float f = (dst + 0.5f) * scale - 0.5f;
+    int i = static_cast<int>(std::floor(f));
+    LinearTap tap;
+    tap.w = f - i;
+    if (i < 0) {
+        i = 0;
+        tap.w = 0.0f;
+    }
+    if (i >= srcSize - 1) {
+        i = srcSize - 1;
+        tap.w = 0.0f;
+    }
+    tap.i0 = i;
+    tap.i1 = std::min(i + 1, srcSize - 1);
+    return tap;
+}
+
+/**
+ * @brief Per-thread scratch, sized on first use and then reused
+ *
+ * Each call runs on one thread (the pipeline preprocess stage or the
+ * caller of ML::analyzeDetailed), so thread_local avoids both locking
+ * and per-frame allocation.
+ */
+struct PreprocessScratch {
+    int srcWidth;
+    int dstSize;
+    std::vector<LinearTap> xTaps;   ///< Indices pre-multiplied by 3 (BGR)
+    std::vector<float> row;         ///< Vertically blended source row (BGR)
+};
+
+/* ============================================================================
+ * Vertical Blend
+ * ============================================================================ */
+
+void ImageKernels::blendRows(const uint8_t* a, const uint8_t* b, float w, float* dst, int count)
+{
+    int i = 0;
+
+#if defined(LS_SIMD_NEON)
+    const float32x4_t vw = vdupq_n_f32(w);
+    for (; i + 8 <= count; i += 8) {
+        uint16x8_t a16 = vmovl_u8(vld1_u8(a + i));
+        uint16x8_t b16 = vmovl_u8(vld1_u8(b + i));
+        float32x4_t alo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(a16)));
+        float32x4_t ahi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(a16)));
+        float32x4_t dlo = vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(b16))), alo);
+        float32x4_t dhi = vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(b16))), ahi);
+    #if defined(__aarch64__)
+        vst1q_f32(dst + i, vfmaq_f32(alo, dlo, vw));
+        vst1q_f32(dst + i + 4, vfmaq_f32(ahi, dhi, vw));
+    #else
+        vst1q_f32(dst + i, vmlaq_f32(alo, dlo, vw));
+        vst1q_f32(dst + i + 4, vmlaq_f32(ahi, dhi, vw));
+    #endif
+    }
+#elif defined(LS_SIMD_AVX2)
+    const __m256 vw = _mm256_set1_ps(w);
+    for (; i + 8 <= count; i += 8) {
+        __m128i a8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a + i));
+        __m128i b8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b + i));
+        __m256 va = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(a8));
+        __m256 vb = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(b8));
+        _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(_mm256_sub_ps(vb, va), vw, va));
+    }
+#elif defined(LS_SIMD_SSE2)
+    const __m128 vw = _mm_set1_ps(w);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        __m128i a16 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(a + i)), zero);
+        __m128i b16 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(b + i)), zero);
+        __m128 alo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(a16, zero));
+        __m128 ahi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(a16, zero));
+        __m128 blo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(b16, zero));
+        __m128 bhi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(b16, zero));
+        _mm_storeu_ps(dst + i, _mm_add_ps(alo, _mm_mul_ps(_mm_sub_ps(blo, alo), vw)));
+        _mm_storeu_ps(dst + i + 4, _mm_add_ps(ahi, _mm_mul_ps(_mm_sub_ps(bhi, ahi), vw)));
+    }
+#endif
+
+    for (; i < count; i++) {
+        dst[i] = a[i] + (b[i] - a[i]) * w;
+    }
+}
+
+/* ============================================================================
+ * Green Test and Normalization
+ * ============================================================================ */
+
+int ImageKernels::countGreen(const float* r, const float* g, const float* b, int count)
+{
+    // With v = max, d = max - min: S >= 30 is d * 255 >= 30 * v, and the
+    // hue window only needs the branch OpenCV takes (G max, else R max)
+    int green = 0;
+    int i = 0;
+
+#if defined(LS_SIMD_NEON)
+    const float32x4_t minVal = vdupq_n_f32(GREEN_MIN_VAL);
+    const float32x4_t minSat = vdupq_n_f32(GREEN_MIN_SAT);
+    const float32x4_t full = vdupq_n_f32(255.0f);
+    const float32x4_t hueLo = vdupq_n_f32(GREEN_HUE_LO);
+    const float32x4_t hueHi = vdupq_n_f32(GREEN_HUE_HI);
+    uint32x4_t acc = vdupq_n_u32(0);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t vr = vld1q_f32(r + i);
+        float32x4_t vg = vld1q_f32(g + i);
+        float32x4_t vb = vld1q_f32(b + i);
+        float32x4_t mx = vmaxq_f32(vmaxq_f32(vr, vg), vb);
+        float32x4_t d = vsubq_f32(mx, vminq_f32(vminq_f32(vr, vg), vb));
+        uint32x4_t ok = vandq_u32(vcgeq_f32(mx, minVal),
+                                  vcgeq_f32(vmulq_f32(d, full), vmulq_f32(mx, minSat)));
+        uint32x4_t gMax = vcgeq_f32(vg, mx);
+        uint32x4_t hueG = vcltq_f32(vsubq_f32(vb, vr), vmulq_f32(d, hueHi));
+        uint32x4_t hueR = vandq_u32(vcgeq_f32(vr, mx), vcgeq_f32(vsubq_f32(vg, vb), vmulq_f32(d, hueLo)));
+        uint32x4_t hue = vbslq_u32(gMax, hueG, hueR);
+        acc = vsubq_u32(acc, vandq_u32(ok, hue));  // true lanes are all ones (-1)
+    }
+    green += static_cast<int>(vgetq_lane_u32(acc, 0) + vgetq_lane_u32(acc, 1) +
+                              vgetq_lane_u32(acc, 2) + vgetq_lane_u32(acc, 3));
+#elif defined(LS_SIMD_AVX2)
+    const __m256 minVal = _mm256_set1_ps(GREEN_MIN_VAL);
+    const __m256 minSat = _mm256_set1_ps(GREEN_MIN_SAT);
+    const __m256 full = _mm256_set1_ps(255.0f);
+    const __m256 hueLo = _mm256_set1_ps(GREEN_HUE_LO);
+    const __m256 hueHi = _mm256_set1_ps(GREEN_HUE_HI);
+    for (; i + 8 <= count; i += 8) {
+        __m256 vr = _mm256_loadu_ps(r + i);
+        __m256 vg = _mm256_loadu_ps(g + i);
+        __m256 vb = _mm256_loadu_ps(b + i);
+        __m256 mx = _mm256_max_ps(_mm256_max_ps(vr, vg), vb);
+        __m256 d = _mm256_sub_ps(mx, _mm256_min_ps(_mm256_min_ps(vr, vg), vb));
+        __m256 ok = _mm256_and_ps(_mm256_cmp_ps(mx, minVal, _CMP_GE_OQ),
+                                  _mm256_cmp_ps(_mm256_mul_ps(d, full), _mm256_mul_ps(mx, minSat), _CMP_GE_OQ));
+        __m256 gMax = _mm256_cmp_ps(vg, mx, _CMP_GE_OQ);
+        __m256 hueG = _mm256_cmp_ps(_mm256_sub_ps(vb, vr), _mm256_mul_ps(d, hueHi), _CMP_LT_OQ);
+        __m256 hueR = _mm256_and_ps(_mm256_cmp_ps(vr, mx, _CMP_GE_OQ),
+                                    _mm256_cmp_ps(_mm256_sub_ps(vg, vb), _mm256_mul_ps(d, hueLo), _CMP_GE_OQ));
+        __m256 hue = _mm256_blendv_ps(hueR, hueG, gMax);
+        green += __builtin_popcount(_mm256_movemask_ps(_mm256_and_ps(ok, hue)));
+    }
+#elif defined(LS_SIMD_SSE2)
+    const __m128 minVal = _mm_set1_ps(GREEN_MIN_VAL);
+    const __m128 minSat = _mm_set1_ps(GREEN_MIN_SAT);
+    const __m128 full = _mm_set1_ps(255.0f);
+    const __m128 hueLo = _mm_set1_ps(GREEN_HUE_LO);
+    const __m128 hueHi = _mm_set1_ps(GREEN_HUE_HI);
+    for (; i + 4 <= count; i += 4) {
+        __m128 vr = _mm_loadu_ps(r + i);
+        __m128 vg = _mm_loadu_ps(g + i);
+        __m128 vb = _mm_loadu_ps(b + i);
+        __m128 mx = _mm_max_ps(_mm_max_ps(vr, vg), vb);
+        __m128 d = _mm_sub_ps(mx, _mm_min_ps(_mm_min_ps(vr, vg), vb));
+        __m128 ok = _mm_and_ps(_mm_cmpge_ps(mx, minVal),
+                               _mm_cmpge_ps(_mm_mul_ps(d, full), _mm_mul_ps(mx, minSat)));
+        __m128 gMax = _mm_cmpge_ps(vg, mx);
+        __m128 hueG = _mm_cmplt_ps(_mm_sub_ps(vb, vr), _mm_mul_ps(d, hueHi));
+        __m128 hueR = _mm_and_ps(_mm_cmpge_ps(vr, mx),
+                                 _mm_cmpge_ps(_mm_sub_ps(vg, vb), _mm_mul_ps(d, hueLo)));
+        __m128 hue = _mm_or_ps(_mm_and_ps(gMax, hueG), _mm_andnot_ps(gMax, hueR));
+        green += __builtin_popcount(_mm_movemask_ps(_mm_and_ps(ok, hue)));
+    }
+#endif
+
+    for (; i < count; i++) {
+        const float mx = std::max(std::max(r[i], g[i]), b[i]);
+        const float d = mx - std::min(std::min(r[i], g[i]), b[i]);
+        if (mx < GREEN_MIN_VAL || d * 255.0f < mx * GREEN_MIN_SAT) continue;
+        const bool hue = g[i] >= mx ? (b[i] - r[i] < d * GREEN_HUE_HI)
+                                    : (r[i] >= mx && g[i] - b[i] >= d * GREEN_HUE_LO);
+        if (hue) green++;
+    }
+    return green;
+}
+
+void ImageKernels::scaleRow(float* p, int count, float scale, float bias)
+{
+    int i = 0;
+
+#if defined(LS_SIMD_NEON)
+    const float32x4_t vs = vdupq_n_f32(scale);
+    const float32x4_t vb = vdupq_n_f32(bias);
+    for (; i + 4 <= count; i += 4) {
+    #if defined(__aarch64__)
+        vst1q_f32(p + i, vfmaq_f32(vb, vld1q_f32(p + i), vs));
+    #else
+        vst1q_f32(p + i, vmlaq_f32(vb, vld1q_f32(p + i), vs));
+    #endif
+    }
+#elif defined(LS_SIMD_AVX2)
+    const __m256 vs = _mm256_set1_ps(scale);
+    const __m256 vb = _mm256_set1_ps(bias);
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(p + i, _mm256_fmadd_ps(_mm256_loadu_ps(p + i), vs, vb));
+    }
+#elif defined(LS_SIMD_SSE2)
+    const __m128 vs = _mm_set1_ps(scale);
+    const __m128 vb = _mm_set1_ps(bias);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(p + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(p + i), vs), vb));
+    }
+#endif
+
+    for (; i < count; i++) {
+        p[i] = p[i] * scale + bias;
+    }
+}
+
+/* ============================================================================
+ * Fused Preprocess
+ * ============================================================================ */
+
+void ImageKernels::preprocessCHW(const uint8_t* src, int srcWidth, int srcHeight, size_t srcStep,
+                                 float* dst, int dstSize, float* greenRatio)
+{
+    static thread_local PreprocessScratch scratch = { 0, 0, {}, {} };
+
+    if (scratch.srcWidth != srcWidth || scratch.dstSize != dstSize) {
+        const float xScale = static_cast<float>(srcWidth) / dstSize;
+        scratch.xTaps.resize(dstSize);
+        for (int x = 0; x < dstSize; x++) {
+            LinearTap tap = linearTap(x, srcWidth, xScale);
+            tap.i0 *= 3;
+            tap.i1 *= 3;
+            scratch.xTaps[x] = tap;
+        }
+        scratch.row.resize(3 * static_cast<size_t>(srcWidth));
+        scratch.srcWidth = srcWidth;
+        scratch.dstSize = dstSize;
+    }
+
+    // (pixel / 255 - mean) / std folded into one multiply-add per value
+    float scale[3];
+    float bias[3];
+    for (int c = 0; c < 3; c++) {
+        scale[c] = 1.0f / (255.0f * IMAGENET_STD[c]);
+        bias[c] = -IMAGENET_MEAN[c] / IMAGENET_STD[c];
+    }
+
+    const size_t plane = static_cast<size_t>(dstSize) * dstSize;
+    const float yScale = static_cast<float>(srcHeight) / dstSize;
+    const float* row = scratch.row.data();
+    const LinearTap* xTaps = scratch.xTaps.data();
+    int green = 0;
+
+    for (int y = 0; y < dstSize; y++) {
+        // Vertical first: one vector pass over the two source rows, then a
+        // single gather per output pixel
+        const LinearTap ty = linearTap(y, srcHeight, yScale);
+        blendRows(src + ty.i0 * srcStep, src + ty.i1 * srcStep, ty.w, scratch.row.data(), 3 * srcWidth);
+
+        // Planes in RGB order from BGR pixels, still 0-255 here
+        float* r = dst + static_cast<size_t>(y) * dstSize;
+        float* g = r + plane;
+        float* b = g + plane;
+        for (int x = 0; x < dstSize; x++) {
+            const float* p0 = row + xTaps[x].i0;
+            const float* p1 = row + xTaps[x].i1;
+            const float w = xTaps[x].w;
+            b[x] = p0[0] + (p1[0] - p0[0]) * w;
+            g[x] = p0[1] + (p1[1] - p0[1]) * w;
+            r[x] = p0[2] + (p1[2] - p0[2]) * w;
+        }
+
+        // OOD colour test while the row is hot in L1, then normalize it
+        if (greenRatio) {
+            green += countGreen(r, g, b, dstSize);
+        }
+        scaleRow(r, dstSize, scale[0], bias[0]);
+        scaleRow(g, dstSize, scale[1], bias[1]);
+        scaleRow(b, dstSize, scale[2], bias[2]);
+    }
+
+    if (greenRatio) {
+        *greenRatio = static_cast<float>(green) / static_cast<float>(plane);
+    }
+}
+
+/* ============================================================================
+ * Content Hash
+ * ============================================================================ */
+
+static const uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotl64(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const uint8_t* p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));  // Unaligned-safe; both targets are little-endian
+    return v;
+}
+
+static inline uint64_t hashRound(uint64_t acc, uint64_t input)
+{
+    acc += input * PRIME2;
+    acc = rotl64(acc, 31);
+    return acc * PRIME1;
+}
+
+/**
+ * @brief Hash of one contiguous row; four independent lanes keep the
+ *        multiplier busy instead of waiting on one dependency chain
+ */
+static uint64_t hashRow(const uint8_t* p, size_t len, uint64_t seed)
+{
+    const uint8_t* end = p + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        uint64_t v1 = seed + PRIME1 + PRIME2;
+        uint64_t v2 = seed + PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = hashRound(v1, read64(p));
+            v2 = hashRound(v2, read64(p + 8));
+            v3 = hashRound(v3, read64(p + 16));
+            v4 = hashRound(v4, read64(p + 24));
+        }
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+    } else {
+        h = seed + PRIME5;
+    }
+    h += len;
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= hashRound(0, read64(p));
+        h = rotl64(h, 27) * PRIME1 + PRIME4;
+    }
+    for (; p < end; p++) {
+        h ^= *p * PRIME5;
+        h = rotl64(h, 11) * PRIME1;
+    }
+
+    // Final avalanche
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t ImageKernels::contentHash(const uint8_t* src, size_t rowBytes, int rows, size_t srcStep,
+                                   uint64_t seed)
+{
+    // Rows are chained so padded and contiguous copies of a frame agree
+    uint64_t h = seed;
+    for (int y = 0; y < rows; y++) {
+        h = hashRow(src + y * srcStep, rowBytes, h);
+    }
+    return h;
+}
+
+const char* ImageKernels::simdPath()
+{
+#if defined(LS_SIMD_NEON)
+    return "neon";
+#elif defined(LS_SIMD_AVX2)
+    return "avx2";
+#elif defined(LS_SIMD_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,209 @@
+/**
+ * @file InferenceCache.cpp
+ * @brief Implementation of the Inference Result Cache
+ */
+
+#include "InferenceCache.h"
+#include "dbManager.h"
+#include "Logger.h"
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+/**
+ * @brief Doubles single quotes for use inside an SQL string literal
+ */
+static std::string sqlEscape(const std::string& text)
+{
+    std::string escaped = text;
+    size_t pos = 0;
+    while ((pos = escaped.find("'", pos)) != std::string::npos) {
+        escaped.replace(pos, 1, "''");
+        pos += 2;
+    }
+    return escaped;
+}
+
+/* ============================================================================
+ * Construction / Destruction
+ * ============================================================================ */
+
+InferenceCache::InferenceCache(size_t entries, const std::string& dbPath)
+    : capacity(entries > 0 ? entries : 1)
+    , db(nullptr)
+    , memoryHits(0)
+    , dbHits(0)
+    , misses(0)
+{
+    pthread_mutex_init(&mutex, NULL);
+
+    if (dbPath.empty()) return;
+
+    db = new dbManager(dbPath);
+    db->execute("PRAGMA busy_timeout = 2000;");  // Shared with the database daemon
+    bool ok = db->execute("CREATE TABLE IF NOT EXISTS ml_result_cache ("
+                          "image_hash TEXT NOT NULL, "
+                          "model_version TEXT NOT NULL, "
+                          "class_id INTEGER NOT NULL, "
+                          "class_name TEXT NOT NULL, "
+                          "confidence REAL NOT NULL, "
+                          "entropy REAL NOT NULL, "
+                          "is_valid INTEGER NOT NULL, "
+                          "probs TEXT NOT NULL, "
+                          "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP, "
+                          "PRIMARY KEY (image_hash, model_version));");
+    if (!ok) {
+        LS_WARN("MLCache", "Persistent cache unavailable in {}, using memory only", dbPath);
+        delete db;
+        db = nullptr;
+    }
+}
+
+InferenceCache::~InferenceCache()
+{
+    uint64_t memory, persistent, missed;
+    getStats(memory, persistent, missed);
+    LS_INFO("MLCache", "{} memory hits, {} database hits, {} misses", memory, persistent, missed);
+
+    delete db;
+    pthread_mutex_destroy(&mutex);
+}
+
+/* ============================================================================
+ * Lookup / Store
+ * ============================================================================ */
+
+bool InferenceCache::lookup(const std::string& hash, const std::string& modelVersion, MLResult& result)
+{
+    if (hash.empty()) return false;
+    const std::string key = hash + "|" + modelVersion;
+
+    pthread_mutex_lock(&mutex);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        lru.splice(lru.begin(), lru, it->second);
+        result = it->second->second;
+        memoryHits++;
+        pthread_mutex_unlock(&mutex);
+        return true;
+    }
+
+    bool found = db && loadFromDb(hash, modelVersion, result);
+    if (found) {
+        // Keeps prune() least-recently-used rather than oldest-first
+        db->execute("UPDATE ml_result_cache SET created_at = CURRENT_TIMESTAMP WHERE image_hash = '" +
+                    sqlEscape(hash) + "' AND model_version = '" + sqlEscape(modelVersion) + "';");
+    }
+    if (found) {
+        remember(key, result);
+        dbHits++;
+    } else {
+        misses++;
+    }
+    pthread_mutex_unlock(&mutex);
+    return found;
+}
+
+void InferenceCache::store(const std::string& hash, const std::string& modelVersion, const MLResult& result)
+{
+    if (hash.empty() || result.probs.empty()) return;
+
+    std::stringstream probs;
+    for (size_t i = 0; i < result.probs.size(); i++) {
+        if (i > 0) probs << ",";
+        probs << result.probs[i];
+    }
+
+    pthread_mutex_lock(&mutex);
+    remember(hash + "|" + modelVersion, result);
+    if (db) {
+        std::stringstream sql;
+        sql << "INSERT OR REPLACE INTO ml_result_cache "
+            << "(image_hash, model_version, class_id, class_name, confidence, entropy, is_valid, probs) "
+            << "VALUES ('" << sqlEscape(hash) << "', '" << sqlEscape(modelVersion) << "', " << result.class_id << ", '"
+            << sqlEscape(result.class_name) << "', " << result.confidence << ", " << result.entropy << ", "
+            << (result.isValidPlant ? 1 : 0) << ", '" << probs.str() << "');";
+        db->execute(sql.str());
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+size_t InferenceCache::prune(int maxRows, int maxAgeDays)
+{
+    if (!db) return 0;
+
+    pthread_mutex_lock(&mutex);
+    DBResult before = db->read("SELECT COUNT(*) FROM ml_result_cache;");
+    if (maxAgeDays > 0) {
+        db->execute("DELETE FROM ml_result_cache WHERE created_at < datetime('now', '-" +
+                    std::to_string(maxAgeDays) + " days');");
+    }
+    if (maxRows >= 0) {
+        db->execute("DELETE FROM ml_result_cache WHERE rowid IN (SELECT rowid FROM ml_result_cache "
+                    "ORDER BY created_at DESC, rowid DESC LIMIT -1 OFFSET " + std::to_string(maxRows) + ");");
+    }
+    DBResult after = db->read("SELECT COUNT(*) FROM ml_result_cache;");
+    pthread_mutex_unlock(&mutex);
+
+    if (before.rows.empty() || after.rows.empty() || before.rows[0].empty() || after.rows[0].empty()) return 0;
+    long deleted = atol(before.rows[0][0].c_str()) - atol(after.rows[0][0].c_str());
+    return deleted > 0 ? static_cast<size_t>(deleted) : 0;
+}
+
+void InferenceCache::getStats(uint64_t& memory, uint64_t& persistent, uint64_t& missed)
+{
+    pthread_mutex_lock(&mutex);
+    memory = memoryHits;
+    persistent = dbHits;
+    missed = misses;
+    pthread_mutex_unlock(&mutex);
+}
+
+/* ============================================================================
+ * Internals
+ * ============================================================================ */
+
+void InferenceCache::remember(const std::string& key, const MLResult& result)
+{
+    auto it = index.find(key);
+    if (it != index.end()) {
+        it->second->second = result;
+        lru.splice(lru.begin(), lru, it->second);
+        return;
+    }
+
+    lru.push_front(Entry(key, result));
+    index[key] = lru.begin();
+    if (lru.size() > capacity) {
+        index.erase(lru.back().first);
+        lru.pop_back();
+    }
+}
+
+bool InferenceCache::loadFromDb(const std::string& hash, const std::string& modelVersion, MLResult& result)
+{
+    DBResult rows = db->read("SELECT class_id, class_name, confidence, entropy, is_valid, probs "
+                             "FROM ml_result_cache WHERE image_hash = '" + sqlEscape(hash) +
+                             "' AND model_version = '" + sqlEscape(modelVersion) + "';");
+    if (rows.rows.empty() || rows.rows[0].size() < 6) return false;
+
+    const std::vector<std::string>& row = rows.rows[0];
+    result.class_id = atoi(row[0].c_str());
+    result.class_name = row[1];
+    result.confidence = static_cast<float>(atof(row[2].c_str()));
+    result.entropy = static_cast<float>(atof(row[3].c_str()));
+    result.isValidPlant = row[4] == "1";
+    result.modelVersion = modelVersion;
+
+    result.probs.clear();
+    std::stringstream probs(row[5]);
+    std::string value;
+    while (std::getline(probs, value, ',')) {
+        result.probs.push_back(static_cast<float>(atof(value.c_str())));
+    }
+    return true;
+}
@@ -7,11 +7,19 @@
  */
 
 #include "ML.h"
-#include <iostream>
+#include "ImageKernels.h"
+#include "Logger.h"
+#include "Trace.h"
 #include <fstream>
+#include <iterator>
 #include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <ctime>
+#include <cstdio>
+#include <atomic>
+#include <unistd.h>
+#include <sys/stat.h>
 
 // OpenCV for image loading and preprocessing
 #include <opencv2/opencv.hpp>
@@ -36,116 +44,501 @@ const std::vector<std::string> ML::CLASS_NAMES = {
     "Pest Damage"
 };
 
+static const int HEALTHY_CLASS = 2;  // Index in CLASS_NAMES
+
 /* ============================================================================
  * Construction / Destruction
  * ============================================================================ */
 
 ML::ML(std::string dir, std::string name)
-    : initialized(false)
+    : modelDir(dir)
+    , modelName(name)
     , env(nullptr)
-    , session(nullptr)
-    , sessionOptions(nullptr)
+    , active(nullptr)
+    , previous(nullptr)
+    , watching(false)
+    , watchIntervalMs(0)
+    , prepJob(nullptr)
+    , prepGeneration(0)
+    , prepPending(0)
+    , prepStop(false)
+    , tileGrid(0)
+    , tileOverlap(0.25f)
 {
+    pthread_mutex_init(&swapMutex, NULL);
+    pthread_mutex_init(&reloadMutex, NULL);
+    pthread_mutex_init(&watchMutex, NULL);
+    pthread_cond_init(&watchCond, NULL);
+    pthread_mutex_init(&prepSubmitMutex, NULL);
+    pthread_mutex_init(&prepMutex, NULL);
+    pthread_cond_init(&prepCond, NULL);
+    pthread_cond_init(&prepDoneCond, NULL);
+    
+    // The caller of analyzeBatch() is one worker, the pool covers the other cores
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    for (long i = 1; i < cpus; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, prepThreadFunc, this) != 0) {
+            LS_WARN("ML", "Batch preprocessing pool limited to {} thread(s)", prepThreads.size());
+            break;
+        }
+        prepThreads.push_back(thread);
+    }
+    
     // Build full model path
     modelPath = dir + "/" + name;
     
-    // Check if model file exists
-    std::ifstream f(modelPath);
-    if (!f.good()) {
-        std::cerr << "[ML] Warning: Model file not found: " << modelPath << std::endl;
-        std::cerr << "[ML] Running in mock mode (always returns Healthy)" << std::endl;
+    try {
+        // One environment for every model loaded over the engine's lifetime
+        env = new Ort::Env(ORT_LOGGING_LEVEL_WARNING, "LeafSenseML");
+    } catch (const Ort::Exception& e) {
+        LS_ERROR("ML", "Failed to create ONNX Runtime environment: {}", e.what());
+        LS_WARN("ML", "Running in mock mode (always returns Healthy)");
         return;
     }
-    f.close();
+    
+    if (!reload()) {
+        LS_WARN("ML", "Running in mock mode (always returns Healthy)");
+    }
+}
+
+ML::~ML()
+{
+    stopWatching();
+    
+    pthread_mutex_lock(&prepMutex);
+    prepStop = true;
+    pthread_cond_broadcast(&prepCond);
+    pthread_mutex_unlock(&prepMutex);
+    for (pthread_t thread : prepThreads) {
+        pthread_join(thread, NULL);
+    }
+    
+    // Inferences are over: nothing else references the models
+    if (active) destroyModel(active);
+    if (previous) destroyModel(previous);
+    if (env) {
+        delete static_cast<Ort::Env*>(env);
+    }
+    pthread_cond_destroy(&prepDoneCond);
+    pthread_cond_destroy(&prepCond);
+    pthread_mutex_destroy(&prepMutex);
+    pthread_mutex_destroy(&prepSubmitMutex);
+    pthread_cond_destroy(&watchCond);
+    pthread_mutex_destroy(&watchMutex);
+    pthread_mutex_destroy(&reloadMutex);
+    pthread_mutex_destroy(&swapMutex);
+}
+
+std::string ML::resolveModel(const std::string& dir, const std::string& variant)
+{
+    const std::string fp32 = "leafsense_model.onnx";
+    if (variant == "fp32") {
+        return fp32;
+    }
+    if (variant == "int8") {
+        const std::string int8 = "leafsense_model_int8.onnx";
+        std::ifstream f(dir + "/" + int8);
+        if (f.good()) {
+            return int8;
+        }
+        LS_WARN("ML", "{}/{} not found, using the float32 model", dir, int8);
+        return fp32;
+    }
+    LS_WARN("ML", "Unknown ml.variant '{}', using fp32", variant);
+    return fp32;
+}
+
+std::string ML::imageHash(const cv::Mat& image)
+{
+    if (image.empty() || image.depth() != CV_8U) {
+        return "";
+    }
+    
+    // Dimensions and type seed the hash so reshaped buffers do not collide
+    uint64_t seed = (static_cast<uint64_t>(image.cols) << 32) ^
+                    (static_cast<uint64_t>(image.rows) << 8) ^ static_cast<uint64_t>(image.type());
+    uint64_t hash = ImageKernels::contentHash(image.data, image.cols * image.elemSize(), image.rows,
+                                              image.step, seed);
+    
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+    return hex;
+}
+
+/* ============================================================================
+ * Run State
+ * ============================================================================ */
+
+ML::Model* ML::loadModel(const std::vector<uint8_t>& bytes, const std::string& weightsHash)
+{
+    Model* model = new Model();
+    model->name = modelName;
+    model->precision = "unknown";
+    model->session = nullptr;
+    model->sessionOptions = nullptr;
+    model->inputBuffer.assign(TENSOR_SIZE, 0.0f);
+    model->ioBinding = nullptr;
+    model->inputValue = nullptr;
+    model->outputValue = nullptr;
+    model->batchDynamic = false;
+    model->refs = 0;
+    pthread_mutex_init(&model->runMutex, NULL);
     
     try {
-        // Create ONNX Runtime environment
-        Ort::Env* ortEnv = new Ort::Env(ORT_LOGGING_LEVEL_WARNING, "LeafSenseML");
-        env = ortEnv;
-        
         // Configure session options
         Ort::SessionOptions* ortOptions = new Ort::SessionOptions();
         ortOptions->SetIntraOpNumThreads(2);
         ortOptions->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-        sessionOptions = ortOptions;
+        model->sessionOptions = ortOptions;
         
         // Load model
-        Ort::Session* ortSession = new Ort::Session(*ortEnv, modelPath.c_str(), *ortOptions);
-        session = ortSession;
+        model->session = new Ort::Session(*static_cast<Ort::Env*>(env), bytes.data(), bytes.size(), *ortOptions);
+        LS_INFO("ML", "Model loaded successfully: {}", modelPath);
         
-        initialized = true;
-        std::cout << "[ML] Model loaded successfully: " << modelPath << std::endl;
+        setupRunState(model);
+        model->version = modelName + "/" + model->precision + "/" + weightsHash;
+        return model;
         
     } catch (const Ort::Exception& e) {
-        std::cerr << "[ML] Failed to load ONNX model: " << e.what() << std::endl;
-        std::cerr << "[ML] Running in mock mode (always returns Healthy)" << std::endl;
-        initialized = false;
+        LS_ERROR("ML", "Failed to load ONNX model: {}", e.what());
+        destroyModel(model);
+        return nullptr;
     }
 }
 
-ML::~ML()
+void ML::destroyModel(Model* model)
 {
-    if (session) {
-        delete static_cast<Ort::Session*>(session);
+    // Bound values reference the session and buffers: release them first
+    delete static_cast<Ort::IoBinding*>(model->ioBinding);
+    delete static_cast<Ort::Value*>(model->inputValue);
+    delete static_cast<Ort::Value*>(model->outputValue);
+    delete static_cast<Ort::Session*>(model->session);
+    delete static_cast<Ort::SessionOptions*>(model->sessionOptions);
+    pthread_mutex_destroy(&model->runMutex);
+    delete model;
+}
+
+void ML::setupRunState(Model* model)
+{
+    Ort::Session* ortSession = static_cast<Ort::Session*>(model->session);
+    Ort::AllocatorWithDefaultOptions allocator;
+    
+    model->inputName = ortSession->GetInputNameAllocated(0, allocator).get();
+    model->outputName = ortSession->GetOutputNameAllocated(0, allocator).get();
+    
+    // QDQ models quantize inside the graph; the I/O must stay float
+    if (ortSession->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetElementType() !=
+            ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT ||
+        ortSession->GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetElementType() !=
+            ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+        throw Ort::Exception("Model input/output must be float (export INT8 models as QDQ)",
+                             ORT_INVALID_GRAPH);
     }
-    if (sessionOptions) {
-        delete static_cast<Ort::SessionOptions*>(sessionOptions);
+    
+    // Tagged by ml/train_model.py
+    auto tag = ortSession->GetModelMetadata().LookupCustomMetadataMapAllocated("leafsense.precision", allocator);
+    if (tag) {
+        model->precision = tag.get();
     }
-    if (env) {
-        delete static_cast<Ort::Env*>(env);
+    
+    // Output is [batch, classes]; a dynamic batch dimension is bound as 1
+    std::vector<int64_t> outputShape =
+        ortSession->GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    if (outputShape.size() != 2 || outputShape[1] <= 0) {
+        throw Ort::Exception("Unexpected output shape (expected [batch, classes])", ORT_INVALID_GRAPH);
     }
+    outputShape[0] = 1;
+    model->outputBuffer.assign(static_cast<size_t>(outputShape[1]), 0.0f);
+    
+    // analyzeBatch() stacks frames only if the export kept the batch axis dynamic
+    std::vector<int64_t> modelInputShape =
+        ortSession->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    model->batchDynamic = !modelInputShape.empty() && modelInputShape[0] < 0;
+    
+    const int64_t inputShape[] = {1, 3, IMAGE_SIZE, IMAGE_SIZE};
+    auto memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    
+    Ort::Value* input = new Ort::Value(Ort::Value::CreateTensor<float>(
+        memoryInfo, model->inputBuffer.data(), model->inputBuffer.size(), inputShape, 4));
+    model->inputValue = input;
+    Ort::Value* output = new Ort::Value(Ort::Value::CreateTensor<float>(
+        memoryInfo, model->outputBuffer.data(), model->outputBuffer.size(), outputShape.data(), outputShape.size()));
+    model->outputValue = output;
+    
+    Ort::IoBinding* binding = new Ort::IoBinding(*ortSession);
+    binding->BindInput(model->inputName.c_str(), *input);
+    binding->BindOutput(model->outputName.c_str(), *output);
+    model->ioBinding = binding;
+    
+    // Warm-up: the first Run initializes kernels and the memory arena
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    std::fill(model->inputBuffer.begin(), model->inputBuffer.end(), 0.0f);
+    ortSession->Run(Ort::RunOptions{nullptr}, *binding);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    
+    LS_INFO("ML", "Bound {} -> {} ({} classes, {}, {} batch), warm-up run {} ms", model->inputName,
+            model->outputName, model->outputBuffer.size(), model->precision,
+            model->batchDynamic ? "dynamic" : "fixed",
+            (t1.tv_sec - t0.tv_sec) * 1000.0 + (t1.tv_nsec - t0.tv_nsec) / 1e6);
 }
 
 /* ============================================================================
- * Image Preprocessing
+ * Model Swap
  * ============================================================================ */
 
-std::vector<float> ML::preprocess(const std::string& imagePath)
+/**
+ * @brief Same file contents and metadata as when last polled
+ */
+static bool sameFile(const struct stat& a, const struct stat& b)
 {
-    // Load image with OpenCV
-    cv::Mat image = cv::imread(imagePath);
-    
-    if (image.empty()) {
-        std::cerr << "[ML] Failed to load image: " << imagePath << std::endl;
-        return std::vector<float>();
+    return a.st_ino == b.st_ino && a.st_size == b.st_size &&
+           a.st_mtim.tv_sec == b.st_mtim.tv_sec && a.st_mtim.tv_nsec == b.st_mtim.tv_nsec;
+}
+
+/**
+ * @brief Whether a model version carries the given weights hash
+ */
+static bool hasWeights(const std::string& version, const std::string& weightsHash)
+{
+    return version.size() > weightsHash.size() &&
+           version.compare(version.size() - weightsHash.size(), weightsHash.size(), weightsHash) == 0;
+}
+
+ML::Model* ML::acquire() const
+{
+    pthread_mutex_lock(&swapMutex);
+    Model* model = active;
+    if (model) model->refs++;
+    pthread_mutex_unlock(&swapMutex);
+    return model;
+}
+
+void ML::release(Model* model) const
+{
+    if (!model) return;
+    pthread_mutex_lock(&swapMutex);
+    bool last = --model->refs == 0;
+    pthread_mutex_unlock(&swapMutex);
+    if (last) {
+        LS_INFO("ML", "Unloaded {}", model->version);
+        destroyModel(model);
     }
+}
+
+bool ML::isInitialized() const
+{
+    pthread_mutex_lock(&swapMutex);
+    bool loaded = active != nullptr;
+    pthread_mutex_unlock(&swapMutex);
+    return loaded;
+}
+
+std::string ML::getPrecision() const
+{
+    pthread_mutex_lock(&swapMutex);
+    std::string precision = active ? active->precision : "unknown";
+    pthread_mutex_unlock(&swapMutex);
+    return precision;
+}
+
+std::string ML::getModelVersion() const
+{
+    pthread_mutex_lock(&swapMutex);
+    std::string version = active ? active->version : "mock";
+    pthread_mutex_unlock(&swapMutex);
+    return version;
+}
+
+bool ML::reload()
+{
+    if (!env) return false;
+    pthread_mutex_lock(&reloadMutex);
     
-    cv::Mat resized, rgb, normalized;
+    // Check if model file exists
+    std::ifstream f(modelPath, std::ios::binary);
+    if (!f.good()) {
+        LS_WARN("ML", "Model file not found: {}", modelPath);
+        pthread_mutex_unlock(&reloadMutex);
+        return false;
+    }
     
-    // Resize to 224x224
-    cv::resize(image, resized, cv::Size(IMAGE_SIZE, IMAGE_SIZE));
+    // Content hash of the weights: a retrained model deployed under the same
+    // file name must not match results cached for the previous one
+    std::vector<uint8_t> modelBytes((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    f.close();
+    char weightsHash[9];
+    snprintf(weightsHash, sizeof(weightsHash), "%08llx", static_cast<unsigned long long>(
+        ImageKernels::contentHash(modelBytes.data(), modelBytes.size(), 1, modelBytes.size(), 0) & 0xffffffffULL));
     
-    // BGR to RGB
-    cv::cvtColor(resized, rgb, cv::COLOR_BGR2RGB);
+    // Same weights as a loaded model (touched file, or a redeployed old
+    // version after a rollback): nothing to load
+    pthread_mutex_lock(&swapMutex);
+    bool isActive = active && hasWeights(active->version, weightsHash);
+    bool isPrevious = !isActive && previous && hasWeights(previous->version, weightsHash);
+    pthread_mutex_unlock(&swapMutex);
+    if (isActive || isPrevious) {
+        pthread_mutex_unlock(&reloadMutex);
+        return isActive || rollback();
+    }
     
-    // Convert to float and normalize to [0, 1]
-    rgb.convertTo(normalized, CV_32FC3, 1.0 / 255.0);
+    // Build and warm up next to the serving model
+    Model* model = loadModel(modelBytes, weightsHash);
+    std::vector<uint8_t>().swap(modelBytes);
+    if (!model) {
+        pthread_mutex_unlock(&reloadMutex);
+        return false;
+    }
     
-    // Split into channels
-    std::vector<cv::Mat> channels(3);
-    cv::split(normalized, channels);
+    // The swap: inferences already running keep their reference
+    pthread_mutex_lock(&swapMutex);
+    Model* dropped = previous;
+    previous = active;
+    active = model;
+    model->refs = 1;
+    std::string replaced = previous ? previous->version : "mock";
+    pthread_mutex_unlock(&swapMutex);
+    release(dropped);
     
-    // ImageNet normalization: (pixel - mean) / std
-    float mean[] = {0.485f, 0.456f, 0.406f};
-    float std_dev[] = {0.229f, 0.224f, 0.225f};
+    LS_INFO("ML", "Model {} active (replaced {})", model->version, replaced);
+    pthread_mutex_unlock(&reloadMutex);
+    return true;
+}
+
+bool ML::rollback()
+{
+    pthread_mutex_lock(&swapMutex);
+    if (!previous) {
+        pthread_mutex_unlock(&swapMutex);
+        LS_WARN("ML", "No previous model to roll back to");
+        return false;
+    }
+    std::swap(active, previous);
+    std::string version = active->version;
+    pthread_mutex_unlock(&swapMutex);
     
-    for (int i = 0; i < 3; i++) {
-        channels[i] = (channels[i] - mean[i]) / std_dev[i];
+    LS_INFO("ML", "Rolled back to {}", version);
+    return true;
+}
+
+void ML::startWatching(int intervalMs)
+{
+    if (watching || intervalMs <= 0) return;
+    watchIntervalMs = intervalMs;
+    watching = true;
+    if (pthread_create(&watchThread, NULL, watchThreadFunc, this) != 0) {
+        LS_ERROR("ML", "Cannot start the model watcher");
+        watching = false;
+    }
+}
+
+void ML::stopWatching()
+{
+    pthread_mutex_lock(&watchMutex);
+    if (!watching) {
+        pthread_mutex_unlock(&watchMutex);
+        return;
     }
+    watching = false;
+    pthread_cond_signal(&watchCond);
+    pthread_mutex_unlock(&watchMutex);
+    pthread_join(watchThread, NULL);
+}
+
+void ML::watchLoop()
+{
+    Tracer::setThreadName("tModelWatch");
+    LS_INFO("ML", "Watching {} every {} ms", modelPath, watchIntervalMs);
     
-    // Convert to CHW format (Channels, Height, Width) for ONNX
-    std::vector<float> tensor(3 * IMAGE_SIZE * IMAGE_SIZE);
+    struct stat seen;
+    bool exists = stat(modelPath.c_str(), &seen) == 0;
+    bool pending = false;  // Changed on the last poll, load once it settles
     
-    for (int c = 0; c < 3; c++) {
-        for (int h = 0; h < IMAGE_SIZE; h++) {
-            for (int w = 0; w < IMAGE_SIZE; w++) {
-                tensor[c * IMAGE_SIZE * IMAGE_SIZE + h * IMAGE_SIZE + w] = 
-                    channels[c].at<float>(h, w);
+    for (;;) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += watchIntervalMs / 1000;
+        ts.tv_nsec += (watchIntervalMs % 1000) * 1000000L;
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+        
+        pthread_mutex_lock(&watchMutex);
+        if (watching) {
+            pthread_cond_timedwait(&watchCond, &watchMutex, &ts);
+        }
+        bool stop = !watching;
+        pthread_mutex_unlock(&watchMutex);
+        if (stop) break;
+        
+        // A copy in progress keeps changing size/mtime; a rename is one change
+        struct stat now;
+        if (stat(modelPath.c_str(), &now) != 0) {
+            exists = false;
+            pending = false;
+            continue;
+        }
+        if (!exists || !sameFile(now, seen)) {
+            seen = now;
+            exists = true;
+            pending = true;
+            continue;
+        }
+        if (pending) {
+            pending = false;
+            LS_INFO("ML", "{} changed, reloading", modelPath);
+            if (!reload()) {
+                LS_WARN("ML", "New model rejected, still serving {}", getModelVersion());
             }
         }
     }
+}
+
+void* ML::watchThreadFunc(void* arg)
+{
+    ((ML*)arg)->watchLoop();
+    return NULL;
+}
+
+/* ============================================================================
+ * Image Preprocessing
+ * ============================================================================ */
+
+bool ML::preprocess(const cv::Mat& image, std::vector<float>& tensor, float& greenRatio)
+{
+    if (image.empty()) {
+        return false;
+    }
+    tensor.resize(3 * IMAGE_SIZE * IMAGE_SIZE);
+    return preprocess(image, tensor.data(), greenRatio);
+}
+
+bool ML::preprocess(const cv::Mat& image, float* tensor, float& greenRatio)
+{
+    LS_TRACE_SPAN("ml.preprocess");
+    if (image.empty()) {
+        return false;
+    }
     
-    return tensor;
+    // The kernel reads packed 8-bit BGR
+    cv::Mat bgr = image;
+    if (image.type() == CV_8UC1) {
+        cv::cvtColor(image, bgr, cv::COLOR_GRAY2BGR);
+    } else if (image.type() == CV_8UC4) {
+        cv::cvtColor(image, bgr, cv::COLOR_BGRA2BGR);
+    } else if (image.type() != CV_8UC3) {
+        LS_ERROR("ML", "Unsupported image type {}", image.type());
+        return false;
+    }
+    
+    // Resize, BGR->RGB, green ratio (plants have significant green content;
+    // this rejects walls, keyboards etc. the model was never trained on),
+    // ImageNet normalization and CHW layout in one pass
+    ImageKernels::preprocessCHW(bgr.data, bgr.cols, bgr.rows, bgr.step, tensor, IMAGE_SIZE, &greenRatio);
+    LS_DEBUG("ML", "Green pixel ratio: {}%", greenRatio * 100);
+    return true;
 }
 
 /* ============================================================================
@@ -176,50 +569,6 @@ std::vector<float> ML::softmax(const std::vector<float>& logits)
  * Out-of-Distribution Detection
  * ============================================================================ */
 
-/**
- * @brief Check if image contains sufficient green/plant-like colors
- * @param imagePath Path to image file
- * @return Ratio of green pixels (0.0 to 1.0)
- * 
- * Plants typically have significant green content. This heuristic helps
- * reject obvious non-plant images (keyboards, walls, etc.) that the ML
- * model might incorrectly classify due to lack of OOD training data.
- */
-float ML::checkGreenRatio(const std::string& imagePath)
-{
-    cv::Mat image = cv::imread(imagePath);
-    if (image.empty()) {
-        return 0.0f;
-    }
-    
-    // Convert to HSV for better green detection
-    cv::Mat hsv;
-    cv::cvtColor(image, hsv, cv::COLOR_BGR2HSV);
-    
-    // Green color range in HSV
-    // Hue: 35-85 (green range), Saturation: 30+ (not gray), Value: 30+ (not too dark)
-    cv::Mat greenMask;
-    cv::inRange(hsv, cv::Scalar(35, 30, 30), cv::Scalar(85, 255, 255), greenMask);
-    
-    // Also check for yellow-green (sick plants) and brown-green (diseased)
-    cv::Mat yellowGreenMask;
-    cv::inRange(hsv, cv::Scalar(20, 30, 30), cv::Scalar(35, 255, 255), yellowGreenMask);
-    
-    // Combine masks
-    cv::Mat combinedMask;
-    cv::bitwise_or(greenMask, yellowGreenMask, combinedMask);
-    
-    // Calculate ratio of green-ish pixels
-    int greenPixels = cv::countNonZero(combinedMask);
-    int totalPixels = image.rows * image.cols;
-    
-    float greenRatio = static_cast<float>(greenPixels) / static_cast<float>(totalPixels);
-    
-    std::cout << "[ML] Green pixel ratio: " << (greenRatio * 100) << "%" << std::endl;
-    
-    return greenRatio;
-}
-
 float ML::calculateEntropy(const std::vector<float>& probs)
 {
     // Shannon entropy: H = -sum(p * log2(p))
@@ -246,23 +595,22 @@ bool ML::checkValidPlant(float entropy, float maxConfidence, float greenRatio)
     
     // Check 1: Image must contain some green/plant-like colors
     if (greenRatio < MIN_GREEN_RATIO) {
-        std::cout << "[ML] Insufficient green pixels (" << (greenRatio * 100) << "% < " 
-                  << (MIN_GREEN_RATIO * 100) << "%) - likely non-plant image" << std::endl;
+        LS_INFO("ML", "Insufficient green pixels ({}% < {}%) - likely non-plant image",
+                greenRatio * 100, MIN_GREEN_RATIO * 100);
         return false;
     }
     
     // Check 2: Entropy should be low (model is confident)
     // For 4 classes, max entropy is log2(4) = 2.0 (uniform distribution)
     if (entropy > ENTROPY_THRESHOLD) {
-        std::cout << "[ML] High entropy (" << entropy << " > " << ENTROPY_THRESHOLD 
-                  << ") - possible non-plant image" << std::endl;
+        LS_INFO("ML", "High entropy ({} > {}) - possible non-plant image", entropy, ENTROPY_THRESHOLD);
         return false;
     }
     
     // Check 3: Confidence should be above threshold
     if (maxConfidence < MIN_CONFIDENCE_THRESHOLD) {
-        std::cout << "[ML] Low confidence (" << (maxConfidence * 100) << "% < " 
-                  << (MIN_CONFIDENCE_THRESHOLD * 100) << "%) - possible non-plant image" << std::endl;
+        LS_INFO("ML", "Low confidence ({}% < {}%) - possible non-plant image",
+                maxConfidence * 100, MIN_CONFIDENCE_THRESHOLD * 100);
         return false;
     }
     
@@ -273,119 +621,525 @@ bool ML::checkValidPlant(float entropy, float maxConfidence, float greenRatio)
  * Inference
  * ============================================================================ */
 
+bool ML::prepareInput(const std::string& imagePath, std::vector<float>& tensor, float& greenRatio)
+{
+    cv::Mat image = cv::imread(imagePath);
+    
+    if (image.empty()) {
+        LS_ERROR("ML", "Failed to load image: {}", imagePath);
+        return false;
+    }
+    
+    return prepareInput(image, tensor, greenRatio);
+}
+
+bool ML::prepareInput(const cv::Mat& image, std::vector<float>& tensor, float& greenRatio)
+{
+    // The same pass produces the model input and the OOD check
+    if (image.empty()) {
+        return false;
+    }
+    
+    return preprocess(image, tensor, greenRatio);
+}
+
 MLResult ML::analyzeDetailed(const std::string& imagePath)
+{
+    // Mock mode if not initialized (skip image decoding entirely)
+    Model* model = acquire();
+    if (!model) {
+        return infer(std::vector<float>(), 1.0f);
+    }
+    if (tileGrid >= 2) {
+        release(model);
+        cv::Mat image = cv::imread(imagePath);
+        if (image.empty()) {
+            LS_ERROR("ML", "Failed to load image: {}", imagePath);
+            return infer(std::vector<float>(), 0.0f);
+        }
+        return analyzeTiled(image, tileGrid, tileOverlap);
+    }
+    
+    // Decode straight into the bound input buffer
+    float greenRatio = 0.0f;
+    pthread_mutex_lock(&model->runMutex);
+    bool ok = prepareInput(imagePath, model->inputBuffer, greenRatio);
+    MLResult result = ok ? classify(model, greenRatio) : infer(std::vector<float>(), greenRatio);
+    pthread_mutex_unlock(&model->runMutex);
+    release(model);
+    return result;
+}
+
+MLResult ML::analyzeDetailed(const cv::Mat& image)
+{
+    Model* model = acquire();
+    if (!model) {
+        return infer(std::vector<float>(), 1.0f);
+    }
+    if (tileGrid >= 2) {
+        release(model);
+        return analyzeTiled(image, tileGrid, tileOverlap);
+    }
+    
+    float greenRatio = 0.0f;
+    pthread_mutex_lock(&model->runMutex);
+    bool ok = prepareInput(image, model->inputBuffer, greenRatio);
+    if (!ok) {
+        LS_ERROR("ML", "Empty frame");
+    }
+    MLResult result = ok ? classify(model, greenRatio) : infer(std::vector<float>(), greenRatio);
+    pthread_mutex_unlock(&model->runMutex);
+    release(model);
+    return result;
+}
+
+MLResult ML::infer(const std::vector<float>& inputTensor, float greenRatio)
+{
+    // Mock mode if not initialized
+    if (!isInitialized()) {
+        LS_DEBUG("ML", "Mock mode: returning Healthy");
+        return defaultResult();
+    }
+    
+    if (inputTensor.empty()) {
+        LS_ERROR("ML", "Preprocessing failed, returning default");
+        return defaultResult();
+    }
+    if (inputTensor.size() != static_cast<size_t>(TENSOR_SIZE)) {
+        LS_ERROR("ML", "Input has {} values, model expects {}", inputTensor.size(), TENSOR_SIZE);
+        return defaultResult();
+    }
+    
+    Model* model = acquire();
+    if (!model) {
+        return defaultResult();
+    }
+    
+    // The binding reads inputBuffer; tensors prepared elsewhere are copied in
+    pthread_mutex_lock(&model->runMutex);
+    if (inputTensor.data() != model->inputBuffer.data()) {
+        std::copy(inputTensor.begin(), inputTensor.end(), model->inputBuffer.begin());
+    }
+    MLResult result = classify(model, greenRatio);
+    pthread_mutex_unlock(&model->runMutex);
+    release(model);
+    return result;
+}
+
+MLResult ML::defaultResult()
 {
     MLResult result;
-    result.class_id = 2;  // Default to Healthy
+    result.class_id = HEALTHY_CLASS;  // Default to Healthy
     result.class_name = "Healthy";
     result.confidence = 1.0f;
     result.isValidPlant = true;
     result.entropy = 0.0f;
-    
-    // Mock mode if not initialized
-    if (!initialized) {
-        std::cout << "[ML] Mock mode: returning Healthy" << std::endl;
+    result.modelVersion = "mock";
+    return result;
+}
+
+MLResult ML::errorResult()
+{
+    MLResult result = defaultResult();
+    result.confidence = 0.0f;
+    result.isValidPlant = false;
+    result.entropy = 2.0f;
+    return result;
+}
+
+MLResult ML::classify(Model* model, float greenRatio)
+{
+    try {
+        // Input and output are bound to inputBuffer/outputBuffer at load time
+        Ort::Session* ortSession = static_cast<Ort::Session*>(model->session);
+        LS_TRACE_SPAN("ml.ort_run");
+        ortSession->Run(Ort::RunOptions{nullptr}, *static_cast<Ort::IoBinding*>(model->ioBinding));
+    } catch (const Ort::Exception& e) {
+        LS_ERROR("ML", "Inference error: {}", e.what());
+        MLResult result = errorResult();
+        result.modelVersion = model->version;
         return result;
     }
     
-    try {
-        // Preprocess image
-        std::vector<float> inputTensor = preprocess(imagePath);
-        
-        if (inputTensor.empty()) {
-            std::cerr << "[ML] Preprocessing failed, returning default" << std::endl;
-            return result;
+    MLResult result = scoreLogits(model->outputBuffer.data(), model->outputBuffer.size(), greenRatio);
+    result.modelVersion = model->version;
+    return result;
+}
+
+MLResult ML::scoreLogits(const float* logits, size_t count, float greenRatio)
+{
+    // Apply softmax
+    return scoreProbs(softmax(std::vector<float>(logits, logits + count)), greenRatio);
+}
+
+MLResult ML::scoreProbs(std::vector<float> probs, float greenRatio)
+{
+    MLResult result = defaultResult();
+    result.probs.swap(probs);
+    
+    // Find max probability
+    auto maxIt = std::max_element(result.probs.begin(), result.probs.end());
+    result.class_id = std::distance(result.probs.begin(), maxIt);
+    result.confidence = *maxIt;
+    
+    // Calculate entropy for out-of-distribution detection
+    result.entropy = calculateEntropy(result.probs);
+    
+    // Combined OOD check: entropy + confidence + green ratio
+    result.isValidPlant = checkValidPlant(result.entropy, result.confidence, greenRatio);
+    
+    if (result.class_id < (int)CLASS_NAMES.size()) {
+        result.class_name = CLASS_NAMES[result.class_id];
+    } else {
+        result.class_name = "Unknown";
+    }
+    
+    // Modify output if not a valid plant
+    if (!result.isValidPlant) {
+        LS_INFO("ML", "Out-of-distribution detected");
+        LS_INFO("ML", "Entropy: {}, Max confidence: {}%, Green ratio: {}%",
+                result.entropy, result.confidence * 100, greenRatio * 100);
+        result.class_name = "Unknown (Not a Plant)";
+        result.class_id = -1;  // Indicate invalid
+    }
+    
+    LS_INFO("ML", "Prediction: {} (confidence: {}%, entropy: {}, valid: {})",
+            result.class_name, result.confidence * 100, result.entropy,
+            result.isValidPlant ? "yes" : "no");
+    
+    return result;
+}
+
+/* ============================================================================
+ * Batch Inference
+ * ============================================================================ */
+
+/**
+ * @brief Work shared by the preprocessing threads of one chunk
+ *
+ * Workers take the next index from a counter, so a slow decode does not
+ * hold back the frames behind it.
+ */
+struct BatchPrepJob {
+    ML* ml;
+    const cv::Mat* frames;
+    const std::string* paths;
+    size_t first;                   ///< Index of the chunk's first input
+    size_t count;                   ///< Inputs in this chunk
+    float* tensors;                 ///< count consecutive CHW tensors
+    float* greenRatios;
+    char* ok;
+    std::atomic<size_t> next;
+};
+
+void ML::runPrepJob(BatchPrepJob* job)
+{
+    const size_t tensorSize = TENSOR_SIZE;
+    
+    for (size_t i = job->next++; i < job->count; i = job->next++) {
+        const size_t index = job->first + i;
+        cv::Mat decoded;
+        if (job->paths) {
+            decoded = cv::imread(job->paths[index]);
+            if (decoded.empty()) {
+                LS_ERROR("ML", "Failed to load image: {}", job->paths[index]);
+            }
         }
+        const cv::Mat& image = job->paths ? decoded : job->frames[index];
+        if (image.empty()) {
+            job->ok[i] = 0;
+            continue;
+        }
+        job->ok[i] = job->ml->preprocess(image, job->tensors + i * tensorSize, job->greenRatios[i]);
+    }
+}
+
+void ML::prepLoop()
+{
+    Tracer::setThreadName("tBatchPrep");
+    
+    pthread_mutex_lock(&prepMutex);
+    unsigned seen = prepGeneration;
+    for (;;) {
+        while (!prepStop && prepGeneration == seen) {
+            pthread_cond_wait(&prepCond, &prepMutex);
+        }
+        if (prepStop) break;
+        seen = prepGeneration;
+        BatchPrepJob* job = prepJob;
+        pthread_mutex_unlock(&prepMutex);
         
-        // Get session
-        Ort::Session* ortSession = static_cast<Ort::Session*>(session);
-        
-        // Create input tensor
-        std::vector<int64_t> inputShape = {1, 3, IMAGE_SIZE, IMAGE_SIZE};
-        
-        auto memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-        
-        Ort::Value inputOrt = Ort::Value::CreateTensor<float>(
-            memoryInfo,
-            inputTensor.data(),
-            inputTensor.size(),
-            inputShape.data(),
-            inputShape.size()
-        );
-        
-        // Get input/output names
-        Ort::AllocatorWithDefaultOptions allocator;
-        
-        auto inputNamePtr = ortSession->GetInputNameAllocated(0, allocator);
-        auto outputNamePtr = ortSession->GetOutputNameAllocated(0, allocator);
-        
-        const char* inputNames[] = {inputNamePtr.get()};
-        const char* outputNames[] = {outputNamePtr.get()};
-        
-        // Run inference
-        auto outputTensors = ortSession->Run(
-            Ort::RunOptions{nullptr},
-            inputNames,
-            &inputOrt,
-            1,
-            outputNames,
-            1
-        );
-        
-        // Get output
-        float* outputData = outputTensors[0].GetTensorMutableData<float>();
-        auto outputShape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
-        
-        int numClasses = static_cast<int>(outputShape[1]);
-        std::vector<float> logits(outputData, outputData + numClasses);
-        
-        // Apply softmax
-        result.probs = softmax(logits);
-        
-        // Find max probability
-        auto maxIt = std::max_element(result.probs.begin(), result.probs.end());
-        result.class_id = std::distance(result.probs.begin(), maxIt);
-        result.confidence = *maxIt;
-        
-        // Calculate entropy for out-of-distribution detection
-        result.entropy = calculateEntropy(result.probs);
-        
-        // Check green ratio for color-based OOD detection
-        float greenRatio = checkGreenRatio(imagePath);
+        runPrepJob(job);
         
-        // Combined OOD check: entropy + confidence + green ratio
-        result.isValidPlant = checkValidPlant(result.entropy, result.confidence, greenRatio);
+        pthread_mutex_lock(&prepMutex);
+        if (--prepPending == 0) {
+            pthread_cond_signal(&prepDoneCond);
+        }
+    }
+    pthread_mutex_unlock(&prepMutex);
+}
+
+void* ML::prepThreadFunc(void* arg)
+{
+    ((ML*)arg)->prepLoop();
+    return NULL;
+}
+
+void ML::runOnPool(BatchPrepJob* job)
+{
+    // Small jobs and concurrent batches (pool taken) run on the caller alone
+    if (job->count < 2 || prepThreads.empty() || pthread_mutex_trylock(&prepSubmitMutex) != 0) {
+        runPrepJob(job);
+        return;
+    }
+    
+    pthread_mutex_lock(&prepMutex);
+    prepJob = job;
+    prepPending = prepThreads.size();
+    prepGeneration++;
+    pthread_cond_broadcast(&prepCond);
+    pthread_mutex_unlock(&prepMutex);
+    
+    runPrepJob(job);  // The caller works too
+    
+    // Every pool thread must be done with job before it goes out of scope
+    pthread_mutex_lock(&prepMutex);
+    while (prepPending > 0) {
+        pthread_cond_wait(&prepDoneCond, &prepMutex);
+    }
+    prepJob = nullptr;
+    pthread_mutex_unlock(&prepMutex);
+    pthread_mutex_unlock(&prepSubmitMutex);
+}
+
+std::vector<MLResult> ML::analyzeBatch(const std::vector<cv::Mat>& frames)
+{
+    return analyzeBatch(frames.size(), frames.data(), nullptr, MAX_BATCH);
+}
+
+std::vector<MLResult> ML::analyzeBatch(const std::vector<std::string>& imagePaths)
+{
+    return analyzeBatch(imagePaths.size(), nullptr, imagePaths.data(), MAX_BATCH);
+}
+
+std::vector<MLResult> ML::analyzeBatch(size_t count, const cv::Mat* frames, const std::string* paths,
+                                       size_t chunk)
+{
+    std::vector<MLResult> results;
+    results.reserve(count);
+    // One model for the whole call, even if a swap happens meanwhile
+    Model* model = acquire();
+    if (!model) {
+        LS_DEBUG("ML", "Mock mode: returning Healthy");
+        results.assign(count, defaultResult());
+        return results;
+    }
+    
+    const size_t tensorSize = TENSOR_SIZE;
+    const size_t classes = model->outputBuffer.size();
+    chunk = std::max(std::min(chunk, count), static_cast<size_t>(1));
+    std::vector<float> tensors(chunk * tensorSize);
+    std::vector<float> greenRatios(chunk);
+    std::vector<char> ok(chunk);
+    
+    Ort::Session* ortSession = static_cast<Ort::Session*>(model->session);
+    auto memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    const char* inputNames[] = { model->inputName.c_str() };
+    const char* outputNames[] = { model->outputName.c_str() };
+    
+    for (size_t first = 0; first < count; first += chunk) {
+        const size_t n = std::min(count - first, chunk);
         
-        if (result.class_id < (int)CLASS_NAMES.size()) {
-            result.class_name = CLASS_NAMES[result.class_id];
-        } else {
-            result.class_name = "Unknown";
+        // 1. Decode and preprocess the chunk in parallel
+        BatchPrepJob job;
+        job.ml = this;
+        job.frames = frames;
+        job.paths = paths;
+        job.first = first;
+        job.count = n;
+        job.tensors = tensors.data();
+        job.greenRatios = greenRatios.data();
+        job.ok = ok.data();
+        job.next = 0;
+        {
+            LS_TRACE_SPAN("ml.batch_prepare");
+            runOnPool(&job);
         }
         
-        // Modify output if not a valid plant
-        if (!result.isValidPlant) {
-            std::cout << "[ML] Out-of-distribution detected: " << imagePath << std::endl;
-            std::cout << "[ML] Entropy: " << result.entropy << ", Max confidence: " 
-                      << (result.confidence * 100) << "%, Green ratio: " 
-                      << (greenRatio * 100) << "%" << std::endl;
-            result.class_name = "Unknown (Not a Plant)";
-            result.class_id = -1;  // Indicate invalid
+        // 2. One ORT call for the whole chunk (failed slots run on zeros
+        //    and are replaced below)
+        std::vector<float> logits;
+        bool ran = false;
+        if (model->batchDynamic) {
+            try {
+                LS_TRACE_SPAN("ml.ort_run_batch");
+                const int64_t shape[] = { static_cast<int64_t>(n), 3, IMAGE_SIZE, IMAGE_SIZE };
+                for (size_t i = 0; i < n; i++) {
+                    if (!ok[i]) std::fill_n(tensors.data() + i * tensorSize, tensorSize, 0.0f);
+                }
+                Ort::Value input = Ort::Value::CreateTensor<float>(
+                    memoryInfo, tensors.data(), n * tensorSize, shape, 4);
+                // Session::Run is thread-safe; the bound buffers are not used here
+                std::vector<Ort::Value> outputs = ortSession->Run(
+                    Ort::RunOptions{nullptr}, inputNames, &input, 1, outputNames, 1);
+                const float* data = outputs[0].GetTensorData<float>();
+                logits.assign(data, data + n * classes);
+                ran = true;
+            } catch (const Ort::Exception& e) {
+                LS_ERROR("ML", "Batch inference error: {}", e.what());
+            }
         }
         
-        std::cout << "[ML] Prediction: " << result.class_name 
-                  << " (confidence: " << (result.confidence * 100) << "%"
-                  << ", entropy: " << result.entropy 
-                  << ", valid: " << (result.isValidPlant ? "yes" : "no") << ")" << std::endl;
+        // 3. Score each frame
+        for (size_t i = 0; i < n; i++) {
+            if (!ok[i]) {
+                LS_ERROR("ML", "Preprocessing failed for batch item {}, returning default", first + i);
+                results.push_back(defaultResult());
+            } else if (ran) {
+                results.push_back(scoreLogits(logits.data() + i * classes, classes, greenRatios[i]));
+                results.back().modelVersion = model->version;
+            } else if (model->batchDynamic) {
+                results.push_back(errorResult());
+                results.back().modelVersion = model->version;
+            } else {
+                // Fixed batch of 1: run each frame through the bound buffers
+                pthread_mutex_lock(&model->runMutex);
+                std::copy_n(tensors.data() + i * tensorSize, tensorSize, model->inputBuffer.begin());
+                results.push_back(classify(model, greenRatios[i]));
+                pthread_mutex_unlock(&model->runMutex);
+            }
+        }
+    }
+    
+    release(model);
+    return results;
+}
+
+/* ============================================================================
+ * Tiled Inference
+ * ============================================================================ */
+
+void ML::setTiling(int grid, float overlap)
+{
+    tileGrid = grid >= 2 ? std::min(grid, static_cast<int>(MAX_TILE_GRID)) : 0;
+    tileOverlap = std::max(0.0f, std::min(overlap, 0.5f));
+    if (tileGrid) {
+        LS_INFO("ML", "Tiled inference: {}x{} tiles, {}% overlap, plus the full frame",
+                tileGrid, tileGrid, tileOverlap * 100);
+    }
+}
+
+MLResult ML::analyzeTiled(const cv::Mat& image, int grid, float overlap)
+{
+    LS_TRACE_SPAN("ml.analyze_tiled");
+    if (image.empty()) {
+        LS_ERROR("ML", "Empty frame");
+        return infer(std::vector<float>(), 0.0f);
+    }
+    grid = std::max(1, std::min(grid, static_cast<int>(MAX_TILE_GRID)));
+    overlap = std::max(0.0f, std::min(overlap, 0.5f));
+    
+    // The full frame first, then grid x grid tiles that together span it
+    std::vector<MLRegion> rects;
+    rects.push_back({ 0, 0, image.cols, image.rows, -1, 0.0f });
+    if (grid > 1) {
+        const float span = grid - (grid - 1) * overlap;  // Tiles per frame width
+        const int tileW = cvRound(image.cols / span);
+        const int tileH = cvRound(image.rows / span);
+        for (int r = 0; r < grid; r++) {
+            for (int c = 0; c < grid; c++) {
+                // The last row/column ends exactly at the frame edge
+                int x = (c == grid - 1) ? image.cols - tileW : cvRound(c * tileW * (1.0f - overlap));
+                int y = (r == grid - 1) ? image.rows - tileH : cvRound(r * tileH * (1.0f - overlap));
+                rects.push_back({ x, y, tileW, tileH, -1, 0.0f });
+            }
+        }
+    }
+    
+    // Crops share the frame's pixels; one ORT call for all of them
+    std::vector<cv::Mat> crops;
+    for (const MLRegion& rect : rects) {
+        crops.push_back(image(cv::Rect(rect.x, rect.y, rect.width, rect.height)));
+    }
+    std::vector<MLResult> tiles = analyzeBatch(crops.size(), crops.data(), nullptr, crops.size());
+    return aggregateTiles(tiles, rects);
+}
+
+MLResult ML::aggregateTiles(const std::vector<MLResult>& tiles, const std::vector<MLRegion>& rects)
+{
+    // Background crops (wall, tray) say nothing about the plant
+    std::vector<size_t> valid;
+    for (size_t i = 0; i < tiles.size(); i++) {
+        if (tiles[i].isValidPlant && !tiles[i].probs.empty()) {
+            valid.push_back(i);
+        }
+    }
+    if (tiles.size() == 1 || valid.empty()) {
+        return tiles[0];  // Mock mode, input error, or no plant anywhere
+    }
+    
+    // Unhealthy classes: highest tile probability; Healthy: lowest
+    const size_t classes = tiles[valid[0]].probs.size();
+    std::vector<float> pooled(classes, 0.0f);
+    if (HEALTHY_CLASS < static_cast<int>(classes)) {
+        pooled[HEALTHY_CLASS] = 1.0f;
+    }
+    for (size_t i : valid) {
+        for (size_t c = 0; c < classes && c < tiles[i].probs.size(); c++) {
+            pooled[c] = (static_cast<int>(c) == HEALTHY_CLASS) ? std::min(pooled[c], tiles[i].probs[c])
+                                                             : std::max(pooled[c], tiles[i].probs[c]);
+        }
+    }
+    float sum = std::accumulate(pooled.begin(), pooled.end(), 0.0f);
+    for (float& p : pooled) {
+        p /= sum;
+    }
+    
+    // Every valid tile already passed the green ratio check
+    MLResult result = scoreProbs(pooled, 1.0f);
+    result.modelVersion = tiles[valid[0]].modelVersion;
+    
+    // Regions: unhealthy tiles (not the full frame), merged where they overlap
+    if (result.isValidPlant) {
+        for (size_t i : valid) {
+            if (i == 0 || tiles[i].class_id == HEALTHY_CLASS ||
+                tiles[i].confidence < TILE_MIN_CONFIDENCE) {
+                continue;
+            }
+            MLRegion region = rects[i];
+            region.class_id = tiles[i].class_id;
+            region.confidence = tiles[i].confidence;
+            result.regions.push_back(region);
+        }
         
-    } catch (const Ort::Exception& e) {
-        std::cerr << "[ML] Inference error: " << e.what() << std::endl;
-        result.class_id = 2;
-        result.class_name = "Healthy";
-        result.confidence = 0.0f;
-        result.isValidPlant = false;
-        result.entropy = 2.0f;
+        bool merged = true;
+        while (merged) {
+            merged = false;
+            for (size_t a = 0; a < result.regions.size() && !merged; a++) {
+                for (size_t b = a + 1; b < result.regions.size() && !merged; b++) {
+                    MLRegion& ra = result.regions[a];
+                    const MLRegion& rb = result.regions[b];
+                    if (ra.class_id != rb.class_id ||
+                        ra.x >= rb.x + rb.width || rb.x >= ra.x + ra.width ||
+                        ra.y >= rb.y + rb.height || rb.y >= ra.y + ra.height) {
+                        continue;
+                    }
+                    int x2 = std::max(ra.x + ra.width, rb.x + rb.width);
+                    int y2 = std::max(ra.y + ra.height, rb.y + rb.height);
+                    ra.x = std::min(ra.x, rb.x);
+                    ra.y = std::min(ra.y, rb.y);
+                    ra.width = x2 - ra.x;
+                    ra.height = y2 - ra.y;
+                    ra.confidence = std::max(ra.confidence, rb.confidence);
+                    result.regions.erase(result.regions.begin() + b);
+                    merged = true;
+                }
+            }
+        }
     }
     
+    LS_INFO("ML", "Tiled: {} of {} crops on plant, {} region(s), result {}",
+            valid.size(), tiles.size(), result.regions.size(), result.class_name);
     return result;
 }
 
@@ -7,7 +7,7 @@
  */
 
 #include "drivers/actuators/AlertLed.h"
-#include <iostream>
+#include "Logger.h"
 #include <fcntl.h>   // For open()
 #include <unistd.h>  // For write(), close()
 #include <cstring>   // For strlen
@@ -61,8 +61,7 @@ void AlertLed::writeToDriver(const char* val)
     int fd = open(devicePath.c_str(), O_WRONLY);
     
     if (fd < 0) {
-        std::cerr << "[AlertLed] Error: Cannot open driver at " << devicePath 
-                  << ". Is the kernel module loaded?" << std::endl;
+        LS_ERROR("AlertLed", "Cannot open driver at {}. Is the kernel module loaded?", devicePath);
         return;
     }
     
@@ -70,7 +69,7 @@ void AlertLed::writeToDriver(const char* val)
     ssize_t bytesWritten = write(fd, val, 1);
     
     if (bytesWritten < 0) {
-        std::cerr << "[AlertLed] Error: Failed to write to driver." << std::endl;
+        LS_ERROR("AlertLed", "Failed to write to driver");
     }
     
     // Close the device file
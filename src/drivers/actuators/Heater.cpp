@@ -7,26 +7,29 @@
  */
 
 #include "Heater.h"
-#include <iostream>
+#include "Logger.h"
 
 /* ============================================================================
  * Construction / Destruction
  * ============================================================================ */
 
 Heater::Heater(int pin) 
-    : state(false), gpioPin(pin), initialized(false), chip(nullptr), line(nullptr) 
+    : state(false), gpioPin(pin), initialized(false), chip(nullptr), line(nullptr), sim(nullptr) 
 {
+    // No relay wired (e.g. simulated reservoir)
+    if (gpioPin < 0) return;
+    
     // Open GPIO chip (gpiochip0 for Raspberry Pi)
     chip = gpiod_chip_open_by_name("gpiochip0");
     if (!chip) {
-        std::cerr << "[Heater] WARNING: Cannot open gpiochip0, running in mock mode" << std::endl;
+        LS_WARN("Heater", "Cannot open gpiochip0, running in mock mode");
         return;
     }
     
     // Get the GPIO line
     line = gpiod_chip_get_line(chip, gpioPin);
     if (!line) {
-        std::cerr << "[Heater] WARNING: Cannot get GPIO line " << gpioPin << ", running in mock mode" << std::endl;
+        LS_WARN("Heater", "Cannot get GPIO line {}, running in mock mode", gpioPin);
         gpiod_chip_close(chip);
         chip = nullptr;
         return;
@@ -35,7 +38,7 @@ Heater::Heater(int pin)
     // Request line as output with initial value HIGH (heater off - inverted logic)
     int ret = gpiod_line_request_output(line, "leafsense-heater", 1);
     if (ret < 0) {
-        std::cerr << "[Heater] WARNING: Cannot request GPIO " << gpioPin << " as output, running in mock mode" << std::endl;
+        LS_WARN("Heater", "Cannot request GPIO {} as output, running in mock mode", gpioPin);
         gpiod_chip_close(chip);
         chip = nullptr;
         line = nullptr;
@@ -43,7 +46,7 @@ Heater::Heater(int pin)
     }
     
     initialized = true;
-    std::cout << "[Heater] GPIO " << gpioPin << " initialized successfully (libgpiod)" << std::endl;
+    LS_INFO("Heater", "GPIO {} initialized successfully (libgpiod)", gpioPin);
 }
 
 Heater::~Heater() 
@@ -57,7 +60,7 @@ Heater::~Heater()
     }
     if (chip) {
         gpiod_chip_close(chip);
-        std::cout << "[Heater] GPIO " << gpioPin << " released" << std::endl;
+        LS_INFO("Heater", "GPIO {} released", gpioPin);
     }
 }
 
@@ -69,17 +72,21 @@ void Heater::setState(bool on)
 {
     state = on;
     
+    if (sim) {
+        sim->setOutput(SIM_HEATER, on);
+    }
+    
     if (initialized && line) {
         // Real GPIO control via libgpiod
         // Note: Inverted logic - GPIO LOW = Heater ON, GPIO HIGH = Heater OFF
         int ret = gpiod_line_set_value(line, on ? 0 : 1);
         if (ret < 0) {
-            std::cerr << "[Heater] Error setting GPIO " << gpioPin << " value" << std::endl;
+            LS_ERROR("Heater", "Error setting GPIO {} value", gpioPin);
         } else {
-            std::cout << "[Heater] GPIO " << gpioPin << " -> " << (on ? "LOW (ON)" : "HIGH (OFF)") << std::endl;
+            LS_DEBUG("Heater", "GPIO {} -> {}", gpioPin, on ? "LOW (ON)" : "HIGH (OFF)");
         }
-    } else {
+    } else if (!sim) {
         // Mock mode fallback
-        std::cout << "[Heater] (MOCK) " << (on ? "ON" : "OFF") << std::endl;
+        LS_DEBUG("Heater", "(MOCK) {}", on ? "ON" : "OFF");
     }
 }
\ No newline at end of file
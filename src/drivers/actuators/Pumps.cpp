@@ -7,26 +7,30 @@
  */
 
 #include "Pumps.h"
-#include <iostream>
+#include "Logger.h"
 
 /* ============================================================================
  * Construction / Destruction
  * ============================================================================ */
 
 Pumps::Pumps(int pin) 
-    : gpioPin(pin), state(false), initialized(false), chip(nullptr), line(nullptr) 
+    : gpioPin(pin), state(false), initialized(false), chip(nullptr), line(nullptr)
+    , sim(nullptr), simOutput(SIM_NUTRIENTS) 
 {
+    // No relay wired (e.g. simulated reservoir)
+    if (gpioPin < 0) return;
+    
     // Open GPIO chip (gpiochip0 for Raspberry Pi)
     chip = gpiod_chip_open_by_name("gpiochip0");
     if (!chip) {
-        std::cerr << "[Pump GPIO" << gpioPin << "] WARNING: Cannot open gpiochip0, running in mock mode" << std::endl;
+        LS_WARN("Pump", "GPIO {}: cannot open gpiochip0, running in mock mode", gpioPin);
         return;
     }
     
     // Get the GPIO line
     line = gpiod_chip_get_line(chip, gpioPin);
     if (!line) {
-        std::cerr << "[Pump GPIO" << gpioPin << "] WARNING: Cannot get GPIO line, running in mock mode" << std::endl;
+        LS_WARN("Pump", "GPIO {}: cannot get GPIO line, running in mock mode", gpioPin);
         gpiod_chip_close(chip);
         chip = nullptr;
         return;
@@ -35,7 +39,7 @@ Pumps::Pumps(int pin)
     // Request line as output with initial value LOW (pump off)
     int ret = gpiod_line_request_output(line, "leafsense-pump", 0);
     if (ret < 0) {
-        std::cerr << "[Pump GPIO" << gpioPin << "] WARNING: Cannot request GPIO as output, running in mock mode" << std::endl;
+        LS_WARN("Pump", "GPIO {}: cannot request GPIO as output, running in mock mode", gpioPin);
         gpiod_chip_close(chip);
         chip = nullptr;
         line = nullptr;
@@ -43,7 +47,7 @@ Pumps::Pumps(int pin)
     }
     
     initialized = true;
-    std::cout << "[Pump GPIO" << gpioPin << "] Initialized successfully (libgpiod)" << std::endl;
+    LS_INFO("Pump", "GPIO {} initialized successfully (libgpiod)", gpioPin);
 }
 
 Pumps::~Pumps() 
@@ -57,7 +61,7 @@ Pumps::~Pumps()
     }
     if (chip) {
         gpiod_chip_close(chip);
-        std::cout << "[Pump GPIO" << gpioPin << "] Released" << std::endl;
+        LS_INFO("Pump", "GPIO {} released", gpioPin);
     }
 }
 
@@ -69,16 +73,20 @@ void Pumps::pump(bool on)
 {
     state = on;
     
+    if (sim) {
+        sim->setOutput(simOutput, on);
+    }
+    
     if (initialized && line) {
         // Real GPIO control via libgpiod
         int ret = gpiod_line_set_value(line, on ? 1 : 0);
         if (ret < 0) {
-            std::cerr << "[Pump GPIO" << gpioPin << "] Error setting value" << std::endl;
+            LS_ERROR("Pump", "GPIO {}: error setting value", gpioPin);
         } else {
-            std::cout << "[Pump GPIO" << gpioPin << "] -> " << (on ? "HIGH (ON)" : "LOW (OFF)") << std::endl;
+            LS_DEBUG("Pump", "GPIO {} -> {}", gpioPin, on ? "HIGH (ON)" : "LOW (OFF)");
         }
-    } else {
+    } else if (!sim) {
         // Mock mode fallback
-        std::cout << "[Pump GPIO" << gpioPin << "] (MOCK) " << (on ? "ON" : "OFF") << std::endl;
+        LS_DEBUG("Pump", "GPIO {} (MOCK) {}", gpioPin, on ? "ON" : "OFF");
     }
 }
\ No newline at end of file
@@ -1,133 +1,411 @@
 /**
  * @file ADC.cpp
  * @brief Implementation of ADS1115 ADC Driver with I2C support
- * 
- * Uses Linux I2C interface (/dev/i2c-1) to communicate with ADS1115.
+ *
+ * Uses the shared I2CBus to communicate with ADS1115.
  * Falls back to mock mode if I2C is not available.
  */
 
 #include "ADC.h"
+#include "Logger.h"
+#include "Trace.h"
 #include <cstdlib>
 #include <cstdint>
-#include <iostream>
-#include <fcntl.h>
-#include <unistd.h>
-#include <sys/ioctl.h>
-#include <linux/i2c-dev.h>
-#include <cstring>
+#include <poll.h>
+#include <time.h>
 #include <cerrno>
 
+/* ============================================================================
+ * ADS1115 Registers / Config Fields
+ * ============================================================================ */
+
+static const uint8_t REG_CONVERSION = 0x00;
+static const uint8_t REG_CONFIG     = 0x01;
+static const uint8_t REG_LO_THRESH  = 0x02;
+static const uint8_t REG_HI_THRESH  = 0x03;
+
+static const uint16_t CFG_OS_START  = 0x8000;  // Bit 15: start single conversion
+static const uint16_t CFG_PGA_4V096 = 0x0200;  // Bits 11-9: ±4.096V
+static const uint16_t CFG_MODE_SS   = 0x0100;  // Bit 8: single-shot (0 = continuous)
+static const uint16_t CFG_COMP_OFF  = 0x0003;  // Bits 1-0: comparator disabled
+static const uint16_t CFG_COMP_RDY  = 0x0000;  // Bits 1-0: assert after one conversion
+
+// Supported data rates and their DR field (bits 7-5)
+static const int RATE_SPS[8] = { 8, 16, 32, 64, 128, 250, 475, 860 };
+
+static uint64_t monotonicMs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000ULL + ts.tv_nsec / 1000000;
+}
+
 /* ============================================================================
  * Constructor
  * ============================================================================ */
 
-ADC::ADC(int addr) 
-    : i2cAddr(addr), i2cFd(-1), initialized(false)
+ADC::ADC(I2CBus* i2cBus, int addr)
+    : bus(i2cBus), i2cAddr(addr), initialized(false)
+    , dataRateBits(4 << 5), dataRateSps(128)
+    , readyPin(-1), chip(nullptr), readyLine(nullptr)
+    , scanning(false), scanCount(0), scanIndex(0), settleCount(0)
 {
-    // Try to open I2C bus
-    i2cFd = open("/dev/i2c-1", O_RDWR);
-    if (i2cFd < 0) {
-        std::cerr << "[ADC] Cannot open /dev/i2c-1: " << strerror(errno) << std::endl;
-        std::cout << "[ADC] Running in MOCK mode" << std::endl;
-        return;
+    for (int i = 0; i < NUM_CHANNELS; i++) {
+        scanList[i] = -1;
+        for (int j = 0; j < HISTORY_SIZE; j++) history[i][j] = 0.0f;
+        sampleCount[i] = 0;
+        sampleTimeMs[i] = 0;
+    }
+    pthread_mutex_init(&sampleMutex, NULL);
+    pthread_cond_init(&sampleCond, NULL);
+
+    if (i2cAddr < 0x48 || i2cAddr > 0x4B) {
+        LS_WARN("ADC", "0x{:x} is not an ADS1115 address (0x48-0x4B)", i2cAddr);
     }
-    
-    // Set I2C slave address
-    if (ioctl(i2cFd, I2C_SLAVE, i2cAddr) < 0) {
-        std::cerr << "[ADC] Cannot set I2C address 0x" << std::hex << i2cAddr << ": " << strerror(errno) << std::endl;
-        close(i2cFd);
-        i2cFd = -1;
-        std::cout << "[ADC] Running in MOCK mode" << std::endl;
+
+    if (!bus || !bus->isOpen()) {
+        LS_INFO("ADC", "Running in MOCK mode");
         return;
     }
-    
+
     initialized = true;
-    std::cout << "[ADC] I2C initialized successfully at address 0x" << std::hex << i2cAddr << std::dec << std::endl;
+    LS_INFO("ADC", "Using {} at address 0x{:x}", bus->getDevicePath(), i2cAddr);
 }
 
 ADC::~ADC()
 {
-    if (i2cFd >= 0) {
-        close(i2cFd);
-        std::cout << "[ADC] I2C connection closed" << std::endl;
+    stopScan();
+
+    if (readyLine) {
+        gpiod_line_release(readyLine);
+    }
+    if (chip) {
+        gpiod_chip_close(chip);
+    }
+
+    pthread_cond_destroy(&sampleCond);
+    pthread_mutex_destroy(&sampleMutex);
+}
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+int ADC::setDataRate(int sps)
+{
+    int index = 7;
+    for (int i = 0; i < 8; i++) {
+        if (RATE_SPS[i] >= sps) {
+            index = i;
+            break;
+        }
+    }
+    dataRateBits = static_cast<uint16_t>(index << 5);
+    dataRateSps = RATE_SPS[index];
+    return dataRateSps;
+}
+
+bool ADC::attachReadyPin(int gpioPin)
+{
+    if (gpioPin < 0 || readyLine) return false;
+
+    chip = gpiod_chip_open_by_name("gpiochip0");
+    if (!chip) {
+        LS_WARN("ADC", "Cannot open gpiochip0, ALERT/RDY not used");
+        return false;
+    }
+
+    readyLine = gpiod_chip_get_line(chip, gpioPin);
+    // ALERT/RDY is open-drain, active low (COMP_POL = 0): a conversion ends on the falling edge
+    if (!readyLine || gpiod_line_request_falling_edge_events(readyLine, "leafsense-adc-rdy") < 0) {
+        LS_WARN("ADC", "Cannot request GPIO {} for edge events", gpioPin);
+        gpiod_chip_close(chip);
+        chip = nullptr;
+        readyLine = nullptr;
+        return false;
+    }
+
+    // Hi_thresh MSB = 1 and Lo_thresh MSB = 0 turn the comparator into a conversion-ready output
+    if (initialized && (!writeRegister(REG_LO_THRESH, 0x0000) || !writeRegister(REG_HI_THRESH, 0x8000))) {
+        LS_WARN("ADC", "Cannot program ready thresholds");
+    }
+
+    readyPin = gpioPin;
+    LS_INFO("ADC", "0x{:x} ALERT/RDY on GPIO {}", i2cAddr, readyPin);
+    return true;
+}
+
+void ADC::enableChannel(int ch)
+{
+    if (ch < 0 || ch >= NUM_CHANNELS || scanning) return;
+    for (int i = 0; i < scanCount; i++) {
+        if (scanList[i] == ch) return;
+    }
+    scanList[scanCount++] = ch;
+}
+
+/* ============================================================================
+ * Register Access
+ * ============================================================================ */
+
+uint16_t ADC::buildConfig(int channel, bool singleShot) const
+{
+    uint16_t config = 0;
+    config |= ((channel & 0x03) + 4) << 12;  // MUX: AINx vs GND
+    config |= CFG_PGA_4V096;
+    config |= dataRateBits;
+    if (singleShot) {
+        config |= CFG_OS_START | CFG_MODE_SS;
     }
+    config |= readyLine ? CFG_COMP_RDY : CFG_COMP_OFF;
+    return config;
+}
+
+bool ADC::writeRegister(uint8_t reg, uint16_t value)
+{
+    return bus->writeRegister16(i2cAddr, reg, value);
+}
+
+bool ADC::readRegister(uint8_t reg, uint16_t &value)
+{
+    // One combined transaction (pointer write + repeated-start read)
+    return bus->readRegister16(i2cAddr, reg, value);
+}
+
+float ADC::toVoltage(uint16_t raw)
+{
+    // 16-bit signed, ±4.096V range
+    return (static_cast<int16_t>(raw) / 32768.0f) * 4.096f;
+}
+
+/* ============================================================================
+ * ALERT/RDY Events
+ * ============================================================================ */
+
+int ADC::getReadyFd() const
+{
+    return readyLine ? gpiod_line_event_get_fd(readyLine) : -1;
+}
+
+bool ADC::waitReady(int timeoutMs)
+{
+    struct pollfd pfd;
+    pfd.fd = getReadyFd();
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (pfd.fd < 0 || poll(&pfd, 1, timeoutMs) <= 0) return false;
+
+    struct gpiod_line_event event;
+    return gpiod_line_event_read(readyLine, &event) == 0;
+}
+
+/* ============================================================================
+ * Continuous Scan
+ * ============================================================================ */
+
+bool ADC::startScan()
+{
+    if (scanning) return true;
+    if (!initialized || !readyLine || scanCount == 0) return false;
+
+    scanIndex = 0;
+    settleCount = 0;
+    if (!writeRegister(REG_CONFIG, buildConfig(scanList[scanIndex], false))) {
+        LS_ERROR("ADC", "Cannot start continuous mode");
+        return false;
+    }
+
+    scanning = true;
+    LS_INFO("ADC", "0x{:x} scanning {} channel(s) at {} SPS", i2cAddr, scanCount, dataRateSps);
+    return true;
+}
+
+void ADC::stopScan()
+{
+    if (!scanning.exchange(false)) return;
+
+    // Back to single-shot: the device powers down between conversions
+    writeRegister(REG_CONFIG, buildConfig(scanList[scanIndex], false) | CFG_MODE_SS);
+
+    // Wake readers waiting for a first sample
+    pthread_mutex_lock(&sampleMutex);
+    pthread_cond_broadcast(&sampleCond);
+    pthread_mutex_unlock(&sampleMutex);
+}
+
+bool ADC::serviceReady()
+{
+    // Consume the edge; several pending edges still mean one fresh result
+    struct gpiod_line_event event;
+    if (gpiod_line_event_read(readyLine, &event) != 0) return false;
+    if (!scanning) return true;
+
+    uint16_t raw;
+    if (!readRegister(REG_CONVERSION, raw)) {
+        LS_ERROR("ADC", "I2C read error while scanning");
+        return false;
+    }
+
+    // The conversion running during a MUX write may still finish on the
+    // old input, so the first result after a switch is discarded
+    if (settleCount > 0) {
+        settleCount--;
+        return true;
+    }
+
+    int channel = scanList[scanIndex];
+    pthread_mutex_lock(&sampleMutex);
+    history[channel][sampleCount[channel] % HISTORY_SIZE] = toVoltage(raw);
+    sampleCount[channel]++;
+    sampleTimeMs[channel] = monotonicMs();
+    pthread_cond_broadcast(&sampleCond);
+    pthread_mutex_unlock(&sampleMutex);
+
+    if (scanCount > 1) {
+        // scanIndex follows the MUX: after a failed write the same channel
+        // keeps converting and the switch is retried on the next edge
+        int next = (scanIndex + 1) % scanCount;
+        if (!writeRegister(REG_CONFIG, buildConfig(scanList[next], false))) {
+            LS_ERROR("ADC", "I2C write error while scanning");
+            return false;
+        }
+        scanIndex = next;
+        settleCount = 1;
+    }
+    return true;
 }
 
 /* ============================================================================
  * Voltage Reading
  * ============================================================================ */
 
-float ADC::readVoltage(int channel) 
+uint64_t ADC::staleAfterMs() const
 {
+    // Each channel gets one stored and one discarded conversion per cycle
+    const int conversions = scanCount > 1 ? 2 * scanCount : 1;
+    return static_cast<uint64_t>(STALE_SCANS) * conversions * 1000 / dataRateSps + 1;
+}
+
+float ADC::readVoltage(int channel)
+{
+    return readAveraged(channel, 1);
+}
+
+float ADC::readAveraged(int channel, int n)
+{
+    LS_TRACE_SPAN("adc.convert");
+    if (n < 1) n = 1;
+
     if (!initialized) {
         // Mock mode: Generate random voltage between 0.0V and 3.0V
         float noise = (float)(rand() % 300) / 100.0;
         return noise;
     }
-    
+
+    if (scanning) {
+        if (channel < 0 || channel >= NUM_CHANNELS) return -1.0f;
+
+        // Mean of the latest scanned values; wait up to 250 ms for a fresh one
+        const uint64_t maxAgeMs = staleAfterMs();
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += 250 * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        pthread_mutex_lock(&sampleMutex);
+        while (scanning && (sampleCount[channel] == 0 ||
+                            monotonicMs() - sampleTimeMs[channel] > maxAgeMs)) {
+            if (pthread_cond_timedwait(&sampleCond, &sampleMutex, &deadline) == ETIMEDOUT) break;
+        }
+        uint64_t ageMs = monotonicMs() - sampleTimeMs[channel];
+        uint32_t stored = sampleCount[channel];
+        uint32_t used = stored;
+        if (used > static_cast<uint32_t>(n)) used = n;
+        if (used > static_cast<uint32_t>(HISTORY_SIZE)) used = HISTORY_SIZE;
+        float sum = 0.0f;
+        for (uint32_t i = 1; i <= used; i++) {
+            sum += history[channel][(stored - i) % HISTORY_SIZE];
+        }
+        pthread_mutex_unlock(&sampleMutex);
+
+        bool available = used > 0;
+        float voltage = available ? sum / used : -1.0f;
+
+        if (!available) {
+            LS_ERROR("ADC", "No scanned sample for channel {}", channel);
+            return -1.0f;
+        }
+        if (ageMs > maxAgeMs) {
+            LS_WARN("ADC", "Scanned sample for channel {} is {} ms old", channel, ageMs);
+            return -1.0f;
+        }
+        return voltage;
+    }
+
+    // Oversampling: failed conversions are skipped, all failing is an error
+    float sum = 0.0f;
+    int good = 0;
+    for (int i = 0; i < n; i++) {
+        float v = readSingleShot(channel);
+        if (v < 0.0f) continue;
+        sum += v;
+        good++;
+    }
+    return good > 0 ? sum / good : -1.0f;
+}
+
+float ADC::readSingleShot(int channel)
+{
     // Configure ADS1115 for single-ended reading on specified channel
     // Config register (0x01):
     // Bit 15: OS = 1 (start conversion)
     // Bits 14-12: MUX = channel (000=AIN0, 001=AIN1, 010=AIN2, 011=AIN3)
     // Bits 11-9: PGA = 001 (±4.096V)
     // Bit 8: MODE = 1 (single-shot)
-    // Bits 7-5: DR = 100 (128 SPS)
-    // Bits 4-0: comparator disabled
-    
-    uint16_t config = 0x8000;  // OS bit
-    config |= ((channel & 0x03) + 4) << 12;  // MUX: AINx vs GND
-    config |= 0x0200;  // PGA: ±4.096V
-    config |= 0x0100;  // Single-shot mode
-    config |= 0x0080;  // 128 SPS
-    
-    uint8_t configBytes[3];
-    configBytes[0] = 0x01;  // Config register
-    configBytes[1] = (config >> 8) & 0xFF;
-    configBytes[2] = config & 0xFF;
-    
-    // Write config
-    if (write(i2cFd, configBytes, 3) != 3) {
-        std::cerr << "[ADC] I2C write error on channel " << channel << std::endl;
+    // Bits 7-5: DR = selected data rate (default 100 = 128 SPS)
+    // Bits 4-0: comparator disabled, or conversion-ready with ALERT/RDY
+    if (!writeRegister(REG_CONFIG, buildConfig(channel, true))) {
+        LS_ERROR("ADC", "I2C write error on channel {}", channel);
         return -1.0f;
     }
-    
-    // Poll conversion ready bit (bit 15 of config register)
-    // This avoids using usleep() - proper hardware polling
-    uint8_t pollReg = 0x01;  // Config register
-    uint8_t pollBuffer[2];
-    int pollAttempts = 0;
-    const int maxPollAttempts = 100;  // Timeout after ~100 iterations
-    
-    do {
-        if (write(i2cFd, &pollReg, 1) != 1) break;
-        if (read(i2cFd, pollBuffer, 2) != 2) break;
-        pollAttempts++;
-    } while (((pollBuffer[0] & 0x80) == 0) && (pollAttempts < maxPollAttempts));
-    
-    if (pollAttempts >= maxPollAttempts) {
-        std::cerr << "[ADC] Conversion timeout on channel " << channel << std::endl;
-        return -1.0f;
+
+    if (readyLine) {
+        // Sleep on the ALERT/RDY edge: two conversion periods plus margin
+        int timeoutMs = 2 * (1000 / dataRateSps) + 10;
+        if (!waitReady(timeoutMs)) {
+            LS_ERROR("ADC", "Conversion timeout on channel {}", channel);
+            return -1.0f;
+        }
+    } else {
+        // Poll conversion ready bit (bit 15 of config register)
+        uint16_t status = 0;
+        int pollAttempts = 0;
+        const int maxPollAttempts = 100;  // Timeout after ~100 iterations
+
+        do {
+            if (!readRegister(REG_CONFIG, status)) break;
+            pollAttempts++;
+        } while (((status & CFG_OS_START) == 0) && (pollAttempts < maxPollAttempts));
+
+        if (pollAttempts >= maxPollAttempts) {
+            LS_ERROR("ADC", "Conversion timeout on channel {}", channel);
+            return -1.0f;
+        }
     }
-    
+
     // Read conversion register (0x00)
-    uint8_t regAddr = 0x00;
-    if (write(i2cFd, &regAddr, 1) != 1) {
-        std::cerr << "[ADC] I2C register select error" << std::endl;
-        return -1.0f;
-    }
-    
-    uint8_t readBuffer[2];
-    if (read(i2cFd, readBuffer, 2) != 2) {
-        std::cerr << "[ADC] I2C read error" << std::endl;
+    uint16_t rawValue;
+    if (!readRegister(REG_CONVERSION, rawValue)) {
+        LS_ERROR("ADC", "I2C read error");
         return -1.0f;
     }
-    
-    // Convert to voltage (16-bit signed, ±4.096V range)
-    int16_t rawValue = (readBuffer[0] << 8) | readBuffer[1];
-    float voltage = (rawValue / 32768.0f) * 4.096f;
-    
-    std::cout << "[ADC] Channel " << channel << ": Raw=" << rawValue 
-              << ", Voltage=" << voltage << "V" << std::endl;
-    
+
+    float voltage = toVoltage(rawValue);
+
+    LS_DEBUG("ADC", "Channel {}: Raw={}, Voltage={}V", channel, static_cast<int16_t>(rawValue), voltage);
+
     return voltage;
-}
\ No newline at end of file
+}
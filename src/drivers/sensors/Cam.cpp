@@ -4,8 +4,9 @@
  */
 
 #include "Cam.h"
+#include "Logger.h"
+#include "Trace.h"
 #include <opencv2/opencv.hpp>
-#include <iostream>
 #include <ctime>
 #include <sstream>
 #include <iomanip>
@@ -16,6 +17,7 @@
 #include <sys/ioctl.h>
 #include <linux/videodev2.h>
 #include <cstring>
+#include <vector>
 
 /* ============================================================================
  * Helper Functions
@@ -49,7 +51,8 @@ static bool isValidCaptureDevice(const char* device_path) {
  * @param input Input image (BGR format)
  * @return Enhanced image
  */
-static cv::Mat enhanceImage(const cv::Mat& input) {
+cv::Mat Cam::enhanceImage(const cv::Mat& input) {
+    LS_TRACE_SPAN("camera.enhance");
     if (input.empty()) return input;
     
     cv::Mat enhanced = input.clone();
@@ -91,10 +94,10 @@ static cv::Mat enhanceImage(const cv::Mat& input) {
 /**
  * @brief Try to capture using OpenCV with specified device
  * @param device Device number to try
- * @param filepath Output file path
+ * @param[out] image Enhanced BGR frame
  * @return true if capture succeeded
  */
-static bool tryOpenCVCapture(int device, const std::string& filepath) {
+static bool tryOpenCVCapture(int device, cv::Mat& image) {
     cv::VideoCapture camera;
     
     // Try different backends in order of preference
@@ -107,8 +110,7 @@ static bool tryOpenCVCapture(int device, const std::string& filepath) {
     for (const auto& backend : backends) {
         camera.open(device, backend);
         if (camera.isOpened()) {
-            std::cout << "[Camera] Opened device " << device 
-                      << " with backend " << backend << std::endl;
+            LS_INFO("Camera", "Opened device {} with backend {}", device, static_cast<int>(backend));
             break;
         }
     }
@@ -138,14 +140,24 @@ static bool tryOpenCVCapture(int device, const std::string& filepath) {
     }
     
     // Apply image enhancement
-    cv::Mat enhanced = enhanceImage(frame);
+    image = Cam::enhanceImage(frame);
+    return true;
+}
+
+/* ============================================================================
+ * Gallery Encoding
+ * ============================================================================ */
+
+bool Cam::saveImage(const cv::Mat& image, const std::string& filepath)
+{
+    LS_TRACE_SPAN("camera.encode");
+    if (image.empty()) return false;
     
-    // Save enhanced image as JPEG
     std::vector<int> compression_params;
     compression_params.push_back(cv::IMWRITE_JPEG_QUALITY);
     compression_params.push_back(85); // Quality 0-100
     
-    return cv::imwrite(filepath, enhanced, compression_params);
+    return cv::imwrite(filepath, image, compression_params);
 }
 
 /* ============================================================================
@@ -154,6 +166,22 @@ static bool tryOpenCVCapture(int device, const std::string& filepath) {
 
 std::string Cam::takePhoto() 
 {
+    cv::Mat image;
+    bool saved = false;
+    std::string filepath = capture(image, saved);
+    
+    if (filepath.empty()) return "";
+    if (!saved && !saveImage(image, filepath)) {
+        LS_ERROR("Camera", "Failed to write {}", filepath);
+        return "";
+    }
+    return filepath;
+}
+
+std::string Cam::capture(cv::Mat& image, bool& saved)
+{
+    LS_TRACE_SPAN("camera.capture");
+    saved = false;
     // Output directory for captured images
     const std::string OUTPUT_DIR = "/opt/leafsense/gallery/";
     
@@ -162,7 +190,7 @@ std::string Cam::takePhoto()
     if (stat(OUTPUT_DIR.c_str(), &info) != 0) {
         // Directory doesn't exist, create it
         if (mkdir(OUTPUT_DIR.c_str(), 0755) != 0) {
-            std::cerr << "[Camera] Failed to create gallery directory: " << OUTPUT_DIR << std::endl;
+            LS_ERROR("Camera", "Failed to create gallery directory: {}", OUTPUT_DIR);
             return ""; // Return empty string on failure
         }
     }
@@ -171,82 +199,78 @@ std::string Cam::takePhoto()
     std::time_t now = std::time(nullptr);
     std::tm* timeinfo = std::localtime(&now);
     std::ostringstream filename;
-    filename << OUTPUT_DIR << "plant_"
+    filename << OUTPUT_DIR << filePrefix << "_"
              << std::put_time(timeinfo, "%Y%m%d_%H%M%S")
              << ".jpg";
     
     std::string filepath = filename.str();
     
-    std::cout << "[Camera] Attempting capture to: " << filepath << std::endl;
+    LS_INFO("Camera", "Attempting capture to: {}", filepath);
     
     // Strategy 1: Use libcamera's cam utility FIRST (works with Pi Camera on modern kernels)
-    std::cout << "[Camera] Trying libcamera 'cam' utility..." << std::endl;
+    LS_DEBUG("Camera", "Trying libcamera 'cam' utility");
     
     // Capture using cam utility - saves as PPM, then convert to JPEG
     std::string ppmFile = filepath.substr(0, filepath.length() - 4) + ".ppm";
     std::ostringstream camCmd;
-    camCmd << "cam --camera=1 --capture=1 --stream width=640,height=480,pixelformat=BGR888 --file=" << ppmFile << " 2>/dev/null";
+    camCmd << "cam --camera=" << (cameraIndex >= 0 ? cameraIndex + 1 : 1) << " --capture=1 --stream width=640,height=480,pixelformat=BGR888 --file=" << ppmFile << " 2>/dev/null";
     
     int camResult = system(camCmd.str().c_str());
     if (camResult == 0) {
         // Check if PPM file was created
         struct stat st;
         if (stat(ppmFile.c_str(), &st) == 0 && st.st_size > 0) {
-            // Convert PPM to JPEG using OpenCV
+            // Uncompressed, so reading it back is cheap; JPEG encoding is
+            // left to the caller
             cv::Mat ppmImage = cv::imread(ppmFile);
+            std::remove(ppmFile.c_str()); // Delete temp PPM
             if (!ppmImage.empty()) {
-                cv::Mat enhanced = enhanceImage(ppmImage);
-                std::vector<int> params;
-                params.push_back(cv::IMWRITE_JPEG_QUALITY);
-                params.push_back(85);
-                if (cv::imwrite(filepath, enhanced, params)) {
-                    std::remove(ppmFile.c_str()); // Delete temp PPM
-                    std::cout << "[Camera] Captured via libcamera cam: " << filepath << std::endl;
-                    return filepath;
-                }
+                image = enhanceImage(ppmImage);
+                LS_INFO("Camera", "Captured via libcamera cam: {}", filepath);
+                return filepath;
             }
         }
     }
     
     // Strategy 2: Try libcamera-still if available
-    std::cout << "[Camera] Trying libcamera-still..." << std::endl;
+    LS_DEBUG("Camera", "Trying libcamera-still");
     std::ostringstream stillCmd;
-    stillCmd << "libcamera-still -o " << filepath << " --width 640 --height 480 -t 500 -n 2>/dev/null";
+    stillCmd << "libcamera-still";
+    if (cameraIndex >= 0) stillCmd << " --camera " << cameraIndex;
+    stillCmd << " -o " << filepath << " --width 640 --height 480 -t 500 -n 2>/dev/null";
     if (system(stillCmd.str().c_str()) == 0) {
         struct stat st;
         if (stat(filepath.c_str(), &st) == 0 && st.st_size > 0) {
-            std::cout << "[Camera] Captured via libcamera-still: " << filepath << std::endl;
+            // Already encoded by libcamera-still: decode once for analysis
+            image = cv::imread(filepath);
+            saved = true;
+            LS_INFO("Camera", "Captured via libcamera-still: {}", filepath);
             return filepath;
         }
     }
     
     // Strategy 3: Try OpenCV with video devices (USB webcam fallback)
-    std::cout << "[Camera] Trying OpenCV V4L2 devices..." << std::endl;
+    LS_DEBUG("Camera", "Trying OpenCV V4L2 devices");
     
-    const int devices_to_try[] = {0, 1, 2};
+    std::vector<int> devices_to_try = {0, 1, 2};
+    if (cameraIndex >= 0) devices_to_try = {cameraIndex};
     for (int device : devices_to_try) {
         std::ostringstream dev_path;
         dev_path << "/dev/video" << device;
         
         if (isValidCaptureDevice(dev_path.str().c_str())) {
-            std::cout << "[Camera] Trying device " << device << "..." << std::endl;
-            if (tryOpenCVCapture(device, filepath)) {
-                std::cout << "[Camera] Photo captured successfully: " << filepath << std::endl;
+            LS_DEBUG("Camera", "Trying device {}", device);
+            if (tryOpenCVCapture(device, image)) {
+                LS_INFO("Camera", "Photo captured successfully: {}", filepath);
                 return filepath;
             }
         }
     }
     
     // Strategy 4: Create realistic test pattern as absolute fallback
-    std::cerr << "╔══════════════════════════════════════════════════════════════════╗" << std::endl;
-    std::cerr << "║  WARNING: CAMERA HARDWARE NOT DETECTED                           ║" << std::endl;
-    std::cerr << "║  Generating TEST PATTERN instead of real camera capture         ║" << std::endl;
-    std::cerr << "║                                                                  ║" << std::endl;
-    std::cerr << "║  To fix:                                                         ║" << std::endl;
-    std::cerr << "║  1. Connect Raspberry Pi Camera Module to CSI port              ║" << std::endl;
-    std::cerr << "║  2. Check camera detected: vcgencmd get_camera                  ║" << std::endl;
-    std::cerr << "║  3. Enable camera in config.txt if needed                       ║" << std::endl;
-    std::cerr << "╚══════════════════════════════════════════════════════════════════╝" << std::endl;
+    LS_WARN("Camera", "Camera hardware not detected, generating a TEST PATTERN instead");
+    LS_WARN("Camera", "To fix: connect the camera to the CSI port, check 'vcgencmd get_camera', "
+                      "enable the camera in config.txt if needed");
     
     cv::Mat testImage(480, 640, CV_8UC3);
     
@@ -297,15 +321,7 @@ std::string Cam::takePhoto()
     cv::putText(testImage, watermark.str(), cv::Point(10, 470),
                 cv::FONT_HERSHEY_SIMPLEX, 0.4, cv::Scalar(200, 200, 200), 1);
     
-    std::vector<int> compression_params;
-    compression_params.push_back(cv::IMWRITE_JPEG_QUALITY);
-    compression_params.push_back(85);
-    
-    if (cv::imwrite(filepath, testImage, compression_params)) {
-        std::cout << "[Camera] Test image created: " << filepath << std::endl;
-        return filepath;
-    }
-    
-    std::cerr << "[Camera] All capture methods failed" << std::endl;
-    return "";
+    image = testImage;
+    LS_INFO("Camera", "Test image created: {}", filepath);
+    return filepath;
 }
\ No newline at end of file
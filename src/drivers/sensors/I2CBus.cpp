@@ -0,0 +1,167 @@
+/**
+ * @file I2CBus.cpp
+ * @brief Implementation of the Shared I2C Bus Manager
+ *
+ * Uses the Linux I2C_RDWR ioctl so that each transaction carries its
+ * own slave address: no I2C_SLAVE switching between devices, and a
+ * register read is a single syscall.
+ */
+
+#include "I2CBus.h"
+#include "Logger.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <cstring>
+#include <cerrno>
+
+/* ============================================================================
+ * Construction / Destruction
+ * ============================================================================ */
+
+I2CBus::I2CBus(const std::string& device, int retries)
+    : devicePath(device), fd(-1), maxRetries(retries < 0 ? 0 : retries)
+{
+    pthread_mutex_init(&busMutex, NULL);
+    memset(stats, 0, sizeof(stats));
+
+    fd = open(devicePath.c_str(), O_RDWR);
+    if (fd < 0) {
+        LS_WARN("I2CBus", "Cannot open {}: {}", devicePath, strerror(errno));
+        LS_INFO("I2CBus", "Running in MOCK mode");
+        return;
+    }
+
+    LS_INFO("I2CBus", "{} opened (combined transfers)", devicePath);
+}
+
+I2CBus::~I2CBus()
+{
+    if (fd >= 0) {
+        logStats();
+        close(fd);
+        LS_INFO("I2CBus", "{} closed", devicePath);
+    }
+    pthread_mutex_destroy(&busMutex);
+}
+
+/* ============================================================================
+ * Transfers
+ * ============================================================================ */
+
+bool I2CBus::transferLocked(int addr, const uint8_t* tx, size_t txLen, uint8_t* rx, size_t rxLen)
+{
+    struct i2c_msg msgs[2];
+    int count = 0;
+
+    if (txLen > 0) {
+        msgs[count].addr = static_cast<uint16_t>(addr);
+        msgs[count].flags = 0;
+        msgs[count].len = static_cast<uint16_t>(txLen);
+        msgs[count].buf = const_cast<uint8_t*>(tx);
+        count++;
+    }
+    if (rxLen > 0) {
+        msgs[count].addr = static_cast<uint16_t>(addr);
+        msgs[count].flags = I2C_M_RD;
+        msgs[count].len = static_cast<uint16_t>(rxLen);
+        msgs[count].buf = rx;
+        count++;
+    }
+    if (count == 0) {
+        // Zero-length write: address-only probe
+        msgs[0].addr = static_cast<uint16_t>(addr);
+        msgs[0].flags = 0;
+        msgs[0].len = 0;
+        msgs[0].buf = nullptr;
+        count = 1;
+    }
+
+    struct i2c_rdwr_ioctl_data data;
+    data.msgs = msgs;
+    data.nmsgs = count;
+    return ioctl(fd, I2C_RDWR, &data) == count;
+}
+
+bool I2CBus::transfer(int addr, const uint8_t* tx, size_t txLen, uint8_t* rx, size_t rxLen)
+{
+    if (fd < 0 || addr < 0 || addr > MAX_ADDRESS) return false;
+
+    pthread_mutex_lock(&busMutex);
+    bool ok = false;
+    for (int attempt = 0; attempt <= maxRetries; attempt++) {
+        if (attempt > 0) stats[addr].retries++;
+        if (transferLocked(addr, tx, txLen, rx, rxLen)) {
+            ok = true;
+            break;
+        }
+    }
+    if (ok) {
+        stats[addr].transfers++;
+    } else {
+        stats[addr].errors++;
+    }
+    pthread_mutex_unlock(&busMutex);
+
+    if (!ok) {
+        LS_ERROR("I2CBus", "Transfer to 0x{:x} failed: {}", addr, strerror(errno));
+    }
+    return ok;
+}
+
+bool I2CBus::writeRegister16(int addr, uint8_t reg, uint16_t value)
+{
+    uint8_t bytes[3];
+    bytes[0] = reg;
+    bytes[1] = (value >> 8) & 0xFF;
+    bytes[2] = value & 0xFF;
+    return transfer(addr, bytes, 3, nullptr, 0);
+}
+
+bool I2CBus::readRegister16(int addr, uint8_t reg, uint16_t& value)
+{
+    uint8_t buffer[2];
+    if (!transfer(addr, &reg, 1, buffer, 2)) return false;
+    value = static_cast<uint16_t>((buffer[0] << 8) | buffer[1]);
+    return true;
+}
+
+bool I2CBus::probe(int addr)
+{
+    if (fd < 0 || addr < 0 || addr > MAX_ADDRESS) return false;
+
+    // Single attempt, not counted: absence is an answer, not an error
+    uint8_t dummy;
+    pthread_mutex_lock(&busMutex);
+    bool ok = transferLocked(addr, nullptr, 0, &dummy, 1);
+    pthread_mutex_unlock(&busMutex);
+    return ok;
+}
+
+/* ============================================================================
+ * Diagnostics
+ * ============================================================================ */
+
+I2CDeviceStats I2CBus::getStats(int addr)
+{
+    I2CDeviceStats result = { 0, 0, 0 };
+    if (addr < 0 || addr > MAX_ADDRESS) return result;
+
+    pthread_mutex_lock(&busMutex);
+    result = stats[addr];
+    pthread_mutex_unlock(&busMutex);
+    return result;
+}
+
+void I2CBus::logStats()
+{
+    pthread_mutex_lock(&busMutex);
+    for (int addr = 0; addr <= MAX_ADDRESS; addr++) {
+        const I2CDeviceStats& s = stats[addr];
+        if (s.transfers == 0 && s.errors == 0) continue;
+        LS_INFO("I2CBus", "0x{:x}: {} ok, {} retries, {} errors", addr, s.transfers, s.retries, s.errors);
+    }
+    pthread_mutex_unlock(&busMutex);
+}
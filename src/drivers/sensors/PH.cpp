@@ -14,8 +14,9 @@
  */
 
 #include "PH.h"
+#include "Logger.h"
+#include "ReservoirSim.h"
 #include <cstdlib>
-#include <iostream>
 
 /* ============================================================================
  * Calibration Constants (adjust after calibration)
@@ -37,16 +38,27 @@ static const float PH_VOLTAGE_PER_PH = 0.18f;       // ~0.18V per pH unit (Nerns
 
 float PH::readSensor() 
 {
+    if (sim) {
+        // Simulated probe: noise comes from the model, filtering still applies
+        rawValue = sim->readPh();
+        realValue = filter.process(rawValue);
+        status = SENSOR_MOCK;
+        LS_DEBUG("pH", "Simulated: {} (raw {})", realValue, rawValue);
+        return realValue;
+    }
+    
     if (adc) {
-        // Read voltage from ADC channel
-        float voltage = adc->readVoltage(channel);
+        // Read voltage from ADC channel (oversampled per the filter settings)
+        float voltage = adc->readAveraged(channel, filter.getOversample());
         
         // Check if ADC read failed (returns -1.0 on error)
         if (voltage < 0.0f) {
             // Fallback to mock mode on ADC error
             float noise = (float)(rand() % 100) / 100.0f;
             realValue = 6.0f + noise;
-            std::cout << "[pH] ADC error, mock mode: " << realValue << std::endl;
+            rawValue = realValue;
+            status = SENSOR_FALLBACK;
+            LS_WARN("pH", "ADC error, mock mode: {}", realValue);
             return realValue;
         }
         
@@ -58,15 +70,17 @@ float PH::readSensor()
         // pH probes output ~2.5V at pH 7.0, with ~59mV change per pH unit at 25°C
         // Higher voltage = more acidic (lower pH)
         // Lower voltage = more alkaline (higher pH)
-        realValue = 7.0f + ((PH_NEUTRAL_VOLTAGE - voltage) / PH_VOLTAGE_PER_PH);
+        rawValue = 7.0f + ((PH_NEUTRAL_VOLTAGE - voltage) / PH_VOLTAGE_PER_PH);
+        status = SENSOR_OK;
         
         // Clamp to valid pH range
-        if (realValue < 0.0f) realValue = 0.0f;
-        if (realValue > 14.0f) realValue = 14.0f;
+        if (rawValue < 0.0f) { rawValue = 0.0f; status |= SENSOR_CLAMPED; }
+        if (rawValue > 14.0f) { rawValue = 14.0f; status |= SENSOR_CLAMPED; }
+        
+        // Control decisions use the filtered value
+        realValue = filter.process(rawValue);
         
-        std::cout << "[pH] Channel " << channel 
-                  << ": Voltage=" << voltage << "V, pH=" << realValue 
-                  << std::endl;
+        LS_DEBUG("pH", "Channel {}: Voltage={}V, pH={} (raw {})", channel, voltage, realValue, rawValue);
         
         return realValue;
     }
@@ -74,6 +88,8 @@ float PH::readSensor()
     // Mock mode: Returns random pH between 6.0 and 7.0
     float noise = (float)(rand() % 100) / 100.0f;
     realValue = 6.0f + noise;
-    std::cout << "[pH] Mock mode: " << realValue << std::endl;
+    rawValue = realValue;
+    status = SENSOR_MOCK;
+    LS_DEBUG("pH", "Mock mode: {}", realValue);
     return realValue;
 }
\ No newline at end of file
@@ -0,0 +1,180 @@
+/**
+ * @file ReservoirSim.cpp
+ * @brief Implementation of the Reservoir Physics Simulator
+ */
+
+#include "ReservoirSim.h"
+#include <cmath>
+#include <cstdio>
+
+static const double SECONDS_PER_DAY = 86400.0;
+static const double WATER_J_PER_L_C = 4186.0;   ///< Specific heat of 1 L of water
+static const float NEUTRAL_PH = 7.0f;           ///< Top-up water
+
+/* ============================================================================
+ * Construction / Destruction
+ * ============================================================================ */
+
+ReservoirSim::ReservoirSim(const ReservoirSimParams& p)
+    : params(p)
+    , rng(p.seed)
+    , gauss(0.0f, 1.0f)
+    , simSeconds(0.0)
+    , tempC(p.initialTempC)
+    , ph(p.initialPh)
+    , ecPpm(p.initialEcPpm)
+    , volumeL(p.volumeL)
+{
+    pthread_mutex_init(&simMutex, NULL);
+    for (int i = 0; i < SIM_ACTUATOR_COUNT; i++) {
+        outputs[i] = false;
+        dosedMl[i] = 0.0;
+    }
+}
+
+ReservoirSim::~ReservoirSim()
+{
+    pthread_mutex_destroy(&simMutex);
+}
+
+/* ============================================================================
+ * Physics
+ * ============================================================================ */
+
+void ReservoirSim::stepLocked(double dt)
+{
+    double dayFraction = std::fmod(simSeconds, SECONDS_PER_DAY) / SECONDS_PER_DAY;
+
+    // Ambient peaks mid-afternoon (15:00), lowest at 03:00
+    float ambient = params.ambientC
+        + params.ambientSwingC * static_cast<float>(std::sin(2.0 * M_PI * (dayFraction - 0.375)));
+
+    // Temperature: heater in, Newtonian loss out
+    double heatW = (outputs[SIM_HEATER] ? params.heaterW : 0.0f)
+                 - params.lossWPerC * (tempC - ambient);
+    tempC += static_cast<float>(heatW * dt / (volumeL * WATER_J_PER_L_C));
+    if (outputs[SIM_HEATER]) dosedMl[SIM_HEATER] += dt;
+
+    // Dosing: effect scales with the current volume
+    float ml = static_cast<float>(params.pumpMlPerS * dt);
+    if (outputs[SIM_PH_UP]) {
+        ph += ml * params.phPerMlPerL / volumeL;
+        volumeL += ml / 1000.0f;
+        dosedMl[SIM_PH_UP] += ml;
+    }
+    if (outputs[SIM_PH_DOWN]) {
+        ph -= ml * params.phPerMlPerL / volumeL;
+        volumeL += ml / 1000.0f;
+        dosedMl[SIM_PH_DOWN] += ml;
+    }
+    if (outputs[SIM_NUTRIENTS]) {
+        ecPpm += ml * params.ecPpmPerMlPerL / volumeL;
+        volumeL += ml / 1000.0f;
+        dosedMl[SIM_NUTRIENTS] += ml;
+    }
+
+    // Plant uptake
+    float dayStep = static_cast<float>(dt / SECONDS_PER_DAY);
+    ph += params.phDriftPerDay * dayStep;
+    ecPpm -= params.ecUptakePerDay * dayStep;
+    if (ecPpm < 0.0f) ecPpm = 0.0f;
+
+    // Evaporation leaves the salts behind
+    float evaporated = params.evaporationLPerDay * dayStep;
+    if (evaporated > 0.0f && volumeL > evaporated) {
+        ecPpm *= volumeL / (volumeL - evaporated);
+        volumeL -= evaporated;
+    }
+
+    // Float valve: fresh water at neutral pH and ambient temperature
+    if (params.topUpFraction > 0.0f && volumeL < params.topUpFraction * params.volumeL) {
+        float added = params.volumeL - volumeL;
+        ecPpm = ecPpm * volumeL / params.volumeL;
+        ph = (ph * volumeL + NEUTRAL_PH * added) / params.volumeL;
+        tempC = (tempC * volumeL + ambient * added) / params.volumeL;
+        volumeL = params.volumeL;
+    }
+
+    if (ph < 0.0f) ph = 0.0f;
+    if (ph > 14.0f) ph = 14.0f;
+
+    simSeconds += dt;
+}
+
+void ReservoirSim::advance(double seconds)
+{
+    pthread_mutex_lock(&simMutex);
+    while (seconds > 0.0) {
+        double dt = seconds < 1.0 ? seconds : 1.0;
+        stepLocked(dt);
+        seconds -= dt;
+    }
+    pthread_mutex_unlock(&simMutex);
+}
+
+void ReservoirSim::setOutput(SimActuator which, bool on)
+{
+    if (which < 0 || which >= SIM_ACTUATOR_COUNT) return;
+    pthread_mutex_lock(&simMutex);
+    outputs[which] = on;
+    pthread_mutex_unlock(&simMutex);
+}
+
+/* ============================================================================
+ * Probe Readings
+ * ============================================================================ */
+
+float ReservoirSim::noisyLocked(float value, float sigma)
+{
+    return sigma > 0.0f ? value + sigma * gauss(rng) : value;
+}
+
+float ReservoirSim::readTemperature()
+{
+    pthread_mutex_lock(&simMutex);
+    float value = noisyLocked(tempC, params.tempNoise);
+    pthread_mutex_unlock(&simMutex);
+    return value;
+}
+
+float ReservoirSim::readPh()
+{
+    pthread_mutex_lock(&simMutex);
+    float value = noisyLocked(ph, params.phNoise);
+    pthread_mutex_unlock(&simMutex);
+    return value;
+}
+
+float ReservoirSim::readEc()
+{
+    pthread_mutex_lock(&simMutex);
+    float value = noisyLocked(ecPpm, params.ecNoise);
+    pthread_mutex_unlock(&simMutex);
+    return value < 0.0f ? 0.0f : value;
+}
+
+/* ============================================================================
+ * Diagnostics
+ * ============================================================================ */
+
+double ReservoirSim::getSimSeconds()
+{
+    pthread_mutex_lock(&simMutex);
+    double t = simSeconds;
+    pthread_mutex_unlock(&simMutex);
+    return t;
+}
+
+std::string ReservoirSim::describe()
+{
+    char line[160];
+    pthread_mutex_lock(&simMutex);
+    snprintf(line, sizeof(line),
+             "day %.2f: T=%.2fC pH=%.2f EC=%.0fppm V=%.2fL "
+             "(heater %.0fs, pH+ %.0fmL, pH- %.0fmL, nutrients %.0fmL)",
+             simSeconds / SECONDS_PER_DAY, tempC, ph, ecPpm, volumeL,
+             dosedMl[SIM_HEATER], dosedMl[SIM_PH_UP], dosedMl[SIM_PH_DOWN],
+             dosedMl[SIM_NUTRIENTS]);
+    pthread_mutex_unlock(&simMutex);
+    return line;
+}
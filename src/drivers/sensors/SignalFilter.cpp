@@ -0,0 +1,168 @@
+/**
+ * @file SignalFilter.cpp
+ * @brief Implementation of the Per-Channel Digital Filter Chain
+ */
+
+#include "SignalFilter.h"
+
+/* ============================================================================
+ * FilterConfig
+ * ============================================================================ */
+
+FilterConfig FilterConfig::passthrough()
+{
+    FilterConfig cfg;
+    cfg.oversample = 1;
+    cfg.medianWindow = 1;
+    cfg.emaAlpha = 1.0f;
+    cfg.kalman = false;
+    cfg.kalmanQ = 0.0f;
+    cfg.kalmanR = 1.0f;
+    return cfg;
+}
+
+/* ============================================================================
+ * MedianFilter
+ * ============================================================================ */
+
+MedianFilter::MedianFilter(int size)
+    : window(1), count(0), head(0)
+{
+    setWindow(size);
+}
+
+void MedianFilter::setWindow(int size)
+{
+    if (size < 1) size = 1;
+    if (size > MAX_WINDOW) size = MAX_WINDOW;
+    if (size % 2 == 0) size--;  // Odd window: the median is a real sample
+    window = size;
+    reset();
+}
+
+void MedianFilter::reset()
+{
+    count = 0;
+    head = 0;
+}
+
+float MedianFilter::process(float value)
+{
+    ring[head] = value;
+    head = (head + 1) % window;
+    if (count < window) count++;
+
+    // Insertion sort on a stack copy (at most MAX_WINDOW elements)
+    float sorted[MAX_WINDOW];
+    for (int i = 0; i < count; i++) {
+        float v = ring[i];
+        int j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+
+    if (count % 2 == 1) return sorted[count / 2];
+    return 0.5f * (sorted[count / 2 - 1] + sorted[count / 2]);  // Window still filling
+}
+
+/* ============================================================================
+ * EmaFilter
+ * ============================================================================ */
+
+EmaFilter::EmaFilter(float a)
+    : alpha(1.0f), state(0.0f), primed(false)
+{
+    setAlpha(a);
+}
+
+void EmaFilter::setAlpha(float a)
+{
+    if (a <= 0.0f || a > 1.0f) a = 1.0f;
+    alpha = a;
+    primed = false;
+}
+
+float EmaFilter::process(float value)
+{
+    if (!primed) {
+        state = value;
+        primed = true;
+    } else {
+        state += alpha * (value - state);
+    }
+    return state;
+}
+
+/* ============================================================================
+ * KalmanFilter1D
+ * ============================================================================ */
+
+KalmanFilter1D::KalmanFilter1D(float processNoise, float measurementNoise)
+    : q(0.0f), r(1.0f), x(0.0f), p(0.0f), primed(false)
+{
+    setNoise(processNoise, measurementNoise);
+}
+
+void KalmanFilter1D::setNoise(float processNoise, float measurementNoise)
+{
+    q = processNoise < 0.0f ? 0.0f : processNoise;
+    r = measurementNoise > 0.0f ? measurementNoise : 1.0f;
+    primed = false;
+}
+
+float KalmanFilter1D::process(float value)
+{
+    if (!primed) {
+        // First measurement initialises the estimate with its own variance
+        x = value;
+        p = r;
+        primed = true;
+        return x;
+    }
+
+    // Predict (constant model), then correct
+    p += q;
+    float gain = p / (p + r);
+    x += gain * (value - x);
+    p *= (1.0f - gain);
+    return x;
+}
+
+/* ============================================================================
+ * SignalFilter
+ * ============================================================================ */
+
+SignalFilter::SignalFilter(const FilterConfig& cfg)
+    : config(cfg)
+{
+    configure(cfg);
+}
+
+void SignalFilter::configure(const FilterConfig& cfg)
+{
+    config = cfg;
+    if (config.oversample < 1) config.oversample = 1;
+    median.setWindow(config.medianWindow);
+    ema.setAlpha(config.emaAlpha);
+    kalmanFilter.setNoise(config.kalmanQ, config.kalmanR);
+}
+
+void SignalFilter::reset()
+{
+    median.reset();
+    ema.reset();
+    kalmanFilter.reset();
+}
+
+float SignalFilter::process(float value)
+{
+    float v = median.process(value);
+    v = ema.process(v);
+    if (config.kalman) {
+        v = kalmanFilter.process(v);
+    }
+    return v;
+}
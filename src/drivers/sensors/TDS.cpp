@@ -7,8 +7,9 @@
  */
 
 #include "TDS.h"
+#include "Logger.h"
+#include "ReservoirSim.h"
 #include <cstdlib>
-#include <iostream>
 
 /* ============================================================================
  * Sensor Reading with ADC Support
@@ -16,15 +17,26 @@
 
 float TDS::readSensor() 
 {
+    if (sim) {
+        // Simulated probe: noise comes from the model, filtering still applies
+        rawValue = sim->readEc();
+        realValue = filter.process(rawValue);
+        status = SENSOR_MOCK;
+        LS_DEBUG("TDS", "Simulated: {}ppm (raw {})", realValue, rawValue);
+        return realValue;
+    }
+    
     if (adc) {
-        // Read voltage from ADC channel
-        float voltage = adc->readVoltage(channel);
+        // Read voltage from ADC channel (oversampled per the filter settings)
+        float voltage = adc->readAveraged(channel, filter.getOversample());
         
         // Check if ADC read failed (returns -1.0 on error)
         if (voltage < 0.0f) {
             // Fallback to mock mode on ADC error
             realValue = 1200.0 + (rand() % 200);
-            std::cout << "[TDS] ADC error, mock mode: " << realValue << "ppm" << std::endl;
+            rawValue = realValue;
+            status = SENSOR_FALLBACK;
+            LS_WARN("TDS", "ADC error, mock mode: {}ppm", realValue);
             return realValue;
         }
         
@@ -32,21 +44,25 @@ float TDS::readSensor()
         // Typical TDS probe: 0V = 0ppm, 2.3V = ~1000ppm (linear approximation)
         // TDS = voltage * (1000 / 2.3) ≈ voltage * 435
         // Adjusted for typical hydroponics range (500-2000 ppm)
-        realValue = voltage * 435.0;
+        rawValue = voltage * 435.0;
+        status = SENSOR_OK;
         
         // Clamp to reasonable range
-        if (realValue < 0.0) realValue = 0.0;
-        if (realValue > 5000.0) realValue = 5000.0;
+        if (rawValue < 0.0) { rawValue = 0.0; status |= SENSOR_CLAMPED; }
+        if (rawValue > 5000.0) { rawValue = 5000.0; status |= SENSOR_CLAMPED; }
+        
+        // Control decisions use the filtered value
+        realValue = filter.process(rawValue);
         
-        std::cout << "[TDS] Channel " << channel 
-                  << ": Voltage=" << voltage << "V, EC=" << realValue << "ppm" 
-                  << std::endl;
+        LS_DEBUG("TDS", "Channel {}: Voltage={}V, EC={}ppm (raw {})", channel, voltage, realValue, rawValue);
         
         return realValue;
     }
     
     // Mock mode: Returns random EC/TDS around 1200-1400 ppm
     realValue = 1200.0 + (rand() % 200);
-    std::cout << "[TDS] Mock mode: " << realValue << "ppm" << std::endl;
+    rawValue = realValue;
+    status = SENSOR_MOCK;
+    LS_DEBUG("TDS", "Mock mode: {}ppm", realValue);
     return realValue;
 }
\ No newline at end of file
@@ -0,0 +1,263 @@
+/**
+ * @file W1Bus.cpp
+ * @brief Implementation of the 1-Wire Bus Master for DS18B20 Probes
+ *
+ * Kernel interface (w1-gpio + w1_therm):
+ * - <master>/w1_master_slaves : one slave id per line
+ * - <master>/therm_bulk_read  : write "trigger" to convert on all probes;
+ *                               reads -1 while a conversion is running
+ * - <id>/temperature          : millidegrees, returns the bulk result
+ * - <id>/w1_slave             : two-line format (older kernels)
+ */
+
+#include "W1Bus.h"
+#include "Logger.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+
+// 1-Wire device path
+static const char* W1_DEVICES_PATH = "/sys/bus/w1/devices/";
+
+/* ============================================================================
+ * Construction / Destruction
+ * ============================================================================ */
+
+W1Bus::W1Bus(const std::string& master)
+    : masterPath(std::string(W1_DEVICES_PATH) + master + "/")
+    , slavesFd(-1)
+    , bulkFd(-1)
+    , needsRefresh(false)
+{
+    pthread_mutex_init(&busMutex, NULL);
+
+    slavesFd = open((masterPath + "w1_master_slaves").c_str(), O_RDONLY);
+    if (slavesFd < 0) {
+        LS_INFO("W1Bus", "{} not found, running in MOCK mode", master);
+        return;
+    }
+
+    bulkFd = open((masterPath + "therm_bulk_read").c_str(), O_RDWR);
+    if (bulkFd < 0) {
+        LS_INFO("W1Bus", "therm_bulk_read unsupported, probes convert one by one");
+    }
+
+    pthread_mutex_lock(&busMutex);
+    readSlaveList(slaveList);
+    discoverLocked();
+    pthread_mutex_unlock(&busMutex);
+}
+
+W1Bus::~W1Bus()
+{
+    closeProbes();
+    if (bulkFd >= 0) close(bulkFd);
+    if (slavesFd >= 0) close(slavesFd);
+    pthread_mutex_destroy(&busMutex);
+}
+
+/* ============================================================================
+ * Discovery
+ * ============================================================================ */
+
+void W1Bus::closeProbes()
+{
+    for (size_t i = 0; i < probes.size(); i++) {
+        if (probes[i].fd >= 0) close(probes[i].fd);
+    }
+    probes.clear();
+}
+
+bool W1Bus::readSlaveList(std::string& list)
+{
+    char buffer[1024];
+    ssize_t n = pread(slavesFd, buffer, sizeof(buffer) - 1, 0);
+    if (n < 0) return false;
+    list.assign(buffer, static_cast<size_t>(n));
+    return true;
+}
+
+void W1Bus::discoverLocked()
+{
+    closeProbes();
+    needsRefresh = false;
+
+    size_t start = 0;
+    while (start < slaveList.size()) {
+        size_t end = slaveList.find('\n', start);
+        if (end == std::string::npos) end = slaveList.size();
+        std::string id = slaveList.substr(start, end - start);
+        start = end + 1;
+
+        // DS18B20 devices start with "28-"
+        if (id.compare(0, 3, "28-") != 0) continue;
+
+        Probe probe;
+        probe.id = id;
+        probe.legacy = false;
+        probe.fd = open((std::string(W1_DEVICES_PATH) + id + "/temperature").c_str(), O_RDONLY);
+        if (probe.fd < 0) {
+            probe.legacy = true;
+            probe.fd = open((std::string(W1_DEVICES_PATH) + id + "/w1_slave").c_str(), O_RDONLY);
+        }
+        if (probe.fd < 0) {
+            LS_ERROR("W1Bus", "Cannot open probe {}", id);
+            continue;
+        }
+        probes.push_back(probe);
+    }
+
+    // Stable order regardless of enumeration order
+    std::sort(probes.begin(), probes.end(),
+              [](const Probe& a, const Probe& b) { return a.id < b.id; });
+
+    LS_INFO("W1Bus", "{} DS18B20 probe(s)", probes.size());
+    for (size_t i = 0; i < probes.size(); i++) {
+        LS_INFO("W1Bus", "  {}", probes[i].id);
+    }
+}
+
+size_t W1Bus::refresh()
+{
+    if (slavesFd < 0) return 0;
+
+    pthread_mutex_lock(&busMutex);
+    std::string list;
+    if (readSlaveList(list) && (list != slaveList || needsRefresh)) {
+        slaveList = list;
+        discoverLocked();
+    }
+    size_t count = probes.size();
+    pthread_mutex_unlock(&busMutex);
+    return count;
+}
+
+std::vector<std::string> W1Bus::getProbeIds()
+{
+    std::vector<std::string> ids;
+    pthread_mutex_lock(&busMutex);
+    for (size_t i = 0; i < probes.size(); i++) {
+        ids.push_back(probes[i].id);
+    }
+    pthread_mutex_unlock(&busMutex);
+    return ids;
+}
+
+/* ============================================================================
+ * Bulk Conversion
+ * ============================================================================ */
+
+bool W1Bus::waitBulkDone(int timeoutMs)
+{
+    // Same timed-wait idiom as the timer thread (no usleep)
+    pthread_mutex_t waitMutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t waitCond = PTHREAD_COND_INITIALIZER;
+    const int stepMs = 50;
+    bool done = false;
+
+    for (int waited = 0; waited <= timeoutMs; waited += stepMs) {
+        char state[8] = {0};
+        if (pread(bulkFd, state, sizeof(state) - 1, 0) <= 0) break;
+        if (std::atoi(state) != -1) {
+            done = true;
+            break;
+        }
+
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += stepMs * 1000000L;
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+        pthread_mutex_lock(&waitMutex);
+        pthread_cond_timedwait(&waitCond, &waitMutex, &ts);
+        pthread_mutex_unlock(&waitMutex);
+    }
+
+    pthread_mutex_destroy(&waitMutex);
+    pthread_cond_destroy(&waitCond);
+    return done;
+}
+
+bool W1Bus::convertAll()
+{
+    LS_TRACE_SPAN("w1.convert");
+    refresh();
+    if (bulkFd < 0) return false;
+
+    pthread_mutex_lock(&busMutex);
+    bool ok = false;
+    if (!probes.empty()) {
+        static const char trigger[] = "trigger\n";
+        if (pwrite(bulkFd, trigger, sizeof(trigger) - 1, 0) < 0) {
+            LS_ERROR("W1Bus", "Bulk conversion trigger failed");
+        } else {
+            ok = waitBulkDone(1000);  // 750 ms at 12-bit resolution
+            if (!ok) LS_ERROR("W1Bus", "Bulk conversion timeout");
+        }
+    }
+    pthread_mutex_unlock(&busMutex);
+    return ok;
+}
+
+/* ============================================================================
+ * Reading
+ * ============================================================================ */
+
+bool W1Bus::parseTemperature(const char* text, bool legacy, float& celsius)
+{
+    const char* value = text;
+    if (legacy) {
+        // Line 1 ends in "YES" if the CRC matched, line 2 holds "t=<millidegrees>"
+        const char* newline = strchr(text, '\n');
+        if (!newline || newline - text < 3 || strncmp(newline - 3, "YES", 3) != 0) return false;
+        value = strstr(newline, "t=");
+        if (!value) return false;
+        value += 2;
+    }
+
+    char* end = nullptr;
+    long milli = std::strtol(value, &end, 10);
+    if (end == value) return false;
+
+    // 85 °C is the power-on reset value, i.e. a conversion that never ran
+    if (milli == 85000) return false;
+
+    celsius = milli / 1000.0f;
+    return true;
+}
+
+bool W1Bus::readProbe(const std::string& id, float& celsius)
+{
+    LS_TRACE_SPAN("w1.read");
+    pthread_mutex_lock(&busMutex);
+    const Probe* probe = nullptr;
+    bool automatic = id.empty() || id == "auto" || id == "mock_addr";
+    for (size_t i = 0; i < probes.size(); i++) {
+        if (automatic || probes[i].id == id) {
+            probe = &probes[i];
+            break;
+        }
+    }
+
+    bool ok = false;
+    if (probe) {
+        char buffer[128];
+        ssize_t n = pread(probe->fd, buffer, sizeof(buffer) - 1, 0);
+        if (n > 0) {
+            buffer[n] = '\0';
+            ok = parseTemperature(buffer, probe->legacy, celsius);
+        }
+        if (!ok) {
+            LS_ERROR("W1Bus", "Read failed on {}", probe->id);
+            needsRefresh = true;  // Probe may have been unplugged
+        }
+    }
+    pthread_mutex_unlock(&busMutex);
+    return ok;
+}
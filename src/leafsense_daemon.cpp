@@ -0,0 +1,131 @@
+/**
+ * @file leafsense_daemon.cpp
+ * @brief LeafSense Headless Daemon Entry Point
+ *
+ * Runs the backend without Qt or a display:
+ * - Message queue for thread communication
+ * - Database daemon for persistent storage
+ * - Master controller for sensor/actuator management
+ *
+ * Live readings are published to the GUI through shared memory and
+ * commands come back over a Unix socket (LiveState.h, ControlServer.h),
+ * so the GUI can be restarted or crash without interrupting control.
+ * Set gui.embedded_backend = false so the GUI does not start a second
+ * controller. Stops cleanly on SIGINT/SIGTERM.
+ *
+ * @author Daniel Cardoso, Marco Costa
+ * @version 1.0
+ */
+
+#include <pthread.h>
+#include <signal.h>
+#include <cstring>
+#include <iostream>
+
+#include "../include/middleware/MQueueHandler.h"
+#include "../include/middleware/dDatabase.h"
+#include "../include/middleware/Master.h"
+#include "../include/middleware/LiveState.h"
+#include "../include/middleware/ControlServer.h"
+#include "../include/middleware/Config.h"
+#include "../include/middleware/Logger.h"
+
+/* ============================================================================
+ * Thread Entry Points
+ * ============================================================================ */
+
+/**
+ * @brief Database daemon thread function
+ * @param arg Pointer to dDatabase instance
+ * @return NULL on completion
+ */
+static void* dbDaemonFunc(void* arg)
+{
+    ((dDatabase*)arg)->run();
+    return NULL;
+}
+
+/* ============================================================================
+ * Application Entry Point
+ * ============================================================================ */
+
+/**
+ * @brief Main function - Daemon entry point
+ * @param argc Argument count
+ * @param argv Argument vector (--db <path> overrides database.path)
+ * @return Exit code (0 = success)
+ */
+int main(int argc, char *argv[])
+{
+    std::string dbPath = Config::instance().getString("database.path", "/opt/leafsense/leafsense.db");
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--db") == 0 && i + 1 < argc) {
+            dbPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--db <path>]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Block termination signals before any thread exists; every backend
+    // thread inherits the mask and main() collects them with sigwait()
+    sigset_t stopSignals;
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, NULL);
+
+    // -------------------------------------------------------------------------
+    // 1. Initialize Backend Services
+    // -------------------------------------------------------------------------
+
+    MQueueHandler* mqueueToDB = new MQueueHandler();
+
+    dDatabase* dbDaemon = new dDatabase(mqueueToDB, dbPath);
+    pthread_t tDatabase;
+    pthread_create(&tDatabase, NULL, dbDaemonFunc, (void*)dbDaemon);
+
+    Master* systemMaster = new Master(mqueueToDB);
+
+    // GUI link: live state in shared memory, commands over the socket
+    const Config& config = Config::instance();
+    LiveState* liveState = LiveState::create(config.getString("ipc.shm", "/leafsense-live"));
+    if (liveState) systemMaster->attachLiveState(liveState);
+
+    ControlServer* controlServer = new ControlServer(
+        config.getString("ipc.socket", "/var/run/leafsense.sock"), liveState,
+        [systemMaster](const std::string& line, ControlServer::PendingReply& later) {
+            return systemMaster->handleCommand(line, later);
+        });
+    controlServer->start();
+
+    systemMaster->start();
+
+    LS_INFO("System", "Headless daemon running (database {})", dbPath);
+
+    // -------------------------------------------------------------------------
+    // 2. Wait for SIGINT/SIGTERM
+    // -------------------------------------------------------------------------
+
+    int sig = 0;
+    sigwait(&stopSignals, &sig);
+    LS_INFO("System", "Signal {} received, stopping backend services", sig);
+
+    // -------------------------------------------------------------------------
+    // 3. Cleanup
+    // -------------------------------------------------------------------------
+
+    delete controlServer;  // No more commands into a stopping Master
+    systemMaster->stop();
+    dbDaemon->stop();
+    pthread_join(tDatabase, NULL);
+
+    delete systemMaster;
+    delete liveState;
+    delete dbDaemon;
+    delete mqueueToDB;
+
+    // Flush records still queued by the backend threads
+    Logger::instance().shutdown();
+    return 0;
+}
@@ -0,0 +1,265 @@
+/**
+ * @file leafsense_rescore.cpp
+ * @brief Gallery Re-Scoring Tool
+ *
+ * Runs the current model over every image recorded in plant_images and
+ * adds one ml_predictions row per image, tagged with model_version, so a
+ * new model can be rolled out without waiting for fresh captures. The
+ * GUI shows the newest prediction of each image; earlier rows are kept
+ * for comparison. Images that already have a prediction with this
+ * model_version are skipped, so an interrupted run can be restarted.
+ *
+ * Results are looked up in the inference cache first (ml_result_cache,
+ * keyed on plant_images.image_hash), so duplicate images and images an
+ * earlier run already scored with this model never reach the model.
+ * Rows captured before image_hash was recorded are hashed here and
+ * backfilled. This tool is the only writer of ml_result_cache; after a
+ * run it prunes the table to ml.cache_max_rows / ml.cache_max_age_days.
+ *
+ * A cache key always names the pixels the model saw. The camera pipeline
+ * hashes the captured frame; the JPEG in the gallery decodes to slightly
+ * different pixels. Results for rows that already carry a capture hash
+ * are therefore written to ml_predictions only, never to the cache under
+ * that hash. Backfilled rows are hashed from the decoded file, so their
+ * results are cached.
+ *
+ *   leafsense-rescore [--db <path>] [--model <file.onnx>]
+ *                     [--model-version <tag>] [--zone <id>]
+ *
+ * Defaults come from leafsense.conf (database.path, ml.dir, ml.variant).
+ * The model version defaults to ML::getModelVersion(). Images whose
+ * file is missing or cannot be decoded are skipped, not scored. Safe to run next to the
+ * daemon: each chunk is committed in one short transaction.
+ *
+ * @author Daniel Cardoso, Marco Costa
+ * @version 1.0
+ */
+
+#include <unistd.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../include/middleware/dbManager.h"
+#include "../include/middleware/Config.h"
+#include "../include/middleware/Logger.h"
+#include "../include/application/ml/ML.h"
+#include "../include/application/ml/InferenceCache.h"
+
+#include <opencv2/opencv.hpp>
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+/** Images handed to ML::analyzeBatch() and committed per transaction */
+static const size_t CHUNK_SIZE = 32;
+
+/**
+ * @brief Doubles single quotes for use inside an SQL string literal
+ */
+static std::string sqlQuote(const std::string& text)
+{
+    std::string quoted = text;
+    size_t pos = 0;
+    while ((pos = quoted.find("'", pos)) != std::string::npos) {
+        quoted.replace(pos, 1, "''");
+        pos += 2;
+    }
+    return quoted;
+}
+
+/**
+ * @brief Splits a model path into directory and file name
+ */
+static void splitPath(const std::string& path, std::string& dir, std::string& name)
+{
+    size_t slash = path.find_last_of('/');
+    if (slash == std::string::npos) {
+        dir = ".";
+        name = path;
+    } else {
+        dir = path.substr(0, slash);
+        name = path.substr(slash + 1);
+    }
+}
+
+/* ============================================================================
+ * Entry Point
+ * ============================================================================ */
+
+int main(int argc, char *argv[])
+{
+    const Config& config = Config::instance();
+    std::string dbPath = config.getString("database.path", "/opt/leafsense/leafsense.db");
+    std::string modelDir = config.getString("ml.dir", "/opt/leafsense");
+    std::string modelName = ML::resolveModel(modelDir, config.getString("ml.variant", "fp32"));
+    std::string modelVersion;
+    int zoneId = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--db") == 0 && i + 1 < argc) {
+            dbPath = argv[++i];
+        } else if (strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+            splitPath(argv[++i], modelDir, modelName);
+        } else if (strcmp(argv[i], "--model-version") == 0 && i + 1 < argc) {
+            modelVersion = argv[++i];
+        } else if (strcmp(argv[i], "--zone") == 0 && i + 1 < argc) {
+            zoneId = atoi(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--db <path>] [--model <file.onnx>] [--model-version <tag>] [--zone <id>]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // 1. Load the model (refuse to write mock predictions)
+    // -------------------------------------------------------------------------
+
+    ML ml(modelDir, modelName);
+    if (!ml.isInitialized()) {
+        std::cerr << "[Rescore] Model " << modelDir << "/" << modelName << " could not be loaded" << std::endl;
+        return 1;
+    }
+    if (modelVersion.empty()) {
+        modelVersion = ml.getModelVersion();
+    }
+    InferenceCache cache(static_cast<size_t>(std::max(1, config.getInt("ml.cache_entries", 256))), dbPath);
+
+    // -------------------------------------------------------------------------
+    // 2. List the gallery
+    // -------------------------------------------------------------------------
+
+    dbManager db(dbPath);
+    db.execute("PRAGMA busy_timeout = 5000;");  // The daemon may be writing
+
+    std::stringstream query;
+    query << "SELECT pi.id, pi.filepath, pi.image_hash FROM plant_images pi "
+          << "WHERE NOT EXISTS (SELECT 1 FROM ml_predictions mp WHERE mp.image_id = pi.id "
+          << "AND mp.model_version = '" << sqlQuote(modelVersion) << "')";
+    if (zoneId > 0) query << " AND pi.zone_id = " << zoneId;
+    query << " ORDER BY pi.id;";
+    DBResult images = db.read(query.str());
+
+    std::vector<std::string> ids;
+    std::vector<std::string> paths;
+    std::vector<std::string> hashes;
+    size_t missing = 0;
+    for (const std::vector<std::string>& row : images.rows) {
+        if (row.size() < 3 || access(row[1].c_str(), R_OK) != 0) {
+            missing++;
+            continue;
+        }
+        ids.push_back(row[0]);
+        paths.push_back(row[1]);
+        hashes.push_back(row[2] == "NULL" ? "" : row[2]);
+    }
+
+    std::cout << "[Rescore] " << paths.size() << " images (" << missing << " missing on disk), model "
+              << modelVersion << std::endl;
+
+    // -------------------------------------------------------------------------
+    // 3. Score in chunks, one transaction per chunk
+    // -------------------------------------------------------------------------
+
+    std::map<std::string, size_t> perClass;
+    size_t written = 0;
+    size_t unreadable = 0;
+    size_t fromCache = 0;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (size_t first = 0; first < paths.size(); first += CHUNK_SIZE) {
+        const size_t n = std::min(CHUNK_SIZE, paths.size() - first);
+        std::vector<MLResult> results(n);
+        std::stringstream sql;
+        sql << "BEGIN;";
+
+        // Cache first; unhashed rows are decoded once here (hash backfill)
+        // and handed to the model as frames, hashed rows as paths
+        std::vector<size_t> pathSlots, frameSlots;
+        std::vector<std::string> missPaths;
+        std::vector<cv::Mat> missFrames;
+        for (size_t i = 0; i < n; i++) {
+            std::string& hash = hashes[first + i];
+            cv::Mat decoded;
+            if (hash.empty()) {
+                decoded = cv::imread(paths[first + i]);
+                hash = ML::imageHash(decoded);
+                if (!hash.empty()) {
+                    sql << "UPDATE plant_images SET image_hash = '" << hash << "' WHERE id = " << ids[first + i] << ";";
+                }
+            }
+            if (cache.lookup(hash, ml.getModelVersion(), results[i])) {
+                fromCache++;
+            } else if (!decoded.empty()) {
+                frameSlots.push_back(i);
+                missFrames.push_back(decoded);
+            } else {
+                pathSlots.push_back(i);
+                missPaths.push_back(paths[first + i]);
+            }
+        }
+
+        std::vector<MLResult> fromPaths = ml.analyzeBatch(missPaths);
+        std::vector<MLResult> fromFrames = ml.analyzeBatch(missFrames);
+        for (size_t k = 0; k < pathSlots.size(); k++) results[pathSlots[k]] = fromPaths[k];
+        for (size_t k = 0; k < frameSlots.size(); k++) results[frameSlots[k]] = fromFrames[k];
+        // Path results come from the decoded JPEG, not the frame behind the
+        // row's capture hash: only results for decoded-file hashes are cached
+        for (size_t slot : frameSlots) cache.store(hashes[first + slot], ml.getModelVersion(), results[slot]);
+
+        for (size_t i = 0; i < n; i++) {
+            // Only real model outputs carry probabilities; the default
+            // result of a failed decode must not be stored as "Healthy"
+            if (results[i].probs.empty()) {
+                unreadable++;
+                continue;
+            }
+            const std::string label = sqlQuote(results[i].class_name);
+            sql << "INSERT INTO ml_predictions (image_id, prediction_type, prediction_label, confidence, model_version) "
+                << "VALUES (" << ids[first + i] << ", '" << label << "', '" << label << "', "
+                << results[i].confidence << ", '" << sqlQuote(modelVersion) << "');";
+            perClass[results[i].class_name]++;
+            written++;
+        }
+        sql << "COMMIT;";
+
+        if (!db.execute(sql.str())) {
+            db.execute("ROLLBACK;");
+            std::cerr << "[Rescore] Stopped at image " << first << ", earlier chunks were kept" << std::endl;
+            return 1;
+        }
+        std::cout << "[Rescore] " << first + n << "/" << paths.size() << std::endl;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    // This tool is the only writer of ml_result_cache, so it bounds it too
+    size_t pruned = cache.prune(config.getInt("ml.cache_max_rows", 20000),
+                                config.getInt("ml.cache_max_age_days", 180));
+
+    // -------------------------------------------------------------------------
+    // 4. Summary
+    // -------------------------------------------------------------------------
+
+    std::cout << "[Rescore] " << written << " predictions written in " << seconds << " s";
+    if (seconds > 0) std::cout << " (" << written / seconds << " images/s)";
+    std::cout << ", " << fromCache << " from the cache, " << pruned << " cache rows pruned" << std::endl;
+    if (unreadable > 0) std::cout << "[Rescore] " << unreadable << " images could not be decoded" << std::endl;
+    for (const auto& entry : perClass) {
+        std::cout << "  " << entry.first << ": " << entry.second << std::endl;
+    }
+
+    Logger::instance().shutdown();
+    return 0;
+}
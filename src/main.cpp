@@ -8,6 +8,10 @@
  * - Master controller for sensor/actuator management
  * - Qt GUI with login and main window
  * 
+ * With gui.embedded_backend = false the backend is left to
+ * leafsense-daemon: live readings come from its shared memory and
+ * commands go over its control socket (LiveClient.h).
+ * 
  * @author Daniel Cardoso, Marco Costa
  * @version 1.0
  */
@@ -24,6 +28,9 @@
 #include "../include/middleware/MQueueHandler.h"
 #include "../include/middleware/dDatabase.h"
 #include "../include/middleware/Master.h"
+#include "../include/middleware/LiveClient.h"
+#include "../include/middleware/Config.h"
+#include "../include/middleware/Logger.h"
 
 /* ============================================================================
  * Global System Components
@@ -33,6 +40,7 @@ Master* systemMaster = nullptr;         ///< Main system controller
 dDatabase* dbDaemon = nullptr;          ///< Database daemon
 MQueueHandler* mqueueToDB = nullptr;    ///< Message queue handler
 pthread_t tDatabase;                    ///< Database thread
+LiveClient* liveClient = nullptr;       ///< Link to leafsense-daemon
 
 /* ============================================================================
  * Thread Entry Points
@@ -64,13 +72,18 @@ void performCleanup()
     qDebug() << "[System] Stopping backend services...";
     
     if (systemMaster) systemMaster->stop();
-    if (dbDaemon) dbDaemon->stop();
-    
-    pthread_join(tDatabase, NULL);
+    if (dbDaemon) {
+        dbDaemon->stop();
+        pthread_join(tDatabase, NULL);
+    }
     
     delete systemMaster; 
     delete dbDaemon; 
     delete mqueueToDB;
+    delete liveClient;
+    
+    // Flush records still queued by the backend threads
+    Logger::instance().shutdown();
     
     qDebug() << "[System] Cleanup done.";
 }
@@ -108,19 +121,27 @@ int main(int argc, char *argv[])
     app.setApplicationName("LeafSense");
 
     // -------------------------------------------------------------------------
-    // 1. Initialize Backend Services
+    // 1. Initialize Backend Services (unless leafsense-daemon runs them)
     // -------------------------------------------------------------------------
     
-    // Create message queue for inter-thread communication
-    mqueueToDB = new MQueueHandler();
-    
-    // Start database daemon thread (use absolute path for Pi deployment)
-    dbDaemon = new dDatabase(mqueueToDB, "/opt/leafsense/leafsense.db"); 
-    pthread_create(&tDatabase, NULL, dbDaemonFunc, (void*)dbDaemon);
-    
-    // Start master controller (manages sensors and actuators)
-    systemMaster = new Master(mqueueToDB);
-    systemMaster->start(); 
+    if (Config::instance().getBool("gui.embedded_backend", true)) {
+        // Create message queue for inter-thread communication
+        mqueueToDB = new MQueueHandler();
+        
+        // Start database daemon thread (use absolute path for Pi deployment)
+        dbDaemon = new dDatabase(mqueueToDB,
+            Config::instance().getString("database.path", "/opt/leafsense/leafsense.db"));
+        pthread_create(&tDatabase, NULL, dbDaemonFunc, (void*)dbDaemon);
+        
+        // Start master controller (manages sensors and actuators)
+        systemMaster = new Master(mqueueToDB);
+        systemMaster->start(); 
+    } else {
+        qDebug() << "[System] Backend runs in leafsense-daemon";
+        liveClient = new LiveClient(
+            Config::instance().getString("ipc.socket", "/var/run/leafsense.sock"),
+            Config::instance().getString("ipc.shm", "/leafsense-live"));
+    }
 
     // -------------------------------------------------------------------------
     // 2. Initialize GUI
@@ -143,6 +164,8 @@ int main(int argc, char *argv[])
             p.id = 1; 
             p.name = "Lettuce"; 
             w->set_selected_plant(p);
+            w->set_sensor_snapshot(systemMaster ? systemMaster->getSensorSnapshot() : nullptr);
+            if (liveClient) w->set_live_client(liveClient);
             w->show();
             
             int res = app.exec();
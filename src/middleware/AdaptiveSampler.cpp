@@ -0,0 +1,105 @@
+/**
+ * @file AdaptiveSampler.cpp
+ * @brief Implementation of Per-Sensor Adaptive Sampling Interval
+ */
+
+#include "AdaptiveSampler.h"
+#include <cmath>
+
+/* ============================================================================
+ * Constructor / Destructor
+ * ============================================================================ */
+
+AdaptiveSampler::AdaptiveSampler(const SamplingLimits& lim, int initialTicks)
+    : limits(lim)
+    , countdown(0)      // First reading happens on the first tick
+    , hasLast(false)
+    , lastValue(0.0f)
+    , lastMs(0)
+{
+    if (limits.minTicks < 1) limits.minTicks = 1;
+    if (limits.maxTicks < limits.minTicks) limits.maxTicks = limits.minTicks;
+
+    interval = initialTicks;
+    if (interval < limits.minTicks) interval = limits.minTicks;
+    if (interval > limits.maxTicks) interval = limits.maxTicks;
+
+    pthread_mutex_init(&mutex, NULL);
+}
+
+AdaptiveSampler::~AdaptiveSampler()
+{
+    pthread_mutex_destroy(&mutex);
+}
+
+/* ============================================================================
+ * Scheduling
+ * ============================================================================ */
+
+bool AdaptiveSampler::tick()
+{
+    pthread_mutex_lock(&mutex);
+    bool due = (countdown <= 0);
+    if (due) {
+        countdown = interval - 1;  // This tick counts: due again in `interval` ticks
+    } else {
+        countdown--;
+    }
+    pthread_mutex_unlock(&mutex);
+    return due;
+}
+
+void AdaptiveSampler::update(float value, const float range[2], bool correcting, uint64_t nowMs)
+{
+    pthread_mutex_lock(&mutex);
+
+    // Rate of change since the previous reading (units per minute)
+    bool fast = false;
+    if (hasLast && nowMs > lastMs) {
+        float minutes = (nowMs - lastMs) / 60000.0f;
+        fast = std::fabs(value - lastValue) / minutes > limits.rateThreshold;
+    }
+
+    // Close to either edge of the ideal range (or already outside it)
+    float margin = (range[1] - range[0]) * limits.nearMargin;
+    bool nearThreshold = (value < range[0] + margin) || (value > range[1] - margin);
+
+    if (fast || nearThreshold || correcting) {
+        interval = limits.minTicks;
+    } else {
+        // Stable: back off exponentially towards the heartbeat
+        interval *= 2;
+        if (interval > limits.maxTicks) interval = limits.maxTicks;
+    }
+
+    // Speeding up takes effect immediately rather than after the old countdown
+    if (countdown > interval - 1) {
+        countdown = interval - 1;
+    }
+
+    hasLast = true;
+    lastValue = value;
+    lastMs = nowMs;
+
+    pthread_mutex_unlock(&mutex);
+}
+
+/* ============================================================================
+ * Getters
+ * ============================================================================ */
+
+int AdaptiveSampler::getInterval()
+{
+    pthread_mutex_lock(&mutex);
+    int n = interval;
+    pthread_mutex_unlock(&mutex);
+    return n;
+}
+
+int AdaptiveSampler::getCountdown()
+{
+    pthread_mutex_lock(&mutex);
+    int n = countdown;
+    pthread_mutex_unlock(&mutex);
+    return n;
+}
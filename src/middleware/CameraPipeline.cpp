@@ -0,0 +1,347 @@
+/**
+ * @file CameraPipeline.cpp
+ * @brief Implementation of the Staged Camera/ML Pipeline
+ */
+
+#include "CameraPipeline.h"
+#include "Logger.h"
+#include "Trace.h"
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+/**
+ * @brief Monotonic time in milliseconds (sub-millisecond resolution)
+ */
+static double monotonicMs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static const char* STAGE_NAMES[STAGE_COUNT] = {
+    "capture", "preprocess", "inference", "persist"
+};
+
+/* ============================================================================
+ * Constructor / Destructor
+ * ============================================================================ */
+
+CameraPipeline::CameraPipeline(InferenceService* service, PersistHandler handler, size_t queueCapacity)
+    : inference(service)
+    , mlEngine(service->getEngine())
+    , resultCache(nullptr)
+    , persistHandler(handler)
+    , captureQueue(queueCapacity, OverflowPolicy::DROP_NEWEST)     // Collapse trigger bursts
+    , preprocessQueue(queueCapacity, OverflowPolicy::DROP_OLDEST)  // Prefer fresh frames
+    , inferenceQueue(queueCapacity, OverflowPolicy::DROP_OLDEST)   // Prefer fresh frames
+    , persistQueue(queueCapacity, OverflowPolicy::BLOCK)           // Never lose a result
+    , running(false)
+    , nextSequence(0)
+{
+    // Dropped frames never reach persist, which would record their file
+    preprocessQueue.setDropHandler(discardFrame);
+    inferenceQueue.setDropHandler(discardFrame);
+
+    pthread_mutex_init(&statsMutex, NULL);
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        processed[i] = 0;
+        totalMs[i] = 0.0;
+        lastMs[i] = 0.0;
+        maxMs[i] = 0.0;
+    }
+}
+
+CameraPipeline::~CameraPipeline()
+{
+    stop();
+    pthread_mutex_destroy(&statsMutex);
+}
+
+int CameraPipeline::addCamera(Cam* cam)
+{
+    cameras.push_back(cam);
+    return static_cast<int>(cameras.size()) - 1;
+}
+
+void CameraPipeline::setResultCache(InferenceCache* cache)
+{
+    resultCache = cache;
+}
+
+/* ============================================================================
+ * Lifecycle Control
+ * ============================================================================ */
+
+void CameraPipeline::start()
+{
+    if (running) return;
+    running = true;
+
+    pthread_create(&tCapture, NULL, captureLoopStatic, this);
+    pthread_create(&tPreprocess, NULL, preprocessLoopStatic, this);
+    pthread_create(&tInference, NULL, inferenceLoopStatic, this);
+    pthread_create(&tPersist, NULL, persistLoopStatic, this);
+}
+
+void CameraPipeline::stop()
+{
+    if (!running) return;
+    running = false;
+
+    // Closing a queue lets its consumer drain and exit; each stage closes
+    // the next queue on its way out so in-flight frames are still persisted
+    captureQueue.close();
+
+    pthread_join(tCapture, NULL);
+    pthread_join(tPreprocess, NULL);
+    pthread_join(tInference, NULL);
+    pthread_join(tPersist, NULL);
+}
+
+/* ============================================================================
+ * Triggers
+ * ============================================================================ */
+
+int CameraPipeline::trigger()
+{
+    int accepted = 0;
+    for (size_t i = 0; i < cameras.size(); i++) {
+        if (triggerCamera(static_cast<int>(i))) {
+            accepted++;
+        }
+    }
+    return accepted;
+}
+
+bool CameraPipeline::triggerCamera(int cameraId)
+{
+    if (cameraId < 0 || cameraId >= static_cast<int>(cameras.size())) {
+        return false;
+    }
+
+    PipelineFrame frame;
+    frame.cameraId = cameraId;
+    frame.triggeredAtMs = static_cast<uint64_t>(monotonicMs());
+    frame.imageSaved = false;
+    frame.cached = false;
+    frame.greenRatio = 0.0f;
+    frame.inputValid = false;
+    for (int i = 0; i < STAGE_COUNT; i++) frame.stageMs[i] = 0.0;
+
+    pthread_mutex_lock(&statsMutex);
+    frame.sequence = nextSequence++;
+    pthread_mutex_unlock(&statsMutex);
+
+    if (!captureQueue.push(std::move(frame))) {
+        LS_WARN("Pipeline", "Capture request for camera {} dropped - pipeline saturated", cameraId);
+        return false;
+    }
+    return true;
+}
+
+/* ============================================================================
+ * Stage Loops
+ * ============================================================================ */
+
+void CameraPipeline::captureLoop()
+{
+    Tracer::setThreadName("pipeline.capture");
+    PipelineFrame frame;
+    while (captureQueue.pop(frame)) {
+        double t0 = monotonicMs();
+        frame.photoPath = cameras[frame.cameraId]->capture(frame.image, frame.imageSaved);
+        frame.imageHash = ML::imageHash(frame.image);
+        frame.stageMs[STAGE_CAPTURE] = monotonicMs() - t0;
+        recordStage(STAGE_CAPTURE, frame.stageMs[STAGE_CAPTURE]);
+
+        if (frame.photoPath.empty()) {
+            LS_ERROR("Camera", "Failed to capture photo (camera {})", frame.cameraId);
+            continue;
+        }
+        frame.filename = frame.photoPath.substr(frame.photoPath.find_last_of("/") + 1);
+
+        preprocessQueue.push(std::move(frame));
+    }
+    preprocessQueue.close();
+}
+
+void CameraPipeline::preprocessLoop()
+{
+    Tracer::setThreadName("pipeline.preprocess");
+    PipelineFrame frame;
+    while (preprocessQueue.pop(frame)) {
+        double t0 = monotonicMs();
+        if (mlEngine->getTileGrid() >= 2) {
+            // The service cuts and preprocesses the crops; the cache has no regions
+            frame.inputValid = true;
+        } else if (resultCache && mlEngine->isInitialized() &&
+            resultCache->lookup(frame.imageHash, mlEngine->getModelVersion(), frame.result)) {
+            // Same pixels, same model: the stored result is exact
+            frame.cached = true;
+            frame.inputValid = true;
+            LS_DEBUG("Pipeline", "Frame {} matches cached result {}", frame.sequence, frame.imageHash);
+        } else if (mlEngine->isInitialized()) {
+            frame.inputValid = mlEngine->prepareInput(frame.image, frame.tensor, frame.greenRatio);
+        }
+        frame.stageMs[STAGE_PREPROCESS] = monotonicMs() - t0;
+        recordStage(STAGE_PREPROCESS, frame.stageMs[STAGE_PREPROCESS]);
+
+        inferenceQueue.push(std::move(frame));
+    }
+    inferenceQueue.close();
+}
+
+void CameraPipeline::inferenceLoop()
+{
+    Tracer::setThreadName("pipeline.inference");
+    PipelineFrame frame;
+    while (inferenceQueue.pop(frame)) {
+        double t0 = monotonicMs();
+        if (!frame.cached) {
+            // The tensor moves into the request; ON_DEMAND requests may run first
+            const bool tiled = mlEngine->getTileGrid() >= 2;
+            std::future<MLResult> pending = tiled
+                ? inference->submit(frame.image, InferencePriority::SCHEDULED)
+                : inference->submitPrepared(std::move(frame.tensor), frame.greenRatio,
+                                            InferencePriority::SCHEDULED);
+            try {
+                frame.result = pending.get();
+            } catch (const InferenceCancelled& e) {
+                LS_WARN("Pipeline", "Frame {} (camera {}) not analysed: {}",
+                        frame.sequence, frame.cameraId, e.what());
+                discardFrame(frame);
+                continue;
+            }
+            if (resultCache && !tiled) {
+                resultCache->store(frame.imageHash, frame.result.modelVersion, frame.result);
+            }
+        }
+        frame.stageMs[STAGE_INFERENCE] = monotonicMs() - t0;
+        recordStage(STAGE_INFERENCE, frame.stageMs[STAGE_INFERENCE]);
+
+        persistQueue.push(std::move(frame));
+    }
+    persistQueue.close();
+}
+
+void CameraPipeline::persistLoop()
+{
+    Tracer::setThreadName("pipeline.persist");
+    PipelineFrame frame;
+    while (persistQueue.pop(frame)) {
+        double t0 = monotonicMs();
+
+        // The handler records photoPath, so the file must exist first
+        if (!frame.imageSaved && !Cam::saveImage(frame.image, frame.photoPath)) {
+            LS_ERROR("Camera", "Failed to write {}", frame.photoPath);
+        }
+        frame.image.release();
+
+        if (persistHandler) {
+            persistHandler(frame);
+        }
+        frame.stageMs[STAGE_PERSIST] = monotonicMs() - t0;
+        recordStage(STAGE_PERSIST, frame.stageMs[STAGE_PERSIST]);
+
+        LS_INFO("Pipeline", "Frame {} (camera {}) done in {} ms",
+                frame.sequence, frame.cameraId, monotonicMs() - frame.triggeredAtMs);
+        printStats();
+    }
+}
+
+/* ============================================================================
+ * Static Thread Entry Points
+ * ============================================================================ */
+
+void* CameraPipeline::captureLoopStatic(void* arg) {
+    ((CameraPipeline*)arg)->captureLoop();
+    return NULL;
+}
+
+void* CameraPipeline::preprocessLoopStatic(void* arg) {
+    ((CameraPipeline*)arg)->preprocessLoop();
+    return NULL;
+}
+
+void* CameraPipeline::inferenceLoopStatic(void* arg) {
+    ((CameraPipeline*)arg)->inferenceLoop();
+    return NULL;
+}
+
+void* CameraPipeline::persistLoopStatic(void* arg) {
+    ((CameraPipeline*)arg)->persistLoop();
+    return NULL;
+}
+
+/* ============================================================================
+ * Statistics
+ * ============================================================================ */
+
+void CameraPipeline::recordStage(PipelineStage stage, double ms)
+{
+    pthread_mutex_lock(&statsMutex);
+    processed[stage]++;
+    totalMs[stage] += ms;
+    lastMs[stage] = ms;
+    if (ms > maxMs[stage]) maxMs[stage] = ms;
+    pthread_mutex_unlock(&statsMutex);
+}
+
+void CameraPipeline::discardFrame(PipelineFrame& frame)
+{
+    // Frames the pipeline encodes itself are only written by persist
+    if (!frame.imageSaved || frame.photoPath.empty()) return;
+    if (unlink(frame.photoPath.c_str()) != 0 && errno != ENOENT) {
+        LS_WARN("Pipeline", "Cannot delete dropped frame {}: {}", frame.photoPath, strerror(errno));
+        return;
+    }
+    LS_DEBUG("Pipeline", "Frame {} dropped, deleted {}", frame.sequence, frame.photoPath);
+}
+
+BoundedQueue<PipelineFrame>* CameraPipeline::inputQueue(PipelineStage stage)
+{
+    switch (stage) {
+        case STAGE_CAPTURE:    return &captureQueue;
+        case STAGE_PREPROCESS: return &preprocessQueue;
+        case STAGE_INFERENCE:  return &inferenceQueue;
+        case STAGE_PERSIST:    return &persistQueue;
+        default:               return nullptr;
+    }
+}
+
+PipelineStageStats CameraPipeline::getStats(PipelineStage stage)
+{
+    PipelineStageStats stats = {};
+    BoundedQueue<PipelineFrame>* queue = inputQueue(stage);
+    if (!queue) return stats;
+
+    pthread_mutex_lock(&statsMutex);
+    stats.processed = processed[stage];
+    stats.lastMs = lastMs[stage];
+    stats.avgMs = processed[stage] ? totalMs[stage] / processed[stage] : 0.0;
+    stats.maxMs = maxMs[stage];
+    pthread_mutex_unlock(&statsMutex);
+
+    stats.dropped = queue->droppedCount();
+    stats.queueDepth = queue->size();
+    stats.queueHighWater = queue->highWaterMark();
+    stats.queueCapacity = queue->getCapacity();
+    return stats;
+}
+
+void CameraPipeline::printStats()
+{
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        PipelineStageStats s = getStats(static_cast<PipelineStage>(i));
+        LS_INFO("Pipeline", "{} n={} last={}ms avg={}ms max={}ms queue={}/{} (peak {}) dropped={}",
+                STAGE_NAMES[i], s.processed, s.lastMs, s.avgMs, s.maxMs,
+                s.queueDepth, s.queueCapacity, s.queueHighWater, s.dropped);
+    }
+}
@@ -0,0 +1,143 @@
+/**
+ * @file Config.cpp
+ * @brief Implementation of Runtime Configuration
+ */
+
+#include "Config.h"
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+static std::string trim(const std::string& s)
+{
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+/**
+ * @brief Maps "sampling.min_interval_s" to "LEAFSENSE_SAMPLING_MIN_INTERVAL_S"
+ */
+static std::string envName(const std::string& key)
+{
+    std::string name = "LEAFSENSE_";
+    for (char c : key) {
+        name += std::isalnum(static_cast<unsigned char>(c))
+            ? static_cast<char>(std::toupper(static_cast<unsigned char>(c)))
+            : '_';
+    }
+    return name;
+}
+
+/* ============================================================================
+ * Construction / Loading
+ * ============================================================================ */
+
+Config::Config()
+{
+    const char* path = std::getenv("LEAFSENSE_CONFIG");
+    load(path ? path : "/opt/leafsense/leafsense.conf");
+}
+
+Config& Config::instance()
+{
+    static Config config;
+    return config;
+}
+
+bool Config::load(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cout << "[Config] " << path << " not found, using defaults" << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(file, line)) {
+        lineNo++;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            std::cerr << "[Config] " << path << ":" << lineNo << " ignored (no '=')" << std::endl;
+            continue;
+        }
+        values[trim(line.substr(0, eq))] = trim(line.substr(eq + 1));
+    }
+
+    sourcePath = path;
+    std::cout << "[Config] Loaded " << values.size() << " settings from " << path << std::endl;
+    return true;
+}
+
+bool Config::lookup(const std::string& key, std::string& value) const
+{
+    const char* env = std::getenv(envName(key).c_str());
+    if (env) {
+        value = env;
+        return true;
+    }
+
+    std::map<std::string, std::string>::const_iterator it = values.find(key);
+    if (it == values.end()) return false;
+    value = it->second;
+    return true;
+}
+
+/* ============================================================================
+ * Typed Getters
+ * ============================================================================ */
+
+std::string Config::getString(const std::string& key, const std::string& def) const
+{
+    std::string value;
+    return lookup(key, value) ? value : def;
+}
+
+int Config::getInt(const std::string& key, int def) const
+{
+    std::string value;
+    if (!lookup(key, value)) return def;
+
+    char* end = nullptr;
+    long parsed = std::strtol(value.c_str(), &end, 0);  // Accepts 0x.. (I2C addresses)
+    if (end == value.c_str() || *end != '\0') {
+        std::cerr << "[Config] Invalid integer for " << key << ": " << value << std::endl;
+        return def;
+    }
+    return static_cast<int>(parsed);
+}
+
+float Config::getFloat(const std::string& key, float def) const
+{
+    std::string value;
+    if (!lookup(key, value)) return def;
+
+    char* end = nullptr;
+    float parsed = std::strtof(value.c_str(), &end);
+    if (end == value.c_str() || *end != '\0') {
+        std::cerr << "[Config] Invalid number for " << key << ": " << value << std::endl;
+        return def;
+    }
+    return parsed;
+}
+
+bool Config::getBool(const std::string& key, bool def) const
+{
+    std::string value;
+    if (!lookup(key, value)) return def;
+
+    if (value == "1" || value == "true" || value == "yes" || value == "on") return true;
+    if (value == "0" || value == "false" || value == "no" || value == "off") return false;
+    std::cerr << "[Config] Invalid boolean for " << key << ": " << value << std::endl;
+    return def;
+}
@@ -0,0 +1,245 @@
+/**
+ * @file ControlServer.cpp
+ * @brief Implementation of the Unix-Socket Control Channel
+ */
+
+#include "ControlServer.h"
+#include "Logger.h"
+#include "Trace.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+static const size_t MAX_CLIENTS = 16;
+static const size_t MAX_LINE = 512;
+static const int PENDING_POLL_MS = 10;  ///< Poll period while a reply is being computed
+
+/* ============================================================================
+ * Construction / Destruction
+ * ============================================================================ */
+
+ControlServer::ControlServer(const std::string& path, LiveState* state, CommandHandler commandHandler)
+    : socketPath(path)
+    , live(state)
+    , handler(commandHandler)
+    , listenFd(-1)
+    , stopFd(-1)
+    , started(false)
+{
+}
+
+ControlServer::~ControlServer()
+{
+    stop();
+}
+
+/* ============================================================================
+ * Lifecycle
+ * ============================================================================ */
+
+bool ControlServer::start()
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        LS_ERROR("Control", "Socket path too long: {}", socketPath);
+        return false;
+    }
+    strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (listenFd < 0) {
+        LS_ERROR("Control", "socket() failed: {}", strerror(errno));
+        return false;
+    }
+
+    unlink(socketPath.c_str());  // Left behind by a daemon that was killed
+    if (bind(listenFd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listenFd, 4) != 0) {
+        LS_ERROR("Control", "Cannot listen on {}: {}", socketPath, strerror(errno));
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    started = (pthread_create(&thread, NULL, threadFunc, this) == 0);
+    if (started) {
+        LS_INFO("Control", "Listening on {}", socketPath);
+    }
+    return started;
+}
+
+void ControlServer::stop()
+{
+    if (started) {
+        uint64_t one = 1;
+        ssize_t n = write(stopFd, &one, sizeof(one));
+        (void)n;
+        pthread_join(thread, NULL);
+        started = false;
+    }
+
+    for (size_t i = 0; i < clients.size(); i++) {
+        close(clients[i].fd);
+    }
+    clients.clear();
+
+    if (listenFd >= 0) {
+        close(listenFd);
+        listenFd = -1;
+        unlink(socketPath.c_str());
+    }
+    if (stopFd >= 0) {
+        close(stopFd);
+        stopFd = -1;
+    }
+}
+
+/* ============================================================================
+ * Server Thread
+ * ============================================================================ */
+
+void* ControlServer::threadFunc(void* arg)
+{
+    Tracer::setThreadName("tControl");
+    static_cast<ControlServer*>(arg)->loop();
+    return NULL;
+}
+
+void ControlServer::loop()
+{
+    const int notifyFd = live ? live->getNotifyFd() : -1;
+    std::vector<struct pollfd> fds;
+
+    for (;;) {
+        // [0] stop, [1] listen, [2] frame notifications, [3..] clients
+        fds.clear();
+        fds.push_back({ stopFd, POLLIN, 0 });
+        fds.push_back({ listenFd, POLLIN, 0 });
+        fds.push_back({ notifyFd, POLLIN, 0 });
+        // A client waiting for a reply sends nothing new until it has it
+        // (hang-ups are still reported)
+        bool waiting = false;
+        for (size_t i = 0; i < clients.size(); i++) {
+            short events = clients[i].waiting ? 0 : POLLIN;
+            waiting = waiting || clients[i].waiting;
+            fds.push_back({ clients[i].fd, events, 0 });
+        }
+
+        if (poll(fds.data(), fds.size(), waiting ? PENDING_POLL_MS : -1) < 0) {
+            if (errno == EINTR) continue;
+            LS_ERROR("Control", "poll() failed: {}", strerror(errno));
+            return;
+        }
+
+        if (fds[0].revents) return;
+
+        // Serve clients first: the vector is reindexed on disconnect
+        for (size_t i = clients.size(); i-- > 0;) {
+            bool ok = true;
+            if (fds[3 + i].revents) ok = serviceClient(clients[i]);
+            if (ok && clients[i].waiting) ok = checkWaiting(clients[i]);
+            if (!ok) {
+                close(clients[i].fd);
+                clients.erase(clients.begin() + i);
+            }
+        }
+
+        if (fds[2].revents & POLLIN) notifySubscribers();
+        if (fds[1].revents & POLLIN) acceptClient();
+    }
+}
+
+void ControlServer::acceptClient()
+{
+    int fd = accept4(listenFd, NULL, NULL, SOCK_CLOEXEC | SOCK_NONBLOCK);
+    if (fd < 0) return;
+
+    if (clients.size() >= MAX_CLIENTS) {
+        writeLine(fd, "ERR|Too many clients");
+        close(fd);
+        return;
+    }
+
+    Client client;
+    client.fd = fd;
+    client.subscribed = false;
+    clients.push_back(client);
+}
+
+bool ControlServer::serviceClient(Client& client)
+{
+    char buffer[256];
+    ssize_t n = read(client.fd, buffer, sizeof(buffer));
+    if (n == 0) return false;
+    if (n < 0) return errno == EAGAIN || errno == EINTR;
+
+    client.pending.append(buffer, static_cast<size_t>(n));
+    if (client.pending.size() > MAX_LINE && client.pending.find('\n') == std::string::npos) {
+        LS_WARN("Control", "Dropping client: command line too long");
+        return false;
+    }
+    return runCommands(client);
+}
+
+bool ControlServer::runCommands(Client& client)
+{
+    size_t newline;
+    while (!client.waiting && (newline = client.pending.find('\n')) != std::string::npos) {
+        std::string line = client.pending.substr(0, newline);
+        client.pending.erase(0, newline + 1);
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        if (line.empty()) continue;
+
+        std::string reply;
+        if (line == "SUBSCRIBE") {
+            client.subscribed = true;
+            reply = "OK";
+        } else if (line == "PING") {
+            reply = "OK";
+        } else {
+            LS_TRACE_SPAN("control.command");
+            LS_INFO("Control", "Command: {}", line);
+            reply = handler ? handler(line, client.waiting) : "ERR|No handler";
+            if (client.waiting) break;  // Answered by checkWaiting()
+        }
+        if (!writeLine(client.fd, reply)) return false;
+    }
+    return true;
+}
+
+bool ControlServer::checkWaiting(Client& client)
+{
+    std::string reply;
+    if (!client.waiting(reply)) return true;
+
+    client.waiting = nullptr;
+    if (!writeLine(client.fd, reply)) return false;
+    return runCommands(client);  // Lines that arrived meanwhile
+}
+
+void ControlServer::notifySubscribers()
+{
+    uint64_t count;
+    ssize_t n = read(live->getNotifyFd(), &count, sizeof(count));
+    (void)n;
+
+    for (size_t i = 0; i < clients.size(); i++) {
+        // A subscriber that is not reading only misses coalesced notifications
+        if (clients[i].subscribed) writeLine(clients[i].fd, "FRAME");
+    }
+}
+
+bool ControlServer::writeLine(int fd, const std::string& line)
+{
+    std::string out = line + "\n";
+    ssize_t n = send(fd, out.data(), out.size(), MSG_NOSIGNAL);
+    return n == static_cast<ssize_t>(out.size()) || (n < 0 && errno == EAGAIN);
+}
@@ -6,7 +6,7 @@
 #include "IdealConditions.h"
 
 /* ============================================================================
- * Constructor
+ * Construction / Destruction
  * ============================================================================ */
 
 IdealConditions::IdealConditions() 
@@ -18,6 +18,12 @@ IdealConditions::IdealConditions()
     ph_max = 6.5;
     temp_min = 18.0;
     temp_max = 24.0;
+    pthread_mutex_init(&rangeMutex, NULL);
+}
+
+IdealConditions::~IdealConditions()
+{
+    pthread_mutex_destroy(&rangeMutex);
 }
 
 /* ============================================================================
@@ -26,20 +32,26 @@ IdealConditions::IdealConditions()
 
 void IdealConditions::getTDS(float* range) 
 {
+    pthread_mutex_lock(&rangeMutex);
     range[0] = tds_min;
     range[1] = tds_max;
+    pthread_mutex_unlock(&rangeMutex);
 }
 
 void IdealConditions::getPH(float* range) 
 {
+    pthread_mutex_lock(&rangeMutex);
     range[0] = ph_min;
     range[1] = ph_max;
+    pthread_mutex_unlock(&rangeMutex);
 }
 
 void IdealConditions::getTemp(float* range) 
 {
+    pthread_mutex_lock(&rangeMutex);
     range[0] = temp_min;
     range[1] = temp_max;
+    pthread_mutex_unlock(&rangeMutex);
 }
 
 /* ============================================================================
@@ -48,18 +60,24 @@ void IdealConditions::getTemp(float* range)
 
 void IdealConditions::setTDS(float min, float max) 
 {
+    pthread_mutex_lock(&rangeMutex);
     tds_min = min;
     tds_max = max;
+    pthread_mutex_unlock(&rangeMutex);
 }
 
 void IdealConditions::setPH(float min, float max) 
 {
+    pthread_mutex_lock(&rangeMutex);
     ph_min = min;
     ph_max = max;
+    pthread_mutex_unlock(&rangeMutex);
 }
 
 void IdealConditions::setTemp(float min, float max) 
 {
+    pthread_mutex_lock(&rangeMutex);
     temp_min = min;
     temp_max = max;
+    pthread_mutex_unlock(&rangeMutex);
 }
\ No newline at end of file
@@ -0,0 +1,250 @@
+/**
+ * @file InferenceService.cpp
+ * @brief Implementation of the Asynchronous Inference Service
+ */
+
+#include "InferenceService.h"
+#include "Logger.h"
+#include "Trace.h"
+#include <ctime>
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+/**
+ * @brief Monotonic time in milliseconds (sub-millisecond resolution)
+ */
+static double monotonicMs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static const int PRIORITY_COUNT = 2;
+
+/* ============================================================================
+ * Constructor / Destructor
+ * ============================================================================ */
+
+InferenceService::InferenceService(ML* ml, size_t queueCapacity)
+    : engine(ml)
+    , capacity(queueCapacity ? queueCapacity : 1)
+    , nextTicket(1)
+    , running(false)
+    , completed(0)
+    , cancelled(0)
+    , rejected(0)
+    , totalQueueMs(0.0)
+    , maxQueueMs(0.0)
+    , totalRunMs(0.0)
+    , maxRunMs(0.0)
+{
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&notEmpty, NULL);
+}
+
+InferenceService::~InferenceService()
+{
+    stop();
+    pthread_mutex_destroy(&mutex);
+    pthread_cond_destroy(&notEmpty);
+    delete engine;
+}
+
+/* ============================================================================
+ * Lifecycle Control
+ * ============================================================================ */
+
+void InferenceService::start()
+{
+    if (running) return;
+    running = true;
+    pthread_create(&thread, NULL, threadFunc, this);
+}
+
+void InferenceService::stop()
+{
+    pthread_mutex_lock(&mutex);
+    if (!running) {
+        pthread_mutex_unlock(&mutex);
+        return;
+    }
+    running = false;
+
+    // Nobody will run what is still waiting
+    for (int p = 0; p < PRIORITY_COUNT; p++) {
+        for (Request& request : queues[p]) {
+            request.promise.set_exception(std::make_exception_ptr(
+                InferenceCancelled("Inference service stopped")));
+            cancelled++;
+        }
+        queues[p].clear();
+    }
+    pthread_cond_broadcast(&notEmpty);
+    pthread_mutex_unlock(&mutex);
+
+    pthread_join(thread, NULL);
+}
+
+/* ============================================================================
+ * Requests
+ * ============================================================================ */
+
+std::future<MLResult> InferenceService::submit(const cv::Mat& image, InferencePriority priority,
+                                               Ticket* ticket)
+{
+    Request request;
+    request.image = image;
+    request.greenRatio = 0.0f;
+    request.prepared = false;
+    return enqueue(std::move(request), priority, ticket);
+}
+
+std::future<MLResult> InferenceService::submitPrepared(std::vector<float>&& tensor, float greenRatio,
+                                                       InferencePriority priority, Ticket* ticket)
+{
+    Request request;
+    request.tensor = std::move(tensor);
+    request.greenRatio = greenRatio;
+    request.prepared = true;
+    return enqueue(std::move(request), priority, ticket);
+}
+
+std::future<MLResult> InferenceService::enqueue(Request&& request, InferencePriority priority,
+                                                Ticket* ticket)
+{
+    std::future<MLResult> future = request.promise.get_future();
+    request.submittedMs = monotonicMs();
+
+    pthread_mutex_lock(&mutex);
+    request.ticket = nextTicket++;
+    if (ticket) *ticket = request.ticket;
+
+    if (!running) {
+        rejected++;
+        pthread_mutex_unlock(&mutex);
+        request.promise.set_exception(std::make_exception_ptr(
+            InferenceCancelled("Inference service not running")));
+        return future;
+    }
+
+    std::deque<Request>& scheduled = queues[static_cast<int>(InferencePriority::SCHEDULED)];
+    if (queues[0].size() + queues[1].size() >= capacity) {
+        if (priority == InferencePriority::ON_DEMAND && !scheduled.empty()) {
+            // A waiting user outranks a periodic capture
+            scheduled.front().promise.set_exception(std::make_exception_ptr(
+                InferenceCancelled("Evicted by an on-demand request")));
+            scheduled.pop_front();
+            rejected++;
+        } else {
+            rejected++;
+            pthread_mutex_unlock(&mutex);
+            LS_WARN("Inference", "Queue full ({}), request {} rejected", capacity, request.ticket);
+            request.promise.set_exception(std::make_exception_ptr(
+                InferenceCancelled("Inference queue full")));
+            return future;
+        }
+    }
+
+    queues[static_cast<int>(priority)].push_back(std::move(request));
+    pthread_cond_signal(&notEmpty);
+    pthread_mutex_unlock(&mutex);
+    return future;
+}
+
+bool InferenceService::cancel(Ticket ticket)
+{
+    pthread_mutex_lock(&mutex);
+    for (int p = 0; p < PRIORITY_COUNT; p++) {
+        for (std::deque<Request>::iterator it = queues[p].begin(); it != queues[p].end(); ++it) {
+            if (it->ticket != ticket) continue;
+            it->promise.set_exception(std::make_exception_ptr(
+                InferenceCancelled("Inference request cancelled")));
+            queues[p].erase(it);
+            cancelled++;
+            pthread_mutex_unlock(&mutex);
+            return true;
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+    return false;
+}
+
+/* ============================================================================
+ * Worker
+ * ============================================================================ */
+
+void InferenceService::loop()
+{
+    Tracer::setThreadName("tInferenceSvc");
+
+    for (;;) {
+        pthread_mutex_lock(&mutex);
+        while (running && queues[0].empty() && queues[1].empty()) {
+            pthread_cond_wait(&notEmpty, &mutex);
+        }
+        if (!running) {
+            pthread_mutex_unlock(&mutex);
+            break;
+        }
+        std::deque<Request>& queue = queues[0].empty() ? queues[1] : queues[0];
+        Request request = std::move(queue.front());
+        queue.pop_front();
+        pthread_mutex_unlock(&mutex);
+
+        // Run without the lock so submit()/cancel() never wait on the model
+        double started = monotonicMs();
+        MLResult result;
+        {
+            LS_TRACE_SPAN("inference.request");
+            if (request.prepared) {
+                result = engine->infer(request.tensor, request.greenRatio);
+            } else {
+                result = engine->analyzeDetailed(request.image);
+            }
+        }
+        double finished = monotonicMs();
+
+        double queueMs = started - request.submittedMs;
+        double runMs = finished - started;
+        pthread_mutex_lock(&mutex);
+        completed++;
+        totalQueueMs += queueMs;
+        totalRunMs += runMs;
+        if (queueMs > maxQueueMs) maxQueueMs = queueMs;
+        if (runMs > maxRunMs) maxRunMs = runMs;
+        pthread_mutex_unlock(&mutex);
+
+        LS_DEBUG("Inference", "Request {} waited {} ms, ran {} ms", request.ticket, queueMs, runMs);
+        request.promise.set_value(result);
+    }
+}
+
+void* InferenceService::threadFunc(void* arg)
+{
+    ((InferenceService*)arg)->loop();
+    return NULL;
+}
+
+/* ============================================================================
+ * Statistics
+ * ============================================================================ */
+
+InferenceServiceStats InferenceService::getStats()
+{
+    InferenceServiceStats stats;
+    pthread_mutex_lock(&mutex);
+    stats.completed = completed;
+    stats.cancelled = cancelled;
+    stats.rejected = rejected;
+    stats.avgQueueMs = completed ? totalQueueMs / completed : 0.0;
+    stats.maxQueueMs = maxQueueMs;
+    stats.avgRunMs = completed ? totalRunMs / completed : 0.0;
+    stats.maxRunMs = maxRunMs;
+    stats.queueDepth = queues[0].size() + queues[1].size();
+    stats.queueCapacity = capacity;
+    pthread_mutex_unlock(&mutex);
+    return stats;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file LiveClient.cpp
+ * @brief Implementation of the GUI Side of the Daemon Link
+ */
+
+#include "LiveClient.h"
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/* ============================================================================
+ * Construction / Destruction
+ * ============================================================================ */
+
+LiveClient::LiveClient(const std::string& path, const std::string& shm)
+    : socketPath(path)
+    , shmName(shm)
+    , state(nullptr)
+    , eventFd(-1)
+{
+}
+
+LiveClient::~LiveClient()
+{
+    disconnect();
+    delete state;
+}
+
+/* ============================================================================
+ * Connection
+ * ============================================================================ */
+
+int LiveClient::openSocket(const std::string& path)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) return -1;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (::connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool LiveClient::connect()
+{
+    if (eventFd >= 0) return true;
+
+    if (!state) {
+        state = LiveState::attach(shmName);
+        if (!state) return false;
+    }
+
+    std::string reply;
+    if (!sendCommand("PING", reply, 500)) return false;
+
+    int fd = openSocket(socketPath);
+    if (fd < 0) return false;
+
+    static const char subscribe[] = "SUBSCRIBE\n";
+    if (send(fd, subscribe, sizeof(subscribe) - 1, MSG_NOSIGNAL) != sizeof(subscribe) - 1) {
+        close(fd);
+        return false;
+    }
+    eventFd = fd;
+    return true;
+}
+
+void LiveClient::disconnect()
+{
+    if (eventFd >= 0) {
+        close(eventFd);
+        eventFd = -1;
+    }
+}
+
+bool LiveClient::drainEvents()
+{
+    if (eventFd < 0) return false;
+
+    // "OK" and "FRAME" lines only signal that the snapshot changed
+    char buffer[256];
+    for (;;) {
+        ssize_t n = recv(eventFd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (n > 0) continue;
+        if (n == 0) return false;
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+}
+
+/* ============================================================================
+ * Live Data
+ * ============================================================================ */
+
+const SensorSnapshot* LiveClient::getSnapshot(int zoneId) const
+{
+    if (!state) return nullptr;
+    for (size_t i = 0; i < state->getZoneCount(); i++) {
+        if (state->getZoneId(i) == zoneId) return &state->getZone(i)->snapshot;
+    }
+    return nullptr;
+}
+
+/* ============================================================================
+ * Commands
+ * ============================================================================ */
+
+bool LiveClient::sendCommand(const std::string& command, std::string& reply, int timeoutMs)
+{
+    reply.clear();
+    int fd = openSocket(socketPath);
+    if (fd < 0) return false;
+
+    std::string line = command + "\n";
+    if (send(fd, line.data(), line.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(line.size())) {
+        close(fd);
+        return false;
+    }
+
+    char buffer[256];
+    while (reply.find('\n') == std::string::npos) {
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        if (poll(&pfd, 1, timeoutMs) <= 0) break;
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) break;
+        reply.append(buffer, static_cast<size_t>(n));
+    }
+    close(fd);
+
+    size_t newline = reply.find('\n');
+    if (newline == std::string::npos) {
+        reply.clear();
+        return false;
+    }
+    reply.erase(newline);
+    return reply == "OK" || reply.compare(0, 3, "OK|") == 0;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file LiveState.cpp
+ * @brief Implementation of the Shared-Memory Live State
+ */
+
+#include "LiveState.h"
+#include "Logger.h"
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* ============================================================================
+ * LiveZone
+ * ============================================================================ */
+
+size_t LiveZone::readHistory(std::vector<SensorFrame>& frames, size_t maxFrames) const
+{
+    frames.clear();
+    if (maxFrames > LIVE_HISTORY) maxFrames = LIVE_HISTORY;
+
+    uint32_t end = historyHead.load(std::memory_order_acquire);
+    uint32_t count = end < maxFrames ? end : static_cast<uint32_t>(maxFrames);
+    uint32_t begin = end - count;
+
+    // Slots that could not be copied, or were cleared by recover(), are skipped
+    bool copied[LIVE_HISTORY];
+    for (uint32_t i = begin; i != end; i++) {
+        SensorFrame frame = {};
+        copied[i - begin] = history[i & (LIVE_HISTORY - 1)].load(frame) != 0 && frame.publishedAtMs != 0;
+        frames.push_back(frame);
+    }
+
+    // Drop slots the writer reused while they were being copied
+    uint32_t after = historyHead.load(std::memory_order_acquire);
+    uint32_t valid = after > LIVE_HISTORY ? after - LIVE_HISTORY : 0;
+    size_t stale = valid > begin ? valid - begin : 0;
+
+    size_t kept = 0;
+    for (size_t i = stale; i < count; i++) {
+        if (copied[i]) frames[kept++] = frames[i];
+    }
+    frames.resize(kept);
+    return kept;
+}
+
+/* ============================================================================
+ * Construction / Destruction
+ * ============================================================================ */
+
+LiveState::LiveState(LiveStateLayout* mapped, bool isWriter, int fd)
+    : layout(mapped)
+    , writer(isWriter)
+    , notifyFd(fd)
+{
+}
+
+LiveState::~LiveState()
+{
+    if (writer) {
+        layout->daemonPid.store(0, std::memory_order_release);
+    }
+    munmap(layout, sizeof(LiveStateLayout));
+    if (notifyFd >= 0) close(notifyFd);
+}
+
+LiveState* LiveState::create(const std::string& name)
+{
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        LS_ERROR("LiveState", "shm_open({}) failed: {}", name, strerror(errno));
+        return nullptr;
+    }
+    if (ftruncate(fd, sizeof(LiveStateLayout)) != 0) {
+        LS_ERROR("LiveState", "Cannot size {}: {}", name, strerror(errno));
+        close(fd);
+        return nullptr;
+    }
+    void* mem = mmap(NULL, sizeof(LiveStateLayout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+        LS_ERROR("LiveState", "mmap({}) failed: {}", name, strerror(errno));
+        return nullptr;
+    }
+
+    LiveStateLayout* mapped = static_cast<LiveStateLayout*>(mem);
+
+    // A segment left by a previous daemon is reused, so readers that mapped
+    // it keep working; anything else is reinitialized
+    if (mapped->magic != LIVE_STATE_MAGIC || mapped->version != LIVE_STATE_VERSION) {
+        new (mapped) LiveStateLayout();
+        mapped->magic = LIVE_STATE_MAGIC;
+        mapped->version = LIVE_STATE_VERSION;
+    } else {
+        // Zones are registered again by setZone(); a restart with fewer
+        // zones must not leave the old ones visible to the GUI
+        mapped->zoneCount.store(0, std::memory_order_release);
+        for (size_t z = 0; z < LIVE_MAX_ZONES; z++) {
+            mapped->zoneIds[z] = 0;
+        }
+
+        // The previous daemon may have died in the middle of a publish
+        for (size_t z = 0; z < LIVE_MAX_ZONES; z++) {
+            LiveZone& zone = mapped->zones[z];
+            zone.snapshot.recover();
+            for (uint32_t h = 0; h < LIVE_HISTORY; h++) {
+                zone.history[h].recover();
+            }
+        }
+    }
+    mapped->daemonPid.store(static_cast<int32_t>(getpid()), std::memory_order_release);
+
+    int efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    LS_INFO("LiveState", "Publishing live state in {} ({} KB)", name, sizeof(LiveStateLayout) / 1024);
+    return new LiveState(mapped, true, efd);
+}
+
+LiveState* LiveState::attach(const std::string& name)
+{
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return nullptr;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(LiveStateLayout)) {
+        close(fd);
+        return nullptr;
+    }
+    void* mem = mmap(NULL, sizeof(LiveStateLayout), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) return nullptr;
+
+    LiveStateLayout* mapped = static_cast<LiveStateLayout*>(mem);
+    if (mapped->magic != LIVE_STATE_MAGIC || mapped->version != LIVE_STATE_VERSION) {
+        munmap(mem, sizeof(LiveStateLayout));
+        return nullptr;
+    }
+    return new LiveState(mapped, false, -1);
+}
+
+/* ============================================================================
+ * Writer
+ * ============================================================================ */
+
+void LiveState::setZone(size_t index, int zoneId, uint64_t maxAgeMs)
+{
+    if (!writer || index >= LIVE_MAX_ZONES) return;
+    layout->zoneIds[index] = zoneId;
+    layout->zones[index].snapshot.setMaxAgeMs(maxAgeMs);
+    if (layout->zoneCount.load(std::memory_order_relaxed) < index + 1) {
+        layout->zoneCount.store(static_cast<uint32_t>(index + 1), std::memory_order_release);
+    }
+}
+
+void LiveState::publish(size_t index, const SensorFrame& frame)
+{
+    if (!writer || index >= LIVE_MAX_ZONES) return;
+
+    LiveZone& zone = layout->zones[index];
+    zone.snapshot.republish(frame);
+
+    uint32_t head = zone.historyHead.load(std::memory_order_relaxed);
+    zone.history[head & (LIVE_HISTORY - 1)].store(frame);
+    zone.historyHead.store(head + 1, std::memory_order_release);
+
+    layout->frameCount.fetch_add(1, std::memory_order_release);
+
+    if (notifyFd >= 0) {
+        uint64_t one = 1;
+        ssize_t n = write(notifyFd, &one, sizeof(one));
+        (void)n;  // Counter saturation only coalesces notifications
+    }
+}
+
+/* ============================================================================
+ * Reader
+ * ============================================================================ */
+
+size_t LiveState::getZoneCount() const
+{
+    size_t count = layout->zoneCount.load(std::memory_order_acquire);
+    return count < LIVE_MAX_ZONES ? count : LIVE_MAX_ZONES;
+}
+
+int LiveState::getZoneId(size_t index) const
+{
+    return index < LIVE_MAX_ZONES ? layout->zoneIds[index] : 0;
+}
+
+const LiveZone* LiveState::getZone(size_t index) const
+{
+    return index < LIVE_MAX_ZONES ? &layout->zones[index] : nullptr;
+}
+
+uint64_t LiveState::getFrameCount() const
+{
+    return layout->frameCount.load(std::memory_order_acquire);
+}
+
+int LiveState::getDaemonPid() const
+{
+    return layout->daemonPid.load(std::memory_order_acquire);
+}
@@ -0,0 +1,391 @@
+/**
+ * @file Logger.cpp
+ * @brief Implementation of the Asynchronous Structured Logger
+ */
+
+#include "Logger.h"
+#include "Config.h"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/* ============================================================================
+ * LogRing
+ * ============================================================================ */
+
+LogRecord* LogRing::beginWrite()
+{
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    if (h - t >= CAPACITY) return nullptr;
+    return &slots[h & (CAPACITY - 1)];
+}
+
+void LogRing::commitWrite()
+{
+    head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+LogRecord* LogRing::peek()
+{
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+    if (t == h) return nullptr;
+    return &slots[t & (CAPACITY - 1)];
+}
+
+void LogRing::pop()
+{
+    tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+/* ============================================================================
+ * Construction / Destruction
+ * ============================================================================ */
+
+static int parseLevel(const std::string& name)
+{
+    if (name == "debug") return LEVEL_DEBUG;
+    if (name == "warn") return LEVEL_WARN;
+    if (name == "error") return LEVEL_ERROR;
+    return LEVEL_INFO;
+}
+
+Logger::Logger()
+    : running(false)
+    , minLevel(LEVEL_INFO)
+    , rateLimit(20)
+    , fd(STDOUT_FILENO)
+    , ownsFd(false)
+    , fileSize(0)
+    , maxFileSize(1024 * 1024)
+    , maxFiles(3)
+{
+    pthread_mutex_init(&ringsMutex, NULL);
+    pthread_mutex_init(&wakeMutex, NULL);
+    pthread_cond_init(&wakeCond, NULL);
+
+    const Config& config = Config::instance();
+    int level = parseLevel(config.getString("log.level", "info"));
+    minLevel = level > LEAFSENSE_LOG_MIN_LEVEL ? level : LEAFSENSE_LOG_MIN_LEVEL;
+    int limit = config.getInt("log.rate_limit", 20);
+    rateLimit = limit > 0 ? static_cast<uint32_t>(limit) : 0;
+    maxFileSize = static_cast<size_t>(config.getInt("log.max_size_kb", 1024)) * 1024;
+    maxFiles = config.getInt("log.max_files", 3);
+    filePath = config.getString("log.file", "/var/log/leafsense.log");
+    openFile();
+
+    batch.reserve(LogRing::CAPACITY * 4);
+    out.reserve(64 * 1024);
+
+    running = true;
+    pthread_create(&writerThread, NULL, writerFuncStatic, this);
+}
+
+Logger::~Logger()
+{
+    shutdown();
+    for (size_t i = 0; i < rings.size(); i++) {
+        delete rings[i];
+    }
+    if (ownsFd) {
+        close(fd);
+        fd = STDOUT_FILENO;
+        ownsFd = false;
+    }
+    pthread_cond_destroy(&wakeCond);
+    pthread_mutex_destroy(&wakeMutex);
+    pthread_mutex_destroy(&ringsMutex);
+}
+
+Logger& Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+void Logger::shutdown()
+{
+    if (!running.exchange(false)) return;
+    wake();
+    pthread_join(writerThread, NULL);
+
+    // Records committed while the writer was exiting
+    pthread_mutex_lock(&wakeMutex);
+    drain();
+    pthread_mutex_unlock(&wakeMutex);
+}
+
+/* ============================================================================
+ * Producer Side
+ * ============================================================================ */
+
+int64_t Logger::nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Owner of a thread's ring: marks it retired when the thread exits
+ *
+ * The writer still drains the records left in it, then frees it.
+ */
+struct ThreadRing {
+    LogRing* ring;
+    ThreadRing() : ring(nullptr) {}
+    ~ThreadRing() { if (ring) ring->retired.store(true, std::memory_order_release); }
+};
+
+LogRing* Logger::threadRing()
+{
+    // Registered once per thread, freed by drain() after the thread exits
+    static thread_local ThreadRing owner;
+    if (!owner.ring) {
+        owner.ring = new LogRing();
+        pthread_mutex_lock(&ringsMutex);
+        rings.push_back(owner.ring);
+        pthread_mutex_unlock(&ringsMutex);
+    }
+    return owner.ring;
+}
+
+bool Logger::admit(LogSite& site, int64_t now, uint32_t& suppressedOut)
+{
+    if (rateLimit > 0) {
+        int64_t second = now / 1000000000LL;
+        int64_t window = site.windowSecond.load(std::memory_order_relaxed);
+        if (window != second &&
+            site.windowSecond.compare_exchange_strong(window, second, std::memory_order_relaxed)) {
+            site.windowCount.store(0, std::memory_order_relaxed);
+        }
+        if (site.windowCount.fetch_add(1, std::memory_order_relaxed) >= rateLimit) {
+            site.suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    suppressedOut = site.suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+void Logger::putText(LogRecord& rec, LogArg& arg, const char* s, size_t len)
+{
+    // Strings are copied (callers' buffers may be gone by format time)
+    size_t room = LogRecord::TEXT_SIZE - rec.textUsed;
+    if (len > room) len = room;
+    if (len > 255) len = 255;
+    memcpy(rec.text + rec.textUsed, s, len);
+    arg.type = LogArg::STRING;
+    arg.strOffset = rec.textUsed;
+    arg.strLen = static_cast<uint8_t>(len);
+    rec.textUsed = static_cast<uint16_t>(rec.textUsed + len);
+}
+
+void Logger::wake()
+{
+    pthread_mutex_lock(&wakeMutex);
+    pthread_cond_signal(&wakeCond);
+    pthread_mutex_unlock(&wakeMutex);
+}
+
+void Logger::writeSync(const LogRecord& rec)
+{
+    // Writer thread is gone: format and write in the caller
+    pthread_mutex_lock(&wakeMutex);
+    out.clear();
+    format(rec);
+    writeOut();
+    pthread_mutex_unlock(&wakeMutex);
+}
+
+/* ============================================================================
+ * Writer Thread
+ * ============================================================================ */
+
+void* Logger::writerFuncStatic(void* arg)
+{
+    ((Logger*)arg)->writerFunc();
+    return NULL;
+}
+
+void Logger::writerFunc()
+{
+    while (running.load(std::memory_order_acquire)) {
+        // Batch for up to 100 ms; errors wake the thread early
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += 100 * 1000000L;
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+        pthread_mutex_lock(&wakeMutex);
+        pthread_cond_timedwait(&wakeCond, &wakeMutex, &ts);
+        pthread_mutex_unlock(&wakeMutex);
+
+        drain();
+    }
+}
+
+void Logger::drain()
+{
+    std::vector<LogRing*> snapshot;
+    pthread_mutex_lock(&ringsMutex);
+    snapshot = rings;
+    pthread_mutex_unlock(&ringsMutex);
+
+    batch.clear();
+    uint32_t dropped = 0;
+    std::vector<LogRing*> retired;
+    for (size_t i = 0; i < snapshot.size(); i++) {
+        // Read before draining: a retired ring gets no more records
+        bool exited = snapshot[i]->retired.load(std::memory_order_acquire);
+        LogRecord* rec;
+        while ((rec = snapshot[i]->peek()) != nullptr) {
+            batch.push_back(*rec);
+            snapshot[i]->pop();
+        }
+        dropped += snapshot[i]->dropped.exchange(0, std::memory_order_relaxed);
+        if (exited) retired.push_back(snapshot[i]);
+    }
+    if (!retired.empty()) {
+        pthread_mutex_lock(&ringsMutex);
+        for (LogRing* ring : retired) {
+            rings.erase(std::find(rings.begin(), rings.end(), ring));
+            delete ring;
+        }
+        pthread_mutex_unlock(&ringsMutex);
+    }
+    if (batch.empty() && dropped == 0) return;
+
+    // Merge the per-thread streams into one timeline
+    std::stable_sort(batch.begin(), batch.end(),
+                     [](const LogRecord& a, const LogRecord& b) { return a.timestampNs < b.timestampNs; });
+
+    out.clear();
+    for (size_t i = 0; i < batch.size(); i++) {
+        format(batch[i]);
+    }
+    if (dropped > 0) {
+        char line[96];
+        snprintf(line, sizeof(line), "[Logger] %u message(s) dropped (ring full)\n", dropped);
+        out += line;
+    }
+    writeOut();
+}
+
+void Logger::format(const LogRecord& rec)
+{
+    static const char* LEVEL_NAMES[] = { "DEBUG", "INFO ", "WARN ", "ERROR" };
+
+    char prefix[64];
+    time_t seconds = static_cast<time_t>(rec.timestampNs / 1000000000LL);
+    int millis = static_cast<int>((rec.timestampNs / 1000000LL) % 1000);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    size_t n = strftime(prefix, sizeof(prefix), "%Y-%m-%d %H:%M:%S", &local);
+    snprintf(prefix + n, sizeof(prefix) - n, ".%03d %s [", millis, LEVEL_NAMES[rec.level & 3]);
+    out += prefix;
+    out += rec.tag;
+    out += "] ";
+
+    // Substitute "{}" ("{:x}" = hex integer) placeholders in order
+    int argIndex = 0;
+    for (const char* p = rec.format; *p; p++) {
+        if (strncmp(p, "{:x}", 4) == 0 && argIndex < rec.argCount) {
+            const LogArg& arg = rec.args[argIndex++];
+            char value[32];
+            snprintf(value, sizeof(value), "%" PRIx64, arg.u);
+            out += value;
+            p += 3;
+        } else if (p[0] == '{' && p[1] == '}' && argIndex < rec.argCount) {
+            const LogArg& arg = rec.args[argIndex++];
+            char value[32];
+            switch (arg.type) {
+            case LogArg::INT:     snprintf(value, sizeof(value), "%" PRId64, arg.i); out += value; break;
+            case LogArg::UINT:    snprintf(value, sizeof(value), "%" PRIu64, arg.u); out += value; break;
+            case LogArg::DOUBLE:  snprintf(value, sizeof(value), "%g", arg.d); out += value; break;
+            case LogArg::STRING:  out.append(rec.text + arg.strOffset, arg.strLen); break;
+            case LogArg::CHAR:    out += static_cast<char>(arg.i); break;
+            case LogArg::BOOL:    out += arg.i ? "true" : "false"; break;
+            case LogArg::POINTER: snprintf(value, sizeof(value), "%p", arg.p); out += value; break;
+            }
+            p++;
+        } else {
+            out += *p;
+        }
+    }
+
+    if (rec.suppressed > 0) {
+        char note[48];
+        snprintf(note, sizeof(note), " (+%u suppressed)", rec.suppressed);
+        out += note;
+    }
+    out += '\n';
+}
+
+/* ============================================================================
+ * Output / Rotation
+ * ============================================================================ */
+
+void Logger::openFile()
+{
+    if (filePath.empty()) return;
+
+    int newFd = open(filePath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (newFd < 0) {
+        fprintf(stderr, "[Logger] Cannot open %s, logging to stdout\n", filePath.c_str());
+        return;
+    }
+
+    struct stat st;
+    fileSize = (fstat(newFd, &st) == 0) ? static_cast<size_t>(st.st_size) : 0;
+    fd = newFd;
+    ownsFd = true;
+}
+
+void Logger::rotate()
+{
+    close(fd);
+    fd = STDOUT_FILENO;
+    ownsFd = false;
+
+    // leafsense.log -> .1 -> .2 ... ; max_files counts the live file, so
+    // .<maxFiles - 1> is the oldest kept and is overwritten
+    unlink((filePath + "." + std::to_string(maxFiles > 1 ? maxFiles : 1)).c_str());
+    for (int i = maxFiles - 2; i >= 1; i--) {
+        std::string from = filePath + "." + std::to_string(i);
+        std::string to = filePath + "." + std::to_string(i + 1);
+        rename(from.c_str(), to.c_str());
+    }
+    if (maxFiles > 1) {
+        rename(filePath.c_str(), (filePath + ".1").c_str());
+    } else {
+        unlink(filePath.c_str());
+    }
+    openFile();
+}
+
+void Logger::writeOut()
+{
+    size_t written = 0;
+    while (written < out.size()) {
+        ssize_t n = write(fd, out.data() + written, out.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+    fileSize += written;
+
+    if (ownsFd && maxFileSize > 0 && fileSize >= maxFileSize) {
+        rotate();
+    }
+}
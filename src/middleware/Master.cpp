@@ -4,18 +4,47 @@
  */
 
 #include "Master.h"
-#include <iostream>
+#include "Logger.h"
+#include "Trace.h"
 #include <sstream>
+#include <vector>
 #include <fcntl.h>
 #include <unistd.h>
 #include <ctime>
 #include <signal.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <poll.h>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <opencv2/imgcodecs.hpp>
 
 // Global pointer for signal handler access
 static Master* g_masterInstance = nullptr;
 static pthread_cond_t* g_condTime = nullptr;
 static pthread_mutex_t* g_mutexTime = nullptr;
 
+// Set by SIGUSR1, serviced by tTime (no file I/O in the handler)
+static volatile sig_atomic_t g_traceDumpRequested = 0;
+
+static void sigusr1Handler(int sig) {
+    (void)sig;
+    g_traceDumpRequested = 1;
+}
+
+// Regions of a tiled result as "x,y,w,h;x,y,w,h" (ml_predictions.bounding_box)
+static std::string formatRegions(const MLResult& result)
+{
+    std::stringstream boxes;
+    for (size_t i = 0; i < result.regions.size(); i++) {
+        const MLRegion& r = result.regions[i];
+        boxes << (i ? ";" : "") << r.x << "," << r.y << "," << r.width << "," << r.height;
+    }
+    return boxes.str();
+}
+
 // SIGALRM handler - triggers tSig thread
 static void sigalrmHandler(int sig) {
     (void)sig;
@@ -33,31 +62,92 @@ static void sigalrmHandler(int sig) {
 Master::Master(MQueueHandler* queue) 
     : msgQueue(queue)
     , running(false)
-    , sensorsCorrecting(false)
-    , cameraCaptureCounter(0)
-    , readSensorCD(0)
-    , cameraCaptureInterval(900)  // 900 tSig activations
-    , readSensorInterval(10)      // 10 tSig activations 
+    , tickPeriodMs(TICK_SECONDS * 1000)
+    , lockstep(false)
+    , i2cBus(nullptr)
+    , w1Bus(nullptr)
+    , mlAlertZones(0)
+    , actuatorQueue(32, OverflowPolicy::BLOCK)
+    , adcEventsStarted(false)
+    , reloadStarted(false)
+    , reloading(false)
+    , reloadOk(false)
+    , readRequested(false)
+    , readDone(false)
+    , fenceReached(false)
 {
-    // Initialize configuration
-    idealConditions = new IdealConditions();
-    
-    // Initialize actuators (Mock GPIO pins)
-    heater = new Heater(26);
-    phuPump = new Pumps(6);
-    phdPump = new Pumps(13);
-    nPump = new Pumps(5);
-    
-    // Initialize sensors (Mock drivers)
-    adc = new ADC(0x48);
-    tempSensor = new Temp("mock_addr");
-    phSensor = new PH(adc, 2);    // Channel 2 (A2 on ADS1115)
-    tdsSensor = new TDS(adc, 3);  // Channel 3 (A3 on ADS1115)
-    camera = new Cam();
-    
-    // Initialize ML engine with model path
-    // Model located at: /opt/leafsense/leafsense_model.onnx
-    mlEngine = new ML("/opt/leafsense", "leafsense_model.onnx");
+    const Config& config = Config::instance();
+    
+    // Simulated reservoirs advance TICK_SECONDS per tick, ticks come sim.speed times faster
+    if (config.getBool("sim.enabled", false)) {
+        float speed = config.getFloat("sim.speed", 1.0f);
+        if (speed < 1.0f) speed = 1.0f;
+        tickPeriodMs = static_cast<int>(TICK_SECONDS * 1000 / speed);
+        if (tickPeriodMs < 1) tickPeriodMs = 1;
+        lockstep = true;
+        LS_INFO("Master", "Simulation mode, {}x real time ({} ms per tick)", speed, tickPeriodMs);
+    }
+    
+    // Span recording: "kill -USR1 <pid>" writes trace.file
+    Tracer::configure();
+    signal(SIGUSR1, sigusr1Handler);
+    
+    // Initialize ML engine (shared by every zone)
+    // Model located at: /opt/leafsense/leafsense_model[_int8].onnx
+    const std::string mlDir = config.getString("ml.dir", "/opt/leafsense");
+    mlEngine = new ML(mlDir, ML::resolveModel(mlDir, config.getString("ml.variant", "fp32")));
+    inferenceService = new InferenceService(mlEngine, config.getInt("ml.queue_capacity", 4));
+    analyzeTimeoutMs = config.getInt("ml.request_timeout_ms", 2000);
+    modelWatchMs = config.getInt("ml.watch_interval_ms", 5000);
+    mlEngine->setTiling(config.getInt("ml.tiles", 0), config.getFloat("ml.tile_overlap", 0.25f));
+    
+    // Camera pipeline: one thread per stage, results persisted by Master
+    cameraPipeline = new CameraPipeline(inferenceService,
+        [this](const PipelineFrame& frame) { persistCameraFrame(frame); });
+    
+    // Repeated frames reuse the stored result instead of running the model.
+    // Memory only: dDatabase stays the daemon's single SQLite writer.
+    resultCache = nullptr;
+    int cacheEntries = config.getInt("ml.cache_entries", 256);
+    if (cacheEntries > 0) {
+        resultCache = new InferenceCache(static_cast<size_t>(cacheEntries), "");
+        cameraPipeline->setResultCache(resultCache);
+    }
+    
+    // One bus manager serializes every I2C device
+    i2cBus = new I2CBus(config.getString("i2c.device", "/dev/i2c-1"),
+                        config.getInt("i2c.retries", 2));
+    
+    // All DS18B20 probes hang off one 1-Wire master
+    w1Bus = new W1Bus(config.getString("w1.master", "w1_bus_master1"));
+    
+    // Initialize zones; ADCs are created once per I2C address and shared
+    int zoneCount = config.getInt("zones.count", 1);
+    if (zoneCount < 1) zoneCount = 1;
+    if (zoneCount > 32) zoneCount = 32;  // mlAlertZones bit mask
+    
+    for (int id = 1; id <= zoneCount; id++) {
+        ZoneConfig zoneConfig = ZoneConfig::fromConfig(id, TICK_SECONDS);
+        
+        ADC*& adc = adcBus[zoneConfig.adcAddress];
+        if (!adc) {
+            adc = new ADC(i2cBus, zoneConfig.adcAddress);
+        }
+        
+        adc->enableChannel(zoneConfig.phChannel);
+        adc->enableChannel(zoneConfig.tdsChannel);
+        
+        Zone* zone = new Zone(zoneConfig, adc, w1Bus, msgQueue, &actuatorQueue);
+        if (zone->getCamera()) {
+            zone->setCameraId(cameraPipeline->addCamera(zone->getCamera()));
+            cameraZones.push_back(zone);
+        }
+        zones.push_back(zone);
+    }
+    for (std::map<int, ADC*>::iterator it = adcBus.begin(); it != adcBus.end(); ++it) {
+        configureAdc(it->second);
+    }
+    LS_INFO("Master", "{} zone(s), {} ADC(s), {} camera(s)", zones.size(), adcBus.size(), cameraZones.size());
 
     // Initialize synchronization primitives
     createMutexes();
@@ -70,18 +160,187 @@ Master::~Master()
     destroyMutexes();
     destroyConds();
     
-    // Clean up allocated objects
-    delete idealConditions;
-    delete heater;
-    delete phuPump;
-    delete phdPump;
-    delete nPump;
-    delete adc;
-    delete tempSensor;
-    delete phSensor;
-    delete tdsSensor;
-    delete camera;
-    delete mlEngine;
+    // Clean up allocated objects (pipeline first: it uses zone cameras)
+    delete cameraPipeline;
+    delete resultCache;
+    for (size_t i = 0; i < zones.size(); i++) {
+        delete zones[i];
+    }
+    for (std::map<int, ADC*>::iterator it = adcBus.begin(); it != adcBus.end(); ++it) {
+        delete it->second;
+    }
+    delete i2cBus;
+    delete w1Bus;
+    delete inferenceService;  // Deletes mlEngine
+}
+
+/**
+ * Keys per device, e.g. "adc.0x48.ready_pin = 17" and "adc.0x48.mode =
+ * continuous"; "adc.data_rate" applies to all devices. Without a ready
+ * pin the ADC keeps the polled single-shot mode.
+ */
+void Master::configureAdc(ADC* adc)
+{
+    const Config& config = Config::instance();
+    char base[16];
+    snprintf(base, sizeof(base), "adc.0x%02x.", adc->getAddress());
+    const std::string k = base;
+    
+    adc->setDataRate(config.getInt(k + "data_rate", config.getInt("adc.data_rate", 128)));
+    
+    if (!adc->attachReadyPin(config.getInt(k + "ready_pin", -1))) return;
+    
+    if (config.getString(k + "mode", "continuous") == "continuous") {
+        adc->startScan();
+    }
+}
+
+const SensorSnapshot* Master::getSensorSnapshot(size_t zoneIndex) const
+{
+    return zoneIndex < zones.size() ? zones[zoneIndex]->getSensorSnapshot() : nullptr;
+}
+
+/* ============================================================================
+ * Control Socket
+ * ============================================================================ */
+
+void Master::attachLiveState(LiveState* state)
+{
+    for (size_t i = 0; i < zones.size() && i < LIVE_MAX_ZONES; i++) {
+        state->setZone(i, zones[i]->getId(), zones[i]->getSensorSnapshot()->getMaxAgeMs());
+        zones[i]->setLiveState(state, i);
+    }
+    if (zones.size() > LIVE_MAX_ZONES) {
+        LS_WARN("Master", "Only the first {} zones are published to the GUI", LIVE_MAX_ZONES);
+    }
+}
+
+std::string Master::handleCommand(const std::string& line, ControlServer::PendingReply& later)
+{
+    std::vector<std::string> parts;
+    std::stringstream ss(line);
+    std::string part;
+    while (std::getline(ss, part, '|')) parts.push_back(part);
+    if (parts.empty()) return "ERR|Empty command";
+
+    // Optional zone argument -> zone (nullptr if unknown)
+    auto findZone = [this](const std::string& id) -> Zone* {
+        for (size_t i = 0; i < zones.size(); i++) {
+            if (std::to_string(zones[i]->getId()) == id) return zones[i];
+        }
+        return nullptr;
+    };
+
+    const std::string& tag = parts[0];
+
+    if (tag == "THRESHOLDS") {
+        if (parts.size() != 8) return "ERR|THRESHOLDS needs zone and 6 values";
+        Zone* zone = findZone(parts[1]);
+        if (!zone) return "ERR|Unknown zone " + parts[1];
+
+        float v[6];
+        for (int i = 0; i < 6; i++) {
+            char* end = nullptr;
+            v[i] = std::strtof(parts[2 + i].c_str(), &end);
+            if (end == parts[2 + i].c_str() || *end != '\0') return "ERR|Bad number " + parts[2 + i];
+        }
+        if (v[0] >= v[1] || v[2] >= v[3] || v[4] >= v[5]) return "ERR|Minimum must be below maximum";
+
+        IdealConditions* ideal = zone->getIdealConditions();
+        ideal->setTemp(v[0], v[1]);
+        ideal->setPH(v[2], v[3]);
+        ideal->setTDS(v[4], v[5]);
+        zone->send("LOG|Maintenance|Thresholds updated|T " + parts[2] + "-" + parts[3] +
+                   ", pH " + parts[4] + "-" + parts[5] + ", EC " + parts[6] + "-" + parts[7]);
+        return "OK";
+    }
+
+    // Database updates go through the queue: dDatabase stays the only writer
+    if (tag == "ACK_ALERTS") {
+        if (parts.size() == 1) {
+            msgQueue->sendMessage("ACK|ALERTS");
+            return "OK";
+        }
+        Zone* zone = findZone(parts[1]);
+        if (!zone) return "ERR|Unknown zone " + parts[1];
+        zone->send("ACK|ALERTS");
+        return "OK";
+    }
+
+    if (tag == "ACK_REC") {
+        if (parts.size() != 2 || parts[1].empty()) return "ERR|ACK_REC needs a filename";
+        msgQueue->sendMessage("ACK|REC|" + parts[1]);
+        return "OK";
+    }
+
+    // On-demand classification: runs ahead of scheduled captures
+    if (tag == "ANALYZE") {
+        if (parts.size() != 2 || parts[1].empty()) return "ERR|ANALYZE needs an image path";
+        cv::Mat image = cv::imread(parts[1]);
+        if (image.empty()) return "ERR|Cannot read " + parts[1];
+
+        InferenceService::Ticket ticket = 0;
+        std::shared_ptr<std::future<MLResult>> pending = std::make_shared<std::future<MLResult>>(
+            inferenceService->submit(image, InferencePriority::ON_DEMAND, &ticket));
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(analyzeTimeoutMs);
+        InferenceService* service = inferenceService;
+
+        // Polled by the control thread, which keeps serving other clients
+        later = [pending, ticket, deadline, service](std::string& reply) {
+            if (pending->wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                if (std::chrono::steady_clock::now() < deadline) return false;
+                if (service->cancel(ticket)) {
+                    reply = "ERR|Timed out";
+                    return true;
+                }
+                return false;  // Already running: wait for its result
+            }
+            try {
+                MLResult result = pending->get();
+                std::stringstream out;
+                out << "OK|" << result.class_name << "|" << result.confidence << "|"
+                    << (result.isValidPlant ? 1 : 0) << "|" << formatRegions(result);
+                reply = out.str();
+            } catch (const InferenceCancelled& e) {
+                reply = std::string("ERR|") + e.what();
+            }
+            return true;
+        };
+        return "";
+    }
+
+    // Model swap: inference continues meanwhile
+    if (tag == "MODEL") {
+        if (parts.size() == 2 && parts[1] == "RELOAD") {
+            // Loading and warm-up take seconds: run them on tReload. Master owns
+            // the thread, so a client hanging up never waits for it.
+            if (reloading.load()) return "ERR|A reload is already in progress";
+            if (reloadStarted) {
+                pthread_join(tReload, NULL);  // Finished: returns at once
+                reloadStarted = false;
+            }
+            reloading = true;
+            if (pthread_create(&tReload, NULL, tReloadFuncStatic, this) != 0) {
+                reloading = false;
+                return "ERR|Cannot start the reload";
+            }
+            reloadStarted = true;
+            later = [this](std::string& reply) {
+                if (reloading.load()) return false;
+                reply = reloadOk ? "OK|" + mlEngine->getModelVersion()
+                                 : "ERR|Model not loaded, still serving " + mlEngine->getModelVersion();
+                return true;
+            };
+            return "";
+        } else if (parts.size() == 2 && parts[1] == "ROLLBACK") {
+            if (!mlEngine->rollback()) return "ERR|No previous model";
+        } else if (parts.size() != 1) {
+            return "ERR|MODEL takes RELOAD or ROLLBACK";
+        }
+        return "OK|" + mlEngine->getModelVersion();
+    }
+
+    return "ERR|Unknown command " + tag;
 }
 
 /* ============================================================================
@@ -92,34 +351,63 @@ void Master::start()
 {
     running = true;
     
-    // Create all worker threads
+    // Pipeline stages must be waiting before tSig can trigger a capture
+    inferenceService->start();
+    cameraPipeline->start();
+    
+    // A new model file is loaded and swapped in without a restart
+    mlEngine->startWatching(modelWatchMs);
+    
+    // Create all worker threads (fixed set, independent of zone count)
     pthread_create(&tTime, NULL, tTimeFuncStatic, this);
     pthread_create(&tSig, NULL, tSigFuncStatic, this);
     pthread_create(&tReadSensors, NULL, tReadSensorsFuncStatic, this);
-    pthread_create(&tCamera, NULL, tCameraFuncStatic, this);
-    pthread_create(&tWaterHeater, NULL, tWaterHeaterFuncStatic, this);
-    pthread_create(&tPHU, NULL, tPHUFuncStatic, this);
-    pthread_create(&tPHD, NULL, tPHDFuncStatic, this);
-    pthread_create(&tNutrients, NULL, tNutrientsFuncStatic, this);
+    pthread_create(&tActuators, NULL, tActuatorsFuncStatic, this);
+    
+    // ALERT/RDY servicing only exists while some ADC is scanning
+    for (std::map<int, ADC*>::iterator it = adcBus.begin(); it != adcBus.end(); ++it) {
+        if (it->second->isScanning()) adcEventsStarted = true;
+    }
+    if (adcEventsStarted) {
+        pthread_create(&tAdcEvents, NULL, tAdcEventsFuncStatic, this);
+    }
 }
 
 void Master::stop() 
 {
+    if (!running) return;
     running = false;
     
     // Wake up all waiting threads
     triggerSignal(&condTime, &mutexTime);
     triggerSignal(&condRS, &mutexRS);
-    triggerSignal(&condCam, &mutexCam);
-    triggerSignal(&condWH, &mutexWH);
-    triggerSignal(&condPHU, &mutexPHU);
-    triggerSignal(&condPHD, &mutexPHD);
-    triggerSignal(&condN, &mutexN);
+    triggerSignal(&condStep, &mutexRS);
+    actuatorQueue.close();
     
     // Wait for threads to finish
     pthread_join(tTime, NULL);
     pthread_join(tSig, NULL);
-    pthread_join(tCamera, NULL);
+    pthread_join(tReadSensors, NULL);
+    pthread_join(tActuators, NULL);
+    if (adcEventsStarted) {
+        pthread_join(tAdcEvents, NULL);
+        adcEventsStarted = false;
+    }
+    
+    // A reload still loading finishes before the engine is torn down
+    if (reloadStarted) {
+        pthread_join(tReload, NULL);
+        reloadStarted = false;
+    }
+    
+    // Drain in-flight frames and join the pipeline stages
+    mlEngine->stopWatching();
+    cameraPipeline->stop();
+    inferenceService->stop();
+    
+    if (Tracer::enabled()) {
+        Tracer::dump();
+    }
 }
 
 /* ============================================================================
@@ -128,7 +416,8 @@ void Master::stop()
 
 void Master::tTimeFunc() 
 {
-    std::cout << "[tTime] Timer thread started (5s interval)" << std::endl;
+    LS_INFO("tTime", "Timer thread started ({} ms interval)", tickPeriodMs);
+    Tracer::setThreadName("tTime");
     
     // Use a dedicated mutex and condition for the timer wait
     pthread_mutex_t timerMutex = PTHREAD_MUTEX_INITIALIZER;
@@ -138,7 +427,12 @@ void Master::tTimeFunc()
         // Use pthread_cond_timedwait instead of usleep for proper threading
         struct timespec ts;
         clock_gettime(CLOCK_REALTIME, &ts);
-        ts.tv_sec += 5;  // Wait for 5 seconds
+        ts.tv_sec += tickPeriodMs / 1000;
+        ts.tv_nsec += (tickPeriodMs % 1000) * 1000000L;
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
         
         pthread_mutex_lock(&timerMutex);
         pthread_cond_timedwait(&timerCond, &timerMutex, &ts);
@@ -146,7 +440,12 @@ void Master::tTimeFunc()
         
         if (!running) break;
         
-        std::cout << "[tTime] Timer tick - signaling tSig thread" << std::endl;
+        LS_DEBUG("tTime", "Timer tick - signaling tSig thread");
+        
+        if (g_traceDumpRequested) {
+            g_traceDumpRequested = 0;
+            Tracer::dump();
+        }
         
         // Signal the tSig thread
         pthread_mutex_lock(&mutexTime);
@@ -157,290 +456,148 @@ void Master::tTimeFunc()
     pthread_mutex_destroy(&timerMutex);
     pthread_cond_destroy(&timerCond);
     
-    std::cout << "[tTime] Timer thread stopped" << std::endl;
+    LS_INFO("tTime", "Timer thread stopped");
 }
 
 void Master::tSigFunc() 
 {
-    std::cout << "[tSig] Thread started, waiting for timer signals..." << std::endl;
+    LS_INFO("tSig", "Thread started, waiting for timer signals");
+    Tracer::setThreadName("tSig");
     
     while (running) {
         captureSignal(&condTime, &mutexTime);
         if (!running) break;
 
-        std::cout << "[tSig] Tick! SensorCD=" << readSensorCD 
-                  << ", CameraCD=" << cameraCaptureCounter << std::endl;
-
-        if (nPump->getState()) {
-            triggerSignal(&condN, &mutexN);
-            msgQueue->sendMessage("LOG|Maintenance|Nutrients|Auto Off");
-        }
-        if (phuPump->getState()) {
-            triggerSignal(&condPHU, &mutexPHU);
-            msgQueue->sendMessage("LOG|Maintenance|pH Up|Auto Off");
-        }
-        if (phdPump->getState()) {
-            triggerSignal(&condPHD, &mutexPHD);
-            msgQueue->sendMessage("LOG|Maintenance|pH Down|Auto Off");
-        }
+        LS_DEBUG("tSig", "Tick! ({} zone(s))", zones.size());
 
-        if (readSensorCD <= 0) {
-            std::cout << "[tSig] Triggering sensor read" << std::endl;
-            readSensorCD = readSensorInterval;
-            triggerSignal(&condRS, &mutexRS);
-        } else {
-            if (sensorsCorrecting) {
-                readSensorCD -= 2;
-            } else {
-                readSensorCD -= 1;
+        // Advance every zone's schedule; one wake-up serves all due zones
+        bool readsPending = false;
+        for (size_t i = 0; i < zones.size(); i++) {
+            if (zones[i]->tick()) {
+                readsPending = true;
+            }
+            if (zones[i]->cameraTick()) {
+                LS_INFO("tSig", "Triggering camera capture (zone {})", zones[i]->getId());
+                cameraPipeline->triggerCamera(zones[i]->getCameraId());
             }
         }
         
-        if (cameraCaptureCounter <= 0) {
-            std::cout << "[tSig] Triggering camera capture" << std::endl;
-            cameraCaptureCounter = cameraCaptureInterval;
-            triggerSignal(&condCam, &mutexCam);
-        } else {
-            cameraCaptureCounter -= 1;
+        if (readsPending) {
+            pthread_mutex_lock(&mutexRS);
+            readRequested = true;
+            readDone = false;
+            pthread_cond_signal(&condRS);
+            pthread_mutex_unlock(&mutexRS);
         }
+        
+        if (lockstep) finishStep(readsPending);
     }
 }
 
+void Master::finishStep(bool readsPending)
+{
+    // The simulated water must not advance while this tick's readings and
+    // the commands they produced are still in flight; otherwise a run would
+    // depend on thread timing. Ticks that arrive meanwhile are skipped.
+    pthread_mutex_lock(&mutexRS);
+    while (readsPending && running && !readDone) {
+        pthread_cond_wait(&condStep, &mutexRS);
+    }
+    fenceReached = false;
+    pthread_mutex_unlock(&mutexRS);
+    
+    // Commands are executed in order: once the fence is reached, so is
+    // everything tick() and acquire() queued before it
+    ActuatorCommand fence = { nullptr, ACT_HEATER, false };
+    if (!actuatorQueue.push(fence)) return;  // Closed by stop()
+    
+    pthread_mutex_lock(&mutexRS);
+    while (running && !fenceReached) {
+        pthread_cond_wait(&condStep, &mutexRS);
+    }
+    pthread_mutex_unlock(&mutexRS);
+}
+
 /* ============================================================================
- * Thread Functions - Sensor Reading & Control Logic
+ * Thread Functions - Sensor Acquisition & Control Logic
  * ============================================================================ */
 
 void Master::tReadSensorsFunc() 
 {
-    float phRange[2], tempRange[2], tdsRange[2];
+    Tracer::setThreadName("tReadSensors");
     
     while (running) {
-        captureSignal(&condRS, &mutexRS);
-        sensorsCorrecting = false;
+        // Wait with a predicate: stop() joins this thread, so a wake-up
+        // sent while it was still acquiring must not be lost
+        pthread_mutex_lock(&mutexRS);
+        while (running && !readRequested) {
+            pthread_cond_wait(&condRS, &mutexRS);
+        }
+        readRequested = false;
+        pthread_mutex_unlock(&mutexRS);
         if (!running) break;
-
-        // Read all sensors
-        float t = tempSensor->readSensor();
-        float p = phSensor->readSensor();
-        float e = tdsSensor->readSensor();
         
-        // Log to database via message queue
-        std::stringstream ss;
-        ss << "SENSOR|" << t << "|" << p << "|" << e;
-        msgQueue->sendMessage(ss.str());
-
-        /* --------------------------------------------------------------------
-         * Periodic Camera Capture & ML Analysis (every 30 minutes)
-         * First capture happens 4 seconds after startup for testing
-         * Triggers the dedicated camera thread
-         * -------------------------------------------------------------------- */
+        LS_TRACE_SPAN("sensor.cycle");
         
-
-        // Get ideal ranges for control decisions
-        idealConditions->getTemp(tempRange);
-        idealConditions->getPH(phRange);
-        idealConditions->getTDS(tdsRange);
-
-        /* --------------------------------------------------------------------
-         * Temperature Control (with hysteresis)
-         * -------------------------------------------------------------------- */
-        std::cout << "[Master] Temp Control: Current=" << t << "°C, Range=[" 
-                  << tempRange[0] << "-" << tempRange[1] << "], Heater=" 
-                  << (heater->getState() ? "ON" : "OFF") << std::endl;
-                  
-        if (t < tempRange[0] && !heater->getState()) {
-            std::cout << "[Master] Temperature LOW (" << t << " < " << tempRange[0] << ") -> Turning heater ON" << std::endl;
-            sensorsCorrecting = true;
-            triggerSignal(&condWH, &mutexWH);
-        } else if (t > tempRange[1] && heater->getState()) {
-            std::cout << "[Master] Temperature HIGH (" << t << " > " << tempRange[1] << ") -> Turning heater OFF" << std::endl;
-            triggerSignal(&condWH, &mutexWH);
-        }
-
-        /* --------------------------------------------------------------------
-         * pH Control
-         * -------------------------------------------------------------------- */
-        if (p < phRange[0]) {
-            sensorsCorrecting = true;
-            triggerSignal(&condPHU, &mutexPHU);
-        } else if (p > phRange[1]) {
-            sensorsCorrecting = true;
-            triggerSignal(&condPHD, &mutexPHD);
+        // One bulk DS18B20 conversion serves every hardware zone reading
+        // temperature (up to ~1 s, so never for simulated zones alone)
+        for (size_t i = 0; i < zones.size(); i++) {
+            if (!zones[i]->isSimulated() && zones[i]->isTempDue()) {
+                w1Bus->convertAll();
+                break;
+            }
         }
-
-        /* --------------------------------------------------------------------
-         * TDS/Nutrient Control
-         * -------------------------------------------------------------------- */
-        if (e < tdsRange[0]) {
-            sensorsCorrecting = true;
-            triggerSignal(&condN, &mutexN);
+        
+        // Single acquisition thread: bus transactions of all zones are serialized
+        for (size_t i = 0; i < zones.size(); i++) {
+            zones[i]->acquire();
         }
         
-        /* --------------------------------------------------------------------
-         * Update Alert LED (kernel module integration)
-         * -------------------------------------------------------------------- */
         updateAlertLED();
+        
+        if (lockstep) {
+            pthread_mutex_lock(&mutexRS);
+            readDone = true;
+            pthread_cond_signal(&condStep);
+            pthread_mutex_unlock(&mutexRS);
+        }
+    }
+    
+    for (size_t i = 0; i < zones.size(); i++) {
+        zones[i]->flushLog();
     }
 }
 
 /* ============================================================================
- * Thread Functions - Camera & ML Analysis
+ * Thread Functions - ADC Conversion Events
  * ============================================================================ */
 
-void Master::tCameraFunc() 
+void Master::tAdcEventsFunc() 
 {
+    Tracer::setThreadName("tAdcEvents");
+    // One event loop for every scanning ADC: sleeps on the ALERT/RDY fds
+    std::vector<struct pollfd> fds;
+    std::vector<ADC*> owners;
+    for (std::map<int, ADC*>::iterator it = adcBus.begin(); it != adcBus.end(); ++it) {
+        if (!it->second->isScanning()) continue;
+        struct pollfd pfd;
+        pfd.fd = it->second->getReadyFd();
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        fds.push_back(pfd);
+        owners.push_back(it->second);
+    }
+    LS_INFO("tAdcEvents", "Servicing {} scanning ADC(s)", fds.size());
+    
     while (running) {
-        captureSignal(&condCam, &mutexCam);
-        if (!running) break;
+        // Bounded timeout so stop() is noticed without an extra wake-up fd
+        int ready = poll(fds.data(), fds.size(), 500);
+        if (ready <= 0) continue;
         
-        std::cout << "[Camera] Capturing photo for ML analysis..." << std::endl;
-        std::string photoPath = camera->takePhoto();
-        
-        if (!photoPath.empty()) {
-            // Extract filename from path
-            std::string filename = photoPath.substr(photoPath.find_last_of("/") + 1);
-            
-            // Save image record to database
-            std::stringstream imgMsg;
-            imgMsg << "IMG|" << filename << "|" << photoPath;
-            msgQueue->sendMessage(imgMsg.str());
-            
-            // Run ML inference on captured image
-            MLResult mlResult = mlEngine->analyzeDetailed(photoPath);
-            
-            // Use do-while(false) pattern to allow early exit for OOD
-            do {
-                // ============================================================
-                // Out-of-Distribution Detection (Non-plant image rejection)
-                // ============================================================
-                if (!mlResult.isValidPlant) {
-                    std::cout << "[Camera] OOD Detection: Image does not appear to be a valid plant" << std::endl;
-                    std::cout << "[Camera] Entropy: " << mlResult.entropy 
-                              << ", Confidence: " << (mlResult.confidence * 100) << "%" << std::endl;
-                    
-                    // Save as "Unknown" prediction
-                    std::stringstream predMsg;
-                    predMsg << "PRED|" << filename << "|Unknown (Not a Plant)|" << mlResult.confidence;
-                    msgQueue->sendMessage(predMsg.str());
-                    
-                    // Log the rejection
-                    std::stringstream oodLog;
-                    oodLog << "LOG|ML Analysis|Out-of-Distribution Detected"
-                           << "|Image: " << filename 
-                           << ", Entropy: " << mlResult.entropy 
-                           << ", Confidence: " << (mlResult.confidence * 100) << "%";
-                    msgQueue->sendMessage(oodLog.str());
-                    
-                    // Turn LED OFF for OOD (not a valid plant image)
-                    setMLAlertLED(false);
-                    
-                    // Skip further ML processing for this image
-                    break;
-                }
-                
-                // Save ML prediction to database (linked to image)
-                {
-                    std::stringstream predMsg;
-                    predMsg << "PRED|" << filename << "|" << mlResult.class_name 
-                            << "|" << mlResult.confidence;
-                    msgQueue->sendMessage(predMsg.str());
-                }
-                
-                // Also log for history
-                {
-                    std::stringstream mlLog;
-                    mlLog << "LOG|ML Analysis|" << mlResult.class_name 
-                          << "|Confidence: " << (mlResult.confidence * 100) << "%";
-                    msgQueue->sendMessage(mlLog.str());
-                }
-                
-                std::cout << "[Camera] ML Result: " << mlResult.class_name 
-                          << " (" << (mlResult.confidence * 100) << "%)" << std::endl;
-            
-                // ============================================================
-                // LED Alert Control - ON for bad classes, OFF for Healthy
-                // Class IDs: 0=Deficiency, 1=Disease, 2=Healthy, 3=Pest
-                // ============================================================
-                bool isBadClass = (mlResult.class_id != 2);  // Not Healthy
-                setMLAlertLED(isBadClass);
-                
-                // ============================================================
-                // Generate Recommendations based on ML prediction (TCDIS6, TCDEF5)
-                // ============================================================
-                generateMLRecommendation(mlResult, filename);
-                
-                // ============================================================
-                // Multi-class confidence logging (TCDIS7, TCDEF7)
-                // ============================================================
-                if (mlResult.probs.size() >= 4) {
-                    std::cout << "[Camera] All class probabilities:" << std::endl;
-                    std::cout << "  - Nutrient Deficiency: " << (mlResult.probs[0] * 100) << "%" << std::endl;
-                    std::cout << "  - Disease: " << (mlResult.probs[1] * 100) << "%" << std::endl;
-                    std::cout << "  - Healthy: " << (mlResult.probs[2] * 100) << "%" << std::endl;
-                    std::cout << "  - Pest Damage: " << (mlResult.probs[3] * 100) << "%" << std::endl;
-                    
-                    // Log secondary detections above 20% confidence
-                    for (size_t i = 0; i < 4; i++) {
-                        if ((int)i != mlResult.class_id && mlResult.probs[i] > 0.20f) {
-                            std::string secondaryClass;
-                            switch(i) {
-                                case 0: secondaryClass = "Nutrient Deficiency"; break;
-                                case 1: secondaryClass = "Disease"; break;
-                                case 2: secondaryClass = "Healthy"; break;
-                                case 3: secondaryClass = "Pest Damage"; break;
-                            }
-                            std::stringstream secLog;
-                            secLog << "LOG|ML Analysis|Secondary: " << secondaryClass 
-                                   << "|Confidence: " << (mlResult.probs[i] * 100) << "%";
-                            msgQueue->sendMessage(secLog.str());
-                        }
-                    }
-                }
-                
-                // ============================================================
-                // Confidence threshold alerting (TCDIS8, TCDEF8)
-                // ============================================================
-                const float ALERT_THRESHOLD = 0.70f;  // 70% confidence threshold
-                if (mlResult.class_id != 2 && mlResult.confidence >= ALERT_THRESHOLD) {  // Not Healthy
-                    std::stringstream alertMsg;
-                    alertMsg << "ALERT|Critical|" << mlResult.class_name 
-                             << " detected with " << (mlResult.confidence * 100) << "% confidence";
-                    msgQueue->sendMessage(alertMsg.str());
-                    std::cout << "[Camera] ALERT: " << mlResult.class_name 
-                              << " detected above threshold!" << std::endl;
-                }
-                
-                // ============================================================
-                // Specific Disease/Deficiency Logging (TCDIS9, TCDEF9)
-                // ============================================================
-                if (mlResult.class_id == 1) {  // Disease
-                    std::stringstream diseaseLog;
-                    diseaseLog << "LOG|Disease|" << mlResult.class_name 
-                               << "|Image: " << filename 
-                               << ", Confidence: " << (mlResult.confidence * 100) 
-                               << "%, Timestamp: " << time(nullptr);
-                    msgQueue->sendMessage(diseaseLog.str());
-                } else if (mlResult.class_id == 0) {  // Deficiency
-                    // Get current EC for correlation
-                    float currentEC = tdsSensor->readSensor();
-                    std::stringstream defLog;
-                    defLog << "LOG|Deficiency|" << mlResult.class_name 
-                           << "|Image: " << filename 
-                           << ", Confidence: " << (mlResult.confidence * 100) 
-                           << "%, Current EC: " << currentEC << " µS/cm";
-                    msgQueue->sendMessage(defLog.str());
-                } else if (mlResult.class_id == 3) {  // Pest
-                    std::stringstream pestLog;
-                    pestLog << "LOG|Disease|Pest Damage"
-                            << "|Image: " << filename 
-                            << ", Confidence: " << (mlResult.confidence * 100) << "%";
-                    msgQueue->sendMessage(pestLog.str());
-                }
-                
-            } while(false);  // End of ML processing block (allows break for OOD skip)
-            
-        } else {
-            std::cerr << "[Camera] Failed to capture photo" << std::endl;
+        for (size_t i = 0; i < fds.size(); i++) {
+            if (fds[i].revents & POLLIN) {
+                owners[i]->serviceReady();
+            }
         }
     }
 }
@@ -449,56 +606,189 @@ void Master::tCameraFunc()
  * Thread Functions - Actuator Control
  * ============================================================================ */
 
-void Master::tWaterHeaterFunc() 
+void Master::tActuatorsFunc() 
 {
-    while (running) {
-        captureSignal(&condWH, &mutexWH);
-        if (!running) break;
-        
-        heater->setState(!heater->getState());
-        msgQueue->sendMessage(heater->getState() 
-            ? "LOG|Maintenance|Heater ON|Auto" 
-            : "LOG|Maintenance|Heater OFF|Auto");
+    Tracer::setThreadName("tActuators");
+    ActuatorCommand cmd;
+    while (actuatorQueue.pop(cmd)) {
+        if (!cmd.zone) {
+            // Lockstep fence from tSig (see finishStep())
+            pthread_mutex_lock(&mutexRS);
+            fenceReached = true;
+            pthread_cond_signal(&condStep);
+            pthread_mutex_unlock(&mutexRS);
+            continue;
+        }
+        cmd.zone->actuate(cmd);
     }
 }
 
-void Master::tPHUFunc() 
-{
-    while (running) {
-        captureSignal(&condPHU, &mutexPHU);
-        if (!running) break;
-        
-        phuPump->pump(!phuPump->getState());
-        msgQueue->sendMessage(phuPump->getState() 
-            ? "LOG|Maintenance|pH Up|Auto" 
-            : "LOG|Maintenance|pH Up|Auto");
-    }
-}
+/* ============================================================================
+ * Thread Functions - Model Reload
+ * ============================================================================ */
 
-void Master::tPHDFunc() 
+void Master::tReloadFunc() 
 {
-    while (running) {
-        captureSignal(&condPHD, &mutexPHD);
-        if (!running) break;
-        
-        phdPump->pump(!phdPump->getState());
-        msgQueue->sendMessage(phdPump->getState() 
-            ? "LOG|Maintenance|pH Down|Auto" 
-            : "LOG|Maintenance|pH Down|Auto");
-    }
+    Tracer::setThreadName("tReload");
+    reloadOk = mlEngine->reload();
+    reloading = false;  // Publishes reloadOk to the control thread
 }
 
-void Master::tNutrientsFunc() 
+/* ============================================================================
+ * Camera Pipeline - Persist Stage
+ * ============================================================================ */
+
+void Master::persistCameraFrame(const PipelineFrame& frame) 
 {
-    while (running) {
-        captureSignal(&condN, &mutexN);
-        if (!running) break;
-        
-        nPump->pump(!nPump->getState());
-        msgQueue->sendMessage(nPump->getState() 
-            ? "LOG|Maintenance|Nutrients|Auto" 
-            : "LOG|Maintenance|Nutrients|Auto");
+    LS_TRACE_SPAN("camera.persist");
+    const std::string& photoPath = frame.photoPath;
+    const std::string& filename = frame.filename;
+    const MLResult& mlResult = frame.result;
+    
+    // Every camera belongs to exactly one zone
+    if (frame.cameraId < 0 || frame.cameraId >= static_cast<int>(cameraZones.size())) {
+        LS_ERROR("Camera", "Frame from unknown camera {}", frame.cameraId);
+        return;
     }
+    Zone* zone = cameraZones[frame.cameraId];
+    size_t zoneIndex = static_cast<size_t>(zone->getId() - 1);
+    
+    // Save image record to database
+    std::stringstream imgMsg;
+    imgMsg << "IMG|" << filename << "|" << photoPath << "|" << frame.imageHash;
+    zone->send(imgMsg.str());
+    
+    // Use do-while(false) pattern to allow early exit for OOD
+    do {
+        // ============================================================
+        // Out-of-Distribution Detection (Non-plant image rejection)
+        // ============================================================
+        if (!mlResult.isValidPlant) {
+            LS_INFO("Camera", "OOD Detection: Image does not appear to be a valid plant");
+            LS_INFO("Camera", "Entropy: {}, Confidence: {}%", mlResult.entropy, mlResult.confidence * 100);
+            
+            // Save as "Unknown" prediction
+            std::stringstream predMsg;
+            predMsg << "PRED|" << filename << "|Unknown (Not a Plant)|" << mlResult.confidence
+                    << "|" << mlResult.modelVersion;
+            zone->send(predMsg.str());
+            
+            // Log the rejection
+            std::stringstream oodLog;
+            oodLog << "LOG|ML Analysis|Out-of-Distribution Detected"
+                   << "|Image: " << filename 
+                   << ", Entropy: " << mlResult.entropy 
+                   << ", Confidence: " << (mlResult.confidence * 100) << "%";
+            zone->send(oodLog.str());
+            
+            // Turn LED OFF for OOD (not a valid plant image)
+            setMLAlertLED(zoneIndex, false);
+            
+            // Skip further ML processing for this image
+            break;
+        }
+        
+        // Save ML prediction to database (linked to image)
+        {
+            std::stringstream predMsg;
+            predMsg << "PRED|" << filename << "|" << mlResult.class_name 
+                    << "|" << mlResult.confidence << "|" << mlResult.modelVersion
+                    << "|" << formatRegions(mlResult);
+            zone->send(predMsg.str());
+        }
+        
+        // Also log for history
+        {
+            std::stringstream mlLog;
+            mlLog << "LOG|ML Analysis|" << mlResult.class_name 
+                  << "|Confidence: " << (mlResult.confidence * 100) << "%";
+            zone->send(mlLog.str());
+        }
+        
+        LS_INFO("Camera", "ML Result: {} ({}%)", mlResult.class_name, mlResult.confidence * 100);
+    
+        // ============================================================
+        // LED Alert Control - ON for bad classes, OFF for Healthy
+        // Class IDs: 0=Deficiency, 1=Disease, 2=Healthy, 3=Pest
+        // ============================================================
+        bool isBadClass = (mlResult.class_id != 2);  // Not Healthy
+        setMLAlertLED(zoneIndex, isBadClass);
+        
+        // ============================================================
+        // Generate Recommendations based on ML prediction (TCDIS6, TCDEF5)
+        // ============================================================
+        generateMLRecommendation(zone, mlResult, filename);
+        
+        // ============================================================
+        // Multi-class confidence logging (TCDIS7, TCDEF7)
+        // ============================================================
+        if (mlResult.probs.size() >= 4) {
+            LS_DEBUG("Camera", "Class probabilities: Nutrient Deficiency {}%, Disease {}%, Healthy {}%, Pest Damage {}%",
+                     mlResult.probs[0] * 100, mlResult.probs[1] * 100,
+                     mlResult.probs[2] * 100, mlResult.probs[3] * 100);
+            
+            // Log secondary detections above 20% confidence
+            for (size_t i = 0; i < 4; i++) {
+                if ((int)i != mlResult.class_id && mlResult.probs[i] > 0.20f) {
+                    std::string secondaryClass;
+                    switch(i) {
+                        case 0: secondaryClass = "Nutrient Deficiency"; break;
+                        case 1: secondaryClass = "Disease"; break;
+                        case 2: secondaryClass = "Healthy"; break;
+                        case 3: secondaryClass = "Pest Damage"; break;
+                    }
+                    std::stringstream secLog;
+                    secLog << "LOG|ML Analysis|Secondary: " << secondaryClass 
+                           << "|Confidence: " << (mlResult.probs[i] * 100) << "%";
+                    zone->send(secLog.str());
+                }
+            }
+        }
+        
+        // ============================================================
+        // Confidence threshold alerting (TCDIS8, TCDEF8)
+        // ============================================================
+        const float ALERT_THRESHOLD = 0.70f;  // 70% confidence threshold
+        if (mlResult.class_id != 2 && mlResult.confidence >= ALERT_THRESHOLD) {  // Not Healthy
+            std::stringstream alertMsg;
+            alertMsg << "ALERT|Critical|" << mlResult.class_name 
+                     << " detected with " << (mlResult.confidence * 100) << "% confidence";
+            zone->send(alertMsg.str());
+            LS_WARN("Camera", "ALERT: {} detected above threshold!", mlResult.class_name);
+        }
+        
+        // ============================================================
+        // Specific Disease/Deficiency Logging (TCDIS9, TCDEF9)
+        // ============================================================
+        if (mlResult.class_id == 1) {  // Disease
+            std::stringstream diseaseLog;
+            diseaseLog << "LOG|Disease|" << mlResult.class_name 
+                       << "|Image: " << filename 
+                       << ", Confidence: " << (mlResult.confidence * 100) 
+                       << "%, Timestamp: " << time(nullptr);
+            zone->send(diseaseLog.str());
+        } else if (mlResult.class_id == 0) {  // Deficiency
+            // Get cached EC for correlation (no bus access from this thread)
+            SensorFrame latest;
+            std::stringstream defLog;
+            defLog << "LOG|Deficiency|" << mlResult.class_name 
+                   << "|Image: " << filename 
+                   << ", Confidence: " << (mlResult.confidence * 100) << "%";
+            if (zone->readSnapshot(latest)) {
+                defLog << ", Current EC: " << latest.ec << " µS/cm";
+            } else {
+                defLog << ", Current EC: unavailable";
+            }
+            zone->send(defLog.str());
+        } else if (mlResult.class_id == 3) {  // Pest
+            std::stringstream pestLog;
+            pestLog << "LOG|Disease|Pest Damage"
+                    << "|Image: " << filename 
+                    << ", Confidence: " << (mlResult.confidence * 100) << "%";
+            zone->send(pestLog.str());
+        }
+        
+    } while(false);  // End of ML processing block (allows break for OOD skip)
 }
 
 /* ============================================================================
@@ -520,28 +810,18 @@ void* Master::tReadSensorsFuncStatic(void* arg) {
     return NULL; 
 }
 
-void* Master::tCameraFuncStatic(void* arg) { 
-    ((Master*)arg)->tCameraFunc(); 
-    return NULL; 
-}
-
-void* Master::tWaterHeaterFuncStatic(void* arg) { 
-    ((Master*)arg)->tWaterHeaterFunc(); 
+void* Master::tActuatorsFuncStatic(void* arg) { 
+    ((Master*)arg)->tActuatorsFunc(); 
     return NULL; 
 }
 
-void* Master::tPHUFuncStatic(void* arg) { 
-    ((Master*)arg)->tPHUFunc(); 
+void* Master::tAdcEventsFuncStatic(void* arg) { 
+    ((Master*)arg)->tAdcEventsFunc(); 
     return NULL; 
 }
 
-void* Master::tPHDFuncStatic(void* arg) { 
-    ((Master*)arg)->tPHDFunc(); 
-    return NULL; 
-}
-
-void* Master::tNutrientsFuncStatic(void* arg) { 
-    ((Master*)arg)->tNutrientsFunc(); 
+void* Master::tReloadFuncStatic(void* arg) { 
+    ((Master*)arg)->tReloadFunc(); 
     return NULL; 
 }
 
@@ -571,52 +851,41 @@ void Master::createMutexes()
 {
     pthread_mutex_init(&mutexRS, NULL);
     pthread_mutex_init(&mutexTime, NULL);
-    pthread_mutex_init(&mutexN, NULL);
-    pthread_mutex_init(&mutexPHU, NULL);
-    pthread_mutex_init(&mutexPHD, NULL);
-    pthread_mutex_init(&mutexWH, NULL);
-    pthread_mutex_init(&mutexCam, NULL);
 }
 
 void Master::createConds() 
 {
     pthread_cond_init(&condRS, NULL);
     pthread_cond_init(&condTime, NULL);
-    pthread_cond_init(&condN, NULL);
-    pthread_cond_init(&condPHU, NULL);
-    pthread_cond_init(&condPHD, NULL);
-    pthread_cond_init(&condWH, NULL);
-    pthread_cond_init(&condCam, NULL);
+    pthread_cond_init(&condStep, NULL);
 }
 
 void Master::destroyMutexes() 
 {
     pthread_mutex_destroy(&mutexRS);
     pthread_mutex_destroy(&mutexTime);
-    pthread_mutex_destroy(&mutexN);
-    pthread_mutex_destroy(&mutexPHU);
-    pthread_mutex_destroy(&mutexPHD);
-    pthread_mutex_destroy(&mutexWH);
-    pthread_mutex_destroy(&mutexCam);
 }
 
 void Master::destroyConds() 
 {
     pthread_cond_destroy(&condRS);
     pthread_cond_destroy(&condTime);
-    pthread_cond_destroy(&condN);
-    pthread_cond_destroy(&condPHU);
-    pthread_cond_destroy(&condPHD);
-    pthread_cond_destroy(&condWH);
-    pthread_cond_destroy(&condCam);
+    pthread_cond_destroy(&condStep);
 }
 
 /* ============================================================================
  * LED Alert Control - Based on ML Classification
  * ============================================================================ */
 
-void Master::setMLAlertLED(bool alertActive) 
+void Master::setMLAlertLED(size_t zoneIndex, bool alertActive) 
 {
+    // One LED for all zones: lit while any zone reports a bad class
+    uint32_t bit = 1u << zoneIndex;
+    uint32_t zonesInAlert = alertActive
+        ? (mlAlertZones.fetch_or(bit) | bit)
+        : (mlAlertZones.fetch_and(~bit) & ~bit);
+    alertActive = (zonesInAlert != 0);
+    
     // Control LED via libgpiod (gpioset command) - GPIO 20
     // This is more reliable than the kernel module approach
     const char* cmd = alertActive 
@@ -626,9 +895,9 @@ void Master::setMLAlertLED(bool alertActive)
     int result = system(cmd);
     
     if (result != 0) {
-        std::cerr << "[LED] Failed to control LED via gpioset" << std::endl;
+        LS_ERROR("LED", "Failed to control LED via gpioset");
     } else {
-        std::cout << "[LED] Alert LED -> " << (alertActive ? "ON (Bad class detected)" : "OFF") << std::endl;
+        LS_INFO("LED", "Alert LED -> {}", alertActive ? "ON (Bad class detected)" : "OFF");
     }
 }
 
@@ -642,34 +911,42 @@ void Master::updateAlertLED()
  * ML Recommendation Generation (TCDIS6, TCDEF5, TCDEF6, TCDEF10)
  * ============================================================================ */
 
-void Master::generateMLRecommendation(const MLResult& mlResult, const std::string& filename)
+void Master::generateMLRecommendation(Zone* zone, const MLResult& mlResult, const std::string& filename)
 {
     // Skip recommendation if image is out-of-distribution (not a valid plant)
     if (!mlResult.isValidPlant) {
-        std::cout << "[Master] Skipping recommendation - not a valid plant image" << std::endl;
+        LS_INFO("Master", "Skipping recommendation - not a valid plant image");
         return;
     }
     
     std::string recType;
     std::string recText;
     
-    // Get current sensor values for correlation (TCDEF10)
-    float currentEC = tdsSensor->readSensor();
-    float currentPH = phSensor->readSensor();
-    float currentTemp = tempSensor->readSensor();
+    // Get cached sensor values for correlation (TCDEF10)
+    SensorFrame frame = {};
+    bool sensorsFresh = zone->readSnapshot(frame);
+    if (!sensorsFresh) {
+        LS_WARN("Master", "Sensor snapshot unavailable or stale - recommendation will not use sensor correlation");
+    }
+    float currentEC = frame.ec;
+    float currentPH = frame.ph;
+    float currentTemp = frame.temperature;
     
     // Get ideal ranges for comparison
     float tempRange[2], phRange[2], tdsRange[2];
-    idealConditions->getTemp(tempRange);
-    idealConditions->getPH(phRange);
-    idealConditions->getTDS(tdsRange);
+    zone->getIdealConditions()->getTemp(tempRange);
+    zone->getIdealConditions()->getPH(phRange);
+    zone->getIdealConditions()->getTDS(tdsRange);
     
     switch (mlResult.class_id) {
         case 0:  // Nutrient Deficiency
             recType = "Deficiency";
             
             // TCDEF6: Specific Nutrient Recommendation based on EC correlation
-            if (currentEC < tdsRange[0]) {
+            if (!sensorsFresh) {
+                recText = "Visual nutrient deficiency detected. Current EC/pH readings are unavailable - "
+                          "check sensors, then verify EC and pH manually before dosing.";
+            } else if (currentEC < tdsRange[0]) {
                 // Low EC indicates general nutrient deficiency
                 float deficit = tdsRange[0] - currentEC;
                 if (deficit > 300) {
@@ -714,18 +991,22 @@ void Master::generateMLRecommendation(const MLResult& mlResult, const std::strin
                       "2) Remove visibly infected leaves. "
                       "3) Apply appropriate fungicide/bactericide. "
                       "4) Improve air circulation. "
-                      "5) Reduce humidity if above 70%. "
-                      "Current conditions - Temp: " + std::to_string((int)currentTemp) + 
-                      "°C, pH: " + std::to_string(currentPH).substr(0, 4) + 
-                      ". Monitor closely for 48 hours.";
+                      "5) Reduce humidity if above 70%. " +
+                      (sensorsFresh
+                          ? "Current conditions - Temp: " + std::to_string((int)currentTemp) + 
+                            "°C, pH: " + std::to_string(currentPH).substr(0, 4) + ". "
+                          : std::string("Current conditions unavailable. ")) +
+                      "Monitor closely for 48 hours.";
             break;
             
         case 2:  // Healthy
             recType = "Healthy";
-            recText = "Plant appears healthy. Continue current care routine. "
-                      "Conditions: Temp " + std::to_string((int)currentTemp) + 
-                      "°C, pH " + std::to_string(currentPH).substr(0, 4) + 
-                      ", EC " + std::to_string((int)currentEC) + " µS/cm.";
+            recText = "Plant appears healthy. Continue current care routine. ";
+            if (sensorsFresh) {
+                recText += "Conditions: Temp " + std::to_string((int)currentTemp) + 
+                           "°C, pH " + std::to_string(currentPH).substr(0, 4) + 
+                           ", EC " + std::to_string((int)currentEC) + " µS/cm.";
+            }
             break;
             
         case 3:  // Pest Damage
@@ -749,9 +1030,8 @@ void Master::generateMLRecommendation(const MLResult& mlResult, const std::strin
     std::stringstream recMsg;
     recMsg << "REC|" << filename << "|" << recType << "|" << recText 
            << "|" << mlResult.confidence;
-    msgQueue->sendMessage(recMsg.str());
+    zone->send(recMsg.str());
     
     // Log recommendation
-    std::cout << "[Master] Recommendation (" << recType << "): " 
-              << recText.substr(0, 80) << "..." << std::endl;
+    LS_INFO("Master", "Recommendation ({}): {}...", recType, recText.substr(0, 80));
 }
\ No newline at end of file
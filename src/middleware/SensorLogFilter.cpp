@@ -0,0 +1,150 @@
+/**
+ * @file SensorLogFilter.cpp
+ * @brief Implementation of Swinging-Door Compression of Sensor Rows
+ */
+
+#include "SensorLogFilter.h"
+#include <limits>
+
+/* ============================================================================
+ * SwingingDoor
+ * ============================================================================ */
+
+SwingingDoor::SwingingDoor(float tol)
+    : tolerance(tol)
+    , pivotTime(0.0)
+    , pivotValue(0.0f)
+    , upperSlope(std::numeric_limits<double>::infinity())
+    , lowerSlope(-std::numeric_limits<double>::infinity())
+{
+}
+
+void SwingingDoor::reset(double time, float value)
+{
+    pivotTime = time;
+    pivotValue = value;
+    upperSlope = std::numeric_limits<double>::infinity();
+    lowerSlope = -std::numeric_limits<double>::infinity();
+}
+
+bool SwingingDoor::offer(double time, float value)
+{
+    double dt = time - pivotTime;
+    if (dt <= 0.0) {
+        // Same timestamp as the pivot: only a jump beyond tolerance matters
+        return (value > pivotValue + tolerance) || (value < pivotValue - tolerance);
+    }
+
+    double upper = (value + tolerance - pivotValue) / dt;
+    double lower = (value - tolerance - pivotValue) / dt;
+    double newUpper = (upper < upperSlope) ? upper : upperSlope;
+    double newLower = (lower > lowerSlope) ? lower : lowerSlope;
+
+    if (newLower > newUpper) {
+        return true;  // No line from the pivot covers every point any more
+    }
+
+    upperSlope = newUpper;
+    lowerSlope = newLower;
+    return false;
+}
+
+/* ============================================================================
+ * SensorLogFilter - Constructor
+ * ============================================================================ */
+
+SensorLogFilter::SensorLogFilter(float tempTol, float phTol, float ecTol, int heartbeatS, bool enable)
+    : tempDoor(tempTol)
+    , phDoor(phTol)
+    , ecDoor(ecTol)
+    , heartbeatSeconds(heartbeatS)
+    , enabled(enable)
+    , hasArchived(false)
+    , archivedEpoch(0)
+    , archived()
+    , hasHeld(false)
+    , held()
+{
+}
+
+/* ============================================================================
+ * SensorLogFilter - Filtering
+ * ============================================================================ */
+
+double SensorLogFilter::seconds(const SensorFrame& frame)
+{
+    return frame.acquiredAtMs / 1000.0;
+}
+
+void SensorLogFilter::archive(const SensorFrame& frame, std::vector<SensorFrame>& out)
+{
+    out.push_back(frame);
+    archived = frame;
+    archivedEpoch = frame.acquiredAtEpoch;
+    hasArchived = true;
+
+    double t = seconds(frame);
+    tempDoor.reset(t, frame.temperature);
+    phDoor.reset(t, frame.ph);
+    ecDoor.reset(t, frame.ec);
+}
+
+void SensorLogFilter::process(const SensorFrame& frame, std::vector<SensorFrame>& out)
+{
+    out.clear();
+
+    if (!enabled || !hasArchived) {
+        hasHeld = false;
+        archive(frame, out);
+        return;
+    }
+
+    // A status change (e.g. hardware -> fallback) is always recorded
+    bool statusChanged = frame.tempStatus != archived.tempStatus
+                      || frame.phStatus != archived.phStatus
+                      || frame.ecStatus != archived.ecStatus;
+    if (statusChanged) {
+        if (hasHeld) archive(held, out);
+        hasHeld = false;
+        archive(frame, out);
+        return;
+    }
+
+    // Offer every metric (no short-circuit) so all doors stay in step
+    double t = seconds(frame);
+    bool closed = tempDoor.offer(t, frame.temperature);
+    closed = phDoor.offer(t, frame.ph) || closed;
+    closed = ecDoor.offer(t, frame.ec) || closed;
+
+    if (closed) {
+        if (hasHeld) {
+            // The previous frame becomes the new pivot; re-offer this one from there
+            archive(held, out);
+            double tNow = seconds(frame);
+            tempDoor.offer(tNow, frame.temperature);
+            phDoor.offer(tNow, frame.ph);
+            ecDoor.offer(tNow, frame.ec);
+        } else {
+            // Jump right after a written row: nothing in between to keep
+            archive(frame, out);
+            return;
+        }
+    }
+
+    if (frame.acquiredAtEpoch - archivedEpoch >= heartbeatSeconds) {
+        hasHeld = false;
+        archive(frame, out);
+        return;
+    }
+
+    held = frame;
+    hasHeld = true;
+}
+
+bool SensorLogFilter::flush(SensorFrame& frame)
+{
+    if (!hasHeld) return false;
+    frame = held;
+    hasHeld = false;
+    return true;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file SensorSnapshot.cpp
+ * @brief Implementation of the Timestamped Sensor Frame Cache
+ */
+
+#include "SensorSnapshot.h"
+
+/* ============================================================================
+ * Writer
+ * ============================================================================ */
+
+void SensorSnapshot::publish(SensorFrame frame)
+{
+    publish(frame, nowMs(), static_cast<int64_t>(std::time(nullptr)));
+}
+
+void SensorSnapshot::publish(SensorFrame frame, uint64_t atMs, int64_t atEpoch)
+{
+    frame.acquiredAtMs = atMs;
+    frame.acquiredAtEpoch = atEpoch;
+    frame.publishedAtMs = nowMs();
+    latest.store(frame);
+}
+
+/* ============================================================================
+ * Reader
+ * ============================================================================ */
+
+bool SensorSnapshot::read(SensorFrame& frame, uint64_t maxAgeMs) const
+{
+    SensorFrame copy;
+    if (latest.load(copy) == 0) {
+        return false;  // Nothing acquired yet (or the writer is stuck mid-write)
+    }
+
+    frame = copy;
+    return (nowMs() - copy.publishedAtMs) <= maxAgeMs;
+}
+
+/* ============================================================================
+ * Clock
+ * ============================================================================ */
+
+uint64_t SensorSnapshot::nowMs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000ULL + ts.tv_nsec / 1000000;
+}
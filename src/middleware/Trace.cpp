@@ -0,0 +1,149 @@
+/**
+ * @file Trace.cpp
+ * @brief Implementation of Scoped Trace Spans
+ */
+
+#include "Trace.h"
+#include "Config.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+/* ============================================================================
+ * Static Members
+ * ============================================================================ */
+
+std::atomic<bool> Tracer::active(false);
+std::vector<TraceBuffer*> Tracer::buffers;
+pthread_mutex_t Tracer::buffersMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* ============================================================================
+ * TraceBuffer
+ * ============================================================================ */
+
+TraceBuffer::TraceBuffer()
+    : head(0)
+    , tid(static_cast<int>(syscall(SYS_gettid)))
+{
+    snprintf(threadName, sizeof(threadName), "thread-%d", tid);
+}
+
+/* ============================================================================
+ * Tracer
+ * ============================================================================ */
+
+void Tracer::configure()
+{
+    setEnabled(Config::instance().getBool("trace.enabled", false));
+    if (enabled()) {
+        LS_INFO("Trace", "Span recording enabled ({} spans per thread)", TraceBuffer::CAPACITY);
+    }
+}
+
+int64_t Tracer::nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Owner of a thread's buffer: unregisters and frees it on thread exit
+ *
+ * Spans of threads that exited before dump() are not exported.
+ */
+struct ThreadTraceBuffer {
+    TraceBuffer* buffer;
+    ThreadTraceBuffer() : buffer(nullptr) {}
+    ~ThreadTraceBuffer()
+    {
+        if (!buffer) return;
+        pthread_mutex_lock(&Tracer::buffersMutex);
+        std::vector<TraceBuffer*>& buffers = Tracer::buffers;
+        buffers.erase(std::find(buffers.begin(), buffers.end(), buffer));
+        pthread_mutex_unlock(&Tracer::buffersMutex);
+        delete buffer;
+    }
+};
+
+TraceBuffer* Tracer::threadBuffer()
+{
+    static thread_local ThreadTraceBuffer owner;
+    if (!owner.buffer) {
+        owner.buffer = new TraceBuffer();
+        pthread_mutex_lock(&buffersMutex);
+        buffers.push_back(owner.buffer);
+        pthread_mutex_unlock(&buffersMutex);
+    }
+    return owner.buffer;
+}
+
+void Tracer::setThreadName(const char* name)
+{
+    TraceBuffer* buffer = threadBuffer();
+    snprintf(buffer->threadName, sizeof(buffer->threadName), "%s", name);
+}
+
+bool Tracer::dump(const std::string& path)
+{
+    std::string file = path.empty()
+        ? Config::instance().getString("trace.file", "/tmp/leafsense-trace.json")
+        : path;
+
+    FILE* out = fopen(file.c_str(), "w");
+    if (!out) {
+        LS_ERROR("Trace", "Cannot write {}", file);
+        return false;
+    }
+
+    // Held throughout: an exiting thread frees its buffer under this mutex
+    pthread_mutex_lock(&buffersMutex);
+    const std::vector<TraceBuffer*>& snapshot = buffers;
+    const size_t threads = buffers.size();
+
+    int pid = static_cast<int>(getpid());
+    size_t total = 0;
+    bool first = true;
+    std::vector<TraceEvent> copy;
+
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (size_t b = 0; b < snapshot.size(); b++) {
+        TraceBuffer* buffer = snapshot[b];
+
+        fprintf(out, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+                     "\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",", pid, buffer->tid, buffer->threadName);
+        first = false;
+
+        // Copy without stopping the owner, then drop slots it reused meanwhile
+        uint32_t end = buffer->head.load(std::memory_order_acquire);
+        uint32_t begin = end > TraceBuffer::CAPACITY ? end - TraceBuffer::CAPACITY : 0;
+        copy.clear();
+        for (uint32_t i = begin; i < end; i++) {
+            copy.push_back(buffer->events[i & (TraceBuffer::CAPACITY - 1)]);
+        }
+        // A record() in progress writes slot `after`, the same slot as
+        // `after - CAPACITY`, before it bumps head: that one is not valid either
+        uint32_t after = buffer->head.load(std::memory_order_acquire);
+        uint32_t valid = after + 1 > TraceBuffer::CAPACITY ? after + 1 - TraceBuffer::CAPACITY : 0;
+        size_t skip = valid > begin ? valid - begin : 0;
+
+        for (size_t i = skip; i < copy.size(); i++) {
+            const TraceEvent& e = copy[i];
+            fprintf(out, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,"
+                         "\"ts\":%.3f,\"dur\":%.3f}",
+                    e.name, pid, buffer->tid, e.startNs / 1000.0, e.durNs / 1000.0);
+            total++;
+        }
+    }
+    fprintf(out, "\n]}\n");
+    pthread_mutex_unlock(&buffersMutex);
+
+    bool ok = (fclose(out) == 0);
+    LS_INFO("Trace", "{} span(s) from {} thread(s) written to {}", total, threads, file);
+    return ok;
+}
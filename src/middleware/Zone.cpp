@@ -0,0 +1,454 @@
+/**
+ * @file Zone.cpp
+ * @brief Implementation of a Single Reservoir Zone
+ */
+
+#include "Zone.h"
+#include "Config.h"
+#include "Logger.h"
+#include "Trace.h"
+#include <ctime>
+#include <sstream>
+#include <vector>
+
+/* ============================================================================
+ * ZoneConfig
+ * ============================================================================ */
+
+/**
+ * @brief Reads one channel's filter chain ("filter.<ch>.*")
+ * @param k Key prefix
+ * @param defQ Default Kalman process noise
+ * @param defR Default Kalman measurement noise
+ */
+static FilterConfig filterFromConfig(const std::string& k, float defQ, float defR)
+{
+    const Config& c = Config::instance();
+    FilterConfig f;
+    f.oversample = c.getInt(k + "oversample", 8);
+    f.medianWindow = c.getInt(k + "median", 3);
+    f.emaAlpha = c.getFloat(k + "ema_alpha", 1.0f);
+    f.kalman = c.getBool(k + "kalman", false);
+    f.kalmanQ = c.getFloat(k + "kalman_q", defQ);
+    f.kalmanR = c.getFloat(k + "kalman_r", defR);
+    return f;
+}
+
+/**
+ * @brief Reads the reservoir simulator constants ("sim.*")
+ * @param id Zone id (offsets the seed so zones do not share noise)
+ */
+static ReservoirSimParams simFromConfig(int id)
+{
+    const Config& c = Config::instance();
+    ReservoirSimParams p;
+    p.seed = static_cast<uint32_t>(c.getInt("sim.seed", 1) + id - 1);
+    p.volumeL = c.getFloat("sim.volume_l", 20.0f);
+    p.ambientC = c.getFloat("sim.ambient_c", 19.0f);
+    p.ambientSwingC = c.getFloat("sim.ambient_swing_c", 3.0f);
+    p.heaterW = c.getFloat("sim.heater_w", 50.0f);
+    p.lossWPerC = c.getFloat("sim.loss_w_per_c", 4.0f);
+    p.pumpMlPerS = c.getFloat("sim.pump_ml_per_s", 1.0f);
+    p.phPerMlPerL = c.getFloat("sim.ph_per_ml_per_l", 0.5f);
+    p.ecPpmPerMlPerL = c.getFloat("sim.ec_ppm_per_ml_per_l", 150.0f);
+    p.phDriftPerDay = c.getFloat("sim.ph_drift_per_day", 0.3f);
+    p.ecUptakePerDay = c.getFloat("sim.ec_uptake_per_day", 60.0f);
+    p.evaporationLPerDay = c.getFloat("sim.evaporation_l_per_day", 0.5f);
+    p.topUpFraction = c.getFloat("sim.top_up_fraction", 0.8f);
+    p.tempNoise = c.getFloat("sim.noise.temp", 0.05f);
+    p.phNoise = c.getFloat("sim.noise.ph", 0.03f);
+    p.ecNoise = c.getFloat("sim.noise.ec", 8.0f);
+    p.initialTempC = c.getFloat("sim.initial.temp", 18.0f);
+    p.initialPh = c.getFloat("sim.initial.ph", 6.0f);
+    p.initialEcPpm = c.getFloat("sim.initial.ec", 1100.0f);
+    return p;
+}
+
+ZoneConfig ZoneConfig::fromConfig(int id, int tickSeconds)
+{
+    const Config& c = Config::instance();
+    std::ostringstream base;
+    base << "zone." << id << ".";
+    const std::string k = base.str();
+
+    // Zone 1 keeps the original single-reservoir wiring by default
+    bool first = (id == 1);
+
+    ZoneConfig cfg;
+    cfg.id = id;
+    cfg.name = c.getString(k + "name", "Zone " + std::to_string(id));
+    cfg.heaterPin = c.getInt(k + "heater_pin", first ? 26 : -1);
+    cfg.phUpPin = c.getInt(k + "ph_up_pin", first ? 6 : -1);
+    cfg.phDownPin = c.getInt(k + "ph_down_pin", first ? 13 : -1);
+    cfg.nutrientPin = c.getInt(k + "nutrient_pin", first ? 5 : -1);
+    cfg.adcAddress = c.getInt(k + "adc_address", 0x48);
+    cfg.phChannel = c.getInt(k + "ph_channel", 2);    // A2 on ADS1115
+    cfg.tdsChannel = c.getInt(k + "tds_channel", 3);  // A3 on ADS1115
+    cfg.tempAddress = c.getString(k + "temp_address", "auto");
+    cfg.hasCamera = c.getBool(k + "camera", first);
+    cfg.cameraIndex = c.getInt(k + "camera_index", -1);
+    cfg.cameraIntervalTicks = c.getInt(k + "camera_interval_s", 4500) / tickSeconds;
+    cfg.tickSeconds = tickSeconds;
+    cfg.phFilter = filterFromConfig("filter.ph.", 0.01f, 0.0025f);  // pH^2
+    cfg.ecFilter = filterFromConfig("filter.ec.", 25.0f, 400.0f);    // ppm^2
+    cfg.simulated = c.getBool("sim.enabled", false);
+    cfg.sim = simFromConfig(id);
+
+    // Sampling limits: zone-specific keys fall back to the global ones
+    int minTicks = c.getInt(k + "sampling.min_interval_s",
+                            c.getInt("sampling.min_interval_s", 10)) / tickSeconds;
+    int maxTicks = c.getInt(k + "sampling.max_interval_s",
+                            c.getInt("sampling.max_interval_s", 300)) / tickSeconds;
+    float margin = c.getFloat(k + "sampling.near_margin",
+                              c.getFloat("sampling.near_margin", 0.1f));
+
+    cfg.tempLimits = { minTicks, maxTicks,
+        c.getFloat("sampling.temp.rate_per_min", 0.5f), margin };    // °C/min
+    cfg.phLimits = { minTicks, maxTicks,
+        c.getFloat("sampling.ph.rate_per_min", 0.1f), margin };      // pH/min
+    cfg.ecLimits = { minTicks, maxTicks,
+        c.getFloat("sampling.ec.rate_per_min", 20.0f), margin };     // ppm/min
+    return cfg;
+}
+
+/* ============================================================================
+ * Constructor / Destructor
+ * ============================================================================ */
+
+static const int READ_SENSOR_TICKS = 10;  ///< Initial read interval (ticks)
+
+Zone::Zone(const ZoneConfig& cfg, ADC* adc, W1Bus* w1, MQueueHandler* queue,
+           BoundedQueue<ActuatorCommand>* actuators)
+    : config(cfg)
+    , msgQueue(queue)
+    , actuatorQueue(actuators)
+    , camera(nullptr)
+    , cameraId(-1)
+    , sim(nullptr)
+    , simEpochBase(0)
+    , pendingReads(0)
+    , cameraCountdown(0)  // First capture on the first tick
+    , live(nullptr)
+    , liveIndex(0)
+{
+    prefix = "Z" + std::to_string(config.id) + "|";
+
+    idealConditions = new IdealConditions();
+
+    // A simulated reservoir must never switch real relays
+    if (config.simulated) {
+        sim = new ReservoirSim(config.sim);
+        simEpochBase = static_cast<int64_t>(std::time(nullptr));
+        config.heaterPin = config.phUpPin = config.phDownPin = config.nutrientPin = -1;
+    }
+
+    // Actuators
+    heater = new Heater(config.heaterPin);
+    phuPump = new Pumps(config.phUpPin);
+    phdPump = new Pumps(config.phDownPin);
+    nPump = new Pumps(config.nutrientPin);
+
+    // Sensors (pH and TDS share the zone's ADC, probes share the 1-Wire bus)
+    tempSensor = new Temp(w1, config.tempAddress);
+    phSensor = new PH(adc, config.phChannel);
+    tdsSensor = new TDS(adc, config.tdsChannel);
+    phSensor->setFilter(config.phFilter);
+    tdsSensor->setFilter(config.ecFilter);
+    if (sim) {
+        heater->setSimulation(sim);
+        phuPump->setSimulation(sim, SIM_PH_UP);
+        phdPump->setSimulation(sim, SIM_PH_DOWN);
+        nPump->setSimulation(sim, SIM_NUTRIENTS);
+        tempSensor->setSimulation(sim);
+        phSensor->setSimulation(sim);
+        tdsSensor->setSimulation(sim);
+    }
+    if (config.hasCamera) {
+        camera = new Cam(config.id == 1 ? "plant" : "plant_z" + std::to_string(config.id),
+                         config.cameraIndex);
+    }
+
+    // Schedule
+    tempSampler = new AdaptiveSampler(config.tempLimits, READ_SENSOR_TICKS);
+    phSampler = new AdaptiveSampler(config.phLimits, READ_SENSOR_TICKS);
+    ecSampler = new AdaptiveSampler(config.ecLimits, READ_SENSOR_TICKS);
+
+    // A cached value is "fresh" for as long as the slowest heartbeat allows
+    snapshotMaxAgeMs = static_cast<uint64_t>(tempSampler->getMaxInterval() + 2)
+                       * config.tickSeconds * 1000ULL;
+    sensorSnapshot.setMaxAgeMs(snapshotMaxAgeMs);  // Readers in other threads/processes
+
+    const Config& c = Config::instance();
+
+    // Swinging-door compression of SENSOR rows
+    sensorLogFilter = new SensorLogFilter(
+        c.getFloat("logging.temp.tolerance", 0.2f),   // °C
+        c.getFloat("logging.ph.tolerance", 0.05f),    // pH
+        c.getFloat("logging.ec.tolerance", 10.0f),    // ppm
+        c.getInt("logging.heartbeat_s", 900),
+        c.getBool("logging.compression", true));
+
+    LS_INFO("Zone", "{} {}: ADC 0x{:x} (pH A{}, TDS A{}), heater GPIO {}, camera {}{}",
+            config.id, config.name, config.adcAddress, config.phChannel, config.tdsChannel,
+            config.heaterPin, camera ? "yes" : "no",
+            sim ? ", SIMULATED (seed " + std::to_string(config.sim.seed) + ")" : "");
+}
+
+Zone::~Zone()
+{
+    delete sensorLogFilter;
+    delete tempSampler;
+    delete phSampler;
+    delete ecSampler;
+    delete camera;
+    delete tdsSensor;
+    delete phSensor;
+    delete tempSensor;
+    delete nPump;
+    delete phdPump;
+    delete phuPump;
+    delete heater;
+    delete sim;
+    delete idealConditions;
+}
+
+/* ============================================================================
+ * Scheduler Interface (tSig)
+ * ============================================================================ */
+
+bool Zone::tick()
+{
+    if (sim) {
+        // Fixed step per tick: the run does not depend on wall-clock speed
+        double before = sim->getSimSeconds();
+        sim->advance(config.tickSeconds);
+        if (static_cast<long>(before / 3600.0) != static_cast<long>(sim->getSimSeconds() / 3600.0)) {
+            LS_INFO("Sim", "Zone {} {}", config.id, sim->describe());
+        }
+    }
+
+    // Dosing pumps run for one tick at a time
+    if (nPump->getState()) {
+        requestActuator(ACT_NUTRIENTS, false);
+        send("LOG|Maintenance|Nutrients|Auto Off");
+    }
+    if (phuPump->getState()) {
+        requestActuator(ACT_PH_UP, false);
+        send("LOG|Maintenance|pH Up|Auto Off");
+    }
+    if (phdPump->getState()) {
+        requestActuator(ACT_PH_DOWN, false);
+        send("LOG|Maintenance|pH Down|Auto Off");
+    }
+
+    // Each sensor runs its own adaptive countdown
+    unsigned int due = 0;
+    if (tempSampler->tick()) due |= SAMPLE_TEMP;
+    if (phSampler->tick()) due |= SAMPLE_PH;
+    if (ecSampler->tick()) due |= SAMPLE_EC;
+
+    if (due != 0) {
+        pendingReads.fetch_or(due);
+    }
+    return pendingReads.load() != 0;
+}
+
+bool Zone::cameraTick()
+{
+    if (!camera) return false;
+
+    if (cameraCountdown <= 0) {
+        cameraCountdown = config.cameraIntervalTicks;
+        return true;
+    }
+    cameraCountdown--;
+    return false;
+}
+
+/* ============================================================================
+ * Acquisition Interface (tReadSensors)
+ * ============================================================================ */
+
+void Zone::acquire()
+{
+    // Sensors requested by tSig since the last cycle
+    unsigned int due = pendingReads.exchange(0);
+    if (due == 0) return;
+
+    float phRange[2], tempRange[2], tdsRange[2];
+
+    // Start from the previous frame so sensors that are not due keep
+    // their last value, then read only the due ones
+    SensorFrame frame = {};
+    sensorSnapshot.read(frame, UINT64_MAX);
+
+    if (due & SAMPLE_TEMP) {
+        frame.temperature = tempSensor->readSensor();
+        frame.tempStatus = tempSensor->getStatus();
+    }
+    if (due & SAMPLE_PH) {
+        frame.ph = phSensor->readSensor();
+        frame.phStatus = phSensor->getStatus();
+        frame.phRaw = phSensor->getRawValue();
+    }
+    if (due & SAMPLE_EC) {
+        frame.ec = tdsSensor->readSensor();
+        frame.ecStatus = tdsSensor->getStatus();
+        frame.ecRaw = tdsSensor->getRawValue();
+    }
+
+    // Publish frame so other threads never touch the bus themselves.
+    // A simulated zone is stamped (and logged, and rated) in simulated time.
+    uint64_t now;
+    if (sim) {
+        now = static_cast<uint64_t>(sim->getSimSeconds() * 1000.0);
+        sensorSnapshot.publish(frame, now, simEpochBase + static_cast<int64_t>(now / 1000));
+    } else {
+        sensorSnapshot.publish(frame);
+        now = SensorSnapshot::nowMs();
+    }
+
+    // Same stamped frame for the GUI process
+    if (live) {
+        SensorFrame stamped;
+        sensorSnapshot.read(stamped, UINT64_MAX);
+        live->publish(liveIndex, stamped);
+    }
+
+    float t = frame.temperature;
+    float p = frame.ph;
+    float e = frame.ec;
+
+    // Log to database only the rows needed to reconstruct the signal
+    std::vector<SensorFrame> rows;
+    sensorLogFilter->process(frame, rows);
+    for (size_t i = 0; i < rows.size(); i++) {
+        logSensorRow(rows[i]);
+    }
+
+    // Get ideal ranges for control decisions
+    LS_TRACE_SPAN("zone.control");
+    idealConditions->getTemp(tempRange);
+    idealConditions->getPH(phRange);
+    idealConditions->getTDS(tdsRange);
+
+    /* ------------------------------------------------------------------------
+     * Temperature Control (with hysteresis)
+     * ------------------------------------------------------------------------ */
+    if (due & SAMPLE_TEMP) {
+        LS_DEBUG("Zone", "{}: Temp Control: Current={}°C, Range=[{}-{}], Heater={}",
+                 config.id, t, tempRange[0], tempRange[1], heater->getState() ? "ON" : "OFF");
+
+        bool heating = heater->getState();
+        if (t < tempRange[0] && !heater->getState()) {
+            LS_INFO("Zone", "{}: Temperature LOW ({} < {}) -> Turning heater ON", config.id, t, tempRange[0]);
+            heating = true;
+            requestActuator(ACT_HEATER, true);
+        } else if (t > tempRange[1] && heater->getState()) {
+            LS_INFO("Zone", "{}: Temperature HIGH ({} > {}) -> Turning heater OFF", config.id, t, tempRange[1]);
+            heating = false;
+            requestActuator(ACT_HEATER, false);
+        }
+        tempSampler->update(t, tempRange, heating, now);
+    }
+
+    /* ------------------------------------------------------------------------
+     * pH Control
+     * ------------------------------------------------------------------------ */
+    if (due & SAMPLE_PH) {
+        bool dosing = false;
+        if (p < phRange[0]) {
+            dosing = true;
+            requestActuator(ACT_PH_UP, true);
+        } else if (p > phRange[1]) {
+            dosing = true;
+            requestActuator(ACT_PH_DOWN, true);
+        }
+        phSampler->update(p, phRange, dosing, now);
+    }
+
+    /* ------------------------------------------------------------------------
+     * TDS/Nutrient Control
+     * ------------------------------------------------------------------------ */
+    if (due & SAMPLE_EC) {
+        bool dosing = false;
+        if (e < tdsRange[0]) {
+            dosing = true;
+            requestActuator(ACT_NUTRIENTS, true);
+        }
+        ecSampler->update(e, tdsRange, dosing, now);
+    }
+}
+
+void Zone::flushLog()
+{
+    // Keep the most recent reading even if compression was holding it back
+    SensorFrame last;
+    if (sensorLogFilter->flush(last)) {
+        logSensorRow(last);
+    }
+}
+
+void Zone::logSensorRow(const SensorFrame& frame)
+{
+    // Rows may be written after acquisition, so carry the acquisition time
+    std::stringstream ss;
+    ss << "SENSOR|" << frame.temperature << "|" << frame.ph << "|" << frame.ec
+       << "|" << frame.acquiredAtEpoch;
+    send(ss.str());
+}
+
+/* ============================================================================
+ * Actuator Interface
+ * ============================================================================ */
+
+void Zone::requestActuator(ActuatorKind kind, bool on)
+{
+    ActuatorCommand cmd;
+    cmd.zone = this;
+    cmd.kind = kind;
+    cmd.on = on;
+    actuatorQueue->push(cmd);
+}
+
+void Zone::actuate(const ActuatorCommand& cmd)
+{
+    switch (cmd.kind) {
+        case ACT_HEATER:
+            if (heater->getState() == cmd.on) return;
+            heater->setState(cmd.on);
+            send(cmd.on ? "LOG|Maintenance|Heater ON|Auto"
+                        : "LOG|Maintenance|Heater OFF|Auto");
+            break;
+        case ACT_PH_UP:
+            if (phuPump->getState() == cmd.on) return;
+            phuPump->pump(cmd.on);
+            send("LOG|Maintenance|pH Up|Auto");
+            break;
+        case ACT_PH_DOWN:
+            if (phdPump->getState() == cmd.on) return;
+            phdPump->pump(cmd.on);
+            send("LOG|Maintenance|pH Down|Auto");
+            break;
+        case ACT_NUTRIENTS:
+            if (nPump->getState() == cmd.on) return;
+            nPump->pump(cmd.on);
+            send("LOG|Maintenance|Nutrients|Auto");
+            break;
+    }
+}
+
+/* ============================================================================
+ * Accessors
+ * ============================================================================ */
+
+void Zone::send(const std::string& msg)
+{
+    LS_TRACE_SPAN("queue.send");
+    msgQueue->sendMessage(prefix + msg);
+}
+
+bool Zone::readSnapshot(SensorFrame& frame) const
+{
+    return sensorSnapshot.read(frame, snapshotMaxAgeMs);
+}
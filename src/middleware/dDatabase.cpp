@@ -4,12 +4,59 @@
  */
 
 #include "../../include/middleware/dDatabase.h"
-#include <iostream>
+#include "../../include/middleware/Config.h"
+#include "../../include/middleware/Logger.h"
+#include "../../include/middleware/Trace.h"
 
 dDatabase::dDatabase(MQueueHandler* queue, std::string dbInfo) 
     : incomingQueue(queue), running(true) {
     // Initialize DB Manager
     db = new dbManager(dbInfo);
+    migrateSchema();
+}
+
+// Brings databases created before multi-zone support up to date
+void dDatabase::migrateSchema() {
+    db->execute("CREATE TABLE IF NOT EXISTS zones ("
+                "id INTEGER PRIMARY KEY, "
+                "name TEXT NOT NULL, "
+                "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP);");
+    db->execute("INSERT OR IGNORE INTO zones (id, name) VALUES (1, 'Zone 1');");
+
+    // ALTER TABLE cannot add a REFERENCES column with a non-NULL default
+    // while foreign keys are on, so migrated columns carry no FK clause
+    const char* tables[] = { "sensor_readings", "logs", "alerts", "plant_images" };
+    for (const char* table : tables) {
+        DBResult info = db->read(std::string("PRAGMA table_info(") + table + ");");
+        bool hasZone = false;
+        for (const auto& row : info.rows) {
+            if (row.size() > 1 && row[1] == "zone_id") hasZone = true;
+        }
+        if (info.rows.empty() || hasZone) continue;
+
+        LS_INFO("Daemon", "Migrating {}: adding zone_id", table);
+        db->execute(std::string("ALTER TABLE ") + table +
+                    " ADD COLUMN zone_id INTEGER NOT NULL DEFAULT 1;");
+    }
+
+    db->execute("CREATE INDEX IF NOT EXISTS idx_sensor_zone_timestamp "
+                "ON sensor_readings(zone_id, timestamp);");
+
+    // Keep zone names in step with the configuration Master builds zones from
+    int zoneCount = Config::instance().getInt("zones.count", 1);
+    for (int id = 1; id <= zoneCount && id <= 32; id++) {
+        std::string name = Config::instance().getString(
+            "zone." + std::to_string(id) + ".name", "Zone " + std::to_string(id));
+        size_t pos = 0;
+        while ((pos = name.find('\'', pos)) != std::string::npos) {
+            name.replace(pos, 1, "''");
+            pos += 2;
+        }
+        std::stringstream sql;
+        sql << "INSERT INTO zones (id, name) VALUES (" << id << ", '" << name << "') "
+            << "ON CONFLICT(id) DO UPDATE SET name = excluded.name;";
+        db->execute(sql.str());
+    }
 }
 
 dDatabase::~dDatabase() {
@@ -41,33 +88,75 @@ std::string dDatabase::translateToSQL(std::string rawMessage) {
     
     if (parts.empty()) return "";
 
+    // Optional zone prefix: Z<id>|TAG|... (messages without it belong to zone 1)
+    int zoneId = 1;
+    bool zoned = false;
+    if (parts[0].size() > 1 && parts[0][0] == 'Z' &&
+        parts[0].find_first_not_of("0123456789", 1) == std::string::npos) {
+        zoneId = std::stoi(parts[0].substr(1));
+        zoned = true;
+        parts.erase(parts.begin());
+        if (parts.empty()) return "";
+    }
+
     std::string tag = parts[0];
     std::stringstream sql;
 
-    if (tag == "SENSOR" && parts.size() >= 4) {
+    if (tag == "SENSOR" && parts.size() >= 5) {
+        // Format: SENSOR|TEMP|PH|EC|EPOCH (acquisition time, UTC seconds)
+        // Schema: sensor_readings (zone_id, temperature, ph, ec, timestamp)
+        sql << "INSERT INTO sensor_readings (zone_id, temperature, ph, ec, timestamp) VALUES ("
+            << zoneId << ", " << parts[1] << ", " << parts[2] << ", " << parts[3]
+            << ", datetime(" << parts[4] << ", 'unixepoch'));";
+            
+    } else if (tag == "SENSOR" && parts.size() >= 4) {
         // Format: SENSOR|TEMP|PH|EC
-        // Schema: sensor_readings (temperature, ph, ec)
-        sql << "INSERT INTO sensor_readings (temperature, ph, ec) VALUES ("
-            << parts[1] << ", " << parts[2] << ", " << parts[3] << ");";
+        // Schema: sensor_readings (zone_id, temperature, ph, ec)
+        sql << "INSERT INTO sensor_readings (zone_id, temperature, ph, ec) VALUES ("
+            << zoneId << ", " << parts[1] << ", " << parts[2] << ", " << parts[3] << ");";
             
     } else if (tag == "LOG" && parts.size() >= 4) {
         // Format: LOG|TYPE|MESSAGE|DETAILS
-        // Schema: logs (log_type, message, details)
-        sql << "INSERT INTO logs (log_type, message, details) VALUES ('"
-            << parts[1] << "', '" << parts[2] << "', '" << parts[3] << "');";
+        // Schema: logs (zone_id, log_type, message, details)
+        sql << "INSERT INTO logs (zone_id, log_type, message, details) VALUES ("
+            << zoneId << ", '" << parts[1] << "', '" << parts[2] << "', '" << parts[3] << "');";
             
     } else if (tag == "ALERT" && parts.size() >= 3) {
         // Format: ALERT|TYPE|MESSAGE
-        // Schema: alerts (type, message)
-        sql << "INSERT INTO alerts (type, message) VALUES ('"
-            << parts[1] << "', '" << parts[2] << "');";
+        // Schema: alerts (zone_id, type, message)
+        sql << "INSERT INTO alerts (zone_id, type, message) VALUES ("
+            << zoneId << ", '" << parts[1] << "', '" << parts[2] << "');";
             
+    } else if (tag == "IMG" && parts.size() >= 4) {
+        // Format: IMG|FILENAME|PATH|HASH (hash of the captured pixels)
+        // Schema: plant_images (zone_id, filename, filepath, image_hash)
+        sql << "INSERT INTO plant_images (zone_id, filename, filepath, image_hash) VALUES ("
+            << zoneId << ", '" << parts[1] << "', '" << parts[2] << "', "
+            << (parts[3].empty() ? "NULL" : "'" + parts[3] + "'") << ");";
+
     } else if (tag == "IMG" && parts.size() >= 3) {
         // Format: IMG|FILENAME|PATH
-        // Schema: plant_images (filename, filepath)
-        sql << "INSERT INTO plant_images (filename, filepath) VALUES ('"
-            << parts[1] << "', '" << parts[2] << "');";
+        // Schema: plant_images (zone_id, filename, filepath)
+        sql << "INSERT INTO plant_images (zone_id, filename, filepath) VALUES ("
+            << zoneId << ", '" << parts[1] << "', '" << parts[2] << "');";
             
+    } else if (tag == "PRED" && parts.size() >= 6) {
+        // Format: PRED|FILENAME|LABEL|CONFIDENCE|MODEL_VERSION|BOXES
+        // BOXES: "x,y,w,h[;x,y,w,h...]" from tiled inference, empty if none
+        sql << "INSERT INTO ml_predictions (image_id, prediction_type, prediction_label, confidence, "
+            << "model_version, bounding_box) "
+            << "SELECT id, '" << parts[2] << "', '" << parts[2] << "', " << parts[3] << ", '" << parts[4] << "', "
+            << (parts[5].empty() ? "NULL" : "'" + parts[5] + "'")
+            << " FROM plant_images WHERE filename = '" << parts[1] << "' "
+            << "ORDER BY id DESC LIMIT 1;";
+
+    } else if (tag == "PRED" && parts.size() >= 5) {
+        // Format: PRED|FILENAME|LABEL|CONFIDENCE|MODEL_VERSION
+        sql << "INSERT INTO ml_predictions (image_id, prediction_type, prediction_label, confidence, model_version) "
+            << "SELECT id, '" << parts[2] << "', '" << parts[2] << "', " << parts[3] << ", '" << parts[4] << "'"
+            << " FROM plant_images WHERE filename = '" << parts[1] << "' "
+            << "ORDER BY id DESC LIMIT 1;";
+
     } else if (tag == "PRED" && parts.size() >= 4) {
         // Format: PRED|FILENAME|LABEL|CONFIDENCE
         // Schema: ml_predictions (image_id, prediction_type, prediction_label, confidence)
@@ -96,8 +185,29 @@ std::string dDatabase::translateToSQL(std::string rawMessage) {
             << "JOIN plant_images pi ON mp.image_id = pi.id "
             << "WHERE pi.filename = '" << parts[1] << "' "
             << "ORDER BY mp.id DESC LIMIT 1;";
+    } else if (tag == "ACK" && parts.size() >= 2 && parts[1] == "ALERTS") {
+        // Format: [Z<id>|]ACK|ALERTS (GUI viewed the logs; without a zone: all zones)
+        sql << "UPDATE alerts SET is_read = 1 WHERE is_read = 0";
+        if (zoned) sql << " AND zone_id = " << zoneId;
+        sql << ";";
+
+    } else if (tag == "ACK" && parts.size() >= 3 && parts[1] == "REC") {
+        // Format: ACK|REC|FILENAME (GUI acknowledged a recommendation)
+        std::string filename = parts[2];
+        size_t pos = 0;
+        while ((pos = filename.find("'", pos)) != std::string::npos) {
+            filename.replace(pos, 1, "''");
+            pos += 2;
+        }
+
+        sql << "UPDATE ml_recommendations SET user_acknowledged = 1 "
+            << "WHERE prediction_id IN ("
+            << "SELECT mp.id FROM ml_predictions mp "
+            << "JOIN plant_images pi ON mp.image_id = pi.id "
+            << "WHERE pi.filename = '" << filename << "');";
+
     } else {
-        std::cerr << "[Daemon] Unknown message format: " << rawMessage << std::endl;
+        LS_WARN("Daemon", "Unknown message format: {}", rawMessage);
         return "";
     }
 
@@ -106,7 +216,8 @@ std::string dDatabase::translateToSQL(std::string rawMessage) {
 
 // The Event Loop
 void dDatabase::run() {
-    std::cout << "[Daemon] Database Service Started." << std::endl;
+    LS_INFO("Daemon", "Database service started");
+    Tracer::setThreadName("tDatabase");
 
     while (running) {
         // 1. Wait for Message (Blocking Call)
@@ -121,15 +232,16 @@ void dDatabase::run() {
 
         // 3. Execution Layer
         if (!sqlCommand.empty()) {
+            LS_TRACE_SPAN("sql.commit");
             bool success = db->insert(sqlCommand);
             if (success) {
-                std::cout << "[Daemon] SUCCESS - Inserted: " << msg << std::endl;
+                LS_DEBUG("Daemon", "SUCCESS - Inserted: {}", msg);
             } else {
-                std::cerr << "[Daemon] FAILED to insert: " << msg << std::endl;
-                std::cerr << "[Daemon] SQL: " << sqlCommand << std::endl;
+                LS_ERROR("Daemon", "FAILED to insert: {}", msg);
+                LS_ERROR("Daemon", "SQL: {}", sqlCommand);
             }
         }
     }
     
-    std::cout << "[Daemon] Database Service Stopped." << std::endl;
+    LS_INFO("Daemon", "Database service stopped");
 }
\ No newline at end of file